@@ -26,6 +26,7 @@
 #include "commands/sourceinstall.h"
 #include "commands/distupgrade.h"
 #include "commands/inrverify.h"
+#include "commands/apply-bundle.h"
 #include "commands/patch.h"
 #include "commands/update.h"
 #include "commands/patchcheck.h"
@@ -128,6 +129,7 @@ namespace
       makeCmd<InrVerifyCmd> ( ZypperCommand::VERIFY_e , std::string(), { "verify", "ve" }, InrVerifyCmd::Mode::Verify ),
       makeCmd<SourceInstallCmd> ( ZypperCommand::SRC_INSTALL_e , std::string(), { "source-install", "si" } ),
       makeCmd<InrVerifyCmd> ( ZypperCommand::INSTALL_NEW_RECOMMENDS_e , std::string(), { "install-new-recommends", "inr" }, InrVerifyCmd::Mode::InstallRecommends ),
+      makeCmd<ApplyBundleCmd> ( ZypperCommand::APPLY_BUNDLE_e , std::string(), { "apply-bundle" } ),
 
       makeCmd<UpdateCmd> ( ZypperCommand::UPDATE_e , _("Update Management:"), { "update", "up"  } ),
       makeCmd<ListUpdatesCmd> ( ZypperCommand::LIST_UPDATES_e , std::string(), { "list-updates", "lu" } ),
@@ -164,6 +166,7 @@ namespace
       makeCmd<NeedsRebootingCmd> ( ZypperCommand::NEEDS_REBOOTING_e , std::string(), { "needs-rebooting" } ),
       makeCmd<PSCommand> ( ZypperCommand::PS_e , std::string(), { "ps" } ),
       makeCmd<PurgeKernelsCmd> ( ZypperCommand::PURGE_KERNELS_e , std::string(), { "purge-kernels" } ),
+      makeCmd<LogCmd> ( ZypperCommand::LOG_e , std::string(), { "log" } ),
 
       makeCmd<SubCmd> ( ZypperCommand::SUBCOMMAND_e, _("Subcommands:"), { "subcommand" }),
 
@@ -216,6 +219,7 @@ DEF_ZYPPER_COMMAND( REMOVE );
 DEF_ZYPPER_COMMAND( SRC_INSTALL );
 DEF_ZYPPER_COMMAND( VERIFY );
 DEF_ZYPPER_COMMAND( INSTALL_NEW_RECOMMENDS );
+DEF_ZYPPER_COMMAND( APPLY_BUNDLE );
 
 DEF_ZYPPER_COMMAND( UPDATE );
 DEF_ZYPPER_COMMAND( LIST_UPDATES );
@@ -247,6 +251,7 @@ DEF_ZYPPER_COMMAND( PS );
 DEF_ZYPPER_COMMAND( DOWNLOAD );
 DEF_ZYPPER_COMMAND( SOURCE_DOWNLOAD );
 DEF_ZYPPER_COMMAND( PURGE_KERNELS );
+DEF_ZYPPER_COMMAND( LOG );
 
 DEF_ZYPPER_COMMAND( HELP );
 DEF_ZYPPER_COMMAND( SHELL );
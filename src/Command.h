@@ -44,6 +44,7 @@ struct ZypperCommand
   static const ZypperCommand SRC_INSTALL;
   static const ZypperCommand VERIFY;
   static const ZypperCommand INSTALL_NEW_RECOMMENDS;
+  static const ZypperCommand APPLY_BUNDLE;
 
   static const ZypperCommand UPDATE;
   static const ZypperCommand LIST_UPDATES;
@@ -76,6 +77,7 @@ struct ZypperCommand
   static const ZypperCommand DOWNLOAD;
   static const ZypperCommand SOURCE_DOWNLOAD;
   static const ZypperCommand PURGE_KERNELS;
+  static const ZypperCommand LOG;
 
   static const ZypperCommand HELP;
   static const ZypperCommand SHELL;
@@ -121,6 +123,7 @@ struct ZypperCommand
     SRC_INSTALL_e,
     VERIFY_e,
     INSTALL_NEW_RECOMMENDS_e,
+    APPLY_BUNDLE_e,
 
     UPDATE_e,
     LIST_UPDATES_e,
@@ -152,6 +155,7 @@ struct ZypperCommand
     DOWNLOAD_e,
     SOURCE_DOWNLOAD_e,
     PURGE_KERNELS_e,
+    LOG_e,
 
     HELP_e,
     SHELL_e,
@@ -13,6 +13,7 @@
 #include "Table.h"
 #include "Zypper.h"
 #include "utils/console.h"
+#include "output/OutJSON.h"
 
 CommitSummary::CommitSummary( const zypp::ZYppCommitResult &result, const ViewOptions options ) :
   _viewop(options),
@@ -86,6 +87,21 @@ void CommitSummary::dumpAsXmlTo(std::ostream &out)
   out << "</commit-summary>" << endl;
 }
 
+void CommitSummary::dumpAsJsonTo( std::ostream & out )
+{
+  collectData();
+  OutJSON::Line( out, "commit-summary" )
+    .add( "failed-installs", _failedInstalls.size() )
+    .add( "skipped-installs", _skippedInstalls.size() )
+    .add( "failed-removals", _failedRemovals.size() )
+    .add( "skipped-removals", _skippedRemovals.size() );
+
+  writeJsonResolvableList( out, "failed-installs", _failedInstalls );
+  writeJsonResolvableList( out, "skipped-installs", _skippedInstalls );
+  writeJsonResolvableList( out, "failed-removals", _failedRemovals );
+  writeJsonResolvableList( out, "skipped-removals", _skippedRemovals );
+}
+
 void CommitSummary::showBasicErrorMessage( Zypper &zypp )
 {
   zypp.out().error(_("Installation has completed with error.") );
@@ -95,6 +111,8 @@ void CommitSummary::showBasicErrorMessage( Zypper &zypp )
 
 void CommitSummary::writeXmlResolvableList( std::ostream & out, const std::vector< zypp::sat::Solvable> &solvables )
 {
+  // As in Summary: flushed by the endl closing each list, not per solvable.
+  const XmlDetail detail { Zypper::instance().config().xml_detail };
   for ( const auto &solvable : solvables )
   {
     out << "<solvable";
@@ -102,18 +120,42 @@ void CommitSummary::writeXmlResolvableList( std::ostream & out, const std::vecto
     out << " name=\"" << solvable.name() << "\"";
     out << " edition=\"" << solvable.edition() << "\"";
     out << " arch=\"" << solvable.arch() << "\"";
+    out << " repository=\"" << xml::escape( solvable.repoInfo().alias() ) << "\"";
+    if ( detail >= XmlDetail::NORMAL )
     {
       const std::string & text( solvable.summary() );
       if ( !text.empty() )
         out << " summary=\"" << xml::escape(text) << "\"";
     }
+    if ( detail >= XmlDetail::FULL )
     {
       const std::string & text( solvable.description() );
       if ( !text.empty() )
-        out << ">\n" << "<description>" << xml::escape( text ) << "</description>" << "</solvable>" << endl;
-      else
-        out << "/>" << endl;
+      {
+        out << ">\n" << "<description>" << xml::escape( text ) << "</description>" << "</solvable>" << "\n";
+        continue;
+      }
     }
+    out << "/>" << "\n";
+  }
+}
+
+void CommitSummary::writeJsonResolvableList( std::ostream & out, const char * list_r, const std::vector< zypp::sat::Solvable> &solvables )
+{
+  const XmlDetail detail { Zypper::instance().config().xml_detail };
+  for ( const auto &solvable : solvables )
+  {
+    OutJSON::Line line( out, "commit-item" );
+    line.add( "list", list_r )
+        .add( "kind", solvable.kind().asString() )
+        .add( "name", solvable.name() )
+        .add( "edition", solvable.edition().asString() )
+        .add( "arch", solvable.arch().asString() )
+        .add( "repository", solvable.repoInfo().alias() );
+    if ( detail >= XmlDetail::NORMAL )
+      line.addOptional( "summary", solvable.summary() );
+    if ( detail >= XmlDetail::FULL )
+      line.addOptional( "description", solvable.description() );
   }
 }
 
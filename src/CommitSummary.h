@@ -49,6 +49,8 @@ public:
 
   void dumpTo( std::ostream & out );
   void dumpAsXmlTo( std::ostream & out );
+  /** JSON Lines: the number of failed and skipped items, followed by one line per item. */
+  void dumpAsJsonTo( std::ostream & out );
 
   static void showBasicErrorMessage ( Zypper &zypp );
 
@@ -60,6 +62,7 @@ protected:
   void writeFailedRemovals(std::ostream &out);
   void writeSkippedRemovals(std::ostream &out);
   void writeXmlResolvableList(std::ostream &out, const std::vector<zypp::sat::Solvable> &solvables);
+  void writeJsonResolvableList(std::ostream &out, const char *list_r, const std::vector<zypp::sat::Solvable> &solvables);
 private:
   ViewOptions _viewop = DEFAULT;
   bool _force_no_color = false;
@@ -0,0 +1,168 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <zypp/base/Exception.h>
+#include <zypp/base/String.h>
+#include <zypp/Date.h>
+
+#include "Zypper.h"
+#include "Table.h"
+#include "output/OutJSON.h"
+#include "CommitTimings.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  inline std::string asSeconds( double seconds_r )
+  { return str::form( "%.3f", seconds_r ); }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+CommitTimings::CommitTimings( std::vector<CommitEvents::Timing> timings_r, unsigned slowest_r )
+{
+  for ( const auto & timing : timings_r )
+  {
+    auto it = std::find_if( _phases.begin(), _phases.end(),
+                            [&timing]( const PhaseTotal & total_r ) { return total_r._phase == timing._phase; } );
+    if ( it == _phases.end() )
+      it = _phases.insert( _phases.end(), PhaseTotal { timing._phase } );
+    ++it->_count;
+    it->_seconds += timing._seconds;
+  }
+
+  unsigned n = std::min<std::size_t>( slowest_r, timings_r.size() );
+  std::partial_sort( timings_r.begin(), timings_r.begin() + n, timings_r.end(),
+                     []( const CommitEvents::Timing & lhs, const CommitEvents::Timing & rhs ) { return lhs._seconds > rhs._seconds; } );
+  timings_r.resize( n );
+  _slowest = std::move(timings_r);
+}
+
+std::string CommitTimings::label( const CommitEvents::Timing & timing_r )
+{
+  if ( ! timing_r._solv )
+    return timing_r._detail;
+  if ( timing_r._detail.empty() )
+    return timing_r._solv.asString();
+  return str::Str() << timing_r._solv.asString() << " (" << timing_r._detail << ")";
+}
+
+void CommitTimings::dumpTo( std::ostream & out ) const
+{
+  if ( empty() )
+    return;
+
+  out << std::endl << _("Time spent per phase:") << std::endl;
+  {
+    Table t;
+    t << ( TableHeader() << _("Phase") << _("Count") << _("Seconds") );
+    for ( const auto & total : _phases )
+      t << ( TableRow() << total._phase << total._count << asSeconds( total._seconds ) );
+    out << t;
+  }
+
+  if ( _slowest.empty() )
+    return;
+
+  out << std::endl << str::Format(PL_("The slowest package or script:", "The %1% slowest packages and scripts:", _slowest.size())) % _slowest.size() << std::endl;
+  {
+    Table t;
+    t << ( TableHeader() << _("Seconds") << _("Phase") << _("Package") );
+    for ( const auto & timing : _slowest )
+      t << ( TableRow() << asSeconds( timing._seconds ) << timing._phase << label( timing ) );
+    out << t;
+  }
+}
+
+void CommitTimings::dumpAsXmlTo( std::ostream & out ) const
+{
+  if ( empty() )
+    return;
+
+  out << "<commit-timings>" << std::endl;
+  for ( const auto & total : _phases )
+  {
+    out << "<phase name=\"" << total._phase << "\""
+        << " count=\"" << total._count << "\""
+        << " seconds=\"" << asSeconds( total._seconds ) << "\"/>" << std::endl;
+  }
+  for ( const auto & timing : _slowest )
+  {
+    out << "<timing phase=\"" << timing._phase << "\"";
+    if ( timing._solv )
+    {
+      out << " name=\"" << xml::escape( timing._solv.name() ) << "\""
+          << " edition=\"" << timing._solv.edition() << "\""
+          << " arch=\"" << timing._solv.arch() << "\"";
+    }
+    if ( ! timing._detail.empty() )
+      out << " detail=\"" << xml::escape( timing._detail ) << "\"";
+    out << " seconds=\"" << asSeconds( timing._seconds ) << "\"/>" << std::endl;
+  }
+  out << "</commit-timings>" << std::endl;
+}
+
+void CommitTimings::dumpAsJsonTo( std::ostream & out ) const
+{
+  for ( const auto & total : _phases )
+  {
+    OutJSON::Line( out, "commit-phase" )
+      .add( "phase", total._phase )
+      .add( "count", total._count )
+      .addRaw( "seconds", asSeconds( total._seconds ) );
+  }
+  for ( const auto & timing : _slowest )
+  {
+    OutJSON::Line line( out, "commit-timing" );
+    line.add( "phase", timing._phase );
+    if ( timing._solv )
+    {
+      line.add( "name", timing._solv.name() )
+          .add( "edition", timing._solv.edition().asString() )
+          .add( "arch", timing._solv.arch().asString() );
+    }
+    line.addOptional( "detail", timing._detail )
+        .addRaw( "seconds", asSeconds( timing._seconds ) );
+  }
+}
+
+void CommitTimings::appendTo( const Pathname & file_r ) const
+{
+  std::string phases { "[" };
+  for ( const auto & total : _phases )
+  {
+    if ( phases.size() > 1 )
+      phases += ",";
+    phases += "{\"phase\":\"" + OutJSON::escape( total._phase ) + "\""
+            + ",\"count\":" + str::numstring( total._count )
+            + ",\"seconds\":" + asSeconds( total._seconds ) + "}";
+  }
+  phases += "]";
+
+  std::string slowest { "[" };
+  for ( const auto & timing : _slowest )
+  {
+    if ( slowest.size() > 1 )
+      slowest += ",";
+    slowest += "{\"phase\":\"" + OutJSON::escape( timing._phase ) + "\""
+             + ",\"item\":\"" + OutJSON::escape( label( timing ) ) + "\""
+             + ",\"seconds\":" + asSeconds( timing._seconds ) + "}";
+  }
+  slowest += "]";
+
+  std::ofstream file( file_r.c_str(), std::ios_base::app );
+  OutJSON::Line( file, "commit-timings" )
+    .add( "time", static_cast<long long>( Date::now() ) )
+    .addRaw( "phases", phases )
+    .addRaw( "slowest", slowest );
+  if ( ! file )
+    ZYPP_THROW( Exception( str::Format(_("Can not write '%1%'.")) % file_r ) );
+}
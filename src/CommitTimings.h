@@ -0,0 +1,68 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_COMMITTIMINGS_H_
+#define ZYPPER_COMMITTIMINGS_H_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <zypp/Pathname.h>
+
+#include "utils/CommitEvents.h"
+
+/**
+ * Where the time of a commit went (\c --timings): the total per phase
+ * (download, verify, install, remove, script, transaction) and the slowest
+ * packages and scripts.
+ *
+ * The timings are collected by \ref CommitEvents during the commit. The
+ * report is printed after the commit summary and may be appended to a file
+ * (one JSON line per commit), so runs can be compared.
+ */
+class CommitTimings
+{
+public:
+  /** Report the \a slowest_r slowest of \a timings_r. */
+  CommitTimings( std::vector<CommitEvents::Timing> timings_r, unsigned slowest_r );
+
+  struct PhaseTotal
+  {
+    std::string _phase;
+    unsigned _count = 0;
+    double _seconds = 0.0;
+  };
+
+  /** Totals per phase, in order of first appearance. */
+  const std::vector<PhaseTotal> & phases() const
+  { return _phases; }
+
+  /** The slowest items, slowest first. */
+  const std::vector<CommitEvents::Timing> & slowest() const
+  { return _slowest; }
+
+  bool empty() const
+  { return _phases.empty(); }
+
+  void dumpTo( std::ostream & out ) const;
+  void dumpAsXmlTo( std::ostream & out ) const;
+  void dumpAsJsonTo( std::ostream & out ) const;
+
+  /** Append the report as a single JSON line to \a file_r.
+   * \throws zypp::Exception if \a file_r can not be written.
+   */
+  void appendTo( const zypp::Pathname & file_r ) const;
+
+  /** What the item is about: the package (and script type) or the task. */
+  static std::string label( const CommitEvents::Timing & timing_r );
+
+private:
+  std::vector<PhaseTotal> _phases;
+  std::vector<CommitEvents::Timing> _slowest;
+};
+
+#endif // ZYPPER_COMMITTIMINGS_H_
@@ -19,10 +19,16 @@ extern "C"
 
 #include "utils/messages.h"
 #include "utils/Augeas.h"
+#include "utils/ConfigSnapshot.h"
+#include "utils/MemStats.h"
+#include "utils/CommitEvents.h"
+#include "utils/misc.h"
 #include "utils/flags/flagtypes.h"
 #include "output/OutNormal.h"
 #include "output/OutXML.h"
+#include "output/OutJSON.h"
 #include "Config.h"
+#include "PackageCacheTrim.h"
 #include "global-settings.h"
 #include "Zypper.h"
 
@@ -53,6 +59,22 @@ namespace zypp
                                       ( str::Format(_("Invalid table style %d.")) % s ).asString() +
                                       ( str::Format(_(" Use an integer number from %d to %d")) % 0 % ( (int)TableLineStyle::TLS_End - 1 ) ).asString()) ;
     }
+
+    template<>
+    XmlDetail argValueConvert ( const CommandOption &opt, const boost::optional<std::string> &in )
+    {
+      if ( !in || in->empty() ) ZYPP_THROW(MissingArgumentException(opt.name)); //value required
+
+      if ( *in == "minimal" )
+        return XmlDetail::MINIMAL;
+      else if ( *in == "normal" )
+        return XmlDetail::NORMAL;
+      else if ( *in == "full" )
+        return XmlDetail::FULL;
+      ZYPP_THROW(InvalidValueException ( opt.name, *in,
+                                         // translators: don't translate the level names
+                                         ( str::Format(_("Use one of '%1%', '%2%' or '%3%'.")) % "minimal" % "normal" % "full" ).asString() ));
+    }
   }
 }
 
@@ -73,12 +95,15 @@ namespace
   enum class ConfigOption {
     MAIN_SHOW_ALIAS,
     MAIN_REPO_LIST_COLUMNS,
+    MAIN_SHARED_PACKAGE_STORE,
 
     SOLVER_INSTALL_RECOMMENDS,
     SOLVER_FORCE_RESOLUTION_COMMANDS,
 
     COMMIT_AUTO_AGREE_WITH_LICENSES,
     COMMIT_PS_CHECK_ACCESS_DELETED,
+    COMMIT_PACKAGE_CACHE_MAX_SIZE,
+    COMMIT_PACKAGE_CACHE_MAX_AGE,
 
     COLOR_USE_COLORS,
     COLOR_RESULT,
@@ -110,11 +135,14 @@ namespace
     static const std::vector<std::pair<std::string,ConfigOption>> _data = {
       { "main/showAlias",			ConfigOption::MAIN_SHOW_ALIAS			},
       { "main/repoListColumns",			ConfigOption::MAIN_REPO_LIST_COLUMNS		},
+      { "main/sharedPackageStore",		ConfigOption::MAIN_SHARED_PACKAGE_STORE		},
       { "solver/installRecommends",		ConfigOption::SOLVER_INSTALL_RECOMMENDS		},
       { "solver/forceResolutionCommands",	ConfigOption::SOLVER_FORCE_RESOLUTION_COMMANDS	},
 
       { "commit/autoAgreeWithLicenses",		ConfigOption::COMMIT_AUTO_AGREE_WITH_LICENSES	},
       { "commit/psCheckAccessDeleted",		ConfigOption::COMMIT_PS_CHECK_ACCESS_DELETED	},
+      { "commit/packageCacheMaxSize",		ConfigOption::COMMIT_PACKAGE_CACHE_MAX_SIZE	},
+      { "commit/packageCacheMaxAge",		ConfigOption::COMMIT_PACKAGE_CACHE_MAX_AGE	},
 
       { "color/useColors",			ConfigOption::COLOR_USE_COLORS			},
       //"color/background"			LEGACY
@@ -188,8 +216,10 @@ namespace
 
 Config::Config()
   : repo_list_columns("anr")
+  , sharedPackageStore(false)
   , solver_installRecommends(!ZConfig::instance().solver_onlyRequires())
   , psCheckAccessDeleted(true)
+  , packageCacheMaxAge(0)
   , color_useColors	("autodetect")
   , color_pkglistHighlight(true)
   , color_pkglistHighlightAttribute(ansi::Color::nocolor())
@@ -282,6 +312,62 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
               // translators: --userdata <STRING>
               _("User defined transaction id used in history and plugins.")
         },
+        { "memstats", 0, ZyppFlags::NoArgument,
+              ZyppFlags::CallbackVal( []( const ZyppFlags::CommandOption &, const boost::optional<std::string> & ) {
+                MemStats::instance().enable();
+              }),
+              // translators: --memstats
+              _("Print the memory usage of each phase (loading repositories, solving, commit, ...) to stderr when done.")
+        },
+        { "memstats-file", 0, ZyppFlags::RequiredArgument,
+              ZyppFlags::CallbackVal( []( const ZyppFlags::CommandOption &, const boost::optional<std::string> &val ) {
+                MemStats::instance().enable( *val );
+              }, ARG_FILE ),
+              // translators: --memstats-file <FILE>
+              _("Write the memory usage of each phase as JSON to FILE.")
+        },
+        { "events-fd", 0, ZyppFlags::RequiredArgument,
+              ZyppFlags::CallbackVal( []( const ZyppFlags::CommandOption & opt, const boost::optional<std::string> &val ) {
+                std::string reason;
+                if ( val->empty() || val->find_first_not_of( "0123456789" ) != std::string::npos )
+                  reason = _("The file descriptor must be a non-negative integer.");
+                else
+                {
+                  try
+                  { CommitEvents::instance().enable( str::strtonum<int>( *val ) ); }
+                  catch ( const Exception & e )
+                  { reason = e.asUserString(); }
+                }
+                if ( ! reason.empty() )
+                {
+                  Zypper & zypper = Zypper::instance();
+                  zypper.out().error( reason );
+                  zypper.setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+                  ZYPP_THROW( ZyppFlags::InvalidValueException( opt.name, *val, reason ) );
+                }
+              }, ARG_INTEGER ),
+              // translators: --events-fd <INTEGER>
+              _("Write the begin and end of each package download, signature check, installation, removal and script as JSON lines to the file descriptor.")
+        },
+        { "timings", 0, ZyppFlags::RequiredArgument,
+              ZyppFlags::CallbackVal( [ this ]( const ZyppFlags::CommandOption & opt, const boost::optional<std::string> &val ) {
+                if ( val->empty() || val->find_first_not_of( "0123456789" ) != std::string::npos )
+                {
+                  std::string reason { _("The number of entries must be a non-negative integer.") };
+                  Zypper & zypper = Zypper::instance();
+                  zypper.out().error( str::Format(_("Invalid value '%1%' of the %2% option.")) % *val % "--timings" );
+                  zypper.setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+                  ZYPP_THROW( ZyppFlags::InvalidValueException( opt.name, *val, reason ) );
+                }
+                commit_timings = str::strtonum<int>( *val );
+              }, ARG_INTEGER ),
+              // translators: --timings <INTEGER>
+              _("After the commit print the time spent per phase and the given number of slowest package downloads, installations and scripts.")
+        },
+        { "timings-file", 0, ZyppFlags::RequiredArgument, ZyppFlags::PathNameType( commit_timings_file, boost::optional<std::string>(), ARG_FILE ),
+              // translators: --timings-file <FILE>
+              _("Append the timings of each commit as a JSON line to FILE.")
+        },
         std::move( ZyppFlags::CommandOption(
             "quiet", 'q', ZyppFlags::NoArgument,
             std::move( ZyppFlags::WriteFixedValueType( verbosity, Out::QUIET ).after( [this](){
@@ -357,6 +443,21 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
               _("Switch to XML output.")
           ).setPriority( Priority::OUTPUT )
         ),
+        std::move( ZyppFlags::CommandOption(
+          "jsonout", '\0', ZyppFlags::NoArgument, ZyppFlags::CallbackVal( [ this ]( const ZyppFlags::CommandOption &, const boost::optional<std::string> & ) {
+                do_colors = false;	// no color in json mode!
+                Zypper::instance().setOutputWriter( new OutJSON( verbosity ) );
+                machine_readable = true;
+                no_abbrev = true;
+              }),
+              // translators: --jsonout
+              _("Switch to JSON Lines output (one JSON object per line).")
+          ).setPriority( Priority::OUTPUT )
+        ),
+        { "xml-detail", 0, ZyppFlags::RequiredArgument, ZyppFlags::GenericValueType( xml_detail, "minimal|normal|full" ),
+              // translators: --xml-detail <LEVEL>
+              _("Amount of detail about each package in XML summaries: 'minimal' (name, version, arch and repository), 'normal' (plus summary) or 'full' (plus description, the default).")
+        },
         { "ignore-unknown", 'i', ZyppFlags::NoArgument, ZyppFlags::BoolType( &ignore_unknown, ZyppFlags::StoreTrue, ignore_unknown ),
               // translators: --ignore-unknown, -i
               _("Ignore unknown packages.")
@@ -386,7 +487,9 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
         //conflicting flags
         { "quiet", "verbose", "debug" },
         { "color", "no-color" },
-        { "color", "xmlout" } //color will always be disabled for XML
+        { "color", "xmlout" }, //color will always be disabled for XML
+        { "color", "jsonout" },
+        { "xmlout", "jsonout" }
       }
     } , {
       //start a new section of commands
@@ -541,6 +644,16 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
           _("Operate on a different root directory, but share repositories with the host.")
           ).setPriority( Priority::ROOT )
         ),
+        { "roots", '\0', ZyppFlags::RequiredArgument, ZyppFlags::PathNameType( roots_file, boost::optional<std::string>(), ARG_FILE ),
+          // translators: --roots <FILE>
+          _("Run the command for each root directory listed in the file (one absolute path per line). The roots share the repository caches of the host.")
+        },
+        std::move( ZyppFlags::CommandOption(
+          "roots-jobs", '\0', ZyppFlags::RequiredArgument, ZyppFlags::IntType( &roots_jobs ),
+          // translators: --roots-jobs <INTEGER>
+          _("Number of root directories processed in parallel (requires --non-interactive).")
+          ).setDependencies( { "roots" } )
+        ),
         { "disable-system-resolvables", 0, ZyppFlags::NoArgument,
             std::move( ZyppFlags::BoolType( &disable_system_resolvables, ZyppFlags::StoreTrue ).after( []() {
                 MIL << "System resolvables disabled" << endl;
@@ -552,7 +665,9 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
       },
       //conflicting flags
       {
-        { "root", "installroot" }
+        { "root", "installroot" },
+        { "root", "roots" },
+        { "installroot", "roots" }
       }
     }
   };
@@ -565,7 +680,28 @@ void Config::read( const std::string & file )
     debug::Measure m("ReadConfig");
     std::string s;
 
-    Augeas augeas( file );
+    // Unless a custom config file is used, take the values from the snapshot
+    // of the last run. Augeas is started only if a config file changed (or an
+    // option is not yet in the snapshot).
+    ConfigSnapshot snapshot( file.empty() && ! zypperUserCacheDir().empty() ? zypperUserCacheDir() / "config.snapshot" : Pathname(),
+                             Augeas::defaultConfigFiles() );
+    std::unique_ptr<Augeas> augeasPtr;
+    struct {
+      std::string getOption( const std::string & option_r )
+      {
+        std::string ret;
+        if ( _snapshot.getOption( option_r, ret ) )
+          return ret;
+        if ( ! _augeas )
+          _augeas.reset( new Augeas( _file ) );
+        ret = _augeas->getOption( option_r );
+        _snapshot.setOption( option_r, ret );
+        return ret;
+      }
+      ConfigSnapshot & _snapshot;
+      std::unique_ptr<Augeas> & _augeas;
+      const std::string & _file;
+    } augeas { snapshot, augeasPtr, file };
 
     m.elapsed();
 
@@ -582,6 +718,10 @@ void Config::read( const std::string & file )
     if (!s.empty()) // TODO add some validation
       repo_list_columns = s;
 
+    s = augeas.getOption(asString( ConfigOption::MAIN_SHARED_PACKAGE_STORE ));
+    if ( ! s.empty() )
+      sharedPackageStore = str::strToBool( s, sharedPackageStore );
+
     // ---------------[ solver ]------------------------------------------------
 
     s = augeas.getOption(asString( ConfigOption::SOLVER_INSTALL_RECOMMENDS ));
@@ -611,6 +751,14 @@ void Config::read( const std::string & file )
     if ( ! s.empty() )
       psCheckAccessDeleted = str::strToBool( s, psCheckAccessDeleted );
 
+    s = augeas.getOption(asString( ConfigOption::COMMIT_PACKAGE_CACHE_MAX_SIZE ));
+    if ( ! s.empty() && ! PackageCacheTrim::parseSize( s, packageCacheMaxSize ) )
+      WAR << "Ignore invalid commit/packageCacheMaxSize '" << s << "'" << endl;
+
+    s = augeas.getOption(asString( ConfigOption::COMMIT_PACKAGE_CACHE_MAX_AGE ));
+    if ( ! s.empty() )
+      packageCacheMaxAge = str::strtonum<unsigned>( s );
+
     // ---------------[ colors ]------------------------------------------------
 
     s = augeas.getOption( asString( ConfigOption::COLOR_USE_COLORS ) );
@@ -694,7 +842,15 @@ void Config::read( const std::string & file )
       seach_subcommand_in_path = str::strToBool( s, seach_subcommand_in_path );
 
     // finally remember the default config file for saving back values
-    _cfgSaveFile = augeas.getSaveFile();
+    if ( augeasPtr )
+    {
+      _cfgSaveFile = augeasPtr->getSaveFile();
+      // don't hide the complaints about ambiguous options in the next run
+      if ( ! augeasPtr->isAmbiguous() )
+        snapshot.save();
+    }
+    else
+      _cfgSaveFile = Augeas::defaultConfigFiles().front();
     m.stop();
   }
   catch (Exception & e)
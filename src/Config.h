@@ -11,6 +11,7 @@
 #include <string>
 #include <set>
 
+#include <zypp/ByteCount.h>
 #include <zypp/Url.h>
 #include <zypp/Pathname.h>
 #include <zypp/RepoManager.h>
@@ -22,6 +23,14 @@
 #include "output/Out.h"
 #include <zypp-tui/Config>
 
+/** How much to tell about each solvable in XML summaries (\c --xml-detail). */
+enum class XmlDetail
+{
+  MINIMAL,	///< type, name, edition, arch and repository only
+  NORMAL,	///< plus summary
+  FULL		///< plus description (the default)
+};
+
 /**
  *
  */
@@ -38,10 +47,17 @@ struct Config : public ztui::Config
   /** Which columns to show in repo list by default (string of short options).*/
   std::string repo_list_columns;
 
+  /** Share downloaded packages between the repos' package caches (see \ref PackageStore). */
+  bool sharedPackageStore;
+
   bool solver_installRecommends;
   std::set<ZypperCommand> solver_forceResolutionCommands;
 
   bool psCheckAccessDeleted;	///< do post commit 'zypper ps' check?
+  zypp::ByteCount packageCacheMaxSize;	///< post commit: trim the package caches to this size (0: no limit)
+  unsigned packageCacheMaxAge;		///< post commit: remove cached packages unused for this many days (0: no limit)
+  int commit_timings = 0;		///< --timings: report the slowest N packages and scripts of the commit (0: no report)
+  zypp::Pathname commit_timings_file;	///< --timings-file: append the timings of the commit to this file
 
   /** zypper.conf: color.useColors */
   std::string color_useColors;
@@ -81,8 +97,11 @@ struct Config : public ztui::Config
   std::string root_dir;
   bool is_install_root; /// < used when the package target rootfs is not the same as the zypper metadata rootfs
   zypp::RepoManagerOptions rm_options;
+  zypp::Pathname roots_file;	///< --roots: run the command for each root directory listed in the file
+  int roots_jobs = 1;		///< --roots-jobs: number of roots processed in parallel
   bool no_abbrev;
   bool terse;
+  XmlDetail xml_detail = XmlDetail::FULL;
   bool changedRoot;
   bool ignore_unknown;
   const int	exclude_optional_patches_default;	// global default
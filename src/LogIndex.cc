@@ -0,0 +1,462 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <zypp/base/Exception.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/ExternalProgram.h>
+#include <zypp/PathInfo.h>
+
+#include "main.h"
+#include "LogIndex.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  const std::string magic { "# zypper log index 1" };
+
+  /** The program to decompress \a file_r, or \c nullptr if it's not compressed. */
+  const char * decompressorFor( const Pathname & file_r )
+  {
+    const std::string & ext { file_r.extension() };
+    if ( ext == ".gz" )  return "gzip";
+    if ( ext == ".xz" )  return "xz";
+    if ( ext == ".bz2" ) return "bzip2";
+    if ( ext == ".zst" ) return "zstd";
+    return nullptr;
+  }
+
+  /** Read a (compressed) log line by line, keeping track of the offset. */
+  class LogReader
+  {
+  public:
+    LogReader( const Pathname & file_r )
+    {
+      if ( const char * decompressor = decompressorFor( file_r ) )
+        _prog.reset( new ExternalProgram( { decompressor, "-dc", file_r.asString() }, ExternalProgram::Discard_Stderr ) );
+      else
+        _in.open( file_r.c_str() );
+    }
+
+    /** The next complete line (without the newline).
+     * A last line without newline may still be written and is not returned.
+     */
+    bool getline( std::string & line_r )
+    {
+      if ( _prog )
+      {
+        line_r = _prog->receiveLine();
+        if ( line_r.empty() || line_r.back() != '\n' )
+          return false;
+        _offset += line_r.size();
+        line_r.pop_back();
+        return true;
+      }
+      if ( ! std::getline( _in, line_r ) || _in.eof() )
+        return false;
+      _offset += line_r.size() + 1;
+      return true;
+    }
+
+    /** Continue reading at \a offset_r (forward only for compressed logs). */
+    void seek( std::uint64_t offset_r )
+    {
+      if ( _prog )
+      {
+        for ( std::string line; _offset < offset_r && getline( line ); )
+        {;}
+        return;
+      }
+      _in.seekg( offset_r );
+      _offset = offset_r;
+    }
+
+    std::uint64_t offset() const
+    { return _offset; }
+
+  private:
+    std::unique_ptr<ExternalProgram> _prog;
+    std::ifstream _in;
+    std::uint64_t _offset = 0;
+  };
+
+  /** Split the prefix off a log line:
+   * "DATE TIME <LEVEL> HOST(PID) [COMPONENT] SOURCE MESSAGE".
+   * \return Whether it's a log line at all (and not a continuation line).
+   */
+  bool splitLine( const std::string & line_r, std::vector<std::string> & prefix_r, std::string & message_r )
+  {
+    prefix_r.clear();
+    std::string::size_type pos = 0;
+    while ( prefix_r.size() < 6 )
+    {
+      pos = line_r.find_first_not_of( ' ', pos );
+      if ( pos == std::string::npos )
+        return false;
+      std::string::size_type end = line_r.find( ' ', pos );
+      prefix_r.push_back( line_r.substr( pos, end == std::string::npos ? end : end - pos ) );
+      pos = end;
+    }
+    if ( prefix_r[0].size() != 10 || prefix_r[0][4] != '-' || prefix_r[2][0] != '<' || prefix_r[3].back() != ')' )
+      return false;
+
+    message_r = pos == std::string::npos ? std::string() : str::ltrim( line_r.substr( pos ) );
+    if ( str::hasPrefix( message_r, "{T:" ) )	// thread id
+    {
+      pos = message_r.find( "} " );
+      message_r = pos == std::string::npos ? std::string() : message_r.substr( pos + 2 );
+    }
+    return true;
+  }
+
+  unsigned pidOfHost( const std::string & host_r )
+  {
+    std::string::size_type pos = host_r.rfind( '(' );
+    return pos == std::string::npos ? 0 : str::strtonum<unsigned>( host_r.substr( pos + 1 ) );
+  }
+
+  /** "'zypper' '-v' 'ref'" -> "zypper -v ref" */
+  std::string unquoteArgs( std::string args_r, const std::string & quote_r, const std::string & sep_r )
+  {
+    args_r = str::replaceAll( args_r, quote_r + sep_r + quote_r, " " );
+    if ( str::hasPrefix( args_r, quote_r ) )
+      args_r.erase( 0, quote_r.size() );
+    if ( str::hasSuffix( args_r, quote_r ) )
+      args_r.erase( args_r.size() - quote_r.size() );
+    return args_r;
+  }
+
+  /** The name of the index file for \a log_r. */
+  std::string indexName( const Pathname & log_r )
+  { return str::replaceAll( log_r.asString().substr( 1 ), "/", "-" ) + ".index"; }
+
+  /** The log file an index file is about. */
+  Pathname logOfIndex( const Pathname & indexFile_r )
+  {
+    std::ifstream in( indexFile_r.c_str() );
+    std::string line;
+    if ( ! std::getline( in, line ) || line != magic || ! std::getline( in, line ) || ! str::hasPrefix( line, "log\t" ) )
+      return Pathname();
+    return line.substr( 4 );
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+std::vector<Pathname> LogIndex::logFiles( const Pathname & stem_r, unsigned rotated_r )
+{
+  std::vector<Pathname> ret;
+  if ( rotated_r )
+  {
+    std::list<std::string> entries;
+    filesystem::readdir( entries, stem_r.dirname(), /*dots*/false );
+    const std::string prefix { stem_r.basename() + "-" };
+    std::vector<std::string> rotated;
+    for ( const std::string & entry : entries )
+    {
+      // STEM-YYYYMMDD[.ext]
+      if ( str::hasPrefix( entry, prefix ) && entry.size() >= prefix.size() + 8
+        && entry.find_first_not_of( "0123456789", prefix.size() ) >= prefix.size() + 8
+        && ! str::hasSuffix( entry, ".index" ) )
+        rotated.push_back( entry );
+    }
+    std::sort( rotated.begin(), rotated.end() );
+    if ( rotated.size() > rotated_r )
+      rotated.erase( rotated.begin(), rotated.end() - rotated_r );
+    for ( const std::string & entry : rotated )
+      ret.push_back( stem_r.dirname() / entry );
+  }
+  if ( PathInfo( stem_r ).isFile() )
+    ret.push_back( stem_r );
+  return ret;
+}
+
+void LogIndex::prune( const Pathname & indexDir_r )
+{
+  std::list<std::string> entries;
+  if ( filesystem::readdir( entries, indexDir_r, /*dots*/false ) != 0 )
+    return;
+  for ( const std::string & entry : entries )
+  {
+    if ( ! str::hasSuffix( entry, ".index" ) )
+      continue;
+    Pathname log { logOfIndex( indexDir_r / entry ) };
+    if ( log.empty() || ! PathInfo( log ).isExist() )
+    {
+      MIL << "Remove stale log index " << entry << endl;
+      filesystem::unlink( indexDir_r / entry );
+    }
+  }
+}
+
+unsigned LogIndex::pidOf( const std::string & line_r )
+{
+  std::vector<std::string> prefix;
+  std::string message;
+  return splitLine( line_r, prefix, message ) ? pidOfHost( prefix[3] ) : 0;
+}
+
+std::string LogIndex::messageOf( const std::string & line_r )
+{
+  std::vector<std::string> prefix;
+  std::string message;
+  return splitLine( line_r, prefix, message ) ? message : std::string();
+}
+
+std::string LogIndex::downloadInfo( const std::string & line_r )
+{
+  std::vector<std::string> prefix;
+  std::string message;
+  if ( ! splitLine( line_r, prefix, message ) )
+    return std::string();
+
+  const std::string & source { prefix[5] };
+  if ( ( str::hasPrefix( source, "MediaCurl.cc(doGetFileCopyFile)" ) && message.find( "URL: " ) != std::string::npos )
+    || ( str::hasPrefix( source, "MediaMultiCurl.cc(run)" ) && str::hasPrefix( message, "#" ) )
+    || ( str::hasPrefix( source, "MediaMultiCurl.cc(doGetFileCopy)" ) && message.find( "done:" ) != std::string::npos ) )
+    return message;
+  return std::string();
+}
+
+LogIndex::LogIndex( Pathname log_r, Pathname indexDir_r )
+: _log { log_r.realpath() }
+{
+  PathInfo pi { _log };
+  if ( ! pi.isFile() || ! pi.userMayR() )
+    ZYPP_THROW( Exception( str::Format(_("Can not read '%1%'.")) % log_r ) );
+  FileId now { pi.ino(), std::uint64_t(pi.size()), pi.mtime() };
+
+  if ( ! indexDir_r.empty() )
+    _indexFile = indexDir_r / indexName( _log );
+
+  if ( ! readIndex() )
+    scan( 0 );
+  else if ( _fileId == now )
+    return;	// unchanged
+  else if ( ! decompressorFor( _log ) && _fileId._inode == now._inode && now._size >= _scanned )
+    scan( _scanned );	// appended
+  else
+  {
+    _runs.clear();	// rotated or replaced
+    scan( 0 );
+  }
+  _fileId = now;
+  writeIndex();
+}
+
+void LogIndex::scan( std::uint64_t offset_r )
+{
+  // The run of each PID (by index in _runs)
+  std::unordered_map<unsigned,unsigned> current;
+  for ( unsigned idx = 0; idx < _runs.size(); ++idx )
+    current[_runs[idx]._pid] = idx;
+
+  auto newRun = [&]( std::uint64_t begin_r, unsigned pid_r, const std::vector<std::string> & prefix_r ) -> Run & {
+    current[pid_r] = _runs.size();
+    _runs.push_back( Run() );
+    Run & run { _runs.back() };
+    run._begin = begin_r;
+    run._pid = pid_r;
+    run._time = prefix_r[0] + " " + prefix_r[1];
+    return run;
+  };
+
+  LogReader reader { _log };
+  reader.seek( offset_r );
+  std::vector<std::string> prefix;
+  std::string line;
+  std::string message;
+  unsigned pid = 0;	// of the last log line; continuation lines belong to it
+  for ( std::uint64_t begin = reader.offset(); reader.getline( line ); begin = reader.offset() )
+  {
+    if ( splitLine( line, prefix, message ) )
+    {
+      pid = pidOfHost( prefix[3] );
+      const std::string & source { prefix[5] };
+      if ( str::hasPrefix( source, "main.cc(" ) && str::hasPrefix( message, "===== Hi, me zypper " ) )
+      {
+        newRun( begin, pid, prefix )._version = str::trim( message.substr( 20 ) );
+      }
+      else if ( str::hasPrefix( source, "main.cc(" ) && str::hasPrefix( message, "===== '" ) && str::hasSuffix( message, "' =====" ) )
+      {
+        auto it = current.find( pid );
+        Run & run { it != current.end() && _runs[it->second]._command.empty() && ! _runs[it->second]._version.empty()
+                    ? _runs[it->second] : newRun( begin, pid, prefix ) };
+        run._command = unquoteArgs( message.substr( 6, message.size() - 12 ), "'", " " );
+      }
+      else if ( str::hasPrefix( source, "bin/y2start" ) && message.find( "y2base called with [" ) != std::string::npos )
+      {
+        std::string args { message.substr( message.find( '[' ) + 1 ) };
+        if ( str::hasSuffix( args, "]" ) )
+          args.pop_back();
+        newRun( begin, pid, prefix )._command = "y2base " + unquoteArgs( args, "\"", ", " );
+      }
+      else if ( str::hasPrefix( source, "genericfrontend.cc(" ) && str::hasPrefix( message, "Launched YaST2 component '" ) )
+      {
+        newRun( begin, pid, prefix )._command = unquoteArgs( message.substr( 25 ), "'", " " );
+      }
+    }
+
+    auto it = current.find( pid );
+    if ( it != current.end() )
+      _runs[it->second]._end = reader.offset();
+  }
+  _scanned = reader.offset();
+  MIL << "Scanned " << _log << " from " << offset_r << " to " << _scanned << ": " << _runs.size() << " runs" << endl;
+}
+
+bool LogIndex::readIndex()
+{
+  if ( _indexFile.empty() )
+    return false;
+  std::ifstream in( _indexFile.c_str() );
+  std::string line;
+  if ( ! std::getline( in, line ) || line != magic
+    || ! std::getline( in, line ) || line != "log\t" + _log.asString() )
+    return false;
+
+  std::vector<std::string> words;
+  while ( std::getline( in, line ) )
+  {
+    words.clear();
+    str::splitFields( line, std::back_inserter(words), "\t" );
+    if ( words.empty() )
+      continue;
+    if ( words[0] == "file" && words.size() == 5 )
+    {
+      _fileId._inode = str::strtonum<std::uint64_t>( words[1] );
+      _fileId._size = str::strtonum<std::uint64_t>( words[2] );
+      _fileId._mtime = str::strtonum<std::int64_t>( words[3] );
+      _scanned = str::strtonum<std::uint64_t>( words[4] );
+    }
+    else if ( words[0] == "run" && words.size() == 7 )
+    {
+      Run run;
+      run._begin = str::strtonum<std::uint64_t>( words[1] );
+      run._end = str::strtonum<std::uint64_t>( words[2] );
+      run._pid = str::strtonum<unsigned>( words[3] );
+      run._time = words[4];
+      run._version = words[5];
+      run._command = words[6];
+      _runs.push_back( std::move(run) );
+    }
+    else
+    {
+      WAR << "Malformed line in " << _indexFile << ": " << line << endl;
+      _runs.clear();
+      return false;
+    }
+  }
+  DBG << "Read " << _indexFile << ": " << _runs.size() << " runs" << endl;
+  return true;
+}
+
+void LogIndex::writeIndex() const
+{
+  if ( _indexFile.empty() )
+    return;
+  if ( filesystem::assert_dir( _indexFile.dirname() ) != 0 )
+  {
+    DBG << "Can not create " << _indexFile.dirname() << endl;	// e.g. not root
+    return;
+  }
+
+  Pathname tmpfile { _indexFile.extend( ".new" ) };
+  {
+    std::ofstream out( tmpfile.c_str() );
+    if ( ! out )
+    {
+      DBG << "Can not write " << tmpfile << endl;
+      return;
+    }
+    out << magic << "\n"
+        << "log\t" << _log << "\n"
+        << "file\t" << _fileId._inode << "\t" << _fileId._size << "\t" << _fileId._mtime << "\t" << _scanned << "\n";
+    for ( const Run & run : _runs )
+    {
+      out << "run\t" << run._begin << "\t" << run._end << "\t" << run._pid
+          << "\t" << run._time << "\t" << run._version << "\t" << str::replaceAll( run._command, "\t", " " ) << "\n";
+    }
+    if ( ! out )
+    {
+      WAR << "Can not write " << tmpfile << endl;
+      filesystem::unlink( tmpfile );
+      return;
+    }
+  }
+  if ( filesystem::rename( tmpfile, _indexFile ) != 0 )
+  {
+    WAR << "Can not rename " << tmpfile << endl;
+    filesystem::unlink( tmpfile );
+  }
+}
+
+void LogIndex::forEachLine( const Run & run_r, const std::function<bool( const std::string & line_r )> & fn_r ) const
+{
+  forEachLine( { &run_r }, [&fn_r]( const Run &, const std::string & line_r ) { return fn_r( line_r ); } );
+}
+
+void LogIndex::forEachLine( const std::vector<const Run *> & runs_r, const std::function<bool( const Run & run_r, const std::string & line_r )> & fn_r ) const
+{
+  if ( runs_r.empty() )
+    return;
+
+  // The runs by PID, ordered by begin (a PID may be reused in a log).
+  std::unordered_map<unsigned, std::vector<const Run *>> byPid;
+  std::uint64_t begin = runs_r.front()->_begin;
+  std::uint64_t end = 0;
+  for ( const Run * run : runs_r )
+  {
+    byPid[run->_pid].push_back( run );
+    begin = std::min( begin, run->_begin );
+    end = std::max( end, run->_end );
+  }
+  for ( auto & el : byPid )
+  {
+    std::sort( el.second.begin(), el.second.end(), []( const Run * lhs, const Run * rhs ) {
+      return lhs->_begin < rhs->_begin;
+    } );
+  }
+
+  LogReader reader { _log };
+  reader.seek( begin );
+  std::unordered_set<const Run *> stopped;
+  std::vector<std::string> prefix;
+  std::string message;
+  std::string line;
+  unsigned pid = 0;
+  while ( stopped.size() < runs_r.size() && reader.offset() < end )
+  {
+    std::uint64_t offset = reader.offset();
+    if ( ! reader.getline( line ) )
+      break;
+    if ( splitLine( line, prefix, message ) )
+      pid = pidOfHost( prefix[3] );	// else a continuation line of the last one
+
+    auto it = byPid.find( pid );
+    if ( it == byPid.end() )
+      continue;
+    for ( const Run * run : it->second )
+    {
+      if ( offset < run->_begin )
+        break;
+      if ( offset < run->_end )
+      {
+        if ( ! stopped.count( run ) && ! fn_r( *run, line ) )
+          stopped.insert( run );
+        break;
+      }
+    }
+  }
+}
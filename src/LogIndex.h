@@ -0,0 +1,126 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_LOGINDEX_H_
+#define ZYPPER_LOGINDEX_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <zypp/Pathname.h>
+
+/**
+ * The zypper (and YaST) runs found in a zypp log file (\c zypper \c log).
+ *
+ * A run starts with the line logging the version or the command line and
+ * covers the lines logged by its PID until a new run of the same PID
+ * starts. For each run the offsets of its first line and past its last
+ * line in the (uncompressed) log are remembered, so the lines of a run
+ * can be read without looking at the lines before it.
+ *
+ * Scanning a log of some GB takes a while, so the runs are saved in a
+ * small index file per log below \a indexDir_r:
+ * \code
+ * # zypper log index 1
+ * log	/var/log/zypper.log
+ * file	INODE	SIZE	MTIME	SCANNED
+ * run	BEGIN	END	PID	TIME	VERSION	COMMAND
+ * \endcode
+ * A rotated (compressed) log is scanned once. For the current log only the
+ * lines appended since the last scan are scanned. If the log was truncated
+ * or replaced it is scanned again.
+ *
+ * Compressed logs (\c .gz, \c .xz, \c .bz2, \c .zst) are read as a stream
+ * from the decompressor, so they are never unpacked on disk.
+ */
+class LogIndex
+{
+public:
+  /** A zypper or YaST run. */
+  struct Run
+  {
+    std::uint64_t _begin = 0;	///< offset of the first line
+    std::uint64_t _end = 0;	///< offset past the last line logged by \ref _pid
+    unsigned _pid = 0;
+    std::string _time;		///< "YYYY-MM-DD HH:MM:SS"
+    std::string _version;	///< zypper version (empty for YaST)
+    std::string _command;
+  };
+
+public:
+  /** The logs to read for \a stem_r: the \a rotated_r most recent rotated
+   * ones (\c STEM-YYYYMMDD*), oldest first, followed by \a stem_r itself.
+   * Files which do not exist are omitted.
+   */
+  static std::vector<zypp::Pathname> logFiles( const zypp::Pathname & stem_r, unsigned rotated_r );
+
+  /** Remove the index files in \a indexDir_r whose log no longer exists. */
+  static void prune( const zypp::Pathname & indexDir_r );
+
+  /** The PID of a log line (0 if it's not a log line). */
+  static unsigned pidOf( const std::string & line_r );
+
+  /** The message of a log line, i.e. the text following the source location. */
+  static std::string messageOf( const std::string & line_r );
+
+  /** The message of a log line about a download (as grepped by the
+   * former \c zypper-donload-stats script), or an empty string.
+   */
+  static std::string downloadInfo( const std::string & line_r );
+
+public:
+  /** Index \a log_r, using and updating the index file in \a indexDir_r
+   * (none if empty).
+   * \throws zypp::Exception if \a log_r can not be read.
+   */
+  LogIndex( zypp::Pathname log_r, zypp::Pathname indexDir_r = zypp::Pathname() );
+
+  const zypp::Pathname & log() const
+  { return _log; }
+
+  /** The runs in the order they started. */
+  const std::vector<Run> & runs() const
+  { return _runs; }
+
+  /** Call \a fn_r for each line logged by \a run_r, until it returns \c false. */
+  void forEachLine( const Run & run_r, const std::function<bool( const std::string & line_r )> & fn_r ) const;
+
+  /** Call \a fn_r for each line logged by one of \a runs_r, until it returns
+   * \c false for that run. The log is read once, from the begin of the first
+   * to the end of the last run, and the lines are passed on in log order.
+   * Reading a compressed log once for all runs, rather than once per run,
+   * is what makes this worthwhile.
+   */
+  void forEachLine( const std::vector<const Run *> & runs_r, const std::function<bool( const Run & run_r, const std::string & line_r )> & fn_r ) const;
+
+private:
+  /** Scan the log from \a offset_r on. */
+  void scan( std::uint64_t offset_r );
+
+  bool readIndex();
+  void writeIndex() const;
+
+private:
+  zypp::Pathname _log;
+  zypp::Pathname _indexFile;
+
+  struct FileId
+  {
+    std::uint64_t _inode = 0;
+    std::uint64_t _size = 0;
+    std::int64_t _mtime = 0;
+
+    bool operator==( const FileId & rhs ) const
+    { return _inode == rhs._inode && _size == rhs._size && _mtime == rhs._mtime; }
+  };
+  FileId _fileId;		///< of the scanned log
+  std::uint64_t _scanned = 0;	///< offset past the last complete line scanned
+  std::vector<Run> _runs;
+};
+
+#endif // ZYPPER_LOGINDEX_H_
@@ -0,0 +1,250 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include <zypp/base/Exception.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+
+#include "Zypper.h"
+#include "MultiRoot.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** The \ref MultiRoot::CacheLock file in a child; empty in the parent. */
+  Pathname childCacheLockFile;
+
+  /** Translate a childs wait status into an exit code. */
+  int exitCodeOf( int status_r )
+  {
+    if ( WIFEXITED( status_r ) )
+      return WEXITSTATUS( status_r );
+    if ( WIFSIGNALED( status_r ) && ( WTERMSIG( status_r ) == SIGINT || WTERMSIG( status_r ) == SIGTERM ) )
+      return ZYPPER_EXIT_ON_SIGNAL;
+    return ZYPPER_EXIT_ERR_BUG;
+  }
+
+  /** The URL the caches of \a repo_r are built from. */
+  std::string urlOf( const RepoInfo & repo_r )
+  { return repo_r.baseUrlsEmpty() ? repo_r.mirrorListUrl().asString() : repo_r.url().asString(); }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+std::vector<Pathname> MultiRoot::readRoots( const Pathname & file_r )
+{
+  std::ifstream infile( file_r.c_str() );
+  if ( ! infile )
+    ZYPP_THROW( Exception( str::Format(_("Can not read '%1%'.")) % file_r ) );
+
+  std::vector<Pathname> ret;
+  std::string line;
+  while ( std::getline( infile, line ) )
+  {
+    line = str::trim( line );
+    if ( line.empty() || line[0] == '#' )
+      continue;
+    Pathname root { line };
+    if ( ! root.absolute() )
+      ZYPP_THROW( Exception( str::Format(_("The root '%1%' in '%2%' is not an absolute path.")) % line % file_r ) );
+    ret.push_back( std::move(root) );
+  }
+  return ret;
+}
+
+bool MultiRoot::claimRepoUrls( const Pathname & file_r, const std::list<RepoInfo> & repos_r, bool override_r )
+{
+  CacheLock cacheLock;
+
+  std::map<std::string,std::string> urls;	// alias -> url
+  {
+    std::ifstream infile( file_r.c_str() );
+    std::string line;
+    while ( std::getline( infile, line ) )
+    {
+      std::string::size_type tab = line.find( '\t' );
+      if ( tab != std::string::npos )
+        urls[line.substr( 0, tab )] = line.substr( tab+1 );
+    }
+  }
+
+  bool changed = false;
+  for ( const RepoInfo & repo : repos_r )
+  {
+    std::string url { urlOf( repo ) };
+    auto it = urls.find( repo.alias() );
+    if ( it == urls.end() || it->second != url )
+    {
+      if ( it != urls.end() && ! override_r )
+      {
+        MIL << "Repo '" << repo.alias() << "' " << url << " conflicts with the cached " << it->second << endl;
+        return false;
+      }
+      urls[repo.alias()] = url;
+      changed = true;
+    }
+  }
+  if ( ! changed )
+    return true;
+
+  Pathname tmpfile { file_r.extend( ".new" ) };
+  {
+    std::ofstream outfile( tmpfile.c_str() );
+    for ( const auto & el : urls )
+      outfile << el.first << '\t' << el.second << '\n';
+    if ( ! outfile )
+    {
+      WAR << "Can not write " << tmpfile << endl;
+      return false;	// later roots could not tell a conflict
+    }
+  }
+  filesystem::rename( tmpfile, file_r );
+  return true;
+}
+
+MultiRoot::CacheLock::CacheLock( bool shared_r )
+{
+  if ( childCacheLockFile.empty() )
+    return;
+
+  _fd = ::open( childCacheLockFile.c_str(), O_RDWR|O_CREAT|O_CLOEXEC, 0644 );
+  if ( _fd < 0 )
+  {
+    WAR << "Can not open cache lock " << childCacheLockFile << ": " << str::strerror( errno ) << endl;
+    return;
+  }
+  while ( ::flock( _fd, shared_r ? LOCK_SH : LOCK_EX ) != 0 )
+  {
+    if ( errno == EINTR )
+      continue;
+    WAR << "Can not lock " << childCacheLockFile << ": " << str::strerror( errno ) << endl;
+    ::close( _fd );
+    _fd = -1;
+    return;
+  }
+  DBG << "Locked " << childCacheLockFile << endl;
+}
+
+MultiRoot::CacheLock::~CacheLock()
+{
+  if ( _fd < 0 )
+    return;
+  ::flock( _fd, LOCK_UN );
+  ::close( _fd );
+  DBG << "Unlocked " << childCacheLockFile << endl;
+}
+
+MultiRoot::MultiRoot( std::vector<Pathname> roots_r, unsigned jobs_r, Pathname outputDir_r )
+: _roots { std::move(roots_r) }
+, _jobs { jobs_r ? jobs_r : 1 }
+, _outputDir { std::move(outputDir_r) }
+{}
+
+std::vector<MultiRoot::Result> MultiRoot::run( const Function & fn_r, const DoneFunction & done_r ) const
+{
+  std::vector<Result> ret( _roots.size() );
+  std::map<pid_t,unsigned> running;	// pid -> index
+
+  auto start = [&]( unsigned idx_r ) {
+    Result & result { ret[idx_r] };
+    if ( ! _outputDir.empty() )
+      result._output = _outputDir / str::numstring( idx_r );
+
+    // don't let the child inherit pending output
+    std::cout.flush();
+    std::cerr.flush();
+    ::fflush( nullptr );
+
+    pid_t pid = ::fork();
+    if ( pid < 0 )
+    {
+      ERR << "fork failed for root " << result._root << ": " << str::strerror( errno ) << endl;
+      result._exitCode = ZYPPER_EXIT_ERR_BUG;
+      if ( done_r )
+        done_r( result );
+      return;
+    }
+    if ( pid == 0 )
+    {
+      childCacheLockFile = _cacheLockFile;
+      if ( ! result._output.empty() )
+      {
+        int fd = ::open( result._output.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0600 );
+        if ( fd >= 0 )
+        {
+          ::dup2( fd, STDOUT_FILENO );
+          ::dup2( fd, STDERR_FILENO );
+          ::close( fd );
+        }
+      }
+      int code = fn_r( result._root );
+      std::cout.flush();
+      std::cerr.flush();
+      ::fflush( nullptr );
+      ::_exit( code );	// the parent cleans up what was set up before the fork
+    }
+    MIL << "Processing root " << result._root << " in child " << pid << endl;
+    running[pid] = idx_r;
+  };
+
+  bool warmedUp = false;	// the first root is done
+  unsigned next = 0;
+  for ( unsigned idx = 0; idx < _roots.size(); ++idx )
+  {
+    ret[idx]._root = _roots[idx];
+    ret[idx]._exitCode = ZYPPER_EXIT_ON_SIGNAL;	// unless processed
+  }
+
+  while ( true )
+  {
+    unsigned limit = warmedUp ? _jobs : 1;
+    while ( next < _roots.size() && running.size() < limit && ! Zypper::instance().exitRequested() )
+      start( next++ );
+
+    if ( running.empty() )
+    {
+      if ( next < _roots.size() && ! Zypper::instance().exitRequested() )
+        continue;	// fork failed; try the next one
+      break;
+    }
+
+    int status = 0;
+    pid_t pid = ::waitpid( -1, &status, 0 );
+    if ( pid < 0 )
+    {
+      if ( errno == EINTR )
+        continue;
+      ERR << "waitpid failed: " << str::strerror( errno ) << endl;
+      break;
+    }
+    auto it = running.find( pid );
+    if ( it == running.end() )
+      continue;	// not one of ours
+
+    Result & result { ret[it->second] };
+    result._exitCode = exitCodeOf( status );
+    running.erase( it );
+    warmedUp = true;
+    MIL << "Root " << result._root << " done: exit code " << result._exitCode << endl;
+    if ( done_r )
+      done_r( result );
+  }
+  return ret;
+}
@@ -0,0 +1,103 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_MULTIROOT_H_
+#define ZYPPER_MULTIROOT_H_
+
+#include <functional>
+#include <list>
+#include <vector>
+
+#include <zypp/Pathname.h>
+#include <zypp/RepoInfo.h>
+
+/**
+ * Run a command once per root directory (\c --roots).
+ *
+ * Each root is processed in a child process forked after the global options
+ * and the config files were read. The children share the repository caches
+ * of the host, so identical repos are refreshed and their solv files built
+ * only once.
+ *
+ * With \c jobs > 1 up to \c jobs roots are processed in parallel. The first
+ * root is always processed alone, so the shared caches are up to date before
+ * the parallel children start reading them. Roots may still use repos the
+ * first one did not, so a child refreshing or building the shared caches holds
+ * the \ref CacheLock while doing so, and a child loading them holds it shared.
+ *
+ * The caches are keyed by alias only. A root using an alias for a different URL
+ * than the host or a previous root must not share them; \ref claimRepoUrls tells.
+ *
+ * If an output directory is given, the stdout and stderr of each child are
+ * captured in a file there, to be printed by the parent once the child is
+ * done. Otherwise the children write to the terminal.
+ */
+class MultiRoot
+{
+public:
+  /** Read the roots from \a file_r: one absolute path per line, empty lines and '#' comments are skipped.
+   * \throws zypp::Exception if the file can not be read or a path is not absolute.
+   */
+  static std::vector<zypp::Pathname> readRoots( const zypp::Pathname & file_r );
+
+  /** The outcome for one root. */
+  struct Result
+  {
+    zypp::Pathname _root;
+    int _exitCode = 0;
+    zypp::Pathname _output;	///< captured stdout/stderr (if captured)
+  };
+
+  /** The child calls \a fn_r and exits with the returned code. */
+  using Function = std::function<int( const zypp::Pathname & root_r )>;
+
+  /** The parent is told about each finished child. */
+  using DoneFunction = std::function<void( const Result & result_r )>;
+
+  /** Record the URL of each of \a repos_r by alias in \a file_r.
+   * \return \c false and record nothing if an alias is already recorded with a
+   * different URL, i.e. the repos must not use the shared caches. Unless
+   * \a override_r, then the recorded URL is replaced (the host's repos own the caches).
+   */
+  static bool claimRepoUrls( const zypp::Pathname & file_r, const std::list<zypp::RepoInfo> & repos_r, bool override_r = false );
+
+  /** Lock on the shared repo caches.
+   * Taken exclusive around each refresh and cache build, shared around loading
+   * a cache. It is a no-op unless the process is a child of \ref run and a
+   * \ref cacheLockFile was set.
+   */
+  class CacheLock
+  {
+  public:
+    CacheLock( bool shared_r = false );
+    ~CacheLock();
+    CacheLock( const CacheLock & ) = delete;
+    CacheLock & operator=( const CacheLock & ) = delete;
+  private:
+    int _fd = -1;
+  };
+
+  MultiRoot( std::vector<zypp::Pathname> roots_r, unsigned jobs_r = 1, zypp::Pathname outputDir_r = zypp::Pathname() );
+
+  /** The file the children \ref CacheLock on (created if missing). */
+  void cacheLockFile( zypp::Pathname file_r )
+  { _cacheLockFile = std::move(file_r); }
+
+  /** Process all roots, calling \a done_r whenever a child has finished.
+   * No more children are started once an exit is requested (e.g. Ctrl-C).
+   * \return The results in the order of the roots (roots not processed
+   * have \c ZYPPER_EXIT_ON_SIGNAL).
+   */
+  std::vector<Result> run( const Function & fn_r, const DoneFunction & done_r = DoneFunction() ) const;
+
+private:
+  std::vector<zypp::Pathname> _roots;
+  unsigned _jobs;
+  zypp::Pathname _outputDir;
+  zypp::Pathname _cacheLockFile;
+};
+
+#endif // ZYPPER_MULTIROOT_H_
@@ -0,0 +1,133 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <sys/stat.h>
+#include <algorithm>
+#include <list>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+
+#include "PackageCacheTrim.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  struct CachedFile
+  {
+    Pathname _path;
+    ByteCount _size;
+    time_t _lastUse;
+    bool _keep;
+  };
+
+  void collectFiles( const Pathname & dir_r, const std::set<std::string> & keep_r, std::vector<CachedFile> & files_r )
+  {
+    std::list<std::string> entries;
+    if ( filesystem::readdir( entries, dir_r, /*dots*/false ) != 0 )
+      return;
+
+    for ( const std::string & entry : entries )
+    {
+      Pathname path { dir_r / entry };
+      struct stat st;
+      if ( ::lstat( path.c_str(), &st ) != 0 )
+        continue;
+      if ( S_ISDIR( st.st_mode ) )
+        collectFiles( path, keep_r, files_r );
+      else if ( S_ISREG( st.st_mode ) && str::endsWith( entry, ".rpm" ) )
+        files_r.push_back( { path, ByteCount( st.st_size ), std::max( st.st_atime, st.st_mtime ), keep_r.count( entry ) != 0 } );
+    }
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+PackageCacheTrim::PackageCacheTrim( ByteCount maxSize_r, unsigned maxAgeDays_r )
+: _maxSize { maxSize_r }
+, _maxAgeDays { maxAgeDays_r }
+{}
+
+void PackageCacheTrim::addCacheDir( const Pathname & dir_r )
+{
+  if ( std::find( _dirs.begin(), _dirs.end(), dir_r ) == _dirs.end() )
+    _dirs.push_back( dir_r );
+}
+
+std::string PackageCacheTrim::rpmFileName( const sat::Solvable & solv_r )
+{
+  const Edition & ed { solv_r.edition() };
+  return str::Str() << solv_r.name() << "-" << ed.version() << "-" << ed.release() << "." << solv_r.arch() << ".rpm";
+}
+
+bool PackageCacheTrim::parseSize( const std::string & str_r, ByteCount & size_r )
+{
+  std::string str { str::trim( str_r ) };
+  if ( str.empty() )
+    return false;
+
+  unsigned long long unit = 1;
+  switch ( str.back() )
+  {
+    case 'K': case 'k': unit = ByteCount::K.factor(); break;
+    case 'M': case 'm': unit = ByteCount::M.factor(); break;
+    case 'G': case 'g': unit = ByteCount::G.factor(); break;
+    case 'T': case 't': unit = ByteCount::T.factor(); break;
+  }
+  if ( unit != 1 )
+    str.pop_back();
+  if ( str.empty() || str.find_first_not_of( "0123456789" ) != std::string::npos )
+    return false;
+
+  size_r = ByteCount( str::strtonum<unsigned long long>( str ) * unit );
+  return true;
+}
+
+PackageCacheTrim::Result PackageCacheTrim::run( bool dryRun_r ) const
+{
+  Result ret;
+  std::vector<CachedFile> files;
+  for ( const Pathname & dir : _dirs )
+    collectFiles( dir, _keep, files );
+
+  for ( const CachedFile & file : files )
+    ret._size += file._size;
+  ret._files = files.size();
+
+  // least recently used first
+  std::stable_sort( files.begin(), files.end(), []( const CachedFile & lhs, const CachedFile & rhs ) {
+    return lhs._lastUse < rhs._lastUse;
+  } );
+
+  time_t now = _now ? _now : ::time( nullptr );
+  time_t maxAge = time_t(_maxAgeDays) * 24 * 60 * 60;
+  ByteCount size { ret._size };
+
+  for ( const CachedFile & file : files )
+  {
+    if ( file._keep )
+      continue;
+    bool tooOld = _maxAgeDays && now - file._lastUse > maxAge;
+    bool tooBig = _maxSize && size > _maxSize;
+    if ( ! ( tooOld || tooBig ) )
+      continue;
+
+    if ( ! dryRun_r && filesystem::unlink( file._path ) != 0 )
+    {
+      WAR << "Can not remove " << file._path << endl;
+      continue;
+    }
+    DBG << ( dryRun_r ? "Would remove " : "Removed " ) << file._path << " (" << file._size << ( tooOld ? ", too old)" : ")" ) << endl;
+    size -= file._size;
+    ++ret._removed;
+    ret._freed += file._size;
+  }
+
+  MIL << "Package caches: " << ret._files << " files, " << ret._size << "; removed " << ret._removed << " files, " << ret._freed << endl;
+  return ret;
+}
@@ -0,0 +1,77 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_PACKAGECACHETRIM_H_
+#define ZYPPER_PACKAGECACHETRIM_H_
+
+#include <ctime>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <zypp/ByteCount.h>
+#include <zypp/Pathname.h>
+#include <zypp/sat/Solvable.h>
+
+/**
+ * Bound the size and age of the package caches (\c zypper clean --max-size/--max-age
+ * and the post commit step configured in zypper.conf).
+ *
+ * All rpm files below the added cache directories are candidates. Files not used
+ * for more than \c maxAge days are removed. If the total size still exceeds
+ * \c maxSize, the least recently used files (last access or modification) are
+ * removed until it fits. Files named like the rpm of a \ref keep solvable (usually
+ * the installed ones) are never removed, but count for the total size.
+ */
+class PackageCacheTrim
+{
+public:
+  /** A \c 0 limit is no limit. */
+  PackageCacheTrim( zypp::ByteCount maxSize_r, unsigned maxAgeDays_r );
+
+  /** Add a package cache directory (scanned recursively). */
+  void addCacheDir( const zypp::Pathname & dir_r );
+
+  /** Never remove the rpm file of \a solv_r. */
+  void keep( const zypp::sat::Solvable & solv_r )
+  { keep( rpmFileName( solv_r ) ); }
+
+  /** Never remove files named \a fileName_r. */
+  void keep( std::string fileName_r )
+  { _keep.insert( std::move(fileName_r) ); }
+
+  struct Result
+  {
+    unsigned _files = 0;	///< rpm files found
+    zypp::ByteCount _size;	///< their total size
+    unsigned _removed = 0;	///< files removed
+    zypp::ByteCount _freed;	///< their size
+  };
+
+  /** Remove files exceeding the limits; with \a dryRun_r just tell what would be removed. */
+  Result run( bool dryRun_r = false ) const;
+
+  /** The name libzypp gives the cached rpm of \a solv_r (\c N-V-R.A.rpm). */
+  static std::string rpmFileName( const zypp::sat::Solvable & solv_r );
+
+  /** Parse a size like \c 2G, \c 500M or \c 1024 (bytes); the units are powers of 1024.
+   * \return \c false if \a str_r is not a size.
+   */
+  static bool parseSize( const std::string & str_r, zypp::ByteCount & size_r );
+
+  /** For testing: pretend \a now_r is the current time. */
+  void setNow( time_t now_r )
+  { _now = now_r; }
+
+private:
+  zypp::ByteCount _maxSize;
+  unsigned _maxAgeDays;
+  std::vector<zypp::Pathname> _dirs;
+  std::set<std::string> _keep;
+  time_t _now = 0;
+};
+
+#endif // ZYPPER_PACKAGECACHETRIM_H_
@@ -0,0 +1,153 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <sys/stat.h>
+#include <list>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/CheckSum.h>
+#include <zypp/OnMediaLocation.h>
+#include <zypp/PathInfo.h>
+#include <zypp/RepoInfo.h>
+#include <zypp/sat/SolvAttr.h>
+
+#include "Zypper.h"
+#include "PackageStore.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Hardlink \a from_r to \a to_r via a temporary name, so \a to_r appears complete. */
+  bool linkInto( const Pathname & from_r, const Pathname & to_r )
+  {
+    if ( filesystem::assert_dir( to_r.dirname() ) != 0 )
+      return false;
+    Pathname tmp { to_r.extend( ".new" ) };
+    filesystem::unlink( tmp );
+    if ( filesystem::hardlink( from_r, tmp ) != 0 )
+      return false;
+    if ( filesystem::rename( tmp, to_r ) != 0 )
+    {
+      filesystem::unlink( tmp );
+      return false;
+    }
+    return true;
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+PackageStore::PackageStore( Pathname dir_r )
+: _dir { std::move(dir_r) }
+{}
+
+PackageStore & PackageStore::instance()
+{
+  static PackageStore _instance { [](){
+    const Config & config { Zypper::instance().config() };
+    if ( ! config.sharedPackageStore )
+      return Pathname();
+    return Pathname::assertprefix( config.root_dir, ZYPPER_PACKAGE_STORE_DIR );
+  }() };
+  return _instance;
+}
+
+Pathname PackageStore::cacheLocation( const sat::Solvable & solv_r )
+{
+  RepoInfo repo { solv_r.repository().info() };
+  return repo.packagesPath() / repo.path() / solv_r.lookupLocation().filename();
+}
+
+Pathname PackageStore::storeLocation( const CheckSum & checksum_r ) const
+{
+  if ( checksum_r.empty() )
+    return Pathname();
+  std::string hex { checksum_r.checksum() };
+  return _dir / checksum_r.type() / hex.substr( 0, 2 ) / hex;
+}
+
+bool PackageStore::provide( const sat::Solvable & solv_r ) const
+{
+  Pathname cached { cacheLocation( solv_r ) };
+  if ( PathInfo( cached ).isFile() )
+    return true;
+  if ( ! enabled() || solv_r.isSystem() || ! solv_r.repository().info().keepPackages() )
+    return false;
+
+  CheckSum checksum { solv_r.lookupCheckSumAttribute( sat::SolvAttr::checksum ) };
+  Pathname stored { storeLocation( checksum ) };
+  if ( stored.empty() || ! PathInfo( stored ).isFile() )
+    return false;
+  if ( filesystem::checksum( stored, checksum.type() ) != checksum.checksum() )
+  {
+    WAR << "Checksum mismatch of " << stored << endl;	// the cache it was remembered from was corrupt
+    return false;
+  }
+
+  if ( ! linkInto( stored, cached ) )
+  {
+    DBG << "Can not link " << stored << " to " << cached << endl;
+    return false;
+  }
+  MIL << "Shared package store hit: " << cached << endl;
+  return true;
+}
+
+void PackageStore::remember( const sat::Solvable & solv_r ) const
+{
+  if ( ! enabled() || solv_r.isSystem() )
+    return;
+
+  Pathname cached { cacheLocation( solv_r ) };
+  PathInfo cachedInfo { cached };
+  if ( ! cachedInfo.isFile() )
+    return;
+
+  Pathname stored { storeLocation( solv_r.lookupCheckSumAttribute( sat::SolvAttr::checksum ) ) };
+  if ( stored.empty() )
+    return;
+  PathInfo storedInfo { stored };
+  if ( storedInfo.isExist() && storedInfo.ino() == cachedInfo.ino() && storedInfo.dev() == cachedInfo.dev() )
+    return;	// already there
+
+  if ( ! linkInto( cached, stored ) )
+    DBG << "Can not link " << cached << " to " << stored << endl;	// e.g. not root or other filesystem
+  else
+    DBG << "Remember " << cached << " as " << stored << endl;
+}
+
+unsigned PackageStore::prune() const
+{
+  if ( ! enabled() || ! PathInfo( _dir ).isDir() )
+    return 0;
+
+  unsigned ret = 0;
+  std::list<Pathname> dirs { _dir };
+  while ( ! dirs.empty() )
+  {
+    Pathname dir { dirs.front() };
+    dirs.pop_front();
+
+    std::list<std::string> entries;
+    if ( filesystem::readdir( entries, dir, /*dots*/false ) != 0 )
+      continue;
+    for ( const std::string & entry : entries )
+    {
+      Pathname path { dir / entry };
+      struct stat st;
+      if ( ::lstat( path.c_str(), &st ) != 0 )
+        continue;
+      if ( S_ISDIR( st.st_mode ) )
+        dirs.push_back( path );
+      else if ( st.st_nlink <= 1 && filesystem::unlink( path ) == 0 )	// incl. stale .new files
+        ++ret;
+    }
+  }
+  MIL << "Pruned " << ret << " files from the shared package store " << _dir << endl;
+  return ret;
+}
@@ -0,0 +1,67 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_PACKAGESTORE_H_
+#define ZYPPER_PACKAGESTORE_H_
+
+#include <zypp/CheckSum.h>
+#include <zypp/Pathname.h>
+#include <zypp/sat/Solvable.h>
+
+/** Location of the shared package store. */
+#define ZYPPER_PACKAGE_STORE_DIR "/var/cache/zypper/packages-by-checksum"
+
+/**
+ * Checksum keyed store of the downloaded rpm files, shared by the package caches
+ * of all repositories.
+ *
+ * The same rpm is often available in several repos (e.g. pool and update snapshot).
+ * Packages are looked up in the store by their checksum before they are
+ * downloaded and hardlinked into the package cache of the repo they are taken
+ * from. Downloaded packages are hardlinked into the store. So the store costs no
+ * extra disk space; \ref prune removes the files no package cache uses anymore.
+ *
+ * Everything fails silently (e.g. not root, store on another filesystem), just
+ * logging what happened.
+ */
+class PackageStore
+{
+public:
+  /** The store in \a dir_r; an empty \a dir_r disables the store. */
+  PackageStore( zypp::Pathname dir_r );
+
+  /** The store configured in zypper.conf (main/sharedPackageStore). */
+  static PackageStore & instance();
+
+  bool enabled() const
+  { return ! _dir.empty(); }
+
+  /** If \a solv_r is not in its package cache but in the store, link it into the cache.
+   * Only for repos keeping their packages, and if the stored file matches the checksum.
+   * \return whether the package is in the package cache now.
+   */
+  bool provide( const zypp::sat::Solvable & solv_r ) const;
+
+  /** Add the rpm of \a solv_r to the store, if it's in its package cache. */
+  void remember( const zypp::sat::Solvable & solv_r ) const;
+
+  /** Remove files no package cache links to anymore.
+   * \return the number of files removed.
+   */
+  unsigned prune() const;
+
+  /** Where \a solv_r is expected in its package cache. */
+  static zypp::Pathname cacheLocation( const zypp::sat::Solvable & solv_r );
+
+private:
+  /** The store file for \a checksum_r (empty if there is no checksum). */
+  zypp::Pathname storeLocation( const zypp::CheckSum & checksum_r ) const;
+
+private:
+  zypp::Pathname _dir;
+};
+
+#endif // ZYPPER_PACKAGESTORE_H_
@@ -0,0 +1,146 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include <zypp/base/Exception.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+
+#include "ParallelCacheBuild.h"
+
+using namespace zypp;
+
+ParallelCacheBuild::ParallelCacheBuild( unsigned jobs_r, BuildFunction build_r )
+: _jobs { std::max( jobs_r, 1U ) }
+, _build { std::move(build_r) }
+{}
+
+void ParallelCacheBuild::run( const DoneCallback & done_r, std::ostream & out_r, std::ostream & err_r )
+{
+  unsigned running = 0;
+  unsigned nextStart = 0;
+  unsigned nextReport = 0;
+
+  while ( nextReport < _queue.size() )
+  {
+    while ( running < _jobs && nextStart < _queue.size() && startWorker( _queue[nextStart] ) )
+    {
+      ++running;
+      ++nextStart;
+    }
+
+    // report finished jobs in order
+    while ( nextReport < nextStart && _queue[nextReport]._done )
+    {
+      Job & job { _queue[nextReport++] };
+      replay( job._output.path(), out_r );
+      replay( job._errors.path(), err_r );
+      done_r( job._repo, job._error );
+    }
+    if ( nextReport == _queue.size() )
+      break;
+
+    if ( ! running )
+    {
+      // could not start a worker; build it here
+      Job & job { _queue[nextStart++] };
+      job._error = _build( job._repo );
+      job._done = true;
+      continue;
+    }
+
+    // Reap our own workers only; waiting for any child would steal the
+    // exit status of children forked elsewhere in the process.
+    bool reaped = false;
+    for ( unsigned i = nextReport; i < nextStart; ++i )
+    {
+      Job & job { _queue[i] };
+      if ( job._done || job._pid <= 0 )
+        continue;
+
+      int status = 0;
+      pid_t pid = ::waitpid( job._pid, &status, WNOHANG );
+      if ( pid == 0 || ( pid < 0 && errno == EINTR ) )
+        continue;
+      if ( pid < 0 )
+      {
+        ERR << "waitpid " << job._pid << ": " << str::strerror( errno ) << endl;
+        job._error = true;
+      }
+      else
+      {
+        job._error = !( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+        DBG << "Cache build worker " << pid << " for " << job._repo.alias() << " done (" << status << ")" << endl;
+      }
+      job._done = true;
+      --running;
+      reaped = true;
+    }
+    if ( ! reaped )
+      ::usleep( 10000 );
+  }
+}
+
+bool ParallelCacheBuild::startWorker( Job & job_r ) const
+{
+  // don't let the worker inherit pending output
+  std::cout.flush();
+  std::cerr.flush();
+  ::fflush( nullptr );
+
+  job_r._pid = ::fork();
+  if ( job_r._pid < 0 )
+  {
+    WAR << "Can not fork a cache build worker: " << str::strerror( errno ) << endl;
+    return false;
+  }
+  if ( job_r._pid > 0 )
+  {
+    MIL << "Cache build worker " << job_r._pid << " for " << job_r._repo.alias() << endl;
+    return true;
+  }
+
+  // worker: never return into the callers code, and don't run any
+  // exit handlers (e.g. the zypp lock belongs to the parent).
+  auto capture = []( const Pathname & file_r, int fd_r ) {
+    int fd = ::open( file_r.c_str(), O_WRONLY|O_TRUNC );
+    if ( fd < 0 || ::dup2( fd, fd_r ) < 0 )
+      ::_exit( 1 );
+    ::close( fd );
+  };
+  capture( job_r._output.path(), STDOUT_FILENO );
+  capture( job_r._errors.path(), STDERR_FILENO );
+
+  bool error = true;
+  try
+  {
+    error = _build( job_r._repo );
+  }
+  catch ( const Exception & e )
+  {
+    ZYPP_CAUGHT( e );
+  }
+  catch ( ... )
+  {}
+  std::cout.flush();
+  std::cerr.flush();
+  ::fflush( nullptr );
+  ::_exit( error ? 1 : 0 );
+}
+
+void ParallelCacheBuild::replay( const Pathname & file_r, std::ostream & str_r )
+{
+  std::ifstream in( file_r.c_str() );
+  if ( in && in.peek() != std::ifstream::traits_type::eof() )
+    str_r << in.rdbuf() << std::flush;
+}
@@ -0,0 +1,77 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_PARALLELCACHEBUILD_H_
+#define ZYPPER_PARALLELCACHEBUILD_H_
+
+#include <sys/types.h>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <zypp/RepoInfo.h>
+#include <zypp/TmpPath.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class ParallelCacheBuild
+/// \brief Build the solv caches of several repos at once.
+///
+/// Building a cache is pure CPU work, but neither libzypp (RepoManager,
+/// callbacks) nor our output is thread safe. So each cache is built by a
+/// forked worker process calling the \ref BuildFunction. The workers stdout
+/// and stderr are captured in separate files and replayed on the respective
+/// stream in the order the repos were added, so it looks like building them
+/// one after another (except that a repos errors follow all of its messages).
+/// Only the workers started here are waited for.
+///////////////////////////////////////////////////////////////////
+class ParallelCacheBuild
+{
+public:
+  /** Build the cache of \a repo_r, \c true on error (like \ref build_cache). */
+  using BuildFunction = std::function<bool( const zypp::RepoInfo & repo_r )>;
+
+  /** Called in the order the repos were added, \a error_r as returned by the \ref BuildFunction.
+   * A worker which did not exit normally is an error, too.
+   */
+  using DoneCallback = std::function<void( const zypp::RepoInfo & repo_r, bool error_r )>;
+
+  ParallelCacheBuild( unsigned jobs_r, BuildFunction build_r );
+
+  void add( const zypp::RepoInfo & repo_r )
+  { _queue.push_back( Job( repo_r ) ); }
+
+  bool empty() const
+  { return _queue.empty(); }
+
+  /** Build all caches, replaying the workers stdout on \a out_r and their stderr on \a err_r. */
+  void run( const DoneCallback & done_r, std::ostream & out_r = std::cout, std::ostream & err_r = std::cerr );
+
+private:
+  struct Job
+  {
+    Job( zypp::RepoInfo repo_r )
+    : _repo { std::move(repo_r) }
+    {}
+
+    zypp::RepoInfo _repo;
+    zypp::filesystem::TmpFile _output;	///< captured stdout
+    zypp::filesystem::TmpFile _errors;	///< captured stderr
+    pid_t _pid = -1;
+    bool _done = false;
+    bool _error = false;
+  };
+
+  bool startWorker( Job & job_r ) const;
+
+  static void replay( const zypp::Pathname & file_r, std::ostream & str_r );
+
+private:
+  unsigned _jobs;
+  BuildFunction _build;
+  std::vector<Job> _queue;
+};
+
+#endif // ZYPPER_PARALLELCACHEBUILD_H_
@@ -0,0 +1,158 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <sys/stat.h>
+#include <fnmatch.h>
+#include <algorithm>
+#include <fstream>
+
+#include <zypp/base/Easy.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/ResKind.h>
+
+#include "RepoNameIndex.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Changing the format requires a new magic. */
+  const std::string magic { "# zypper name index v1" };
+
+  inline bool hasGlobChars( const std::string & str_r )
+  { return str_r.find_first_of( "*?[" ) != std::string::npos; }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+RepoNameIndex::RepoNameIndex( Pathname solvDir_r )
+: _solvDir { std::move(solvDir_r) }
+, _file { _solvDir / "zypper-names" }
+{}
+
+std::string RepoNameIndex::solvStamp() const
+{
+  struct stat st;
+  if ( ::stat( ( _solvDir / "solv" ).c_str(), &st ) != 0 )
+    return std::string();
+  return str::Str() << magic << " " << st.st_size << " " << st.st_mtim.tv_sec << " " << st.st_mtim.tv_nsec;
+}
+
+bool RepoNameIndex::valid() const
+{
+  return forEachIdent( []( const std::string & ) { return false; } );
+}
+
+bool RepoNameIndex::forEachIdent( const std::function<bool( const std::string & )> & fnc_r ) const
+{
+  const std::string stamp { solvStamp() };
+  if ( stamp.empty() )
+    return false;
+
+  std::ifstream in( _file.c_str() );
+  std::string line;
+  if ( ! std::getline( in, line ) || line != stamp )
+    return false;
+
+  while ( std::getline( in, line ) )
+  {
+    if ( ! fnc_r( line ) )
+      break;
+  }
+  return true;
+}
+
+void RepoNameIndex::update( const Repository & repo_r ) const
+{
+  if ( valid() )
+    return;
+  const std::string stamp { solvStamp() };
+  if ( stamp.empty() )
+    return;
+
+  std::vector<std::string> idents;
+  idents.reserve( repo_r.solvablesSize() );
+  for_( it, repo_r.solvablesBegin(), repo_r.solvablesEnd() )
+    idents.push_back( it->ident().asString() );
+  std::sort( idents.begin(), idents.end() );
+  idents.erase( std::unique( idents.begin(), idents.end() ), idents.end() );
+
+  Pathname tmpfile { _file.extend( ".new" ) };
+  {
+    std::ofstream out( tmpfile.c_str() );
+    if ( ! out )
+    {
+      DBG << "Can not write " << tmpfile << endl;	// e.g. not root
+      return;
+    }
+    out << stamp << "\n";
+    for ( const std::string & ident : idents )
+      out << ident << "\n";
+    if ( ! out )
+    {
+      WAR << "Can not write " << tmpfile << endl;
+      filesystem::unlink( tmpfile );
+      return;
+    }
+  }
+  if ( filesystem::rename( tmpfile, _file ) != 0 )
+  {
+    WAR << "Can not rename " << tmpfile << endl;
+    filesystem::unlink( tmpfile );
+    return;
+  }
+  MIL << "Wrote name index " << _file << " (" << idents.size() << " idents)" << endl;
+}
+
+std::vector<bool> RepoNameFilter::matches( const RepoNameIndex & index_r ) const
+{
+  std::vector<bool> ret( _names.size(), false );
+
+  // case insensitive, like the PoolQuery default
+  struct Pattern
+  {
+    std::string _name;
+    bool _glob;
+    unsigned _arg;
+  };
+  std::vector<Pattern> patterns;
+  for ( unsigned arg = 0; arg < _names.size(); ++arg )
+  {
+    for ( const std::string & name : _names[arg] )
+      patterns.push_back( { str::toLower( name ), hasGlobChars( name ), arg } );
+  }
+
+  unsigned todo = _names.size();
+  bool valid = index_r.forEachIdent( [&]( const std::string & ident_r ) {
+    std::string name;
+    ResKind kind { ResKind::explicitBuiltin( ident_r ) };
+    if ( kind )
+    {
+      if ( ! _anyKind )
+        return true;
+      name = str::toLower( ident_r.substr( kind.size()+1 ) );
+    }
+    else
+      name = str::toLower( ident_r );
+
+    for ( const Pattern & pattern : patterns )
+    {
+      if ( ! ret[pattern._arg]
+           && ( pattern._glob ? ::fnmatch( pattern._name.c_str(), name.c_str(), 0 ) == 0 : pattern._name == name ) )
+      {
+        ret[pattern._arg] = true;
+        --todo;
+      }
+    }
+    return todo != 0;
+  } );
+
+  if ( ! valid )
+    ret.assign( ret.size(), true );
+  return ret;
+}
@@ -0,0 +1,74 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_REPONAMEINDEX_H_
+#define ZYPPER_REPONAMEINDEX_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <zypp/Pathname.h>
+#include <zypp/Repository.h>
+
+/**
+ * The sorted idents (\c name or \c kind:name) of all solvables in a repo,
+ * written next to its solv cache.
+ *
+ * Commands looking up just a few names (\c info, \c download) use it to
+ * skip loading repos which can not contain any of them (\ref RepoNameFilter).
+ * The index is written whenever a repo is loaded and the index does not
+ * match the solv file (size and mtime) anymore.
+ */
+class RepoNameIndex
+{
+public:
+  /** The index of the repo whose solv cache is in \a solvDir_r. */
+  RepoNameIndex( zypp::Pathname solvDir_r );
+
+  /** Whether an index for the current solv file exists. */
+  bool valid() const;
+
+  /** Call \a fnc_r for each ident in the index until it returns \c false.
+   * \return \c false if the index is not \ref valid.
+   */
+  bool forEachIdent( const std::function<bool( const std::string & )> & fnc_r ) const;
+
+  /** Write the index for the loaded \a repo_r unless it's \ref valid.
+   * Errors (e.g. not running as root) are logged only.
+   */
+  void update( const zypp::Repository & repo_r ) const;
+
+private:
+  /** Header line identifying the solv file the index was built from. */
+  std::string solvStamp() const;
+
+private:
+  zypp::Pathname _solvDir;
+  zypp::Pathname _file;
+};
+
+/**
+ * The names a command is going to look up.
+ *
+ * Set in \ref RuntimeData::repoNameFilter, \ref load_repo_resolvables
+ * loads only repos whose \ref RepoNameIndex may contain a match (or that
+ * have no index). Matching is case insensitive; names containing glob
+ * chars are matched as globs. Not used in the shell, where a later command
+ * may need the whole pool.
+ */
+struct RepoNameFilter
+{
+  /** Per argument the names (or globs, without kind) it may refer to. */
+  std::vector<std::vector<std::string>> _names;
+  bool _anyKind = false;		///< match solvables of any kind, not just packages
+  bool _fullLoadIfUnmatched = false;	///< an argument found in no index needs the whole pool (e.g. to look at provides)
+
+  /** Which of the arguments \a index_r may contain; all \c true if the index is not valid. */
+  std::vector<bool> matches( const RepoNameIndex & index_r ) const;
+};
+
+#endif // ZYPPER_REPONAMEINDEX_H_
@@ -0,0 +1,317 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <iostream>
+#include <fstream>
+
+#include <zypp/ZYpp.h>
+#include <zypp/Digest.h>
+#include <zypp/ResPool.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/Target.h>
+
+#include "Zypper.h"
+#include "global-settings.h"
+#include "SolutionCache.h"
+
+using namespace zypp;
+extern ZYpp::Ptr God;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  const std::string magic { "# zypper solution v3" };
+
+  PoolItem lookup( const std::string & alias_r, const ResKind & kind_r, const std::string & name_r, const Edition & edition_r, const Arch & arch_r )
+  {
+    for ( const PoolItem & pi : God->pool().byIdent( kind_r, name_r ) )
+    {
+      if ( pi.edition() == edition_r && pi.arch() == arch_r && pi.repository().alias() == alias_r )
+        return pi;
+    }
+    return PoolItem();
+  }
+
+  std::string computeFingerprint( Zypper & zypper_r )
+  {
+    str::Str buf;
+
+    // the command
+    const RuntimeData & rdata { zypper_r.runtimeData() };
+    buf << "command " << zypper_r.command()
+        << " " << rdata.solve_update_only
+        << " " << rdata.solve_with_update
+        << " " << rdata.plain_patch_command << endl;
+
+    // solver flags (already set by the caller)
+    Resolver_Ptr resolver { God->resolver() };
+    buf << "flags"
+        << " " << resolver->forceResolve()
+        << " " << resolver->onlyRequires()
+        << " " << resolver->ignoreAlreadyRecommended()
+        << " " << resolver->cleandepsOnRemove()
+        << " " << resolver->updateMode()
+        << " " << resolver->focus()
+        << " " << resolver->allowDowngrade()
+        << " " << resolver->allowNameChange()
+        << " " << resolver->allowArchChange()
+        << " " << resolver->allowVendorChange()
+        << " " << resolver->dupAllowDowngrade()
+        << " " << resolver->dupAllowNameChange()
+        << " " << resolver->dupAllowArchChange()
+        << " " << resolver->dupAllowVendorChange()
+        << " " << resolver->removeOrphaned()
+        << " " << ZConfig::instance().systemArchitecture() << endl;
+
+    // pool cookies
+    for ( const Repository & repo : sat::Pool::instance().repos() )
+    {
+      buf << "repo " << repo.alias() << " " << repo.solvablesSize();
+      if ( repo.isSystemRepo() )
+      {
+        // The rpmdb has no cookie we could use, but the installed
+        // packages are what matters.
+        for ( const sat::Solvable & solv : repo.solvables() )
+          buf << " " << solv.ident() << "-" << solv.edition() << "." << solv.arch();
+      }
+      else
+        buf << " " << repo.generatedTimestamp().asSeconds() << " " << repo.info().priority();
+      buf << endl;
+    }
+
+    // the job
+    for ( const PoolItem & pi : God->pool() )
+    {
+      if ( pi.status().transacts() || pi.status().isLocked() )
+        buf << "job " << ( pi.status().transacts() ? ( pi.status().isToBeInstalled() ? '+' : '-' ) : 'L' )
+            << " " << pi.repository().alias() << " " << pi.satSolvable().asString() << endl;
+    }
+    for ( const Capability & cap : resolver->getRequire() )
+      buf << "require " << cap << endl;
+    for ( const Capability & cap : resolver->getConflict() )
+      buf << "conflict " << cap << endl;
+    for ( const std::string & repo : DupSettings::instance()._fromRepos )
+      buf << "from " << repo << endl;
+
+    return Digest::digest( Digest::sha1(), std::string(buf) );
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+char SolutionCache::actionOf( const PoolItem & pi_r )
+{
+  const ResStatus & status { pi_r.status() };
+  if ( status.isToBeInstalled() )
+    return 'i';
+  if ( status.isToBeUninstalledDueToUpgrade() )
+    return 'U';
+  if ( status.isToBeUninstalledDueToObsolete() )
+    return 'O';
+  if ( status.isToBeUninstalled() )
+    return 'u';
+  return '\0';
+}
+
+bool SolutionCache::applyAction( PoolItem & pi_r, char action_r )
+{
+  if ( pi_r.status().transacts() )
+    return actionOf( pi_r ) == action_r;
+
+  switch ( action_r )
+  {
+    case 'i': return pi_r.status().setToBeInstalled( ResStatus::SOLVER );
+    case 'U': return pi_r.status().setToBeUninstalledDueToUpgrade( ResStatus::SOLVER );
+    case 'O': return pi_r.status().setToBeUninstalledDueToObsolete();
+    case 'u': return pi_r.status().setToBeUninstalled( ResStatus::SOLVER );
+  }
+  return false;
+}
+
+sat::StringQueue SolutionCache::solvedAutoInstalled()
+{ return God->resolver()->getTransaction().autoInstalled(); }
+
+void SolutionCache::restoreAutoInstalled( const sat::StringQueue & autoInstalled_r )
+{
+  sat::Pool::instance().setAutoInstalled( autoInstalled_r );
+  if ( God->getTarget() )
+    God->getTarget()->updateAutoInstalled();
+  MIL << "Restored " << autoInstalled_r.size() << " auto-installed packages" << endl;
+}
+
+SolutionCache::SolutionCache( Zypper & zypper_r )
+: _file { Pathname::assertprefix( zypper_r.config().root_dir, ZYPPER_SOLUTION_CACHE_FILE ) }
+, _fingerprint { computeFingerprint( zypper_r ) }
+{
+  DBG << "Solution fingerprint " << _fingerprint << endl;
+}
+
+bool SolutionCache::save() const
+{
+  Pathname tmpfile { _file.extend( ".new" ) };
+  if ( filesystem::assert_dir( _file.dirname() ) != 0 )
+  {
+    WAR << "Can not create " << _file.dirname() << endl;
+    return false;
+  }
+
+  unsigned count = 0;
+  {
+    std::ofstream outfile( tmpfile.c_str() );
+    if ( ! outfile )
+    {
+      WAR << "Can not write " << tmpfile << endl;
+      return false;
+    }
+
+    outfile << magic << endl;
+    outfile << "fingerprint " << _fingerprint << endl;
+    // how the solver was called (e.g. doUpgrade), not visible in the item states
+    Resolver_Ptr resolver { God->resolver() };
+    outfile << "upgrade-mode " << resolver->upgradeMode() << endl;
+    for ( const Repository & repo : resolver->upgradingRepos() )
+      outfile << "upgrade-repo " << repo.alias() << endl;
+    for ( sat::StringQueue::value_type id : solvedAutoInstalled() )
+      outfile << "auto-installed " << IdString( id ) << endl;
+    for ( const PoolItem & pi : God->pool() )
+    {
+      char action = actionOf( pi );
+      if ( ! action )
+        continue;
+      outfile << action
+              << "\t" << pi.repository().alias()
+              << "\t" << pi.kind()
+              << "\t" << pi.name()
+              << "\t" << pi.edition()
+              << "\t" << pi.arch() << endl;
+      ++count;
+    }
+
+    if ( ! outfile.flush() )
+    {
+      WAR << "Error writing " << tmpfile << endl;
+      filesystem::unlink( tmpfile );
+      return false;
+    }
+  }
+
+  if ( filesystem::rename( tmpfile, _file ) != 0 )
+  {
+    filesystem::unlink( tmpfile );
+    return false;
+  }
+  MIL << "Saved solution with " << count << " transacting items to " << _file << endl;
+  return true;
+}
+
+bool SolutionCache::replay()
+{
+  _autoInstalled.clear();
+  std::ifstream infile( _file.c_str() );
+  if ( ! infile )
+  {
+    DBG << "No saved solution at " << _file << endl;
+    return false;
+  }
+
+  std::string line;
+  if ( ! std::getline( infile, line ) || line != magic )
+  {
+    WAR << "Unknown format of saved solution " << _file << endl;
+    return false;
+  }
+  if ( ! std::getline( infile, line ) || line != "fingerprint " + _fingerprint )
+  {
+    MIL << "Saved solution does not match (" << line << ")" << endl;
+    return false;
+  }
+
+  bool ok = true;
+  unsigned count = 0;
+  bool upgradeMode = false;
+  std::vector<Repository> upgradeRepos;
+  while ( ok && std::getline( infile, line ) )
+  {
+    if ( str::hasPrefix( line, "upgrade-mode " ) )
+    {
+      upgradeMode = str::strToBool( line.substr( 13 ), false );
+      continue;
+    }
+    if ( str::hasPrefix( line, "upgrade-repo " ) )
+    {
+      Repository repo { sat::Pool::instance().reposFind( line.substr( 13 ) ) };
+      if ( ! repo )
+      {
+        MIL << "Upgrade repo of saved solution is not in the pool: " << line << endl;
+        ok = false;
+        break;
+      }
+      upgradeRepos.push_back( repo );
+      continue;
+    }
+    if ( str::hasPrefix( line, "auto-installed " ) )
+    {
+      _autoInstalled.push( IdString( line.substr( 15 ) ).id() );
+      continue;
+    }
+
+    std::vector<std::string> words;
+    if ( str::split( line, std::back_inserter(words), "\t" ) != 6 || words[0].size() != 1 )
+    {
+      WAR << "Malformed line in saved solution: " << line << endl;
+      ok = false;
+      break;
+    }
+
+    PoolItem pi { lookup( words[1], ResKind(words[2]), words[3], Edition(words[4]), Arch(words[5]) ) };
+    if ( ! pi )
+    {
+      MIL << "Item of saved solution is not in the pool: " << line << endl;
+      ok = false;
+      break;
+    }
+    ok = applyAction( pi, words[0][0] );
+    ++count;
+  }
+
+  if ( ok )
+  {
+    // Nothing must transact that is not part of the saved solution.
+    unsigned transacting = 0;
+    for ( const PoolItem & pi : God->pool() )
+    {
+      if ( pi.status().transacts() )
+        ++transacting;
+    }
+    ok = ( transacting == count );
+  }
+
+  if ( ! ok )
+  {
+    WAR << "Failed to replay saved solution. Undo..." << endl;
+    God->resolver()->undo();
+    _autoInstalled.clear();
+    return false;
+  }
+
+  // As if the solver had been called the same way (e.g. doUpgrade for dist-upgrade).
+  Resolver_Ptr resolver { God->resolver() };
+  resolver->setUpgradeMode( upgradeMode );
+  for ( const Repository & repo : upgradeRepos )
+    resolver->addUpgradeRepo( repo );
+
+  MIL << "Replayed saved solution with " << count << " transacting items from " << _file
+      << ( upgradeMode ? " (upgrade mode)" : "" ) << endl;
+  return true;
+}
+
+void SolutionCache::drop() const
+{
+  if ( PathInfo( _file ).isExist() )
+    filesystem::unlink( _file );
+}
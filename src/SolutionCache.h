@@ -0,0 +1,92 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_SOLUTIONCACHE_H_
+#define ZYPPER_SOLUTIONCACHE_H_
+
+#include <string>
+
+#include <zypp/Pathname.h>
+#include <zypp/PoolItem.h>
+#include <zypp/sat/Queue.h>
+
+class Zypper;
+
+/** Location of the solver solution saved by \c --reuse-solution (below the target root). */
+#define ZYPPER_SOLUTION_CACHE_FILE "/var/cache/zypper/solution"
+
+/**
+ * Remember a computed transaction between a \c --dry-run and the real run.
+ *
+ * Besides the transacting items the resolvers upgrade mode and upgrade
+ * repos (\c dist-upgrade, \c --from) are saved and restored, as they
+ * tell the commit and the summary how the solution came about. The names
+ * of the packages the solution installs as dependencies (\ref autoInstalled)
+ * are saved too, as without a solver run the commit would not know them.
+ *
+ * The solution is stored together with a fingerprint of everything the
+ * solver result depends on: the command, the repositories loaded into the
+ * pool (their cookies, i.e. alias, generated timestamp, size and priority),
+ * the installed packages, the solver flags and the job (user requested
+ * transactions, locks, extra requires/conflicts, upgrade repos).
+ *
+ * A later run computing the same fingerprint may \ref replay the saved
+ * decisions instead of calling the solver. If anything changed, the
+ * fingerprint does not match and a normal solver run is needed.
+ *
+ * \note The fingerprint must be computed after the solver flags have
+ * been set and before the solver is called.
+ */
+class SolutionCache
+{
+public:
+  SolutionCache( Zypper & zypper_r );
+
+  const std::string & fingerprint() const
+  { return _fingerprint; }
+
+  const zypp::Pathname & file() const
+  { return _file; }
+
+  /** Save the transacting items of the current pool. */
+  bool save() const;
+
+  /** Apply a saved solution matching our fingerprint to the pool.
+   * On failure any partially applied solver changes are undone.
+   * \return Whether the saved solution was applied.
+   */
+  bool replay();
+
+  /** The idents of the packages auto-installed after committing the \ref replay'ed solution. */
+  const zypp::sat::StringQueue & autoInstalled() const
+  { return _autoInstalled; }
+
+  /** Remove a saved solution (e.g. after it was committed). */
+  void drop() const;
+
+public:
+  /** Single letter code for the action of a transacting \a pi_r ('\0' if not transacting). */
+  static char actionOf( const zypp::PoolItem & pi_r );
+
+  /** Let the solver apply \a action_r to \a pi_r (unless it already transacts this way). */
+  static bool applyAction( zypp::PoolItem & pi_r, char action_r );
+
+  /** The idents of the packages auto-installed after committing the solver's current solution. */
+  static zypp::sat::StringQueue solvedAutoInstalled();
+
+  /** Store \a autoInstalled_r as the auto-installed packages of the target.
+   * libzypp takes them from the solver run when committing; a commit of a
+   * solution not computed by the solver (replayed, bundle) must restore them.
+   */
+  static void restoreAutoInstalled( const zypp::sat::StringQueue & autoInstalled_r );
+
+private:
+  zypp::Pathname _file;
+  std::string _fingerprint;
+  zypp::sat::StringQueue _autoInstalled;
+};
+
+#endif /* ZYPPER_SOLUTIONCACHE_H_ */
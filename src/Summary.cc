@@ -6,9 +6,12 @@
 \*---------------------------------------------------------------------------*/
 
 #include <string.h>
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <sstream>
 #include <string_view>
+#include <unordered_map>
 
 #include <zypp/ZYppFactory.h>
 #include <zypp/base/LogTools.h>
@@ -18,6 +21,8 @@
 #include <zypp/Patch.h>
 #include <zypp/Package.h>
 #include <zypp/ui/Selectable.h>
+#include <zypp/sat/Map.h>
+#include <zypp/sat/WhatProvides.h>
 
 #include "main.h"
 #include "utils/text.h"
@@ -27,6 +32,7 @@
 #include "Zypper.h"
 
 #include "Summary.h"
+#include "output/OutJSON.h"
 #include "utils/console.h"
 
 // Suppress all application related summary messages.
@@ -181,6 +187,62 @@ bool Summary::ResPairNameCompare::operator()( const ResPair & p1, const ResPair
 
 // --------------------------------------------------------------------------
 
+namespace
+{
+  /** Key identifying items with the same name (ident) and edition. */
+  inline std::uint64_t keyOf( const sat::Solvable & solv_r )
+  { return ( std::uint64_t(solv_r.ident().id()) << 32 ) | std::uint32_t(solv_r.edition().id()); }
+
+  /** Order by name and edition like \ref Summary::ResPairNameCompare, but on ids. */
+  inline bool solvableNameLess( const sat::Solvable & lhs, const sat::Solvable & rhs )
+  {
+    int ret = ::strcoll( lhs.name().c_str(), rhs.name().c_str() );
+    if ( ret == 0 )
+      return lhs.edition() < rhs.edition();
+    return ret < 0;
+  }
+} // namespace
+
+bool Summary::ResPairSet::insert( sat::Solvable first_r, sat::Solvable second_r )
+{
+  if ( ! _keys.insert( keyOf( second_r ) ).second )
+    return false;
+  _ids.push_back( IdPair( first_r, second_r ) );
+  return true;
+}
+
+bool Summary::ResPairSet::insert( const ResPair & pair_r )
+{ return insert( pair_r.first ? pair_r.first->satSolvable() : sat::Solvable(), pair_r.second->satSolvable() ); }
+
+bool Summary::ResPairSet::contains( sat::Solvable solv_r ) const
+{ return _keys.count( keyOf( solv_r ) ); }
+
+void Summary::ResPairSet::clear()
+{
+  _ids.clear();
+  _keys.clear();
+  _rendered.clear();
+}
+
+const std::vector<Summary::ResPair> & Summary::ResPairSet::rendered() const
+{
+  if ( _rendered.size() != _ids.size() )
+  {
+    std::vector<IdPair> sorted { _ids };
+    std::sort( sorted.begin(), sorted.end(), []( const IdPair & lhs, const IdPair & rhs ) {
+      return solvableNameLess( lhs.second, rhs.second );
+    } );
+    _rendered.clear();
+    _rendered.reserve( sorted.size() );
+    for ( const IdPair & pair : sorted )
+      _rendered.push_back( ResPair( pair.first ? PoolItem( pair.first ).resolvable() : ResObject::constPtr(),
+                                    PoolItem( pair.second ).resolvable() ) );
+  }
+  return _rendered;
+}
+
+// --------------------------------------------------------------------------
+
 Summary::Summary( const ResPool & pool, SummaryHints summaryHints, const ViewOptions options )
 : _summaryHints { std::move(summaryHints) }
 , _viewop( options )
@@ -194,18 +256,16 @@ Summary::Summary( const ResPool & pool, SummaryHints summaryHints, const ViewOpt
 
 // --------------------------------------------------------------------------
 
-struct ResNameCompare
+namespace
 {
-  bool operator()( ResObject::constPtr r1, ResObject::constPtr r2 ) const
+  /** Order by ident and edition; cheap on ids, and within a name the order of the former name sorted sets. */
+  inline bool identEditionLess( const sat::Solvable & lhs, const sat::Solvable & rhs )
   {
-    int ret = ::strcoll( r1->name().c_str(), r2->name().c_str() );
-    if ( ret == 0 )
-      return r1->edition() < r2->edition();
-    return ret < 0;
+    if ( lhs.ident() != rhs.ident() )
+      return lhs.ident().id() < rhs.ident().id();
+    return lhs.edition() < rhs.edition();
   }
-};
-
-typedef std::map<Resolvable::Kind, std::set<ResObject::constPtr, ResNameCompare> > KindToResObjectSet;
+} // namespace
 
 // --------------------------------------------------------------------------
 
@@ -234,8 +294,8 @@ void Summary::readPool( const ResPool & pool )
   }
   // collect resolvables to be installed/removed
 
-  KindToResObjectSet to_be_installed;
-  KindToResObjectSet to_be_removed;
+  KindToResPairSet to_be_installed;
+  KindToResPairSet to_be_removed;
 
   MIL << "Pool contains " << pool.size() << " items." << std::endl;
   DBG << "Install summary:" << endl;
@@ -254,7 +314,7 @@ void Summary::readPool( const ResPool & pool )
         if ( patch->rebootSuggested() )
         {
           _need_reboot_patch = true;
-          _rebootNeeded[ResKind::patch].insert( ResPair( nullptr, patch ) );
+          _rebootNeeded[ResKind::patch].insert( it->satSolvable() );
         }
         else if ( patch->restartSuggested() )
           _need_restart = true;
@@ -263,20 +323,20 @@ void Summary::readPool( const ResPool & pool )
       if (it->status().isToBeInstalled())
       {
         DBG << "<install>   ";
-        to_be_installed[it->kind()].insert(it->resolvable());
+        to_be_installed[it->kind()].insert( it->satSolvable() );
 
         if ( it->isKind( ResKind::package ) ) {
           Package::constPtr package = asKind<Package>( it->resolvable() );
           if ( package->isNeedreboot() ) {
             _need_reboot_nonpatch = true;
-            _rebootNeeded[ResKind::package].insert( ResPair( nullptr, package ) );
+            _rebootNeeded[ResKind::package].insert( it->satSolvable() );
           }
         }
       }
       if (it->status().isToBeUninstalled())
       {
         DBG << "<uninstall> ";
-        to_be_removed[it->kind()].insert(it->resolvable());
+        to_be_removed[it->kind()].insert( it->satSolvable() );
       }
       DBG << *it << endl;
     }
@@ -299,7 +359,7 @@ void Summary::readPool( const ResPool & pool )
   }
 
   for ( const auto & spkg : Zypper::instance().runtimeData().srcpkgs_to_install )
-  { to_be_installed[ResKind::srcpackage].insert(spkg); }
+  { to_be_installed[ResKind::srcpackage].insert( spkg->satSolvable() ); }
 
   // total packages to download & install
   // (packages & srcpackages only - patches, patterns, and products are virtual)
@@ -309,29 +369,52 @@ void Summary::readPool( const ResPool & pool )
 
   m.elapsed();
 
+  // index to_be_removed by name (ordered by edition), so finding the counterpart
+  // of an installed item is a lookup and not a scan of all removed items
+  std::map<ResKind, std::unordered_map<sat::detail::IdType, std::vector<sat::Solvable>>> removed_by_name;
+  for ( const auto & kindset : to_be_removed )
+  {
+    std::vector<sat::Solvable> removed;
+    for ( const ResPairSet::IdPair & idpair : kindset.second.ids() )
+      removed.push_back( idpair.second );
+    std::sort( removed.begin(), removed.end(), identEditionLess );
+    for ( const sat::Solvable & rm : removed )
+      removed_by_name[kindset.first][rm.ident().id()].push_back( rm );
+  }
+  // removed items which turned out to be upgraded/downgraded
+  std::map<ResKind, sat::Map> removed_paired;
+  for ( const auto & kindset : to_be_removed )
+    removed_paired.emplace( kindset.first, sat::Map( sat::Pool::instance().capacity() ) );
+
   // iterate the to_be_installed to find installs/upgrades/downgrades + size info
-  for_( it, to_be_installed.begin(), to_be_installed.end() )
+  for ( const auto & kindset : to_be_installed )
   {
-    for_( resit, it->second.begin(), it->second.end() )
+    const ResKind & kind { kindset.first };
+    std::vector<sat::Solvable> installed;
+    for ( const ResPairSet::IdPair & idpair : kindset.second.ids() )
+      installed.push_back( idpair.second );
+    std::sort( installed.begin(), installed.end(), identEditionLess );
+
+    for ( const sat::Solvable & res : installed )
     {
-      ResObject::constPtr res(*resit);
-      Package::constPtr pkg = asKind<Package>(res);
+      PoolItem pi { res };
+      Package::constPtr pkg = asKind<Package>( pi.resolvable() );
 
       if ( pkg )
       {
         switch ( pkg->vendorSupport() )
         {
           case VendorSupportUnknown:
-            _supportUnknown[res->kind()].insert( ResPair( nullptr, res ) );
+            _supportUnknown[kind].insert( res );
             break;
           case VendorSupportUnsupported:
-            _supportUnsupported[res->kind()].insert( ResPair( nullptr, res ) );
+            _supportUnsupported[kind].insert( res );
             break;
           case VendorSupportACC:
-            _supportNeedACC[res->kind()].insert( ResPair( nullptr, res ) );
+            _supportNeedACC[kind].insert( res );
             break;
           case VendorSupportSuperseded:
-            _supportSuperseded[res->kind()].insert( ResPair( nullptr, res ) );
+            _supportSuperseded[kind].insert( res );
           default:
             // L1, L2 or L3 support are not reported
             break;
@@ -340,71 +423,70 @@ void Summary::readPool( const ResPool & pool )
 
       // find in to_be_removed:
       bool upgrade_downgrade = false;
-      for_( rmit, to_be_removed[res->kind()].begin(), to_be_removed[res->kind()].end() )
+      std::vector<sat::Solvable> & samename( removed_by_name[kind][res.ident().id()] );
+      for_( rmit, samename.begin(), samename.end() )
       {
-        if ( res->name() == (*rmit)->name() )
-        {
-          ResPair rp( *rmit, res );
+        const sat::Solvable & rm { *rmit };
 
-          // upgrade
-          if ( res->edition() > (*rmit)->edition() )
-          {
-            // don't put multiversion packages to '_toupgrade', they will
-            // always be reported as newly installed (and removed)
-            if (_multiInstalled.find( res->name()) != _multiInstalled.end() )
-              continue;
-
-            _toupgrade[res->kind()].insert( rp );
-            if ( res->arch() != (*rmit)->arch() )
-              _tochangearch[res->kind()].insert( rp );
-            if ( !VendorAttr::instance().equivalent(res->vendor(), (*rmit)->vendor()) )
-              _tochangevendor[res->kind()].insert( rp );
-          }
-          // reinstall
-          else if ( res->edition() == (*rmit)->edition() )
-          {
-            if ( res->arch() != (*rmit)->arch() )
-              _tochangearch[res->kind()].insert( rp );
-            else
-              _toreinstall[res->kind()].insert( rp );
-            if ( !VendorAttr::instance().equivalent( res->vendor(), (*rmit)->vendor() ) )
-              _tochangevendor[res->kind()].insert( rp );
-          }
-          // downgrade
+        // upgrade
+        if ( res.edition() > rm.edition() )
+        {
+          // don't put multiversion packages to '_toupgrade', they will
+          // always be reported as newly installed (and removed)
+          if (_multiInstalled.find( res.name()) != _multiInstalled.end() )
+            continue;
+
+          _toupgrade[kind].insert( rm, res );
+          if ( res.arch() != rm.arch() )
+            _tochangearch[kind].insert( rm, res );
+          if ( !VendorAttr::instance().equivalent( res.vendor(), rm.vendor() ) )
+            _tochangevendor[kind].insert( rm, res );
+        }
+        // reinstall
+        else if ( res.edition() == rm.edition() )
+        {
+          if ( res.arch() != rm.arch() )
+            _tochangearch[kind].insert( rm, res );
           else
-          {
-            // don't put multiversion packages to '_todowngrade', they will
-            // always be reported as newly installed (and removed)
-            if ( _multiInstalled.find( res->name() ) != _multiInstalled.end() )
-              continue;
-
-            _todowngrade[res->kind()].insert( rp );
-            if ( res->arch() != (*rmit)->arch() )
-              _tochangearch[res->kind()].insert( rp );
-            if ( !VendorAttr::instance().equivalent(res->vendor(), (*rmit)->vendor()) )
-              _tochangevendor[res->kind()].insert( rp );
-          }
+            _toreinstall[kind].insert( rm, res );
+          if ( !VendorAttr::instance().equivalent( res.vendor(), rm.vendor() ) )
+            _tochangevendor[kind].insert( rm, res );
+        }
+        // downgrade
+        else
+        {
+          // don't put multiversion packages to '_todowngrade', they will
+          // always be reported as newly installed (and removed)
+          if ( _multiInstalled.find( res.name() ) != _multiInstalled.end() )
+            continue;
+
+          _todowngrade[kind].insert( rm, res );
+          if ( res.arch() != rm.arch() )
+            _tochangearch[kind].insert( rm, res );
+          if ( !VendorAttr::instance().equivalent( res.vendor(), rm.vendor() ) )
+            _tochangevendor[kind].insert( rm, res );
+        }
 
-          _inst_size_install += res->installSize();
-          _inst_size_remove += (*rmit)->installSize();
+        _inst_size_install += res.installSize();
+        _inst_size_remove += rm.installSize();
 
-          // this turned out to be an upgrade/downgrade
-          to_be_removed[res->kind()].erase( *rmit );
-          upgrade_downgrade = true;
-          break;
-        }
+        // this turned out to be an upgrade/downgrade
+        removed_paired[kind].set( rm.id() );
+        samename.erase( rmit );
+        upgrade_downgrade = true;
+        break;
       }
 
       if ( !upgrade_downgrade )
       {
-        _toinstall[res->kind()].insert( ResPair( nullptr, res ) );
-        _inst_size_install += res->installSize();
+        _toinstall[kind].insert( res );
+        _inst_size_install += res.installSize();
       }
 
       if ( pkg && pkg->isCached() )
-        _incache += res->downloadSize();
+        _incache += res.downloadSize();
       else
-        _todownload += res->downloadSize();
+        _todownload += res.downloadSize();
     }
   }
 
@@ -412,21 +494,17 @@ void Summary::readPool( const ResPool & pool )
 
   // collect the rest (not upgraded/downgraded) of to_be_removed as '_toremove'
   // and decrease installed size change accordingly
-
-  //bool _toremove_by_solver = false;
-  for_( it, to_be_removed.begin(), to_be_removed.end() )
-    for_( resit, it->second.begin(), it->second.end() )
+  for ( const auto & kindset : to_be_removed )
+  {
+    const sat::Map & paired { removed_paired[kindset.first] };
+    for ( const ResPairSet::IdPair & idpair : kindset.second.ids() )
     {
-      /** \todo this does not work
-      if (!_toremove_by_solver)
-      {
-        PoolItem pi(*resit);
-        if (pi.status() == ResStatus::SOLVER)
-          _toremove_by_solver = true;
-      }*/
-      _toremove[it->first].insert( ResPair( nullptr, *resit ) );
-      _inst_size_remove += (*resit)->installSize();
+      if ( paired.test( idpair.second.id() ) )
+        continue;
+      _toremove[kindset.first].insert( idpair.second );
+      _inst_size_remove += idpair.second.installSize();
     }
+  }
 
   m.elapsed();
 
@@ -462,7 +540,7 @@ void Summary::readPool( const ResPool & pool )
         && candidate.status().isToBeInstalled() )
         continue;
 
-      candidates[*kit].insert( ResPair( nullptr, candidate.resolvable() ) );
+      candidates[*kit].insert( candidate.satSolvable() );
     }
     MIL << *kit << " update candidates: " << candidates[*kit].size() << endl;
     MIL << "to be actually updated: " << _toupgrade[*kit].size() << endl;
@@ -475,12 +553,11 @@ void Summary::readPool( const ResPool & pool )
   //       for_(it, _toupgrade.begin(), _toupgrade.end()) loop used here and there
   //       were no upgrades for that kind.
   for_( kit, kinds.begin(), kinds.end() )
-    std::set_difference( candidates[*kit].begin(), candidates[*kit].end(),
-                         _toupgrade [*kit].begin(), _toupgrade [*kit].end(),
-                         inserter( _notupdated[*kit], _notupdated[*kit].begin() ),
-                         Summary::ResPairNameCompare() );
+    for ( const ResPairSet::IdPair & idpair : candidates[*kit].ids() )
+      if ( ! _toupgrade[*kit].contains( idpair.second ) )
+        _notupdated[*kit].insert( idpair.second );
 
-  // remove kinds with empty sets after the set_difference
+  // remove kinds with empty sets after the comparison
   for ( KindToResPairSet::iterator it = _notupdated.begin(); it != _notupdated.end(); )
   {
     if (it->second.empty())
@@ -950,70 +1027,80 @@ void Summary::writeReinstalled( std::ostream & out )
 
 // --------------------------------------------------------------------------
 
-void Summary::collectInstalledRecommends( const ResObject::constPtr & obj )
+void Summary::collectInstalledRecommends()
 {
-  Capabilities rec = obj->recommends();
-  for_( capit, rec.begin(), rec.end() )
-  {
-    sat::WhatProvides q( *capit );
-    // not using selectables here: matching found resolvables against those
-    // in the _toinstall set (the ones selected by the solver)
-    for_( sit, q.begin(), q.end() )
-    {
-      if ( sit->isSystem() ) // is it necessary to have the system solvable?
-        continue;
-      if ( sit->name() == obj->name() )
-        continue; // ignore self-recommends (should not happen, though)
-
-      XXX << "rec: " << *sit << endl;
-      ResObject::constPtr recobj = makeResObject( *sit );
-      ResPairSet::const_iterator match = _toinstall[sit->kind()].find( ResPair( nullptr, recobj ) );
-      if ( match != _toinstall[sit->kind()].end() )
-      {
-        if ( _recommended[sit->kind()].insert( *match ).second )
-          collectInstalledRecommends( recobj );
-        break;
-      }
-    }
-  }
-
-  Capabilities req = obj->requires();
-  for_( capit, req.begin(), req.end() )
-  {
-    sat::WhatProvides q( *capit );
-    for_( sit, q.begin(), q.end() )
-    {
-      if ( sit->isSystem() ) // is it necessary to have the system solvable?
-        continue;
-      if ( sit->name() == obj->name() )
-        continue; // ignore self-requires
-      XXX << "req: " << *sit << endl;
-      ResObject::constPtr reqobj = makeResObject( *sit );
-      ResPairSet::const_iterator match = _toinstall[sit->kind()].find( ResPair( nullptr, reqobj ) );
-      if ( match != _toinstall[sit->kind()].end() )
+  // Index _toinstall by ident and edition, so a provider can be matched
+  // by id, without creating a ResObject and comparing names.
+  std::unordered_map<std::uint64_t, sat::Solvable> toinstall;
+  for ( const auto & kindset : _toinstall )
+    for ( const ResPairSet::IdPair & idpair : kindset.second.ids() )
+      toinstall.emplace( keyOf( idpair.second ), idpair.second );
+
+  // Matches already collected (by id of the matching _toinstall item).
+  sat::Map recommended( sat::Pool::instance().capacity() );
+  sat::Map required( sat::Pool::instance().capacity() );
+
+  // Follow the recommends and requires of all packages requested by user
+  // into the _toinstall set (and recursively the ones of the matches).
+  std::vector<sat::Solvable> todo;
+  for ( const auto & kindset : _toinstall )
+    for ( const ResPairSet::IdPair & idpair : kindset.second.ids() )
+      if ( PoolItem( idpair.second ).status().getTransactByValue() != ResStatus::SOLVER )
+        todo.push_back( idpair.second );
+
+  while ( ! todo.empty() )
+  {
+    sat::Solvable solv { todo.back() };
+    todo.pop_back();
+    const std::string name { solv.name() };
+
+    auto follow = [&]( const Capabilities & caps_r, KindToResPairSet & result_r, sat::Map & collected_r ) {
+      for ( const Capability & cap : caps_r )
       {
-        if ( _required[sit->kind()].insert( *match ).second )
-          collectInstalledRecommends( reqobj );
-        break;
+        // not using selectables here: matching found resolvables against those
+        // in the _toinstall set (the ones selected by the solver)
+        for ( const sat::Solvable & prov : sat::WhatProvides( cap ) )
+        {
+          if ( prov.isSystem() ) // is it necessary to have the system solvable?
+            continue;
+          if ( prov.name() == name )
+            continue; // ignore self-deps (should not happen, though)
+
+          XXX << "dep: " << prov << endl;
+          auto match = toinstall.find( keyOf( prov ) );
+          if ( match != toinstall.end() )
+          {
+            sat::detail::SolvableIdType id { match->second.id() };
+            if ( ! collected_r.test( id ) )
+            {
+              collected_r.set( id );
+              result_r[prov.kind()].insert( match->second );
+              todo.push_back( prov );
+            }
+            break;
+          }
+        }
       }
-    }
+    };
+    follow( solv.recommends(), _recommended, recommended );
+    follow( solv.requires(), _required, required );
   }
 }
 
 // --------------------------------------------------------------------------
 
-static void collectNotInstalledDeps( const Dep & dep, const ResObject::constPtr & obj, Summary::KindToResPairSet & result )
+static void collectNotInstalledDeps( const Dep & dep, const sat::Solvable & obj, Summary::KindToResPairSet & result )
 {
   static std::vector<ui::Selectable::Ptr> tmp;	// reuse capacity
   //DBG << obj << endl;
-  Capabilities req = obj->dep( dep );
+  Capabilities req = obj.dep( dep );
   for_( capit, req.begin(), req.end() )
   {
     tmp.clear();
     sat::WhatProvides q( *capit );
     for_( it, q.selectableBegin(), q.selectableEnd() )
     {
-      if ( (*it)->name() == obj->name() )
+      if ( (*it)->name() == obj.name() )
         continue;		// ignore self-deps
 
       if ( (*it)->offSystem() )
@@ -1035,7 +1122,7 @@ static void collectNotInstalledDeps( const Dep & dep, const ResObject::constPtr
       for_( it, tmp.begin(), tmp.end() )
       {
         //DBG << dep << " :" << (*it)->onSystem() << ": " << dump(*(*it)) << endl;
-        result[(*it)->kind()].insert( Summary::ResPair( nullptr, (*it)->candidateObj() ) );
+        result[(*it)->kind()].insert( (*it)->candidateObj().satSolvable() );
       }
     }
   }
@@ -1048,22 +1135,17 @@ void Summary::writeRecommended( std::ostream & out )
   // lazy-compute the installed recommended objects
   if (_recommended.empty() )
   {
-    ResObject::constPtr obj;
-    for_( kindit, _toinstall.begin(), _toinstall.end() )
-      for_( it, kindit->second.begin(), kindit->second.end() )
-        // collect recommends of all packages request by user
-        if ( it->second->poolItem().status().getTransactByValue() != ResStatus::SOLVER )
-          collectInstalledRecommends( it->second );
+    debug::Measure m( "collectInstalledRecommends" );
+    collectInstalledRecommends();
   }
 
   // lazy-compute the not-to-be-installed recommended objects
   if ( _noinstrec.empty() )
   {
-    ResObject::constPtr obj;
     for_( kindit, _toinstall.begin(), _toinstall.end() )
-      for_( it, kindit->second.begin(), kindit->second.end() )
-        if ( it->second->poolItem().status().getTransactByValue() != ResStatus::SOLVER )
-          collectNotInstalledDeps( Dep::RECOMMENDS, it->second, _noinstrec );
+      for ( const ResPairSet::IdPair & idpair : kindit->second.ids() )
+        if ( PoolItem( idpair.second ).status().getTransactByValue() != ResStatus::SOLVER )
+          collectNotInstalledDeps( Dep::RECOMMENDS, idpair.second, _noinstrec );
   }
 
   for_( it, _recommended.begin(), _recommended.end() )
@@ -1212,12 +1294,11 @@ void Summary::writeSuggested( std::ostream & out )
 {
   if ( _noinstsug.empty() )
   {
-    ResObject::constPtr obj;
     for_( kindit, _toinstall.begin(), _toinstall.end() )
-      for_( it, kindit->second.begin(), kindit->second.end() )
+      for ( const ResPairSet::IdPair & idpair : kindit->second.ids() )
         // collect recommends of all packages request by user
-        if ( it->second->poolItem().status().getTransactByValue() != ResStatus::SOLVER )
-          collectNotInstalledDeps( Dep::SUGGESTS, it->second, _noinstsug );
+        if ( PoolItem( idpair.second ).status().getTransactByValue() != ResStatus::SOLVER )
+          collectNotInstalledDeps( Dep::SUGGESTS, idpair.second, _noinstsug );
   }
 
   for_( it, _noinstsug.begin(), _noinstsug.end() )
@@ -1493,9 +1574,9 @@ void Summary::writeLocked( std::ostream & out )
     {
       if ( (*it)->hasInstalledObj() )
        for_( iit, (*it)->installedBegin(), (*it)->installedEnd() )
-         instlocks.insert( ResPair( nullptr, *iit ) );
+         instlocks.insert( iit->satSolvable() );
       else
-       avidents.insert( ResPair( nullptr, (*it)->theObj() ) );
+       avidents.insert( (*it)->theObj().satSolvable() );
     }
   }
   if ( ! ( instlocks.empty() && avidents.empty() ) )
@@ -1850,6 +1931,9 @@ void Summary::dumpTo( std::ostream & out )
 
 void Summary::writeXmlResolvableList( std::ostream & out, const KindToResPairSet & resolvables )
 {
+  // Solvable lines end in '\n', not endl: the stream is flushed by the endl
+  // closing each list, not per solvable. Texts are escaped only if requested.
+  const XmlDetail detail { Zypper::instance().config().xml_detail };
   for_( it, resolvables.begin(), resolvables.end() )
   {
     for_( pairit, it->second.begin(), it->second.end() )
@@ -1868,18 +1952,22 @@ void Summary::writeXmlResolvableList( std::ostream & out, const KindToResPairSet
         out << " edition-old=\"" << rold->edition() << "\"";
         out << " arch-old=\"" << rold->arch() << "\"";
       }
+      if ( detail >= XmlDetail::NORMAL )
       {
         const std::string & text( res->summary() );
         if ( !text.empty() )
           out << " summary=\"" << xml::escape(text) << "\"";
       }
+      if ( detail >= XmlDetail::FULL )
       {
         const std::string & text( res->description() );
         if ( !text.empty() )
-          out << ">\n" << "<description>" << xml::escape( text ) << "</description>" << "</solvable>" << endl;
-        else
-          out << "/>" << endl;
+        {
+          out << ">\n" << "<description>" << xml::escape( text ) << "</description>" << "</solvable>" << "\n";
+          continue;
+        }
       }
+      out << "/>" << "\n";
     }
   }
 }
@@ -1963,3 +2051,66 @@ void Summary::dumpAsXmlTo( std::ostream & out )
 
   out << "</install-summary>" << endl;
 }
+
+// --------------------------------------------------------------------------
+
+void Summary::writeJsonResolvableList( std::ostream & out, const char * list_r, const KindToResPairSet & resolvables )
+{
+  const XmlDetail detail { Zypper::instance().config().xml_detail };
+  for ( const auto & kindpair : resolvables )
+  {
+    for ( const auto & respair : kindpair.second )
+    {
+      ResObject::constPtr res( respair.second );
+      ResObject::constPtr rold( respair.first );
+
+      OutJSON::Line line( out, "summary-item" );
+      line.add( "list", list_r )
+          .add( "kind", res->kind().asString() )
+          .add( "name", res->name() )
+          .add( "edition", res->edition().asString() )
+          .add( "arch", res->arch().asString() )
+          .add( "repository", res->repoInfo().alias() );
+      if ( rold )
+      {
+        line.add( "edition-old", rold->edition().asString() )
+            .add( "arch-old", rold->arch().asString() );
+      }
+      if ( detail >= XmlDetail::NORMAL )
+        line.addOptional( "summary", res->summary() );
+      if ( detail >= XmlDetail::FULL )
+        line.addOptional( "description", res->description() );
+    }
+  }
+}
+
+void Summary::dumpAsJsonTo( std::ostream & out )
+{
+  unsigned pkgchanged = _inst_pkg_total;
+  const auto & iter = _toremove.find( ResKind::package );
+  if ( iter != _toremove.end() )
+    pkgchanged += iter->second.size();
+  zypp::ByteCount _inst_size_change = _inst_size_install - _inst_size_remove;
+
+  OutJSON::Line( out, "install-summary" )
+    .add( "download-size", (ByteCount::SizeType)_todownload )
+    .add( "space-usage-diff", (ByteCount::SizeType)_inst_size_change )
+    .add( "space-usage-installed", (ByteCount::SizeType)_inst_size_install )
+    .add( "space-usage-removed", (ByteCount::SizeType)_inst_size_remove )
+    .add( "packages-to-change", pkgchanged )
+    .add( "need-restart", showNeedRestartHint() )
+    .add( "need-reboot", showNeedRebootHInt() );
+
+  writeJsonResolvableList( out, "to-upgrade", _toupgrade );
+  writeJsonResolvableList( out, "to-downgrade", _todowngrade );
+  writeJsonResolvableList( out, "to-install", _toinstall );
+  writeJsonResolvableList( out, "to-reinstall", _toreinstall );
+  writeJsonResolvableList( out, "to-remove", _toremove );
+  writeJsonResolvableList( out, "to-change-arch", _tochangearch );
+  writeJsonResolvableList( out, "to-change-vendor", _tochangevendor );
+  if ( _viewop & SHOW_UNSUPPORTED )
+  {
+    writeJsonResolvableList( out, "unsupported", _supportUnknown );
+    writeJsonResolvableList( out, "unsupported", _supportUnsupported );
+  }
+}
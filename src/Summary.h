@@ -8,8 +8,11 @@
 #ifndef ZYPPER_UTILS_SUMMARY_H_
 #define ZYPPER_UTILS_SUMMARY_H_
 
+#include <cstdint>
 #include <set>
 #include <map>
+#include <unordered_set>
+#include <vector>
 #include <iosfwd>
 
 #include <zypp/base/PtrTypes.h>
@@ -17,6 +20,7 @@
 #include <zypp/base/DefaultIntegral.h>
 #include <zypp/ResObject.h>
 #include <zypp/ResPool.h>
+#include <zypp/sat/Solvable.h>
 #include "utils/ansi.h"
 
 /// \brief Information collected in SolveAndCommit which is to be shown in the summary.
@@ -46,9 +50,49 @@ public:
   typedef std::pair<zypp::ResObject::constPtr, zypp::ResObject::constPtr> ResPair;
   struct ResPairNameCompare
   {
-    inline bool operator()( const ResPair & p1, const ResPair & p2 ) const;
+    bool operator()( const ResPair & p1, const ResPair & p2 ) const;
+  };
+
+  /**
+   * \brief The items of one summary list, stored as solvable ids.
+   *
+   * Collecting the transaction just appends the ids to a flat vector. Names
+   * and ResObjects are created when the list is iterated (rendered): the ids
+   * are then sorted by name like \ref ResPairNameCompare does. As in the
+   * former std::set<ResPair,ResPairNameCompare>, items with the same name
+   * and edition are stored once.
+   */
+  class ResPairSet
+  {
+  public:
+    typedef std::pair<zypp::sat::Solvable, zypp::sat::Solvable> IdPair;
+    typedef std::vector<ResPair>::const_iterator const_iterator;
+
+    bool insert( zypp::sat::Solvable first_r, zypp::sat::Solvable second_r );
+    bool insert( zypp::sat::Solvable second_r )	{ return insert( zypp::sat::Solvable(), second_r ); }
+    bool insert( const ResPair & pair_r );
+
+    /** Whether an item with the name and edition of \a solv_r is in the list. */
+    bool contains( zypp::sat::Solvable solv_r ) const;
+
+    bool empty() const				{ return _ids.empty(); }
+    size_t size() const				{ return _ids.size(); }
+    void clear();
+
+    /** The ids in the order they were inserted. */
+    const std::vector<IdPair> & ids() const	{ return _ids; }
+
+    /** The ResPairs sorted by name (created on first use). */
+    const_iterator begin() const		{ return rendered().begin(); }
+    const_iterator end() const			{ return rendered().end(); }
+
+  private:
+    const std::vector<ResPair> & rendered() const;
+
+    std::vector<IdPair> _ids;
+    std::unordered_set<std::uint64_t> _keys;	///< ident and edition ids of the items
+    mutable std::vector<ResPair> _rendered;
   };
-  typedef std::set<ResPair, ResPairNameCompare> ResPairSet;
   typedef std::map<zypp::ResKind, ResPairSet> KindToResPairSet;
 
   enum _view_options
@@ -128,6 +172,8 @@ public:
 
   void dumpTo( std::ostream & out );
   void dumpAsXmlTo( std::ostream & out );
+  /** JSON Lines: the totals, followed by one line per resolvable. */
+  void dumpAsJsonTo( std::ostream & out );
 
 private:
   void readPool( const zypp::ResPool & pool );
@@ -137,8 +183,10 @@ private:
   { return writeResolvableList( out, resolvables, ansi::Color::nocolor(), maxEntries_r, withKind_r ); }
 
   void writeXmlResolvableList( std::ostream & out, const KindToResPairSet & resolvables );
+  void writeJsonResolvableList( std::ostream & out, const char * list_r, const KindToResPairSet & resolvables );
 
-  void collectInstalledRecommends( const zypp::ResObject::constPtr & obj );
+  /** Collect the \ref _recommended and \ref _required items of the user requested \ref _toinstall items. */
+  void collectInstalledRecommends();
 
   bool showNeedRestartHint() const;
   bool showNeedRebootHInt() const;
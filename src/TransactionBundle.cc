@@ -0,0 +1,256 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <fstream>
+#include <list>
+
+#include <zypp/ZYpp.h>
+#include <zypp/CheckSum.h>
+#include <zypp/Digest.h>
+#include <zypp/Package.h>
+#include <zypp/PathInfo.h>
+#include <zypp/RepoInfo.h>
+#include <zypp/ResPool.h>
+#include <zypp/base/Exception.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/sat/Pool.h>
+
+#include "main.h"
+#include "PackageStore.h"
+#include "SolutionCache.h"
+#include "TransactionBundle.h"
+
+using namespace zypp;
+extern ZYpp::Ptr God;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  const std::string magic { "# zypper transaction bundle v2" };
+  const std::string manifestName { "transaction" };
+  const std::string rpmsName { "rpms" };
+
+  /** Where the download-only commit left the rpm of \a solv_r (empty if not found). */
+  Pathname downloadedRpm( const sat::Solvable & solv_r )
+  {
+    Pathname cached { PackageStore::cacheLocation( solv_r ) };
+    if ( PathInfo( cached ).isFile() )
+      return cached;
+
+    // Packages of local repos may be used in place.
+    RepoInfo repo { solv_r.repository().info() };
+    Url url { repo.url() };
+    if ( url.schemeIsLocal() )
+    {
+      Pathname local { Pathname( url.getPathName() ) / repo.path() / solv_r.lookupLocation().filename() };
+      if ( PathInfo( local ).isFile() )
+        return local;
+    }
+    return Pathname();
+  }
+
+  PoolItem lookup( const TransactionBundle::Entry & entry_r, const std::string & alias_r )
+  {
+    for ( const PoolItem & pi : God->pool().byIdent( ResKind::package, entry_r._name ) )
+    {
+      if ( pi.edition() != entry_r._edition || pi.arch() != entry_r._arch )
+        continue;
+      if ( entry_r._action == 'i' ? pi.repository().alias() == alias_r : pi.status().isInstalled() )
+        return pi;
+    }
+    return PoolItem();
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+std::string TransactionBundle::Entry::asString() const
+{ return str::Str() << _action << " " << _name << "-" << _edition << "." << _arch; }
+
+std::string TransactionBundle::systemFingerprint()
+{
+  std::vector<std::string> installed;
+  for ( const sat::Solvable & solv : sat::Pool::instance().findSystemRepo().solvables() )
+  {
+    if ( solv.isKind<Package>() )
+      installed.push_back( solv.asString() );
+  }
+  std::sort( installed.begin(), installed.end() );
+  return Digest::digest( Digest::sha1(), str::join( installed, "\n" ) );
+}
+
+TransactionBundle::TransactionBundle( Pathname dir_r )
+: _dir { std::move(dir_r) }
+{
+  Pathname manifest { _dir / manifestName };
+  std::ifstream infile( manifest.c_str() );
+  if ( ! infile )
+    ZYPP_THROW( Exception( str::Format(_("'%1%' is not a transaction bundle.")) % _dir ) );
+
+  std::string line;
+  if ( ! std::getline( infile, line ) || line != magic )
+    ZYPP_THROW( Exception( str::Format(_("Unknown format of transaction bundle '%1%'.")) % _dir ) );
+
+  auto malformed = [&manifest]( const std::string & line_r ) {
+    return Exception( str::Format(_("Malformed line in '%1%': %2%")) % manifest % line_r );
+  };
+
+  while ( std::getline( infile, line ) )
+  {
+    if ( str::hasPrefix( line, "system " ) )
+    {
+      _system = line.substr( 7 );
+      continue;
+    }
+    if ( str::hasPrefix( line, "auto " ) )
+    {
+      _autoInstalled.push( IdString( line.substr( 5 ) ).id() );
+      continue;
+    }
+
+    std::vector<std::string> words;
+    str::split( line, std::back_inserter(words), "\t" );
+    if ( words.empty() || words[0].size() != 1 || std::string("iUOu").find( words[0][0] ) == std::string::npos
+      || words.size() != ( words[0][0] == 'i' ? 6 : 4 ) )
+      ZYPP_THROW( malformed( line ) );
+
+    Entry entry;
+    entry._action = words[0][0];
+    entry._name = words[1];
+    entry._edition = Edition( words[2] );
+    entry._arch = Arch( words[3] );
+    if ( entry._action == 'i' )
+    {
+      entry._checksum = words[4];
+      entry._file = words[5];
+      if ( Pathname( entry._file ).dirname() != rpmsName )	// no escape from the bundle
+        ZYPP_THROW( malformed( line ) );
+    }
+    _entries.push_back( std::move(entry) );
+  }
+  MIL << "Read transaction bundle " << _dir << " with " << _entries.size() << " transacting packages" << endl;
+}
+
+std::vector<std::string> TransactionBundle::verify() const
+{
+  std::vector<std::string> ret;
+  for ( const Entry & entry : _entries )
+  {
+    if ( entry._action != 'i' )
+      continue;
+    Pathname file { _dir / entry._file };
+    if ( ! PathInfo( file ).isFile() || filesystem::checksum( file, CheckSum::sha256Type() ) != entry._checksum )
+    {
+      WAR << "Checksum mismatch: " << file << endl;
+      ret.push_back( entry._file );
+    }
+  }
+  return ret;
+}
+
+std::vector<std::string> TransactionBundle::apply( const std::string & alias_r ) const
+{
+  std::vector<std::string> ret;
+  for ( const Entry & entry : _entries )
+  {
+    PoolItem pi { lookup( entry, alias_r ) };
+    if ( ! ( pi && SolutionCache::applyAction( pi, entry._action ) ) )
+    {
+      MIL << "Bundle item does not match the pool: " << entry.asString() << endl;
+      ret.push_back( entry.asString() );
+    }
+  }
+
+  if ( ! ret.empty() )
+    God->resolver()->undo();
+  return ret;
+}
+
+TransactionBundle TransactionBundle::fromPool( sat::StringQueue autoInstalled_r )
+{
+  TransactionBundle ret;
+  ret._system = systemFingerprint();
+  ret._autoInstalled = std::move(autoInstalled_r);
+  for ( const PoolItem & pi : God->pool() )
+  {
+    Entry entry;
+    entry._action = SolutionCache::actionOf( pi );
+    if ( ! entry._action || ! pi.satSolvable().isKind<Package>() )
+      continue;	// pseudo installed kinds follow their packages
+    entry._name = pi.name();
+    entry._edition = pi.edition();
+    entry._arch = pi.arch();
+    entry._solv = pi.satSolvable();
+    ret._entries.push_back( std::move(entry) );
+  }
+  return ret;
+}
+
+void TransactionBundle::write( const Pathname & dir_r )
+{
+  Pathname manifest { dir_r / manifestName };
+  PathInfo dirInfo { dir_r };
+  if ( dirInfo.isExist() && ! PathInfo( manifest ).isFile() )
+  {
+    std::list<std::string> content;
+    if ( ! dirInfo.isDir() || filesystem::readdir( content, dir_r, /*dots*/false ) != 0 || ! content.empty() )
+      ZYPP_THROW( Exception( str::Format(_("'%1%' is neither empty nor a transaction bundle.")) % dir_r ) );
+  }
+
+  Pathname rpms { dir_r / rpmsName };
+  filesystem::recursive_rmdir( rpms );	// replace an old bundle
+  if ( filesystem::assert_dir( rpms ) != 0 )
+    ZYPP_THROW( Exception( str::Format(_("Can not create directory '%1%'.")) % rpms ) );
+
+  for ( Entry & entry : _entries )
+  {
+    if ( entry._action != 'i' )
+      continue;
+
+    Pathname rpm { downloadedRpm( entry._solv ) };
+    if ( rpm.empty() )
+      ZYPP_THROW( Exception( str::Format(_("The rpm of '%1%' was not downloaded.")) % entry._solv.asString() ) );
+
+    entry._file = rpmsName + "/" + rpm.basename();
+    Pathname target { dir_r / entry._file };
+    if ( filesystem::hardlinkCopy( rpm, target ) != 0 )
+      ZYPP_THROW( Exception( str::Format(_("Can not copy '%1%' to '%2%'.")) % rpm % target ) );
+    entry._checksum = filesystem::checksum( target, CheckSum::sha256Type() );
+  }
+
+  Pathname tmpfile { manifest.extend( ".new" ) };
+  {
+    std::ofstream outfile( tmpfile.c_str() );
+    outfile << magic << endl;
+    outfile << "system " << _system << endl;
+    for ( sat::StringQueue::value_type id : _autoInstalled )
+      outfile << "auto " << IdString( id ) << endl;
+    for ( const Entry & entry : _entries )
+    {
+      outfile << entry._action
+              << "\t" << entry._name
+              << "\t" << entry._edition
+              << "\t" << entry._arch;
+      if ( entry._action == 'i' )
+        outfile << "\t" << entry._checksum << "\t" << entry._file;
+      outfile << endl;
+    }
+    if ( ! outfile.flush() )
+    {
+      filesystem::unlink( tmpfile );
+      ZYPP_THROW( Exception( str::Format(_("Can not write '%1%'.")) % tmpfile ) );
+    }
+  }
+  if ( filesystem::rename( tmpfile, manifest ) != 0 )
+  {
+    filesystem::unlink( tmpfile );
+    ZYPP_THROW( Exception( str::Format(_("Can not write '%1%'.")) % manifest ) );
+  }
+
+  _dir = dir_r;
+  MIL << "Exported " << _entries.size() << " transacting packages to " << _dir << endl;
+}
@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_TRANSACTIONBUNDLE_H_
+#define ZYPPER_TRANSACTIONBUNDLE_H_
+
+#include <string>
+#include <vector>
+
+#include <zypp/Arch.h>
+#include <zypp/Edition.h>
+#include <zypp/Pathname.h>
+#include <zypp/sat/Queue.h>
+#include <zypp/sat/Solvable.h>
+
+/**
+ * A solved transaction together with the rpms it needs, to be committed on
+ * another (e.g. offline) system.
+ *
+ * The bundle is a directory containing the \c transaction manifest and the
+ * rpm files below \c rpms/. The manifest lists the transacting packages by
+ * NEVRA (the installed ones with the sha256 checksum of their rpm) and a
+ * fingerprint of the installed packages the transaction was solved for.
+ * The packages the solver installs as dependencies are listed as \c auto,
+ * to be restored after the commit (\ref SolutionCache::restoreAutoInstalled):
+ * \code
+ * # zypper transaction bundle v2
+ * system <sha1 of the installed packages>
+ * auto IDENT
+ * i	NAME	EDITION	ARCH	SHA256	rpms/FILE
+ * U	NAME	EDITION	ARCH
+ * \endcode
+ * The action codes are those of the \ref SolutionCache.
+ *
+ * The transaction is taken \ref fromPool before a download-only commit and
+ * the bundle is written (\ref write) after it. On the target the bundle is
+ * checked (\ref verify) and applied (\ref apply) to a pool made of the
+ * installed system and the bundled rpms. No repos are refreshed and the
+ * solver is not called.
+ */
+class TransactionBundle
+{
+public:
+  /** The transacting packages of the pool, to be written (\ref write)
+   * after the download-only commit fetched their rpms. \a autoInstalled_r
+   * are the idents auto-installed after the transaction.
+   */
+  static TransactionBundle fromPool( zypp::sat::StringQueue autoInstalled_r );
+
+  /** Fingerprint of the installed packages in the pool. */
+  static std::string systemFingerprint();
+
+public:
+  /** Read the bundle in \a dir_r.
+   * \throws zypp::Exception if there is no bundle or the manifest is malformed.
+   */
+  TransactionBundle( zypp::Pathname dir_r );
+
+  const zypp::Pathname & dir() const
+  { return _dir; }
+
+  /** The directory containing the rpms (to be used as plaindir repo). */
+  zypp::Pathname rpmsDir() const
+  { return _dir / "rpms"; }
+
+  const std::string & system() const
+  { return _system; }
+
+  /** The idents of the packages auto-installed after the transaction. */
+  const zypp::sat::StringQueue & autoInstalled() const
+  { return _autoInstalled; }
+
+  unsigned size() const
+  { return _entries.size(); }
+
+  /** Check the checksums of the bundled rpms.
+   * \return The files which are missing or do not match.
+   */
+  std::vector<std::string> verify() const;
+
+  /** Set the pool status of the bundled transaction.
+   * The packages to install are taken from the repo \a alias_r, the ones to
+   * remove from the installed system. On failure the pool is reset.
+   * \return The manifest lines not matching the pool (empty on success).
+   */
+  std::vector<std::string> apply( const std::string & alias_r ) const;
+
+  /** Copy the rpms of a bundle taken \ref fromPool into \a dir_r and write the manifest.
+   * An existing bundle in \a dir_r is replaced.
+   * \throws zypp::Exception if \a dir_r is not a bundle directory or an rpm is missing.
+   */
+  void write( const zypp::Pathname & dir_r );
+
+public:
+  struct Entry
+  {
+    char _action = '\0';
+    std::string _name;
+    zypp::Edition _edition;
+    zypp::Arch _arch;
+    std::string _checksum;	///< sha256 of the rpm (install only)
+    std::string _file;		///< relative to the bundle dir (install only)
+    zypp::sat::Solvable _solv;	///< if taken \ref fromPool
+
+    std::string asString() const;
+  };
+
+  const std::vector<Entry> & entries() const
+  { return _entries; }
+
+private:
+  TransactionBundle() {}
+
+  zypp::Pathname _dir;
+  std::string _system;
+  zypp::sat::StringQueue _autoInstalled;
+  std::vector<Entry> _entries;
+};
+
+#endif /* ZYPPER_TRANSACTIONBUNDLE_H_ */
@@ -39,8 +39,10 @@
 #include "Zypper.h"
 #include "Command.h"
 #include "SolverRequester.h"
+#include "callbacks/callbacks.h"
 
 #include "Table.h"
+#include "MultiRoot.h"
 #include "utils/text.h"
 #include "output/OutNormal.h"
 
@@ -70,6 +72,28 @@ void Zypper::assertZYppPtrGod()
   if ( God )
     return;	// already have it.
 
+  // Commands using the ZYpp instance need the callback receivers.
+  try
+  {
+    initCallbacks();
+  }
+  catch ( const Exception & e )
+  {
+    ZYPP_CAUGHT( e );
+    out().error( e, "Failed to initialize zypper callbacks." );
+    report_a_bug( out() );
+    setExitCode( ZYPPER_EXIT_ERR_BUG );
+    ZYPP_THROW( ExitRequestException("callbacks") );
+  }
+  catch (...)
+  {
+    out().error( "Failed to initialize zypper callbacks." );
+    ERR << "Failed to initialize zypper callbacks." << endl;
+    report_a_bug( out() );
+    setExitCode( ZYPPER_EXIT_ERR_BUG );
+    ZYPP_THROW( ExitRequestException("callbacks") );
+  }
+
   try
   {
     God = getZYpp();	// lock it
@@ -210,7 +234,10 @@ int Zypper::main( int argc, char ** argv )
   try {
     // parse global options and the command
     _commandArgOffset = processGlobalOptions();
-    doCommand( argc , argv, _commandArgOffset );
+    if ( _config.roots_file.empty() )
+      doCommand( argc , argv, _commandArgOffset );
+    else
+      doCommandForRoots( argc , argv, _commandArgOffset );
     cleanup();
   }
   // Actually safeDoCommand also catches these exceptions.
@@ -651,31 +678,29 @@ void Zypper::doCommand( int cmdArgc, char **cmdArgv, int firstFlag )
       // Legacy command options -y, --no-confirm are aliased to
       // --non-interactive. In case PK holds the lock and we prompt
       // whather to abort it, --non-interactive must be set-up.
-      switch ( command().toEnum() )
+      // bnc#703598: Commands declaring NoZYpp (and help requests) neither
+      // need the ZYpp instance nor the lock. They also don't need the
+      // callback receivers, which are set up along with the instance.
+      if ( newStyleCmd->setupSystemFlags().testFlag( NoZYpp ) || newStyleCmd->helpRequested() )
       {
-        case ZypperCommand::PS_e:
-        case ZypperCommand::SUBCOMMAND_e:
-          // bnc#703598: Quick fix as few commands do not need a zypp lock
-          break;
-
-        default:
-          if ( _config.changedRoot && _config.root_dir != "/" )
-          {
-            // bnc#575096: Quick fix
-            ::setenv( "ZYPP_LOCKFILE_ROOT", _config.root_dir.c_str(), 0 );
-          }
-          {
-            const char *roh = getenv( "ZYPP_READONLY_HACK" );
-            if ( roh != NULL && roh[0] == '1' )
-              zypp_readonly_hack::IWantIt ();
-            else if ( command() == ZypperCommand::LIST_REPOS
-              || command() == ZypperCommand::LIST_SERVICES
-              || command() == ZypperCommand::HELP
-              || command() == ZypperCommand::VERSION_CMP
-              || command() == ZypperCommand::TARGET_OS )
-              zypp_readonly_hack::IWantIt (); // #247001, #302152
-          }
-          assertZYppPtrGod();
+        MIL << "Command does not use the ZYpp instance" << endl;
+      }
+      else
+      {
+        if ( _config.changedRoot && _config.root_dir != "/" )
+        {
+          // bnc#575096: Quick fix
+          ::setenv( "ZYPP_LOCKFILE_ROOT", _config.root_dir.c_str(), 0 );
+        }
+        {
+          const char *roh = getenv( "ZYPP_READONLY_HACK" );
+          if ( roh != NULL && roh[0] == '1' )
+            zypp_readonly_hack::IWantIt ();
+          else if ( command() == ZypperCommand::LIST_REPOS
+            || command() == ZypperCommand::LIST_SERVICES )
+            zypp_readonly_hack::IWantIt (); // #247001, #302152
+        }
+        assertZYppPtrGod();
       }
 
       // === execute command ===
@@ -744,6 +769,147 @@ void Zypper::cleanup()
   _rm.reset();	// release any pending appdata trigger now.
 }
 
+/// process one command for each root listed in the --roots file
+void Zypper::doCommandForRoots( int cmdArgc, char **cmdArgv, int firstFlag )
+{
+  std::vector<Pathname> roots;
+  try
+  {
+    roots = MultiRoot::readRoots( _config.roots_file );
+  }
+  catch ( const Exception & e )
+  {
+    ZYPP_CAUGHT( e );
+    out().error( e, _("Failed to read the root directories.") );
+    setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+    return;
+  }
+  if ( roots.empty() )
+  {
+    out().error( str::Format(_("No root directories listed in '%1%'.")) % _config.roots_file );
+    setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+    return;
+  }
+  if ( _config.roots_jobs < 1 )
+  {
+    out().error( str::Format(_("Invalid value '%1%' of the %2% option.")) % _config.roots_jobs % "--roots-jobs" );
+    setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+    return;
+  }
+  if ( _config.roots_jobs > 1 && ! _config.non_interactive )
+  {
+    out().error( str::Format(_("The %1% option requires %2%.")) % "--roots-jobs" % "--non-interactive" );
+    setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+    return;
+  }
+  MIL << "Processing " << roots.size() << " roots (" << _config.roots_jobs << " parallel)" << endl;
+
+  // All roots share the repo caches of the host.
+  const RepoManagerOptions hostOptions { _config.rm_options };
+
+  // Interleaved output of parallel children is useless and XML must stay
+  // well-formed, so in these cases the output is captured and printed per root.
+  bool capture = ( out().type() == Out::TYPE_XML || _config.roots_jobs > 1 );
+  Pathname outputDir;
+  if ( capture )
+  {
+    outputDir = runtimeData().tmpdir / "roots";
+    filesystem::assert_dir( outputDir );
+  }
+
+  MultiRoot multiRoot { std::move(roots), unsigned(_config.roots_jobs), outputDir };
+  // Parallel children must not refresh or build the same shared caches at once.
+  filesystem::assert_dir( hostOptions.repoCachePath );
+  multiRoot.cacheLockFile( hostOptions.repoCachePath / ".zypper-roots.lock" );
+
+  // The shared caches are keyed by alias; remember the URL behind each alias.
+  // The host's repos own their caches, whatever earlier roots recorded.
+  const Pathname repoUrlsFile { hostOptions.repoCachePath / ".zypper-roots.repos" };
+  try
+  {
+    MultiRoot::claimRepoUrls( repoUrlsFile, RepoManager( hostOptions ).knownRepositories(), true );
+  }
+  catch ( const Exception & e )
+  {
+    ZYPP_CAUGHT( e );	// the host may have no repos
+  }
+
+  auto forRoot = [&]( const Pathname & root_r ) -> int {
+    _config.root_dir = root_r.asString();
+    _config.changedRoot = true;
+    _config.is_install_root = false;
+    _config.rm_options = RepoManagerOptions( root_r );
+
+    bool shareCaches = false;
+    try
+    {
+      shareCaches = MultiRoot::claimRepoUrls( repoUrlsFile, RepoManager( _config.rm_options ).knownRepositories() );
+    }
+    catch ( const Exception & e )
+    {
+      ZYPP_CAUGHT( e );
+    }
+    if ( shareCaches )
+    {
+      _config.rm_options.repoCachePath         = hostOptions.repoCachePath;
+      _config.rm_options.repoRawCachePath      = hostOptions.repoRawCachePath;
+      _config.rm_options.repoSolvCachePath     = hostOptions.repoSolvCachePath;
+      _config.rm_options.repoPackagesCachePath = hostOptions.repoPackagesCachePath;
+    }
+    else
+      out().warning( str::Format(_("A repository alias in '%1%' is used with a different URL by the host or another root. Using the repository caches of the root.")) % root_r );
+
+    if ( ! capture )
+      out().info( str::Format(_("Root directory '%1%':")) % root_r );
+    doCommand( cmdArgc, cmdArgv, firstFlag );
+    cleanupForSubcommand();
+    return exitCode() != ZYPPER_EXIT_OK ? exitCode() : exitInfoCode();
+  };
+
+  auto printOutput = [&]( const MultiRoot::Result & result_r ) {
+    if ( result_r._output.empty() )
+      return;
+    std::ifstream captured( result_r._output.c_str() );
+    if ( out().type() == Out::TYPE_XML )
+    {
+      cout << "<root path=\"" << xml::escape( result_r._root.asString() ) << "\" exitcode=\"" << result_r._exitCode << "\">" << endl;
+      if ( captured && captured.peek() != std::ifstream::traits_type::eof() )
+        cout << captured.rdbuf();
+      cout << "</root>" << endl;
+    }
+    else
+    {
+      out().info( str::Format(_("Root directory '%1%':")) % result_r._root );
+      if ( captured && captured.peek() != std::ifstream::traits_type::eof() )
+        cout << captured.rdbuf();
+      cout << flush;
+    }
+    captured.close();
+    filesystem::unlink( result_r._output );
+  };
+
+  std::vector<MultiRoot::Result> results { multiRoot.run( forRoot, printOutput ) };
+
+  if ( out().type() != Out::TYPE_XML )
+  {
+    Table t;
+    t << ( TableHeader() << _("Root") << _("Exit Code") );
+    for ( const auto & result : results )
+      t << ( TableRow() << result._root.asString() << result._exitCode );
+    out().gap();
+    cout << t;
+  }
+
+  for ( const auto & result : results )
+  {
+    if ( result._exitCode != ZYPPER_EXIT_OK )
+    {
+      setExitCode( result._exitCode );
+      break;
+    }
+  }
+}
+
 void Zypper::cleanupForSubcommand()
 {
   // Clear resources and release the zypp lock.
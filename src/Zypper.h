@@ -8,6 +8,7 @@
 #ifndef ZYPPER_H
 #define ZYPPER_H
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,7 @@
 #include "utils/Offering.h"
 #include "output/Out.h"
 #include "Guardians.h"
+#include "RepoNameIndex.h"
 
 #include "commands/basecommand.h"
 
@@ -122,6 +124,9 @@ struct RuntimeData
 
   bool entered_commit;	// bsc#946750 - give ZYPPER_EXIT_ERR_COMMIT priority over ZYPPER_EXIT_ON_SIGNAL
 
+  //! If set, load only repos which may contain these names (see \ref RepoNameFilter).
+  std::optional<RepoNameFilter> repoNameFilter;
+
   //! Temporary directory for any use, e.g. for temporary repositories.
   Pathname tmpdir;
 };
@@ -224,6 +229,7 @@ private:
   int processGlobalOptions();
   void shellCleanup();
   void doCommand(int cmdArgc, char **cmdArgv , int firstFlag = 0 );
+  void doCommandForRoots( int cmdArgc, char **cmdArgv, int firstFlag );
 
   void setRunningHelp( bool value = true )		{ _running_help = value; }
 
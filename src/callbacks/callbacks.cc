@@ -0,0 +1,26 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include "callbacks/callbacks.h"
+
+#include "callbacks/rpm.h"
+#include "callbacks/keyring.h"
+#include "callbacks/repo.h"
+#include "callbacks/media.h"
+#include "callbacks/locks.h"
+#include "callbacks/job.h"
+
+void initCallbacks()
+{
+  static RpmCallbacks rpm_callbacks;
+  static SourceCallbacks source_callbacks;
+  static MediaCallbacks media_callbacks;
+  static KeyRingCallbacks keyring_callbacks;
+  static DigestCallbacks digest_callbacks;
+  static LocksCallbacks locks_callbacks;
+  static JobCallbacks job_callbacks;
+}
@@ -0,0 +1,21 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#ifndef ZMART_CALLBACKS_H
+#define ZMART_CALLBACKS_H
+
+/** Connect all of zypper's callback receivers (once).
+ *
+ * The receivers are needed as soon as the ZYpp instance is used, so this is
+ * done by \ref Zypper::assertZYppPtrGod. Commands which do not use the ZYpp
+ * instance don't pay for setting them up.
+ *
+ * \throws zypp::Exception if setting up a receiver failed
+ */
+void initCallbacks();
+
+#endif // ZMART_CALLBACKS_H
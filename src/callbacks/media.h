@@ -17,6 +17,9 @@
 #include <zypp/Url.h>
 
 #include "Zypper.h"
+#include "output/ProgressThrottle.h"
+#include "utils/CommitEvents.h"
+#include "utils/DownloadStats.h"
 #include "utils/prompt.h"
 
 // auto-repeat counter limit
@@ -100,6 +103,8 @@ namespace ZmartRecipients
     virtual void start( const Url & uri, Pathname localfile )
     {
       _last_drate_avg = -1;
+      _localfile = localfile;
+      DownloadStats::instance().fileStart( uri );
 
       Out & out = Zypper::instance().out();
 
@@ -118,6 +123,7 @@ namespace ZmartRecipients
       else
         _be_quiet = false;
 
+      ProgressThrottle::instance().done( uri.asString() );
       out.dwnldProgressStart(uri);
     }
 
@@ -131,15 +137,19 @@ namespace ZmartRecipients
         return false;
       }
 
-      if (!zypper.runtimeData().raw_refresh_progress_label.empty())
+      // libzypp reports on every chunk received; redraw at a sane rate only
+      ProgressThrottle & throttle( ProgressThrottle::instance() );
+      if (!zypper.runtimeData().raw_refresh_progress_label.empty()
+          && throttle.due( zypper.out(), "raw-refresh", -1 ))
         zypper.out().progress(
           "raw-refresh", zypper.runtimeData().raw_refresh_progress_label);
 
       if (_be_quiet)
         return true;
 
-      zypper.out().dwnldProgress(uri, value, (long) drate_now);
       _last_drate_avg = drate_avg;
+      if ( throttle.due( zypper.out(), uri.asString(), value ) )
+        zypper.out().dwnldProgress(uri, value, (long) drate_now);
       return true;
     }
 
@@ -159,13 +169,21 @@ namespace ZmartRecipients
       Action action = (Action) read_action_ari(
           PROMPT_ARI_MEDIA_PROBLEM, DownloadProgressReport::ABORT);
       if (action == DownloadProgressReport::RETRY)
+      {
         Zypper::instance().requestExit(false);
+        DownloadStats::instance().fileRetry( uri );
+      }
       return action;
     }
 
     // used only to finish, errors will be reported in media change callback (libzypp 3.20.0)
     virtual void finish( const Url & uri, Error error, const std::string & konreason )
     {
+      ProgressThrottle::instance().done( uri.asString() );
+      if ( error == NO_ERROR )
+        CommitEvents::instance().fileDownloaded( _localfile );
+      if ( error != NOT_FOUND )	// just probing
+        DownloadStats::instance().fileFinish( uri, _localfile, error == NO_ERROR );
       if (_be_quiet)
         return;
 
@@ -176,6 +194,7 @@ namespace ZmartRecipients
   private:
     bool _be_quiet;
     double _last_drate_avg;
+    Pathname _localfile;
   };
 
 
@@ -19,6 +19,8 @@
 #include "Zypper.h"
 #include "utils/prompt.h"
 #include "utils/misc.h"
+#include "utils/CommitEvents.h"
+#include "utils/DownloadStats.h"
 
 ///////////////////////////////////////////////////////////////////
 namespace ZmartRecipients
@@ -56,6 +58,7 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
   {
     _delta = filename;
     _delta_size = downloadsize;
+    DownloadStats::instance().deltaDownload( downloadsize );
     std::ostringstream s;
     s << _("Retrieving delta") << ": "
         << _delta << ", " << _delta_size;
@@ -100,6 +103,7 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
 
   virtual void finishDeltaApply()
   {
+    DownloadStats::instance().deltaApplied();
     Zypper::instance().out().progressEnd("apply-delta", _label_apply_delta);
   }
 
@@ -118,6 +122,11 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
   virtual void infoInCache( Resolvable::constPtr res_r, const Pathname & localfile_r )
   {
     Zypper & zypper = Zypper::instance();
+    if ( res_r )
+    {
+      CommitEvents::instance().cached( res_r->satSolvable(), localfile_r );
+      DownloadStats::instance().cached( res_r->satSolvable(), localfile_r );
+    }
 
     TermLine outstr( TermLine::SF_SPLIT | TermLine::SF_EXPAND );
     outstr.lhs << str::Format(_("In cache %1%")) % localfile_r.basename();
@@ -134,6 +143,8 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
     _resolvable_ptr =  resolvable_ptr;
     _url = url;
     Zypper & zypper = Zypper::instance();
+    CommitEvents::instance().downloadStart( resolvable_ptr->satSolvable() );
+    DownloadStats::instance().packageStart( resolvable_ptr->satSolvable() );
 
     TermLine outstr( TermLine::SF_SPLIT | TermLine::SF_EXPAND );
     outstr.lhs << _("Retrieving:") << " " << _resolvable_ptr-> asUserString();
@@ -157,7 +168,10 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
 
     Action action = (Action) read_action_ari(PROMPT_ARI_RPM_DOWNLOAD_PROBLEM, ABORT);
     if (action == DownloadResolvableReport::RETRY)
+    {
       --Zypper::instance().runtimeData().commit_pkg_current;
+      DownloadStats::instance().packageRetry();
+    }
     else
       Zypper::instance().runtimeData().action_rpm_download = false;
     return action;
@@ -176,6 +190,7 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
     using target::rpm::RpmDb;
     RpmDb::CheckPackageResult result		( userData_r.get<RpmDb::CheckPackageResult>( "CheckPackageResult" ) );
     const RpmDb::CheckPackageDetail & details	( userData_r.get<RpmDb::CheckPackageDetail>( "CheckPackageDetail" ) );
+    CommitEvents::instance().verified( result == RpmDb::CHK_OK );
 
     str::Str msg;
     if ( result != RpmDb::CHK_OK )	// only on error...
@@ -257,6 +272,8 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
   virtual void finish( Resolvable::constPtr /*resolvable_ptr**/, Error error, const std::string & reason )
   {
     Zypper::instance().runtimeData().action_rpm_download = false;
+    CommitEvents::instance().downloadFinish( error == NO_ERROR );
+    DownloadStats::instance().packageFinish( error == NO_ERROR );
 /*
     display_done ("download-resolvable", cout_v);
     display_error (error, reason);
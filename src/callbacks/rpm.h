@@ -24,6 +24,8 @@
 
 #include "Zypper.h"
 #include "output/prompt.h"
+#include "output/ProgressThrottle.h"
+#include "utils/CommitEvents.h"
 #include "global-settings.h"
 #include "utils/prompt.h"
 
@@ -279,12 +281,13 @@ struct RemoveResolvableReportReceiver : public callback::ReceiveReport<target::r
   virtual void start( Resolvable::constPtr resolvable )
   {
     ++Zypper::instance().runtimeData().rpm_pkg_current;
+    CommitEvents::instance().begin( "remove", resolvable->satSolvable(), resolvable->installSize() );
     showProgress( resolvable );
   }
 
   virtual bool progress( int value, Resolvable::constPtr resolvable )
   {
-    if ( _progress )
+    if ( _progress && ProgressThrottle::instance().due( Zypper::instance().out(), "remove-resolvable", value ) )
       (*_progress)->set( value );
     return !Zypper::instance().exitRequested();
   }
@@ -302,6 +305,7 @@ struct RemoveResolvableReportReceiver : public callback::ReceiveReport<target::r
     {
       (*_progress).error();
       _progress.reset();
+      ProgressThrottle::instance().done( "remove-resolvable" );
     }
 
     std::ostringstream s;
@@ -316,13 +320,16 @@ struct RemoveResolvableReportReceiver : public callback::ReceiveReport<target::r
     return ret;
   }
 
-  virtual void finish( Resolvable::constPtr /*resolvable*/, Error error, const std::string & reason )
+  virtual void finish( Resolvable::constPtr resolvable, Error error, const std::string & reason )
   {
+    CommitEvents::instance().end( "remove", resolvable->satSolvable(), error == NO_ERROR );
+
     // finsh progress; indicate error
     if ( _progress )
     {
       (*_progress).error( error != NO_ERROR );
       _progress.reset();
+      ProgressThrottle::instance().done( "remove-resolvable" );
     }
 
     if (error != NO_ERROR)
@@ -339,7 +346,7 @@ struct RemoveResolvableReportReceiver : public callback::ReceiveReport<target::r
   }
 
   virtual void reportend()
-  { _progress.reset(); }
+  { _progress.reset(); ProgressThrottle::instance().done( "remove-resolvable" ); }
 
 private:
   void showProgress( Resolvable::constPtr resolvable_r )
@@ -365,12 +372,13 @@ struct InstallResolvableReportReceiver : public callback::ReceiveReport<target::
   virtual void start( Resolvable::constPtr resolvable )
   {
     ++Zypper::instance().runtimeData().rpm_pkg_current;
+    CommitEvents::instance().begin( "install", resolvable->satSolvable(), resolvable->installSize() );
     showProgress( resolvable );
   }
 
   virtual bool progress( int value, Resolvable::constPtr resolvable )
   {
-    if ( _progress )
+    if ( _progress && ProgressThrottle::instance().due( Zypper::instance().out(), "install-resolvable", value ) )
       (*_progress)->set( value );
     return !Zypper::instance().exitRequested();
   }
@@ -388,6 +396,7 @@ struct InstallResolvableReportReceiver : public callback::ReceiveReport<target::
     {
       (*_progress).error();
       _progress.reset();
+      ProgressThrottle::instance().done( "install-resolvable" );
     }
 
     std::ostringstream s;
@@ -402,13 +411,16 @@ struct InstallResolvableReportReceiver : public callback::ReceiveReport<target::
     return ret;
   }
 
-  virtual void finish( Resolvable::constPtr /*resolvable*/, Error error, const std::string & reason, RpmLevel /*unused*/ )
+  virtual void finish( Resolvable::constPtr resolvable, Error error, const std::string & reason, RpmLevel /*unused*/ )
   {
+    CommitEvents::instance().end( "install", resolvable->satSolvable(), error == NO_ERROR );
+
     // finsh progress; indicate error
     if ( _progress )
     {
       (*_progress).error( error != NO_ERROR );
       _progress.reset();
+      ProgressThrottle::instance().done( "install-resolvable" );
     }
 
     if ( error != NO_ERROR )
@@ -425,7 +437,7 @@ struct InstallResolvableReportReceiver : public callback::ReceiveReport<target::
   }
 
   virtual void reportend()
-  { _progress.reset(); }
+  { _progress.reset(); ProgressThrottle::instance().done( "install-resolvable" ); }
 
 private:
   void showProgress( Resolvable::constPtr resolvable_r )
@@ -582,6 +594,7 @@ struct RemoveResolvableSAReportReceiver : public callback::ReceiveReport<target:
           const UserData & /*userdata*/ ) override
   {
     ++Zypper::instance().runtimeData().rpm_pkg_current;
+    CommitEvents::instance().begin( "remove", resolvable->satSolvable(), resolvable->installSize() );
     showProgress( resolvable );
   }
 
@@ -590,17 +603,20 @@ struct RemoveResolvableSAReportReceiver : public callback::ReceiveReport<target:
           Resolvable::constPtr resolvable,
           const UserData & /*userdata*/  ) override
   {
-    if ( _progress )
+    if ( _progress && ProgressThrottle::instance().due( Zypper::instance().out(), "remove-resolvable", value ) )
       (*_progress)->set( value );
   }
 
-  void finish( Resolvable::constPtr /*resolvable*/, Error error, const UserData & /*userdata*/ ) override
+  void finish( Resolvable::constPtr resolvable, Error error, const UserData & /*userdata*/ ) override
   {
+    CommitEvents::instance().end( "remove", resolvable->satSolvable(), error == NO_ERROR );
+
     // finsh progress; indicate error
     if ( _progress )
     {
       (*_progress).error( error != NO_ERROR );
       _progress.reset();
+      ProgressThrottle::instance().done( "remove-resolvable" );
     }
 
     if (error != NO_ERROR)
@@ -620,7 +636,7 @@ struct RemoveResolvableSAReportReceiver : public callback::ReceiveReport<target:
   }
 
   void reportend() override
-  { _progress.reset(); }
+  { _progress.reset(); ProgressThrottle::instance().done( "remove-resolvable" ); }
 
 private:
   void showProgress( Resolvable::constPtr resolvable_r )
@@ -646,22 +662,26 @@ struct InstallResolvableSAReportReceiver : public callback::ReceiveReport<target
   void start( Resolvable::constPtr resolvable, const UserData & /*userdata*/ ) override
   {
     ++Zypper::instance().runtimeData().rpm_pkg_current;
+    CommitEvents::instance().begin( "install", resolvable->satSolvable(), resolvable->installSize() );
     showProgress( resolvable );
   }
 
   void progress( int value, Resolvable::constPtr resolvable, const UserData & /*userdata*/ ) override
   {
-    if ( _progress )
+    if ( _progress && ProgressThrottle::instance().due( Zypper::instance().out(), "install-resolvable", value ) )
       (*_progress)->set( value );
   }
 
-  void finish( Resolvable::constPtr /*resolvable*/, Error error, const UserData & /*userdata*/ ) override
+  void finish( Resolvable::constPtr resolvable, Error error, const UserData & /*userdata*/ ) override
   {
+    CommitEvents::instance().end( "install", resolvable->satSolvable(), error == NO_ERROR );
+
     // finsh progress; indicate error
     if ( _progress )
     {
       (*_progress).error( error != NO_ERROR );
       _progress.reset();
+      ProgressThrottle::instance().done( "install-resolvable" );
     }
 
     if ( error != NO_ERROR )
@@ -681,7 +701,7 @@ struct InstallResolvableSAReportReceiver : public callback::ReceiveReport<target
   }
 
   void reportend() override
-  { _progress.reset(); }
+  { _progress.reset(); ProgressThrottle::instance().done( "install-resolvable" ); }
 
 private:
   void showProgress( Resolvable::constPtr resolvable_r )
@@ -710,23 +730,29 @@ struct CommitScriptReportSAReportReceiver : public callback::ReceiveReport<targe
           Resolvable::constPtr resolvable,
           const UserData & /*userdata*/ ) override
   {
+    _scriptType = scriptType;
+    _scriptSolv = resolvable ? resolvable->satSolvable() : sat::Solvable();
+    CommitEvents::instance().begin( "script", _scriptSolv, ByteCount(), _scriptType );
     showProgress( scriptType, packageName, resolvable );
   }
 
   void progress( int value, Resolvable::constPtr resolvable, const UserData & /*userdata*/ ) override
   {
-    if ( _progress )
+    if ( _progress && ProgressThrottle::instance().due( Zypper::instance().out(), "execute-script", value ) )
       (*_progress)->set( value );
   }
 
   void finish( Resolvable::constPtr /*resolvable*/, Error error, const UserData & /*userdata*/ ) override
   {
+    CommitEvents::instance().end( "script", _scriptSolv, error == NO_ERROR, ByteCount(), _scriptType );
+
     // finsh progress; indicate error
     if ( _progress )
     {
       ProgressEnd donetag { error==NO_ERROR ? ProgressEnd::done : error==CRITICAL ? ProgressEnd::error : ProgressEnd::attention };
       (*_progress).error( donetag );
       _progress.reset();
+      ProgressThrottle::instance().done( "execute-script" );
     }
 
     if ( error == WARN )
@@ -746,7 +772,7 @@ struct CommitScriptReportSAReportReceiver : public callback::ReceiveReport<targe
   }
 
   void reportend() override
-  { _progress.reset(); }
+  { _progress.reset(); ProgressThrottle::instance().done( "execute-script" ); }
 
 private:
   void showProgress( const std::string &scriptType, const std::string &packageName, Resolvable::constPtr resolvable_r )
@@ -778,6 +804,8 @@ private:
 
 private:
   scoped_ptr<Out::ProgressBar>	_progress;
+  std::string _scriptType;		// for the commit events
+  sat::Solvable _scriptSolv;		// -"-
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -788,12 +816,14 @@ struct TransactionReportSAReceiver : public callback::ReceiveReport<target::rpm:
           const std::string &name,
           const UserData & /*userdata*/ ) override
   {
+    _name = name;
+    CommitEvents::instance().begin( "transaction", sat::Solvable(), ByteCount(), _name );
     showProgress( name );
   }
 
   void progress( int value, const UserData & /*userdata*/ ) override
   {
-    if ( _progress )
+    if ( _progress && ProgressThrottle::instance().due( Zypper::instance().out(), "transaction-prepare", value ) )
       (*_progress)->set( value );
   }
 
@@ -804,7 +834,9 @@ struct TransactionReportSAReceiver : public callback::ReceiveReport<target::rpm:
     {
       (*_progress).error( error != NO_ERROR );
       _progress.reset();
+      ProgressThrottle::instance().done( "transaction-prepare" );
     }
+    CommitEvents::instance().end( "transaction", sat::Solvable(), error == NO_ERROR, ByteCount(), _name );
 
     if ( error != NO_ERROR )
       // don't write to output, the error should have been reported in problem() (bnc #381203)
@@ -824,7 +856,7 @@ struct TransactionReportSAReceiver : public callback::ReceiveReport<target::rpm:
 
 
   void reportend() override
-  { _progress.reset(); }
+  { _progress.reset(); ProgressThrottle::instance().done( "transaction-prepare" ); }
 
 private:
   void showProgress( const std::string &name )
@@ -837,6 +869,7 @@ private:
 
 private:
   scoped_ptr<Out::ProgressBar>	_progress;
+  std::string _name;	///< of the task (for the timings)
 };
 
 
@@ -853,7 +886,7 @@ struct CleanupPackageReportSAReceiver : public callback::ReceiveReport<target::r
 
   void progress( int value, const UserData & /*userdata*/ ) override
   {
-    if ( _progress )
+    if ( _progress && ProgressThrottle::instance().due( Zypper::instance().out(), "cleanup-task", value ) )
       (*_progress)->set( value );
   }
 
@@ -864,6 +897,7 @@ struct CleanupPackageReportSAReceiver : public callback::ReceiveReport<target::r
     {
       (*_progress).error( error != NO_ERROR );
       _progress.reset();
+      ProgressThrottle::instance().done( "cleanup-task" );
     }
 
     if ( error != NO_ERROR )
@@ -884,7 +918,7 @@ struct CleanupPackageReportSAReceiver : public callback::ReceiveReport<target::r
 
 
   void reportend() override
-  { _progress.reset(); }
+  { _progress.reset(); ProgressThrottle::instance().done( "cleanup-task" ); }
 
 private:
   void showProgress( const std::string &name )
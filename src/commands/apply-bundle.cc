@@ -0,0 +1,158 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include "apply-bundle.h"
+#include "commands/conditions.h"
+#include "commands/repos/refresh.h"
+#include "utils/flags/flagtypes.h"
+#include "utils/messages.h"
+#include "utils/misc.h"
+#include "solve-commit.h"
+#include "TransactionBundle.h"
+#include "Zypper.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <zypp/base/Exception.h>
+#include <zypp/RepoInfo.h>
+
+using namespace zypp;
+
+/** Alias of the plaindir repo made of the bundled rpms. */
+#define BUNDLE_REPO_ALIAS "_tmpBundle_"
+
+ApplyBundleCmd::ApplyBundleCmd( std::vector<std::string> &&commandAliases_r )
+: ZypperBaseCommand (
+    std::move( commandAliases_r ),
+    // translators: command synopsis; do not translate lowercase words
+    _("apply-bundle [OPTIONS] <DIR>"),
+    // translators: command summary: apply-bundle
+    _("Install a transaction bundle."),
+    // translators: command description
+    { _("Install and remove the packages of a transaction bundle saved by the '--export-bundle' option of the install, update, patch or dist-upgrade commands."),
+      _("The checksums of the bundled packages are verified. No repositories are refreshed and the dependencies are not solved again. The bundle must have been created on a system with exactly the same packages installed.") },
+    ResetRepoManager )
+{}
+
+std::vector<BaseCommandConditionPtr> ApplyBundleCmd::conditions() const
+{
+  return {
+    std::make_shared<NeedsRootCondition>(),
+    std::make_shared<NeedsWritableRoot>()
+  };
+}
+
+ZyppFlags::CommandGroup ApplyBundleCmd::cmdOptions() const
+{
+  auto that = const_cast<ApplyBundleCmd *>( this );
+  return {{
+    { "force", 'f', ZyppFlags::NoArgument, ZyppFlags::BoolType( &that->_force, ZyppFlags::StoreTrue, _force ),
+      // translators: -f, --force
+      _("Apply the bundle even if it was created for a system with different packages installed.")
+    },
+    { "allow-unsigned-rpm", '\0', ZyppFlags::NoArgument, ZyppFlags::BoolType( &that->_allowUnsignedRPM, ZyppFlags::StoreTrue, _allowUnsignedRPM ),
+      // translators: --allow-unsigned-rpm
+      _("Silently install unsigned rpm packages contained in the bundle.")
+    }
+  }};
+}
+
+void ApplyBundleCmd::doReset()
+{
+  _force = false;
+  _allowUnsignedRPM = false;
+}
+
+int ApplyBundleCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
+{
+  if ( positionalArgs_r.empty() )
+  {
+    report_required_arg_missing( zypper.out(), help() );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+  else if ( positionalArgs_r.size() > 1 )
+  {
+    report_too_many_arguments( zypper.out(), help() );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  std::optional<TransactionBundle> bundle;
+  try
+  {
+    bundle.emplace( Pathname( positionalArgs_r[0] ) );
+  }
+  catch ( const Exception & e )
+  {
+    ZYPP_CAUGHT( e );
+    zypper.out().error( e, _("Failed to read the transaction bundle.") );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  zypper.out().info(_("Verifying the bundled packages...") );
+  std::vector<std::string> corrupt { bundle->verify() };
+  if ( ! corrupt.empty() )
+  {
+    for ( const std::string & file : corrupt )
+      zypper.out().error( str::Format(_("Checksum of '%1%' does not match the bundle.")) % file );
+    return ZYPPER_EXIT_ERR_ZYPP;
+  }
+
+  // The pool is the installed system plus the bundled rpms, never the repos.
+  RuntimeData & gData { zypper.runtimeData() };
+  gData.repos.clear();
+  if ( std::any_of( bundle->entries().begin(), bundle->entries().end(),
+                    []( const TransactionBundle::Entry & entry_r ) { return entry_r._action == 'i'; } ) )
+  {
+    RepoInfo repo;
+    repo.setAlias( BUNDLE_REPO_ALIAS );
+    repo.setName(_("Transaction bundle") );
+    repo.setBaseUrl( make_url( bundle->rpmsDir().asString() ) );
+    repo.setMetadataPath( gData.tmpdir / BUNDLE_REPO_ALIAS / "%AUTO%" );
+    repo.setPackagesPath( gData.tmpdir / BUNDLE_REPO_ALIAS / "%PKG%" );
+    repo.setType( repo::RepoType::RPMPLAINDIR );
+    repo.setEnabled( true );
+    repo.setAutorefresh( true );
+    repo.setKeepPackages( false );
+    if ( _allowUnsignedRPM )
+      repo.setGpgCheck( RepoInfo::GpgCheck::AllowUnsignedPackage );
+
+    // shut up zypper
+    SCOPED_VERBOSITY( zypper.out(), Out::QUIET );
+    if ( RefreshRepoCmd::refreshRepository( zypper, repo ) )	// true on error
+      return ZYPPER_EXIT_ERR_ZYPP;
+    gData.repos.push_back( repo );
+  }
+
+  int code = defaultSystemSetup( zypper, InitTarget | LoadResolvables );
+  if ( code != ZYPPER_EXIT_OK )
+    return code;
+
+  if ( bundle->system() != TransactionBundle::systemFingerprint() )
+  {
+    if ( ! _force )
+    {
+      zypper.out().error( _("The bundle was created for a system with different packages installed."),
+                          str::Format(_("Use '%1%' to apply it anyway.")) % "--force" );
+      return ZYPPER_EXIT_ERR_INVALID_ARGS;
+    }
+    zypper.out().warning( _("The bundle was created for a system with different packages installed.") );
+  }
+
+  std::vector<std::string> unmatched { bundle->apply( BUNDLE_REPO_ALIAS ) };
+  if ( ! unmatched.empty() )
+  {
+    for ( const std::string & item : unmatched )
+      zypper.out().error( str::Format(_("Bundled transaction item does not match the system: %1%")) % item );
+    return ZYPPER_EXIT_ERR_ZYPP;
+  }
+
+  auto policy = SolveAndCommitPolicy().presolved( true ).autoInstalled( bundle->autoInstalled() );
+  policy.zyppCommitPolicy().allowDowngrade( true );	// as solved when creating the bundle
+  solve_and_commit( zypper, policy );
+
+  return zypper.exitCode();
+}
@@ -0,0 +1,34 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_COMMANDS_APPLY_BUNDLE_INCLUDED
+#define ZYPPER_COMMANDS_APPLY_BUNDLE_INCLUDED
+
+#include "commands/basecommand.h"
+#include "commands/optionsets.h"
+#include "utils/flags/zyppflags.h"
+
+/** Install a transaction bundle written by \c --export-bundle. */
+class ApplyBundleCmd : public ZypperBaseCommand
+{
+public:
+  ApplyBundleCmd( std::vector<std::string> &&commandAliases_r );
+
+private:
+  bool _force = false;
+  bool _allowUnsignedRPM = false;
+
+  DryRunOptionSet _dryRun { *this };
+
+  // ZypperBaseCommand interface
+protected:
+  std::vector<BaseCommandConditionPtr> conditions() const override;
+  zypp::ZyppFlags::CommandGroup cmdOptions() const override;
+  void doReset() override;
+  int execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r ) override;
+};
+
+#endif
@@ -26,6 +26,7 @@ std::ostream & operator<<( std::ostream & str, const SetupSystemFlags & obj )
     OUTS( LoadRepoResolvables ),
     OUTS( LoadResolvables ),
     OUTS( Resolve ),
+    OUTS( NoZYpp ),
   };
 #undef OUTS
   return str << zypp::base::stringify( obj, strmap );
@@ -116,9 +117,11 @@ int ZypperBaseCommand::parseArguments( Zypper &, const int argc, char * const *a
 
   int nextArg = 0;
 
-  if ( _parseArguments )
-    nextArg = ZyppFlags::parseCLI( argc, argv, options() );
-  else
+  if ( _parseArguments ) {
+    if ( !_optionTable )
+      _optionTable.reset( new ZyppFlags::OptionTable( options() ) );
+    nextArg = _optionTable->parse( argc, argv );
+  } else
     nextArg = argc; //we eat all arguments
 
   MIL << "Done parsing options." << endl;
@@ -301,7 +304,7 @@ std::string ZypperBaseCommand::help()
   };
 
   //all the options we have
-  std::vector<ZyppFlags::CommandGroup> opts = options();
+  const std::vector<ZyppFlags::CommandGroup> &opts = options();
 
   //collect all deprecated options
   std::vector<const ZyppFlags::CommandOption*> legacyOptions;
@@ -344,8 +347,12 @@ std::string ZypperBaseCommand::help()
   return help;
 }
 
-std::vector<ZyppFlags::CommandGroup> ZypperBaseCommand::options()
+const std::vector<ZyppFlags::CommandGroup> &ZypperBaseCommand::options()
 {
+  //the options are built once, the values write into the command object
+  if ( !_options.empty() )
+    return _options;
+
   //first get the commands own options
   std::vector<ZyppFlags::CommandGroup> allOpts;
 
@@ -382,7 +389,8 @@ std::vector<ZyppFlags::CommandGroup> ZypperBaseCommand::options()
       mergeGroup ( std::move(grp) );
     }
   }
-  return allOpts;
+  _options = std::move(allOpts);
+  return _options;
 }
 
 void ZypperBaseCommand::addOptionSet(BaseCommandOptionSet &set)
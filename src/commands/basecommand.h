@@ -56,6 +56,7 @@ enum SetupSystemBits
  LoadRepoResolvables    = (1 << 6),
  LoadResolvables        = LoadTargetResolvables |  LoadRepoResolvables,            //< Load resolvables
  Resolve                = (1 << 9),             //< compute status of PPP (NOP - since libzypp 17.23.0 the PPP status is auto established)
+ NoZYpp                 = (1 << 10),            //< command uses neither the ZYpp instance nor it's lock (lightweight startup)
  DefaultSetup           = ResetRepoManager | InitTarget | InitRepos | LoadResolvables | Resolve
 };
 ZYPP_DECLARE_FLAGS( SetupSystemFlags, SetupSystemBits );
@@ -153,9 +154,11 @@ public:
   /**
    * Returns the list of all supported options, including all options
    * from registered option sets and a automatically inserted help option.
+   * The list is built on the first call and kept, so all option sets must be
+   * registered before.
    * \sa addOptionSet
    */
-  std::vector<zypp::ZyppFlags::CommandGroup> options ();
+  const std::vector<zypp::ZyppFlags::CommandGroup> &options ();
 
   /**
    * Returns true if the help flag was set on command line
@@ -261,6 +264,8 @@ protected:
 
 private:
   std::vector<BaseCommandOptionSet *> _registeredOptionSets;
+  std::vector<zypp::ZyppFlags::CommandGroup> _options;
+  std::unique_ptr<zypp::ZyppFlags::OptionTable> _optionTable;  //< built from _options on first parse
   bool _helpRequested = false;
   bool _fillRawOptions = false;
   bool _parseArguments = true;
@@ -79,7 +79,7 @@ HelpCmd::HelpCmd ( std::vector<std::string> &&commandAliases_r ) :
     "help",
     _("Print zypper help"),
     _("Print zypper help"),
-    DisableAll
+    NoZYpp
   )
 { }
 
@@ -46,6 +46,9 @@ ZyppFlags::CommandGroup AddLocksCmd::cmdOptions() const
     { "repo", 'r', ZyppFlags::RequiredArgument | ZyppFlags::Repeatable, ZyppFlags::StringVectorType ( &that->_repos, "ALIAS|#|URI" ),  _("Restrict the lock to the specified repository.")},
     { "catalog", 'c', ZyppFlags::RequiredArgument | ZyppFlags::Repeatable | ZyppFlags::Hidden, ZyppFlags::StringVectorType ( &that->_repos, "ALIAS|#|URI"),  "Alias for --repo" },
     { "comment", 'm', ZyppFlags::RequiredArgument, ZyppFlags::StringType ( &that->_comment, "comments string" ),  _("Reason for specific lock.")},
+    { "from-file", 'f', ZyppFlags::RequiredArgument, ZyppFlags::StringType ( &that->_fromFile, boost::optional<const char *>(), "FILE" ),
+      // translators: -f, --from-file <FILE>
+      _("Read additional LOCKSPECs from FILE, one per line. Empty lines and lines starting with '#' are ignored, except for a '# comment:' line setting the comment of the following LOCKSPEC. Use '-' to read from stdin.")},
   }};
 }
 
@@ -53,34 +56,75 @@ void AddLocksCmd::doReset()
 {
   _kinds.clear();
   _repos.clear();
+  _comment.clear();
+  _fromFile.clear();
 }
 
 int AddLocksCmd::execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r)
 {
+  std::vector<std::string> args { positionalArgs_r };
+  std::vector<std::string> comments;	// of the LOCKSPECs read from file
+  std::vector<std::vector<std::string>> fileRepos;	// of the LOCKSPECs read from file
+  if ( ! _fromFile.empty() )
+  {
+    try
+    {
+      locks::readArgsFromFile( _fromFile, args, &comments, &fileRepos );
+    }
+    catch ( const Exception & e )
+    {
+      ZYPP_CAUGHT( e );
+      zypper.out().error( e, _("Problem reading the LOCKSPECs:") );
+      return ZYPPER_EXIT_ERR_INVALID_ARGS;
+    }
+  }
+
   // too few arguments
-  if ( positionalArgs_r.empty() )
+  if ( args.empty() )
   {
+    if ( ! _fromFile.empty() )
+    {
+      zypper.out().info( _("No lock has been added.") );
+      return ZYPPER_EXIT_OK;
+    }
     report_required_arg_missing( zypper.out(), help() );
     return ZYPPER_EXIT_ERR_INVALID_ARGS;
   }
 
   try
   {
+    // Read the locks file once, add all new locks and write it once.
     Locks & locks = Locks::instance();
-    locks.read(Pathname::assertprefix
-        (zypper.config().root_dir, ZConfig::instance().locksFile()));
-    Locks::size_type start = locks.size();
-    for_(it,positionalArgs_r.begin(),positionalArgs_r.end())
+    locks.read( locks::locksFile( zypper ) );
+    locks::LockSnapshot before { locks::snapshot( locks ) };
+
+    std::set<std::string> known;
+    for ( const auto & el : before )
+      known.insert( el.first );
+    for ( unsigned idx = 0; idx < args.size(); ++idx )
     {
-      locks.addLock( locks::arg2query( zypper, *it, _kinds, _repos, _comment ) );
+      const std::string & arg { args[idx] };
+      const std::string & comment { idx < comments.size() && ! comments[idx].empty() ? comments[idx] : _comment };
+      PoolQuery q { locks::arg2query( zypper, arg, _kinds, _repos, comment ) };
+      if ( idx < fileRepos.size() )
+      {
+        for ( const std::string & repo : fileRepos[idx] )
+          q.addRepo( repo );	// as exported, even if not known here
+      }
+      if ( known.insert( locks::lockKey( q ) ).second )
+        locks.addLock( q );
+      else
+        DBG << "Skip duplicate lock " << arg << endl;
     }
-    locks.save(Pathname::assertprefix
-        (zypper.config().root_dir, ZConfig::instance().locksFile()));
-    if ( start != Locks::instance().size() )
+    locks::saveAtomic( zypper, locks );
+
+    locks::LockSnapshot after { locks::snapshot( locks ) };
+    if ( after.size() > before.size() )
       zypper.out().info(PL_(
         "Specified lock has been successfully added.",
         "Specified locks have been successfully added.",
-        Locks::instance().size() - start));
+        after.size() - before.size()));
+    locks::reportChanges( zypper, before, after );
   }
   catch(const Exception & e)
   {
@@ -29,6 +29,7 @@ private:
   std::set<zypp::ResKind> _kinds;
   std::vector<std::string> _repos;
   std::string _comment;
+  std::string _fromFile;
 };
 
 
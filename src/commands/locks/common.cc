@@ -7,7 +7,17 @@
 /** \file commands/locks/common.cc
  * Common code used by different commands.
  */
+#include <iostream>
+#include <fstream>
+
+#include <zypp/base/String.h>
+#include <zypp/base/Logger.h>
+#include <zypp/PathInfo.h>
+#include <zypp/ZConfig.h>
+
 #include "commands/locks/common.h"
+#include "output/Out.h"
+#include "output/OutJSON.h"
 #include "repos.h"
 
 // OLD STYLE VERSIONED LOCKS:
@@ -97,5 +107,216 @@ namespace locks
     return q;
   }
 
+  std::string query2arg( const PoolQuery & q_r )
+  {
+    const PoolQuery::StrContainer & names { q_r.attribute( sat::SolvAttr::name ) };
+    if ( names.size() != 1 || ! q_r.strings().empty() || q_r.attributes().size() != 1
+         || q_r.kinds().size() != 1
+         || ! q_r.matchGlob() || ! q_r.caseSensitive() || q_r.statusFilterFlags() != PoolQuery::ALL )
+      return std::string();
+
+    str::Str ret;
+    const ResKind & kind { *q_r.kinds().begin() };
+    if ( kind != ResKind::package )
+      ret << kind << ":";
+    ret << *names.begin();
+    if ( q_r.editionRel() != Rel::ANY )
+      ret << " " << q_r.editionRel() << " " << q_r.edition();
+    return ret;
+  }
+
+  const std::string commentTag { "# comment:" };
+  const std::string repoTag { "# repo:" };
+
+  void writeArg( std::ostream & out_r, const std::string & arg_r, const std::string & comment_r, const PoolQuery::StrContainer & repos_r )
+  {
+    if ( ! comment_r.empty() )
+      out_r << commentTag << " " << str::replaceAll( comment_r, "\n", " " ) << std::endl;
+    for ( const std::string & repo : repos_r )
+      out_r << repoTag << " " << repo << std::endl;
+    out_r << arg_r << std::endl;
+  }
+
+  void readArgsFromFile( const Pathname & file_r, std::vector<std::string> & args_r, std::vector<std::string> * comments_r,
+                         std::vector<std::vector<std::string>> * repos_r )
+  {
+    std::ifstream infile;
+    if ( file_r != "-" )
+    {
+      infile.open( file_r.c_str() );
+      if ( ! infile )
+        ZYPP_THROW( Exception( str::Format(_("Can not read file '%1%'.") ) % file_r ) );
+    }
+    std::istream & in { file_r == "-" ? std::cin : infile };
+
+    if ( comments_r )
+      comments_r->resize( args_r.size() );
+    if ( repos_r )
+      repos_r->resize( args_r.size() );
+
+    unsigned count = 0;
+    std::string comment;	// for the next LOCKSPEC
+    std::vector<std::string> repos;	// for the next LOCKSPEC
+    for ( std::string line; std::getline( in, line ); )
+    {
+      line = str::trim( line );
+      if ( str::hasPrefix( line, commentTag ) )
+      {
+        comment = str::trim( line.substr( commentTag.size() ) );
+        continue;
+      }
+      if ( str::hasPrefix( line, repoTag ) )
+      {
+        repos.push_back( str::trim( line.substr( repoTag.size() ) ) );
+        continue;
+      }
+      if ( line.empty() || line[0] == '#' )
+        continue;
+      args_r.push_back( std::move(line) );
+      if ( comments_r )
+        comments_r->push_back( std::move(comment) );
+      if ( repos_r )
+        repos_r->push_back( std::move(repos) );
+      comment.clear();
+      repos.clear();
+      ++count;
+    }
+    if ( in.bad() )
+      ZYPP_THROW( Exception( str::Format(_("Can not read file '%1%'.") ) % file_r ) );
+    MIL << "Read " << count << " LOCKSPECs from " << file_r << endl;
+  }
+
+  Pathname locksFile( Zypper & zypper )
+  { return Pathname::assertprefix( zypper.config().root_dir, ZConfig::instance().locksFile() ); }
+
+  std::string lockKey( const PoolQuery & q_r )
+  {
+    str::Str ret;
+    q_r.serialize( ret.stream() );
+    return ret;
+  }
+
+  LockSnapshot snapshot( const Locks & locks_r )
+  {
+    LockSnapshot ret;
+    for ( const PoolQuery & q : locks_r )
+      ret.emplace( lockKey( q ), q );
+    return ret;
+  }
+
+  void saveAtomic( Zypper & zypper, Locks & locks_r )
+  {
+    Pathname file { locksFile( zypper ) };
+    Pathname tmpfile { file.extend( ".new" ) };
+    if ( PathInfo( tmpfile ).isExist() )
+      filesystem::unlink( tmpfile );
+
+    locks_r.save( tmpfile );	// does not write anything if there are no changes
+    if ( ! PathInfo( tmpfile ).isExist() )
+    {
+      DBG << "No changes to save in " << file << endl;
+      return;
+    }
+    if ( filesystem::rename( tmpfile, file ) != 0 )
+    {
+      filesystem::unlink( tmpfile );
+      ZYPP_THROW( Exception( str::Format(_("Can not write file '%1%'.") ) % file ) );
+    }
+    MIL << "Saved " << locks_r.size() << " locks to " << file << endl;
+  }
+
+  void reportChanges( Zypper & zypper, const LockSnapshot & before_r, const LockSnapshot & after_r )
+  {
+    if ( zypper.out().type() != Out::TYPE_XML && zypper.out().type() != OutJSON::TYPE_JSON )
+      return;
+
+    std::vector<const PoolQuery *> added;
+    std::vector<const PoolQuery *> removed;
+    for ( const auto & el : after_r )
+      if ( ! before_r.count( el.first ) )
+        added.push_back( &el.second );
+    for ( const auto & el : before_r )
+      if ( ! after_r.count( el.first ) )
+        removed.push_back( &el.second );
+
+    if ( zypper.out().type() == OutJSON::TYPE_JSON )
+    {
+      auto jsonArray = []( const auto & vals_r ) {
+        std::string ret { "[" };
+        for ( const auto & val : vals_r )
+        {
+          if ( ret.size() > 1 )
+            ret += ",";
+          ret += "\"" + OutJSON::escape( str::asString( val ) ) + "\"";
+        }
+        return ret + "]";
+      };
+      std::string locks { "[" };
+      auto jsonLock = [&]( const char * action_r, const PoolQuery & q_r ) {
+        if ( locks.size() > 1 )
+          locks += ",";
+        std::vector<std::string> names;
+        for ( const std::string & val : q_r.attribute( sat::SolvAttr::name ) )
+          names.push_back( val );
+        for ( const std::string & val : q_r.strings() )
+          names.push_back( val );
+        locks += std::string( "{\"action\":\"" ) + action_r + "\""
+               + ",\"names\":" + jsonArray( names )
+               + ",\"types\":" + jsonArray( q_r.kinds() )
+               + ",\"repos\":" + jsonArray( q_r.repos() );
+        if ( q_r.editionRel() != Rel::ANY )
+        {
+          locks += ",\"range\":{\"flag\":\"" + OutJSON::escape( q_r.editionRel().asString() ) + "\"";
+          if ( q_r.editionRel() != Rel::NONE )
+            locks += ",\"edition\":\"" + OutJSON::escape( q_r.edition().asString() ) + "\"";
+          locks += "}";
+        }
+        locks += "}";
+      };
+      for ( const PoolQuery * q : added )
+        jsonLock( "added", *q );
+      for ( const PoolQuery * q : removed )
+        jsonLock( "removed", *q );
+      locks += "]";
+
+      OutJSON::Line( "locks-changed" )
+        .add( "added", added.size() )
+        .add( "removed", removed.size() )
+        .addRaw( "locks", locks );
+      return;
+    }
+
+    auto writeLock = []( std::ostream & str_r, const char * action_r, const PoolQuery & q_r ) {
+      xmlout::Node lock( str_r, "lock", { { "action", action_r } } );
+      for ( const std::string & val : q_r.attribute( sat::SolvAttr::name ) )
+      { *xmlout::Node( *lock, "name" ) << val; }
+      for ( const std::string & val : q_r.strings() )
+      { *xmlout::Node( *lock, "name" ) << val; }
+      for ( const ResKind & kind : q_r.kinds() )
+      { *xmlout::Node( *lock, "type" ) << kind; }
+      for ( const std::string & repo : q_r.repos() )
+      { *xmlout::Node( *lock, "repo" ) << repo; }
+      if ( q_r.editionRel() != Rel::ANY )
+      {
+        xmlout::Node range { *lock, "range", xmlout::Node::optionalContent, { { "flag", q_r.editionRel() } } };
+        if ( q_r.editionRel() != Rel::NONE )
+          range.addAttr( {
+            { "epoch",   q_r.edition().epoch() },
+            { "version", q_r.edition().version() },
+            { "release", q_r.edition().release() },
+          } );
+      }
+    };
+
+    xmlout::Node changes( std::cout, "locks-changed", xmlout::Node::optionalContent, {
+      { "added",	added.size() },
+      { "removed",	removed.size() },
+    } );
+    for ( const PoolQuery * q : added )
+      writeLock( *changes, "added", *q );
+    for ( const PoolQuery * q : removed )
+      writeLock( *changes, "removed", *q );
+  }
+
 } // namespace locks
 ///////////////////////////////////////////////////////////////////
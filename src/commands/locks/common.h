@@ -10,7 +10,11 @@
 #ifndef ZYPPER_COMMANDS_LOCKS_COMMON_H_INCLUDED
 #define ZYPPER_COMMANDS_LOCKS_COMMON_H_INCLUDED
 
+#include <iosfwd>
+#include <map>
+
 #include <zypp/PoolQuery.h>
+#include <zypp/Locks.h>
 
 #include "Zypper.h"
 
@@ -21,6 +25,60 @@ namespace locks
    */
   zypp::PoolQuery arg2query( Zypper & zypper, const std::string & arg_r, const std::set<zypp::ResKind> & kinds_r, const std::vector<std::string> & repos_r, const std::string & comment_r );
 
+  /** Translate a lock back into a LOCKSPEC accepted by \ref arg2query.
+   * The repositories the lock is restricted to are not part of the LOCKSPEC
+   * (see \ref writeArg). Locks not expressible as a LOCKSPEC (no or multiple
+   * names, multiple or no kinds,...) return an empty string.
+   */
+  std::string query2arg( const zypp::PoolQuery & q_r );
+
+  /** Prefix of the line holding the comment of the following LOCKSPEC (\ref writeArg). */
+  extern const std::string commentTag;
+
+  /** Prefix of a line holding a repository the following LOCKSPEC is restricted to (\ref writeArg). */
+  extern const std::string repoTag;
+
+  /** Write a LOCKSPEC line for \ref readArgsFromFile, preceded by a
+   * \ref commentTag line if the lock has a \a comment_r and a \ref repoTag
+   * line per repository alias in \a repos_r.
+   */
+  void writeArg( std::ostream & out_r, const std::string & arg_r, const std::string & comment_r,
+                 const zypp::PoolQuery::StrContainer & repos_r = zypp::PoolQuery::StrContainer() );
+
+  /** Append the LOCKSPECs read from \a file_r ("-" is stdin) to \a args_r.
+   * One LOCKSPEC per line, empty lines and lines starting with '#' are ignored.
+   * If \a comments_r is not NULL, it's resized to match \a args_r and gets the
+   * comments of the LOCKSPECs read (a \ref commentTag line preceding a LOCKSPEC).
+   * Likewise \a repos_r gets the repository aliases of the \ref repoTag lines
+   * preceding a LOCKSPEC.
+   * \throws zypp::Exception if the file can not be read.
+   */
+  void readArgsFromFile( const zypp::Pathname & file_r, std::vector<std::string> & args_r, std::vector<std::string> * comments_r = nullptr,
+                         std::vector<std::vector<std::string>> * repos_r = nullptr );
+
+  /** The locks file below the target root. */
+  zypp::Pathname locksFile( Zypper & zypper );
+
+  /** Identity of a lock (it's serialized form). */
+  std::string lockKey( const zypp::PoolQuery & q_r );
+
+  /** Snapshot of the locks in \ref zypp::Locks, indexed by \ref lockKey. */
+  typedef std::map<std::string,zypp::PoolQuery> LockSnapshot;
+  LockSnapshot snapshot( const zypp::Locks & locks_r );
+
+  /** Save pending changes of \a locks_r to the locks file.
+   * The new content is written to a temporary file which then replaces the
+   * locks file, so concurrent readers see either the old or the new locks.
+   * If there is nothing to save, the locks file is not touched.
+   * \throws zypp::Exception if writing the file failed.
+   */
+  void saveAtomic( Zypper & zypper, zypp::Locks & locks_r );
+
+  /** Write the locks in \a after_r not in \a before_r (added) and vice versa (removed)
+   * as \c <locks-changed> element or \c locks-changed JSON line (XML and JSON output only).
+   */
+  void reportChanges( Zypper & zypper, const LockSnapshot & before_r, const LockSnapshot & after_r );
+
 } // namespace locks
 ///////////////////////////////////////////////////////////////////
 #endif // ZYPPER_COMMANDS_LOCKS_COMMON_H_INCLUDED
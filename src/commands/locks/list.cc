@@ -7,6 +7,8 @@
 #include "list.h"
 
 #include <iostream>
+#include <fstream>
+#include <optional>
 #include <boost/lexical_cast.hpp>
 
 #include <zypp/base/String.h>
@@ -17,6 +19,8 @@
 #include "Table.h"
 #include "Zypper.h"
 #include "main.h"
+#include "commands/locks/common.h"
+#include "commands/locks/matcher.h"
 
 #include "utils/flags/zyppflags.h"
 #include "utils/flags/flagtypes.h"
@@ -115,11 +119,12 @@ namespace out
         if ( _withMatches )
         {
           // <matches>
-          xmlout::Node matches( *lock, "matches", xmlout::Node::optionalContent, { { "size", q_r.size() } } );
-          if ( _withSolvables && !q_r.empty() )
+          const locks::LockMatcher::Matches & m { _matcher->matches( _i-1 ) };
+          xmlout::Node matches( *lock, "matches", xmlout::Node::optionalContent, { { "size", m.size() } } );
+          if ( _withSolvables && !m.empty() )
           {
             MatchDetails d;
-            getLockDetails( q_r, d );
+            getLockDetails( m, d );
             xmlWriteContainer( *matches, d, MatchDetailFormater() );
           }
         }
@@ -160,7 +165,7 @@ namespace out
 
       // opt Matches
       if ( _withMatches )
-        tr << q_r.size();
+        tr << _matcher->matches( _i-1 ).size();
 
       // Type
       std::set<std::string> strings;
@@ -177,11 +182,11 @@ namespace out
       tr << q_r.comment();
 
       // opt Solvables as detail
-      if ( _withSolvables && !q_r.empty() )
+      if ( _withSolvables && !_matcher->matches( _i-1 ).empty() )
       {
         MatchDetails i;
         MatchDetails a;
-        getLockDetails( q_r, i, a );
+        getLockDetails( _matcher->matches( _i-1 ), i, a );
 
         PropertyTable p;
         {
@@ -209,9 +214,11 @@ namespace out
       return tr;
     }
 
-    LocksTableFormater( bool withSolvables, bool withMatches )
+    /** \a matcher_r is required if \a withSolvables or \a withMatches */
+    LocksTableFormater( bool withSolvables, bool withMatches, const locks::LockMatcher * matcher_r = nullptr )
     : _withSolvables( withSolvables )
     , _withMatches( _withSolvables || withMatches )
+    , _matcher( matcher_r )
     {}
 
   private:
@@ -236,16 +243,17 @@ namespace out
       return ret;
     }
 
-    static void getLockDetails( const PoolQuery & q_r, MatchDetails & i_r, MatchDetails & a_r )
-    { for ( const auto & solv : q_r ) { (solv.isSystem()?i_r:a_r).insert( solv ); } }
+    static void getLockDetails( const locks::LockMatcher::Matches & m_r, MatchDetails & i_r, MatchDetails & a_r )
+    { for ( const auto & solv : m_r ) { (solv.isSystem()?i_r:a_r).insert( solv ); } }
 
-    static void getLockDetails( const PoolQuery & q_r, MatchDetails & d_r )
-    { getLockDetails( q_r, d_r, d_r ); }
+    static void getLockDetails( const locks::LockMatcher::Matches & m_r, MatchDetails & d_r )
+    { getLockDetails( m_r, d_r, d_r ); }
 
   private:
     bool _withSolvables	:1;	//< include match details (implies _withMatches)
     bool _withMatches	:1;	//< include number of matches
     mutable unsigned _i = 0;	//< Lock Number
+    const locks::LockMatcher * _matcher;	//< matches per lock (if _withMatches)
   };
 } // namespace out
 ///////////////////////////////////////////////////////////////////
@@ -277,15 +285,21 @@ void ListLocksCmd::doReset()
 {
   _matches = false;
   _solvables = false;
+  _export.clear();
 }
 
 ZyppFlags::CommandGroup ListLocksCmd::cmdOptions() const
 {
   return {{
-    {
-      { "matches", 'm', ZyppFlags::NoArgument, ZyppFlags::BoolType( const_cast<bool *>(&_matches), ZyppFlags::StoreTrue, _matches), _("Show the number of resolvables matched by each lock.") },
-      { "solvables", 's', ZyppFlags::NoArgument, ZyppFlags::BoolType( const_cast<bool *>(&_solvables), ZyppFlags::StoreTrue, _solvables), _("List the resolvables matched by each lock.")}
-    }
+    { "matches", 'm', ZyppFlags::NoArgument, ZyppFlags::BoolType( const_cast<bool *>(&_matches), ZyppFlags::StoreTrue, _matches), _("Show the number of resolvables matched by each lock.") },
+    { "solvables", 's', ZyppFlags::NoArgument, ZyppFlags::BoolType( const_cast<bool *>(&_solvables), ZyppFlags::StoreTrue, _solvables), _("List the resolvables matched by each lock.")},
+    { "export", '\0', ZyppFlags::RequiredArgument, ZyppFlags::StringType( const_cast<std::string *>(&_export), boost::optional<const char *>(), "FILE" ),
+      // translators: --export <FILE>
+      _("Write the locks as LOCKSPECs to FILE, suitable for 'addlock --from-file'. Use '-' to write to stdout.") }
+  },{
+    //conflicting flags
+    { "export", "matches" },
+    { "export", "solvables" }
   }};
 }
 
@@ -302,12 +316,63 @@ int ListLocksCmd::execute(Zypper &zypper, const std::vector<std::string> &positi
     return ZYPPER_EXIT_ERR_ZYPP;
   }
 
+  if ( ! _export.empty() )
+    return exportLocks( zypper, locks );
+
+  // evaluate all locks in a single pass over the pool
+  std::optional<locks::LockMatcher> matcher;
+  if ( _matches || _solvables )
+    matcher.emplace( locks );
+
   // show result
   Out & out( zypper.out() );
   out.gap();
   out.table( "locks", locks.empty() ? _("There are no package locks defined.") : "",
-             locks, out::LocksTableFormater( _solvables, _matches ) );
+             locks, out::LocksTableFormater( _solvables, _matches, matcher ? &*matcher : nullptr ) );
   out.gap();
 
   return 0;
 }
+
+int ListLocksCmd::exportLocks( Zypper & zypper, const Locks & locks_r ) const
+{
+  std::ofstream outfile;
+  if ( _export != "-" )
+  {
+    outfile.open( _export.c_str() );
+    if ( ! outfile )
+    {
+      zypper.out().error( str::Format(_("Can not write file '%1%'.") ) % _export );
+      return ZYPPER_EXIT_ERR_ZYPP;
+    }
+  }
+  std::ostream & out { _export == "-" ? std::cout : outfile };
+
+  unsigned exported = 0;
+  unsigned skipped = 0;
+  unsigned number = 0;
+  for ( const PoolQuery & q : locks_r )
+  {
+    ++number;
+    const std::string & spec { locks::query2arg( q ) };
+    if ( spec.empty() )
+    {
+      zypper.out().warning( str::Format(_("Lock %1% can not be expressed as LOCKSPEC and is not exported.") ) % number );
+      ++skipped;
+      continue;
+    }
+    locks::writeArg( out, spec, q.comment(), q.repos() );
+    ++exported;
+  }
+
+  if ( ! out.flush() )
+  {
+    zypper.out().error( str::Format(_("Can not write file '%1%'.") ) % _export );
+    return ZYPPER_EXIT_ERR_ZYPP;
+  }
+  if ( _export != "-" )
+    zypper.out().info( str::Format(PL_("%1% lock has been exported.", "%1% locks have been exported.", exported) ) % exported );
+  if ( skipped )
+    zypper.out().warning( str::Format(PL_("%1% lock has not been exported.", "%1% locks have not been exported.", skipped) ) % skipped );
+  return ZYPPER_EXIT_OK;
+}
@@ -10,6 +10,8 @@
 #include "commands/basecommand.h"
 #include "utils/flags/zyppflags.h"
 
+#include <zypp/Locks.h>
+
 class ListLocksCmd : public ZypperBaseCommand
 {
 public:
@@ -24,9 +26,13 @@ protected:
   void doReset() override;
   int systemSetup(Zypper &zypper) override;
 
+private:
+  int exportLocks( Zypper &zypper, const zypp::Locks & locks_r ) const;
+
 private:
   bool _matches   = false;
   bool _solvables = false;
+  std::string _export;
 };
 
 
@@ -0,0 +1,197 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+/** \file commands/locks/matcher.cc
+ * Evaluate all locks in a single pass over the pool.
+ */
+#include <unordered_map>
+#include <unordered_set>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/base/StrMatcher.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/RelCompare.h>
+
+#include "commands/locks/matcher.h"
+
+///////////////////////////////////////////////////////////////////
+namespace locks
+{
+  using namespace zypp;
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    /** A glob without special chars matches exactly. */
+    inline bool isPlainGlob( const std::string & pattern_r )
+    { return pattern_r.find_first_of( "*?[\\" ) == std::string::npos; }
+
+    /** The per lock filters applied after a name matched. */
+    struct LockFilter
+    {
+      LockFilter( const PoolQuery & q_r )
+      : _kinds { q_r.kinds() }
+      , _repos { q_r.repos().begin(), q_r.repos().end() }
+      , _op { q_r.editionRel() }
+      , _edition { q_r.edition() }
+      {}
+
+      bool operator()( const sat::Solvable & solv_r ) const
+      {
+        if ( ! _kinds.empty() && ! solv_r.isKind( _kinds.begin(), _kinds.end() ) )
+          return false;
+        if ( ! _repos.empty() && ! _repos.count( solv_r.repository().alias() ) )
+          return false;
+        if ( _op != Rel::ANY && ! compareByRel( _op, solv_r.edition(), _edition, Edition::Match() ) )
+          return false;
+        return true;
+      }
+
+      std::set<ResKind> _kinds;
+      std::unordered_set<std::string> _repos;
+      Rel _op;
+      Edition _edition;
+    };
+
+    /** A name pattern which can not be looked up in the hash. */
+    struct PatternMatcher
+    {
+      StrMatcher _matcher;
+      unsigned _lock;
+    };
+
+    /** Whether we are able to compile the query or need to ask the query itself. */
+    inline bool isCompilable( const PoolQuery & q_r )
+    {
+      // Locks without name (like '(any)' or complex locks) may carry
+      // predicates we can not see from outside.
+      if ( q_r.attribute( sat::SolvAttr::name ).empty() )
+        return false;
+      if ( ! q_r.strings().empty() )
+        return false;
+      for ( const auto & attr : q_r.attributes() )
+      {
+        if ( attr.first != sat::SolvAttr::name )
+          return false;
+      }
+      if ( q_r.statusFilterFlags() != PoolQuery::ALL )
+        return false;
+      return true;
+    }
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  LockMatcher::LockMatcher( const Locks & locks_r )
+  : _matches( locks_r.size() )
+  {
+    std::vector<LockFilter> filters;
+    filters.reserve( locks_r.size() );
+    std::unordered_map<std::string,std::vector<unsigned>> exactNames;
+    std::unordered_map<std::string,std::vector<unsigned>> exactNamesNocase;
+    std::vector<PatternMatcher> patterns;
+    std::vector<unsigned> fallback;
+
+    // compile...
+    unsigned idx = 0;
+    for ( const PoolQuery & q : locks_r )
+    {
+      filters.push_back( LockFilter( q ) );
+      if ( ! isCompilable( q ) )
+      {
+        fallback.push_back( idx++ );
+        continue;
+      }
+
+      bool compiled = true;
+      std::vector<PatternMatcher> lockPatterns;
+      for ( const std::string & name : q.attribute( sat::SolvAttr::name ) )
+      {
+        if ( ! q.matchWord() && ( q.matchExact() || ( q.matchGlob() && isPlainGlob( name ) ) ) )
+        {
+          if ( q.caseSensitive() )
+            exactNames[name].push_back( idx );
+          else
+            exactNamesNocase[str::toLower( name )].push_back( idx );
+        }
+        else
+        {
+          try
+          {
+            StrMatcher matcher( name, q.flags() );
+            matcher.compile();	// throws on invalid regex
+            lockPatterns.push_back( PatternMatcher{ std::move(matcher), idx } );
+          }
+          catch ( const Exception & excpt )
+          {
+            ZYPP_CAUGHT( excpt );
+            compiled = false;
+            break;
+          }
+        }
+      }
+
+      if ( compiled )
+        std::move( lockPatterns.begin(), lockPatterns.end(), std::back_inserter(patterns) );
+      else
+        fallback.push_back( idx );	// let the query report the error
+      ++idx;
+    }
+    MIL << "Compiled locks: " << exactNames.size() << " exact names, " << exactNamesNocase.size() << " nocase names, "
+        << patterns.size() << " patterns, " << fallback.size() << " fallback queries" << endl;
+
+    // ...and scan the pool once
+    if ( exactNames.size() || exactNamesNocase.size() || patterns.size() )
+    {
+      std::vector<sat::detail::SolvableIdType> lastMatch( locks_r.size(), sat::detail::noSolvableId );
+      auto addMatch = [&]( unsigned lock_r, const sat::Solvable & solv_r ) {
+        if ( lastMatch[lock_r] == solv_r.id() )
+          return;	// lock has multiple names matching the same solvable
+        if ( filters[lock_r]( solv_r ) )
+        {
+          lastMatch[lock_r] = solv_r.id();
+          _matches[lock_r].push_back( solv_r );
+        }
+      };
+
+      for ( const sat::Solvable & solv : sat::Pool::instance().solvables() )
+      {
+        const std::string & name { solv.name() };
+        if ( ! exactNames.empty() )
+        {
+          auto it = exactNames.find( name );
+          if ( it != exactNames.end() )
+            for ( unsigned lock : it->second )
+              addMatch( lock, solv );
+        }
+        if ( ! exactNamesNocase.empty() )
+        {
+          auto it = exactNamesNocase.find( str::toLower( name ) );
+          if ( it != exactNamesNocase.end() )
+            for ( unsigned lock : it->second )
+              addMatch( lock, solv );
+        }
+        for ( const PatternMatcher & pattern : patterns )
+        {
+          if ( pattern._matcher.doMatch( name.c_str() ) )
+            addMatch( pattern._lock, solv );
+        }
+      }
+    }
+
+    // queries we were not able to compile
+    for ( unsigned lock : fallback )
+    {
+      Locks::const_iterator it { locks_r.begin() };
+      std::advance( it, lock );
+      _matches[lock].assign( it->begin(), it->end() );
+    }
+  }
+
+  const LockMatcher::Matches & LockMatcher::matches( unsigned idx_r ) const
+  { return _matches.at( idx_r ); }
+
+} // namespace locks
+///////////////////////////////////////////////////////////////////
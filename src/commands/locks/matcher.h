@@ -0,0 +1,51 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+/** \file commands/locks/matcher.h
+ * Evaluate all locks in a single pass over the pool.
+ */
+#ifndef ZYPPER_COMMANDS_LOCKS_MATCHER_H_INCLUDED
+#define ZYPPER_COMMANDS_LOCKS_MATCHER_H_INCLUDED
+
+#include <vector>
+
+#include <zypp/Locks.h>
+#include <zypp/sat/Solvable.h>
+
+///////////////////////////////////////////////////////////////////
+namespace locks
+{
+  /** Compute the solvables matched by each lock.
+   *
+   * Evaluating each locks \ref zypp::PoolQuery on it's own means a full pool
+   * scan per lock. Instead the name patterns of all locks are compiled into
+   * one matcher (a hash of exact names plus a list of glob/regex/substring
+   * matchers), which is applied in a single pass over the pool. Kind, repo
+   * and edition restrictions are checked per candidate lock.
+   *
+   * Locks using query features the matcher does not know about (e.g. locks
+   * without name, other attributes or status filters) still evaluate their
+   * own \ref zypp::PoolQuery, so the result is identical.
+   *
+   * Results are indexed like the locks in the container passed to the ctor.
+   */
+  class LockMatcher
+  {
+  public:
+    typedef std::vector<zypp::sat::Solvable> Matches;
+
+    LockMatcher( const zypp::Locks & locks_r );
+
+    /** The solvables matched by the \a idx_r-th lock. */
+    const Matches & matches( unsigned idx_r ) const;
+
+  private:
+    std::vector<Matches> _matches;
+  };
+
+} // namespace locks
+///////////////////////////////////////////////////////////////////
+#endif // ZYPPER_COMMANDS_LOCKS_MATCHER_H_INCLUDED
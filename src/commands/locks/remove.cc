@@ -43,7 +43,10 @@ ZyppFlags::CommandGroup RemoveLocksCmd::cmdOptions() const
   return {{
     CommonFlags::resKindSetFlag( that->_kinds ),
     { "repo", 'r', ZyppFlags::RequiredArgument | ZyppFlags::Repeatable, ZyppFlags::StringVectorType ( &that->_repos, "ALIAS|#|URI" ),  _("Remove only locks with specified repository.") },
-    { "catalog", 'c', ZyppFlags::RequiredArgument | ZyppFlags::Repeatable | ZyppFlags::Hidden, ZyppFlags::StringVectorType ( &that->_repos, "ALIAS|#|URI"),  "Alias for --repo" }
+    { "catalog", 'c', ZyppFlags::RequiredArgument | ZyppFlags::Repeatable | ZyppFlags::Hidden, ZyppFlags::StringVectorType ( &that->_repos, "ALIAS|#|URI"),  "Alias for --repo" },
+    { "from-file", 'f', ZyppFlags::RequiredArgument, ZyppFlags::StringType ( &that->_fromFile, boost::optional<const char *>(), "FILE" ),
+      // translators: -f, --from-file <FILE>
+      _("Read additional locks to remove from FILE, one per line. Empty lines and lines starting with '#' are ignored. Use '-' to read from stdin.") }
   }};
 }
 
@@ -51,24 +54,47 @@ void RemoveLocksCmd::doReset()
 {
   _kinds.clear();
   _repos.clear();
+  _fromFile.clear();
 }
 
 int RemoveLocksCmd::execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r)
 {
+  std::vector<std::string> args { positionalArgs_r };
+  std::vector<std::vector<std::string>> fileRepos;	// of the LOCKSPECs read from file
+  if ( ! _fromFile.empty() )
+  {
+    try
+    {
+      locks::readArgsFromFile( _fromFile, args, nullptr, &fileRepos );
+    }
+    catch ( const Exception & e )
+    {
+      ZYPP_CAUGHT( e );
+      zypper.out().error( e, _("Problem reading the LOCKSPECs:") );
+      return ZYPPER_EXIT_ERR_INVALID_ARGS;
+    }
+  }
+
   // too few arguments
-  if ( positionalArgs_r.empty() )
+  if ( args.empty() )
   {
+    if ( ! _fromFile.empty() )
+    {
+      zypper.out().info(_("No lock has been removed."));
+      return ZYPPER_EXIT_OK;
+    }
     report_required_arg_missing( zypper.out(), help() );
     return ZYPPER_EXIT_ERR_INVALID_ARGS;
   }
 
   try
   {
+    // Read the locks file once, remove all locks and write it once.
     Locks & locks = Locks::instance();
-    locks.read(Pathname::assertprefix
-        (zypper.config().root_dir, ZConfig::instance().locksFile()));
+    locks.read( locks::locksFile( zypper ) );
+    locks::LockSnapshot before { locks::snapshot( locks ) };
     Locks::size_type start = locks.size();
-    for_( args_it, positionalArgs_r.begin(), positionalArgs_r.end() )
+    for_( args_it, args.begin(), args.end() )
     {
       Locks::const_iterator it = locks.begin();
       Locks::LockList::size_type i = 0;
@@ -82,12 +108,18 @@ int RemoveLocksCmd::execute(Zypper &zypper, const std::vector<std::string> &posi
       }
       else //package name
       {
-        locks.removeLock( locks::arg2query( zypper, *args_it, _kinds, _repos, "" ) );
+        PoolQuery q { locks::arg2query( zypper, *args_it, _kinds, _repos, "" ) };
+        unsigned idx = args_it - args.begin();
+        if ( idx < fileRepos.size() )
+        {
+          for ( const std::string & repo : fileRepos[idx] )
+            q.addRepo( repo );
+        }
+        locks.removeLock( q );
       }
     }
 
-    locks.save(Pathname::assertprefix
-        (zypper.config().root_dir, ZConfig::instance().locksFile()));
+    locks::saveAtomic( zypper, locks );
 
     // nothing removed
     if (start == locks.size())
@@ -98,6 +130,7 @@ int RemoveLocksCmd::execute(Zypper &zypper, const std::vector<std::string> &posi
         "%zu lock has been successfully removed.",
         "%zu locks have been successfully removed.",
         start - locks.size()), start - locks.size()));
+    locks::reportChanges( zypper, before, locks::snapshot( locks ) );
   }
   catch(const Exception & e)
   {
@@ -25,7 +25,7 @@ NeedsRebootingCmd::NeedsRebootingCmd(std::vector<std::string> &&commandAliases_r
       "Exit code ZYPPER_EXIT_INF_REBOOT_NEEDED indicates that a reboot is suggested, otherwise the exit code is set to ZYPPER_EXIT_OK."),
       _("This is the recommended way for scripts to test whether a system reboot is suggested.")
     },
-    DisableAll
+    NoZYpp
 )
 {}
 
@@ -172,7 +172,7 @@ std::vector<ZyppFlags::CommandGroup> DownloadOptionSet::options()
 {
   // All the flags are defined as Repeatable, even though they do not fill a list, we want it to be possible to override
   // the download mode. This is more in sync with the previous behaviour
-  return {{{
+  std::vector<ZyppFlags::CommandGroup> ret {{{
         { "download", '\0', ZyppFlags::RequiredArgument | ZyppFlags::Repeatable, DownloadModeArgType( *this, _mode ),
               // translators: --download
               str::Format(_("Set the download-install mode. Available modes: %s") ) % "only, in-advance, in-heaps, as-needed"
@@ -185,6 +185,17 @@ std::vector<ZyppFlags::CommandGroup> DownloadOptionSet::options()
         { "download-in-heaps",   '\0', ZyppFlags::NoArgument | ZyppFlags::Repeatable | ZyppFlags::Hidden, DownloadModeNoArgType( *this, DownloadMode::DownloadInHeaps ), "" },
         { "download-as-needed",  '\0', ZyppFlags::NoArgument | ZyppFlags::Repeatable | ZyppFlags::Hidden, DownloadModeNoArgType( *this, DownloadMode::DownloadAsNeeded ), "" }
   }}};
+  if ( _cmdMode == DownloadOptionSet::Default )
+  {
+    ret.front().options.push_back(
+        { "export-bundle", '\0', ZyppFlags::RequiredArgument, ZyppFlags::StringType( &TransactionBundleSettings::instanceNoConst()._exportDir, boost::optional<const char *>(), ARG_DIR ),
+              // translators: --export-bundle <DIR>
+              _("Download the packages and save them together with the solved transaction in a bundle directory, do not install. Use 'zypper apply-bundle' to install the bundle on another system.")
+        } );
+    // a dry run downloads nothing to bundle
+    ret.front().conflictingOptions.push_back( { "export-bundle", "dry-run" } );
+  }
+  return ret;
 }
 
 void DownloadOptionSet::reset()
@@ -0,0 +1,438 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+/** \file commands/ps-scan.cc
+ * Find running processes using deleted files.
+ */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <pwd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+
+#include "commands/ps-scan.h"
+
+///////////////////////////////////////////////////////////////////
+namespace ps
+{
+  using namespace zypp;
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    typedef DeletedFilesScanner::Mapping Mapping;
+    typedef DeletedFilesScanner::ProcEntry ProcEntry;
+
+    const std::string magic { "# zypper ps cache v1" };
+
+    /** stat(2) results of the current scan (one per worker, so no locking). */
+    struct StatMemo
+    {
+      /** \c false if \a path_r does not exist. */
+      bool get( const std::string & path_r, unsigned long long & dev_r, unsigned long long & ino_r )
+      {
+        auto it = _memo.find( path_r );
+        if ( it == _memo.end() )
+        {
+          struct stat st;
+          Value v;
+          if ( ::stat( path_r.c_str(), &st ) == 0 )
+            v = Value { true, st.st_dev, st.st_ino };
+          it = _memo.emplace( path_r, v ).first;
+        }
+        dev_r = it->second._dev;
+        ino_r = it->second._ino;
+        return it->second._exists;
+      }
+
+    private:
+      struct Value
+      {
+        bool _exists = false;
+        unsigned long long _dev = 0;
+        unsigned long long _ino = 0;
+      };
+      std::unordered_map<std::string,Value> _memo;
+    };
+
+    /** The root directory of this process (to skip processes running in containers). */
+    struct RootDir
+    {
+      RootDir( const Pathname & procDir_r )
+      : _procDir { procDir_r }
+      {
+        struct stat st;
+        if ( ::stat( "/proc/self/root", &st ) == 0 )
+        {
+          _dev = st.st_dev;
+          _ino = st.st_ino;
+        }
+      }
+
+      bool isOurs( const std::string & pid_r ) const
+      {
+        struct stat st;
+        if ( ::stat( ( _procDir / pid_r / "root" ).c_str(), &st ) != 0 )
+          return true;	// let reading the maps decide
+        return st.st_dev == _dev && st.st_ino == _ino;
+      }
+
+      Pathname _procDir;
+      unsigned long long _dev = 0;
+      unsigned long long _ino = 0;
+    };
+
+    std::vector<std::string> listPids( const Pathname & procDir_r )
+    {
+      std::vector<std::string> ret;
+      DIR * dir = ::opendir( procDir_r.c_str() );
+      if ( ! dir )
+      {
+        ERR << "Can not read " << procDir_r << endl;
+        return ret;
+      }
+      while ( struct dirent * ent = ::readdir( dir ) )
+      {
+        const char * name = ent->d_name;
+        if ( *name && std::string( name ).find_first_not_of( "0123456789" ) == std::string::npos )
+          ret.push_back( name );
+      }
+      ::closedir( dir );
+      return ret;
+    }
+
+    std::string bootId( const Pathname & procDir_r )
+    {
+      std::ifstream infile( ( procDir_r / "sys/kernel/random/boot_id" ).c_str() );
+      std::string ret;
+      std::getline( infile, ret );
+      return ret;
+    }
+
+    /** The result of scanning a single process. */
+    struct ProcResult
+    {
+      bool _valid = false;	//< process vanished or is not accessible
+      ProcInfo _info;
+      uid_t _uid = 0;
+      ProcEntry _entry;
+    };
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  namespace
+  {
+    /** Parse /proc/PID/stat (comm, ppid, starttime, vsize). */
+    bool readStat( const Pathname & procDir_r, const std::string & pid_r, ProcResult & res_r )
+    {
+      std::ifstream infile( ( procDir_r / pid_r / "stat" ).c_str() );
+      std::string line;
+      if ( ! std::getline( infile, line ) )
+        return false;
+
+      // "PID (COMM) STATE PPID ..." COMM may contain blanks and parens
+      std::string::size_type lpar = line.find( '(' );
+      std::string::size_type rpar = line.rfind( ')' );
+      if ( lpar == std::string::npos || rpar == std::string::npos || rpar < lpar )
+        return false;
+      res_r._info.command = line.substr( lpar+1, rpar-lpar-1 );
+
+      std::vector<std::string> fields;
+      str::split( line.substr( rpar+1 ), std::back_inserter(fields) );
+      if ( fields.size() < 21 )
+        return false;
+      res_r._info.ppid = fields[1];
+      res_r._entry._starttime = fields[19];
+      res_r._entry._vsize = fields[20];
+      return true;
+    }
+
+    /** The real UID from /proc/PID/status. */
+    bool readUid( const Pathname & procDir_r, const std::string & pid_r, ProcResult & res_r )
+    {
+      std::ifstream infile( ( procDir_r / pid_r / "status" ).c_str() );
+      for ( std::string line; std::getline( infile, line ); )
+      {
+        if ( str::hasPrefix( line, "Uid:" ) )
+        {
+          std::vector<std::string> fields;
+          str::split( line, std::back_inserter(fields) );
+          if ( fields.size() < 2 )
+            return false;
+          res_r._info.puid = fields[1];
+          res_r._uid = str::strtonum<uid_t>( fields[1] );
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** The file backed mappings from /proc/PID/maps. */
+    bool readMaps( const Pathname & procDir_r, const std::string & pid_r, StatMemo & memo_r, std::vector<Mapping> & mappings_r )
+    {
+      std::ifstream infile( ( procDir_r / pid_r / "maps" ).c_str() );
+      if ( ! infile )
+        return false;
+
+      std::unordered_set<std::string> seen;
+      for ( std::string line; std::getline( infile, line ); )
+      {
+        Mapping m;
+        std::string path;
+        if ( ! DeletedFilesScanner::parseMapsLine( line, path, m._deleted ) )
+          continue;	// anonymous mapping
+        if ( path.empty() || ! seen.insert( path ).second )
+          continue;	// already got this one
+        if ( ! m._deleted )
+          memo_r.get( path, m._dev, m._ino );
+        m._path = std::move(path);
+        mappings_r.push_back( std::move(m) );
+      }
+      return true;
+    }
+
+    /** Whether a cached \a mapping_r is (now) deleted. */
+    bool isDeleted( const Mapping & mapping_r, StatMemo & memo_r )
+    {
+      if ( mapping_r._deleted )
+        return true;
+      if ( ! mapping_r._ino )
+        return false;	// stat failed when reading the maps, so we can't tell
+      unsigned long long dev = 0;
+      unsigned long long ino = 0;
+      if ( ! memo_r.get( mapping_r._path, dev, ino ) )
+        return true;
+      return dev != mapping_r._dev || ino != mapping_r._ino;
+    }
+
+    void scanProc( const Pathname & procDir_r, const std::string & pid_r, const ProcEntry * cached_r, const RootDir & root_r, StatMemo & memo_r, ProcResult & res_r )
+    {
+      res_r._info.pid = pid_r;
+      if ( ! readStat( procDir_r, pid_r, res_r ) || ! readUid( procDir_r, pid_r, res_r ) )
+        return;	// vanished
+      if ( ! root_r.isOurs( pid_r ) )
+        return;	// runs in a container
+
+      if ( cached_r && cached_r->_starttime == res_r._entry._starttime && cached_r->_vsize == res_r._entry._vsize )
+        res_r._entry._mappings = cached_r->_mappings;
+      else if ( ! readMaps( procDir_r, pid_r, memo_r, res_r._entry._mappings ) )
+        return;	// vanished or not accessible
+      res_r._valid = true;
+
+      for ( const Mapping & m : res_r._entry._mappings )
+      {
+        if ( isDeleted( m, memo_r ) && ! DeletedFilesScanner::ignoreFile( m._path ) )
+          res_r._info.files.push_back( m._path );
+      }
+    }
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  bool DeletedFilesScanner::parseMapsLine( const std::string & line_r, std::string & path_r, bool & deleted_r )
+  {
+    static const std::string deletedTag { " (deleted)" };
+
+    // ADDRESS PERMS OFFSET DEV INODE PATH
+    std::istringstream fields( line_r );
+    std::string address, perms, offset, dev;
+    unsigned long long inode = 0;
+    if ( ! ( fields >> address >> perms >> offset >> dev >> inode ) || inode == 0 )
+      return false;
+    path_r.clear();
+    std::getline( fields >> std::ws, path_r );
+
+    deleted_r = str::hasSuffix( path_r, deletedTag );
+    if ( deleted_r )
+      path_r.erase( path_r.size() - deletedTag.size() );
+    return true;
+  }
+
+  bool DeletedFilesScanner::ignoreFile( const std::string & path_r )
+  {
+    static const char * ignored[] = {
+      "/SYSV",
+      "/dev/",
+      "/memfd:",
+      "/run/",
+      "/var/run/",
+      "/var/lib/gdm",
+      "/var/lib/sss/",
+    };
+    if ( path_r.empty() || path_r[0] != '/' )
+      return true;
+    for ( const char * prefix : ignored )
+    {
+      if ( str::hasPrefix( path_r, prefix ) )
+        return true;
+    }
+    return false;
+  }
+
+  DeletedFilesScanner::DeletedFilesScanner()
+  : _procDir { "/proc" }
+  {}
+
+  DeletedFilesScanner::DeletedFilesScanner( Pathname cacheFile_r )
+  : DeletedFilesScanner( std::move(cacheFile_r), "/proc" )
+  {}
+
+  DeletedFilesScanner::DeletedFilesScanner( Pathname cacheFile_r, Pathname procDir_r )
+  : _procDir { std::move(procDir_r) }
+  , _cacheFile { std::move(cacheFile_r) }
+  {
+    if ( _cacheFile.empty() )
+      return;
+
+    std::ifstream infile( _cacheFile.c_str() );
+    if ( ! infile )
+      return;
+
+    std::string line;
+    if ( ! std::getline( infile, line ) || line != magic || ! std::getline( infile, line ) || line != "boot " + bootId( _procDir ) )
+    {
+      MIL << "Ignore outdated ps cache " << _cacheFile << endl;
+      return;
+    }
+
+    ProcEntry * entry = nullptr;
+    while ( std::getline( infile, line ) )
+    {
+      std::vector<std::string> words;
+      if ( str::hasPrefix( line, "P " ) && str::split( line, std::back_inserter(words) ) == 4 )
+      {
+        entry = &_cache[words[1]];
+        entry->_starttime = words[2];
+        entry->_vsize = words[3];
+      }
+      else if ( entry && str::hasPrefix( line, "M " ) && str::split( line, std::back_inserter(words), " " ) >= 5 )
+      {
+        // M DELETED DEV INO PATH (PATH may contain blanks)
+        Mapping m;
+        m._deleted = ( words[1] == "1" );
+        m._dev = str::strtonum<unsigned long long>( words[2] );
+        m._ino = str::strtonum<unsigned long long>( words[3] );
+        m._path = line.substr( words[0].size() + words[1].size() + words[2].size() + words[3].size() + 4 );
+        entry->_mappings.push_back( std::move(m) );
+      }
+      else
+      {
+        WAR << "Malformed ps cache " << _cacheFile << ": " << line << endl;
+        _cache.clear();
+        return;
+      }
+    }
+    MIL << "Read " << _cache.size() << " processes from ps cache " << _cacheFile << endl;
+  }
+
+  std::vector<ProcInfo> DeletedFilesScanner::scan()
+  {
+    std::vector<std::string> pids { listPids( _procDir ) };
+    std::sort( pids.begin(), pids.end(), []( const std::string & lhs, const std::string & rhs ) {
+      return lhs.size() < rhs.size() || ( lhs.size() == rhs.size() && lhs < rhs );	// numerical
+    } );
+
+    std::vector<ProcResult> results( pids.size() );
+    RootDir root { _procDir };
+    std::atomic<size_t> next { 0 };
+    auto worker = [&]() {
+      StatMemo memo;
+      for ( size_t idx = next++; idx < pids.size(); idx = next++ )
+      {
+        auto it = _cache.find( pids[idx] );
+        scanProc( _procDir, pids[idx], ( it == _cache.end() ? nullptr : &it->second ), root, memo, results[idx] );
+      }
+    };
+
+    // A worker per core, but no need to start them for a handful of processes.
+    unsigned workers = std::max( 1U, std::min<unsigned>( std::thread::hardware_concurrency(), pids.size() / 64 ) );
+    std::vector<std::thread> threads;
+    for ( unsigned i = 1; i < workers; ++i )
+      threads.emplace_back( worker );
+    worker();
+    for ( std::thread & thread : threads )
+      thread.join();
+
+    std::vector<ProcInfo> ret;
+    std::map<std::string,ProcEntry> newcache;
+    std::unordered_map<uid_t,std::string> logins;
+    for ( ProcResult & res : results )
+    {
+      if ( ! res._valid )
+        continue;
+      if ( ! _cacheFile.empty() )
+        newcache.emplace( res._info.pid, std::move(res._entry) );
+      if ( ! res._info.files.empty() )
+      {
+        auto it = logins.find( res._uid );
+        if ( it == logins.end() )
+        {
+          struct passwd * pw = ::getpwuid( res._uid );
+          it = logins.emplace( res._uid, pw ? pw->pw_name : "" ).first;
+        }
+        res._info.login = it->second;
+        ret.push_back( std::move(res._info) );
+      }
+    }
+    _cache.swap( newcache );
+
+    MIL << "Scanned " << pids.size() << " processes using " << workers << " workers: " << ret.size() << " use deleted files" << endl;
+    return ret;
+  }
+
+  void DeletedFilesScanner::saveCache() const
+  {
+    if ( _cacheFile.empty() )
+      return;
+
+    if ( filesystem::assert_dir( _cacheFile.dirname() ) != 0 )
+    {
+      WAR << "Can not create " << _cacheFile.dirname() << endl;
+      return;
+    }
+
+    Pathname tmpfile { _cacheFile.extend( ".new" ) };
+    {
+      std::ofstream outfile( tmpfile.c_str() );
+      if ( ! outfile )
+      {
+        DBG << "Can not write " << tmpfile << endl;
+        return;
+      }
+      filesystem::chmod( tmpfile, 0600 );
+      outfile << magic << endl;
+      outfile << "boot " << bootId( _procDir ) << endl;
+      for ( const auto & el : _cache )
+      {
+        outfile << "P " << el.first << " " << el.second._starttime << " " << el.second._vsize << endl;
+        for ( const Mapping & m : el.second._mappings )
+        {
+          if ( m._path.find( '\n' ) == std::string::npos )
+            outfile << "M " << m._deleted << " " << m._dev << " " << m._ino << " " << m._path << endl;
+        }
+      }
+      if ( ! outfile.flush() )
+      {
+        WAR << "Error writing " << tmpfile << endl;
+        filesystem::unlink( tmpfile );
+        return;
+      }
+    }
+    if ( filesystem::rename( tmpfile, _cacheFile ) != 0 )
+      filesystem::unlink( tmpfile );
+  }
+
+} // namespace ps
+///////////////////////////////////////////////////////////////////
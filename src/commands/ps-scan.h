@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+/** \file commands/ps-scan.h
+ * Find running processes using deleted files.
+ */
+#ifndef ZYPPER_COMMANDS_PS_SCAN_INCLUDED
+#define ZYPPER_COMMANDS_PS_SCAN_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <zypp/Pathname.h>
+#include <zypp/misc/CheckAccessDeleted.h>
+
+///////////////////////////////////////////////////////////////////
+namespace ps
+{
+  typedef zypp::CheckAccessDeleted::ProcInfo ProcInfo;
+
+  /** Location of the per process cache used by \c zypper ps --incremental. */
+  #define ZYPPER_PS_CACHE_FILE "/var/cache/zypper/ps.cache"
+
+  /** Scan \c /proc for running processes using deleted executables or libraries.
+   *
+   * Produces the same \ref ProcInfo as \ref zypp::CheckAccessDeleted, but
+   * instead of parsing the output of lsof, the memory maps of the processes
+   * are read directly and in parallel (one worker per core).
+   *
+   * If a cache file is given, the file backed mappings of each process are
+   * remembered together with the process start time. On the next scan a
+   * process with unchanged PID, start time and virtual memory size is not
+   * read again. It's mapped files are just checked (stat) for being replaced
+   * or removed meanwhile.
+   */
+  class DeletedFilesScanner
+  {
+  public:
+    /** Scan without cache. */
+    DeletedFilesScanner();
+
+    /** Scan using (and updating) the cache in \a cacheFile_r. */
+    DeletedFilesScanner( zypp::Pathname cacheFile_r );
+
+    /** Scan \a procDir_r instead of \c /proc (for testing). An empty \a cacheFile_r means no cache. */
+    DeletedFilesScanner( zypp::Pathname cacheFile_r, zypp::Pathname procDir_r );
+
+    /** Processes using deleted files, ordered by PID. */
+    std::vector<ProcInfo> scan();
+
+    /** Save the cache (if any) after \ref scan. Errors are logged only. */
+    void saveCache() const;
+
+  public:
+    /** Parse a line of \c /proc/PID/maps.
+     * \return \c false for anonymous mappings. Otherwise \a path_r is the mapped
+     * file with a trailing \c " (deleted)" stripped and indicated in \a deleted_r.
+     */
+    static bool parseMapsLine( const std::string & line_r, std::string & path_r, bool & deleted_r );
+
+    /** Mapped files not reported (like \ref zypp::CheckAccessDeleted does): \c /dev/, \c /run/, SYSV shm, memfd, ... */
+    static bool ignoreFile( const std::string & path_r );
+
+  public:
+    /** A file backed mapping of a process. */
+    struct Mapping
+    {
+      std::string _path;
+      bool _deleted = false;	//< deleted when read from maps
+      unsigned long long _dev = 0;	//< stat of _path when read
+      unsigned long long _ino = 0;
+    };
+
+    /** What we remember about a process. */
+    struct ProcEntry
+    {
+      std::string _starttime;
+      std::string _vsize;
+      std::vector<Mapping> _mappings;
+    };
+
+  private:
+    zypp::Pathname _procDir;
+    zypp::Pathname _cacheFile;
+    std::map<std::string,ProcEntry> _cache;	//< by PID
+  };
+
+} // namespace ps
+///////////////////////////////////////////////////////////////////
+#endif // ZYPPER_COMMANDS_PS_SCAN_INCLUDED
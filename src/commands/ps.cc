@@ -17,6 +17,7 @@
 #include "utils/messages.h"
 #include "utils/flags/flagtypes.h"
 #include "commands/needs-rebooting.h"
+#include "commands/ps-scan.h"
 
 using namespace zypp;
 
@@ -28,7 +29,7 @@ PSCommand::PSCommand( std::vector<std::string> &&commandAliases_r ) :
     // translators: command description
     _("List running processes which might still use files and libraries deleted by recent upgrades."),
     std::string(),
-    DisableAll
+    NoZYpp
   )
 { }
 
@@ -50,7 +51,13 @@ ZyppFlags::CommandGroup PSCommand::cmdOptions() const
     }, { "debugFile", 'd', ZyppFlags::RequiredArgument, ZyppFlags::StringType(&that->_debugFile, boost::optional<const char *>(), "PATH")
             // translators: -d, --debugFile <path>
           , _("Write debug output to file <path>.")
+    }, { "incremental", '\0', ZyppFlags::NoArgument, ZyppFlags::BoolType(&that->_incremental, ZyppFlags::StoreTrue, _incremental)
+            // translators: --incremental
+          , _("Remember the files used by each process. On the next run only new or changed processes need to be examined.")
     }
+  },{
+    //conflicting flags
+    { "debugFile", "incremental" }
   }};
 }
 
@@ -59,24 +66,39 @@ void PSCommand::doReset()
   _shortness = 0;
   _debugFile.clear();
   _format.clear();
+  _incremental = false;
 }
 
-inline void loadData( CheckAccessDeleted & checker_r )
+std::vector<ps::ProcInfo> PSCommand::loadData()
 {
-  try
+  if ( debugEnabled() )
   {
-    checker_r.check();
-  }
-  catch ( const Exception & ex )
-  {
-    throw( Out::Error( ZYPPER_EXIT_ERR_ZYPP, _("Check failed:"), ex ) );
+    // The debug output is lsof's, so let CheckAccessDeleted do the job.
+    CheckAccessDeleted checker( false );	// wait for explicit call to check()
+    checker.setDebugOutputFile(_debugFile);
+    try
+    {
+      checker.check();
+    }
+    catch ( const Exception & ex )
+    {
+      throw( Out::Error( ZYPPER_EXIT_ERR_ZYPP, _("Check failed:"), ex ) );
+    }
+    return std::vector<ps::ProcInfo>( checker.begin(), checker.end() );
   }
+
+  // The cache reveals the files used by all processes, so it's root's only.
+  bool incremental = _incremental && geteuid() == 0;
+  ps::DeletedFilesScanner scanner { incremental ? ps::DeletedFilesScanner( ZYPPER_PS_CACHE_FILE ) : ps::DeletedFilesScanner() };
+  std::vector<ps::ProcInfo> ret { scanner.scan() };
+  if ( incremental )
+    scanner.saveCache();
+  return ret;
 }
 
 void PSCommand::printServiceNamesOnly()
 {
-  CheckAccessDeleted checker( false );	// wait for explicit call to check()
-  loadData( checker );
+  std::vector<ps::ProcInfo> checker { loadData() };
 
   std::set<std::string> services;
   for ( const auto & procInfo : checker )
@@ -125,12 +147,7 @@ int PSCommand::execute( Zypper &zypper, const std::vector<std::string> &position
 
   // Here: Table output
   zypper.out().info(_("Checking for running processes using deleted libraries..."), Out::HIGH );
-  CheckAccessDeleted checker( false );	// wait for explicit call to check()
-
-  if(debugEnabled())
-    checker.setDebugOutputFile(_debugFile);
-
-  loadData( checker );
+  std::vector<ps::ProcInfo> checker { loadData() };
 
   Table t;
   bool tableWithFiles = tableWithFilesEnabled();
@@ -9,6 +9,7 @@
 
 #include "commands/basecommand.h"
 #include "utils/flags/zyppflags.h"
+#include "commands/ps-scan.h"
 
 class PSCommand : public ZypperBaseCommand
 {
@@ -23,6 +24,7 @@ protected:
   void doReset() override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs) override;
 
+  std::vector<ps::ProcInfo> loadData();
   void printServiceNamesOnly();
   bool tableWithFilesEnabled() const		{ return _shortness < 1; }
   bool tableWithNonServiceProcsEnabled() const	{ return _shortness < 2; }
@@ -33,6 +35,7 @@ private:
   int _shortness = 0;
   std::string _format;
   std::string _debugFile;
+  bool _incremental = false;
 };
 
 
@@ -5,6 +5,8 @@
                              |__/|_|  |_|
 \*---------------------------------------------------------------------------*/
 
+#include <zypp/base/DtorReset.h>
+
 #include "info.h"
 #include "utils/flags/flagtypes.h"
 #include "utils/messages.h"
@@ -101,6 +103,14 @@ void InfoCmd::doReset()
   _options = PrintInfoOptions();
 }
 
+int InfoCmd::systemSetup( Zypper &zypper )
+{
+  // Load only the repos which may contain the wanted names.
+  DtorReset guard( zypper.runtimeData().repoNameFilter );
+  zypper.runtimeData().repoNameFilter = printInfoRepoNameFilter( positionalArguments(), _options );
+  return ZypperBaseCommand::systemSetup( zypper );
+}
+
 int InfoCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   if ( positionalArgs_r.size() < 1 )
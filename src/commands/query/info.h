@@ -40,6 +40,7 @@ public:
 protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  int systemSetup(Zypper &zypper) override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
 
 private:
@@ -9,6 +9,7 @@
 #include "commands/conditions.h"
 #include "utils/flags/flagtypes.h"
 #include "Zypper.h"
+#include "PackageCacheTrim.h"
 
 CleanRepoCmd::CleanRepoCmd(std::vector<std::string> &&commandAliases_r ):
   ZypperBaseCommand(
@@ -51,7 +52,21 @@ zypp::ZyppFlags::CommandGroup CleanRepoCmd::cmdOptions() const
             ZyppFlags::BitFieldType ( that->_flags, CleanRepoBits::CleanAll),
             // translators: -a, --all
             _("Clean both metadata and package caches.")
+      },{
+        "max-size", '\0', ZyppFlags::RequiredArgument,
+            ZyppFlags::StringType( &that->_maxSize, boost::optional<const char *>(), "SIZE" ),
+            // translators: --max-size <SIZE>
+            _("Instead of cleaning the package caches, remove the least recently used packages until they fit into SIZE (e.g. 2G). Packages of installed versions are kept.")
+      },{
+        "max-age", '\0', ZyppFlags::RequiredArgument,
+            ZyppFlags::IntType( &that->_maxAge ),
+            // translators: --max-age <DAYS>
+            _("Instead of cleaning the package caches, remove the packages not used for DAYS days. Packages of installed versions are kept.")
       }
+  },{
+      //conflicting flags
+      { "all", "max-size" },
+      { "all", "max-age" }
   }};
 }
 
@@ -59,6 +74,19 @@ void CleanRepoCmd::doReset()
 {
   _repos.clear();
   _flags = CleanRepoBits::Default;
+  _maxSize.clear();
+  _maxAge = 0;
+}
+
+std::optional<CleanRepoFlags> CleanRepoCmd::cleanFlags() const
+{
+  if ( _maxSize.empty() && ! _maxAge )
+    return _flags;
+  // --max-size/--max-age trim the package caches instead of cleaning them,
+  // but -m and -M still clean the metadata
+  if ( _flags == CleanRepoBits::Default )
+    return std::nullopt;
+  return _flags | CleanRepoBits::KeepPackages;
 }
 
 int CleanRepoCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
@@ -68,7 +96,27 @@ int CleanRepoCmd::execute( Zypper &zypper, const std::vector<std::string> &posit
   for ( const std::string &repoFromCLI : positionalArgs_r )
     specifiedRepos.push_back(repoFromCLI);
 
-  clean_repos( zypper,  specifiedRepos, _flags );
+  if ( _maxSize.empty() && ! _maxAge )
+  {
+    clean_repos( zypper,  specifiedRepos, _flags );
+    return zypper.exitCode();
+  }
+
+  ByteCount maxSize;
+  if ( ! _maxSize.empty() && ! PackageCacheTrim::parseSize( _maxSize, maxSize ) )
+  {
+    zypper.out().error( str::Format(_("Invalid size '%s'.")) % _maxSize );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+  if ( _maxAge < 0 )
+  {
+    zypper.out().error( str::Format(_("Invalid number of days '%d'.")) % _maxAge );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  if ( std::optional<CleanRepoFlags> flags { cleanFlags() } )
+    clean_repos( zypper,  specifiedRepos, *flags );
+  trim_package_caches( zypper, specifiedRepos, maxSize, _maxAge );
 
   return zypper.exitCode();
 }
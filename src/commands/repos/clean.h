@@ -10,6 +10,7 @@
 #include "commands/basecommand.h"
 #include "repos.h"
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,11 @@ class CleanRepoCmd : public ZypperBaseCommand
 public:
   CleanRepoCmd( std::vector<std::string> &&commandAliases_r );
 
+  /** The flags \ref clean_repos is called with; none if --max-size/--max-age
+   * just trim the package caches.
+   */
+  std::optional<CleanRepoFlags> cleanFlags() const;
+
   // ZypperBaseCommand interface
 protected:
   std::vector<BaseCommandConditionPtr> conditions() const override;
@@ -28,6 +34,8 @@ protected:
 private:
   std::vector<std::string> _repos;
   CleanRepoFlags _flags;
+  std::string _maxSize;
+  int _maxAge = 0;
 };
 
 #endif
@@ -4,8 +4,12 @@
                          /__|\_, | .__/ .__/\___|_|
                              |__/|_|  |_|
 \*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <thread>
+
 #include "refresh.h"
 #include "repos.h"
+#include "ParallelCacheBuild.h"
 #include "commands/conditions.h"
 #include "commands/services/refresh.h"
 
@@ -110,6 +114,11 @@ zypp::ZyppFlags::CommandGroup RefreshRepoCmd::cmdOptions() const
             // translators: -s, --services
             _("Refresh also services before refreshing repos.")
       },
+      {"jobs", 'j', ZyppFlags::RequiredArgument,
+            ZyppFlags::IntType( &that->_jobs ),
+            // translators: -j, --jobs <INTEGER>
+            _("Number of repository caches to build in parallel. Defaults to the number of CPU cores with --build-only.")
+      },
   }};
 }
 
@@ -118,6 +127,7 @@ void RefreshRepoCmd::doReset()
   _flags = Default;
   _repos.clear();
   _services = false;
+  _jobs = 0;
 }
 
 int RefreshRepoCmd::execute( Zypper &zypper , const std::vector<std::string> &positionalArgs_r )
@@ -170,7 +180,7 @@ int RefreshRepoCmd::execute( Zypper &zypper , const std::vector<std::string> &po
   for ( const std::string &repoFromCLI : positionalArgs_r )
     specifiedRepos.push_back(repoFromCLI);
 
-  return refreshRepositories ( zypper, _flags, specifiedRepos );
+  return refreshRepositories ( zypper, _flags, specifiedRepos, std::max( _jobs, 0 ) );
 }
 
 bool RefreshRepoCmd::refreshRepository(Zypper &zypper, const RepoInfo &repo, RefreshFlags flags_r)
@@ -197,7 +207,7 @@ bool RefreshRepoCmd::refreshRepository(Zypper &zypper, const RepoInfo &repo, Ref
   return error;
 }
 
-int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, const std::vector<std::string> repos_r )
+int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, const std::vector<std::string> repos_r, unsigned jobs_r )
 {
   RepoManager & manager( zypper.repoManager() );
   // bsc#1234752: Try to refresh update repos first (to have updated GPG keys on the fly)
@@ -232,6 +242,23 @@ int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, c
   unsigned error_count = 0;
   unsigned enabled_repo_count = repos.size();
 
+  // Building the caches is CPU bound; with more than one job the raw metadata
+  // are still refreshed one after another, the caches are built in parallel afterwards.
+  if ( jobs_r == 0 )
+    jobs_r = flags_r.testFlag(BuildOnly) ? std::thread::hardware_concurrency() : 1;
+  if ( flags_r.testFlag(DownloadOnly) )
+    jobs_r = 1;
+  const bool forceBuild { flags_r.testFlag(Force) || flags_r.testFlag(ForceBuild) };
+  ParallelCacheBuild parallelBuild( jobs_r, [&zypper,forceBuild]( const RepoInfo & repo_r ) {
+    return build_cache( zypper, repo_r, forceBuild );
+  } );
+
+  auto skipOnError = [&]( const RepoInfo & repo_r ) {
+    zypper.out().error( str::Format(_("Skipping repository '%s' because of the above error.")) % repo_r.asUserString() );
+    ERR << "Skipping repository '" << repo_r.alias() << "' because of the above error." << endl;
+    error_count++;
+  };
+
   if ( !specified.empty() || not_found.empty() )
   {
     for_( rit, repos.begin(), repos.end() )
@@ -289,17 +316,30 @@ int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, c
       }
 
       // do the refresh
-      if ( refreshRepository( zypper, repo, flags_r ) )
+      if ( jobs_r > 1 )
       {
-        zypper.out().error( str::Format(_("Skipping repository '%s' because of the above error.")) % repo.asUserString() );
-        ERR << "Skipping repository '" << repo.alias() << "' because of the above error." << endl;
-        error_count++;
+        // the cache is built later, in parallel
+        if ( flags_r.testFlag(BuildOnly) || !refreshRepository( zypper, repo, flags_r | DownloadOnly ) )
+          parallelBuild.add( repo );
+        else
+          skipOnError( repo );
       }
+      else if ( refreshRepository( zypper, repo, flags_r ) )
+        skipOnError( repo );
     }
   }
   else
     enabled_repo_count = 0;
 
+  if ( ! parallelBuild.empty() )
+  {
+    MIL << "building caches, " << jobs_r << " jobs" << endl;
+    parallelBuild.run( [&]( const RepoInfo & repo_r, bool error_r ) {
+      if ( error_r )
+        skipOnError( repo_r );
+    } );
+  }
+
   // print the result message
   if ( !not_found.empty() )
   {
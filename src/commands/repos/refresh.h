@@ -27,7 +27,11 @@ public:
 
   RefreshRepoCmd( std::vector<std::string> &&commandAliases_r );
 
-  static int refreshRepositories ( Zypper &zypper, RefreshFlags flags_r = Default, const std::vector<std::string> repos_r = std::vector<std::string>() );
+  /** Refresh the enabled or given repos.
+   * The caches are built by up to \a jobs_r parallel workers. \c 0 means
+   * the number of CPU cores with \ref BuildOnly, otherwise one after another.
+   */
+  static int refreshRepositories ( Zypper &zypper, RefreshFlags flags_r = Default, const std::vector<std::string> repos_r = std::vector<std::string>(), unsigned jobs_r = 0 );
 
   /** \return false on success, true on error */
   static bool refreshRepository  ( Zypper & zypper, const zypp::RepoInfo & repo, RefreshFlags flags_r = Default );
@@ -44,6 +48,7 @@ private:
   RefreshFlags _flags;
   std::vector<std::string> _repos;
   bool _services = false;
+  int _jobs = 0;
 };
 ZYPP_DECLARE_OPERATORS_FOR_FLAGS(RefreshRepoCmd::RefreshFlags);
 
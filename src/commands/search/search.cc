@@ -5,6 +5,7 @@
 #include "commands/commonflags.h"
 #include "commands/commandhelpformatter.h"
 #include "commands/search/search-packages-hinthack.h"
+#include "output/OutJSON.h"
 
 #include <zypp/base/Algorithm.h>
 #include <zypp/sat/Solvable.h>
@@ -467,7 +468,8 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
     }
     else
     {
-      cout << endl; //! \todo  out().separator()?
+      if ( zypper.out().type() != OutJSON::TYPE_JSON )	// JSON Lines has no empty lines
+        cout << endl; //! \todo  out().separator()?
 
       if ( _details )
       {
@@ -62,6 +62,9 @@ std::vector<zypp::ZyppFlags::CommandGroup> SolverCommonOptionSet::options()
         { "force-resolution", '\0', ZyppFlags::NoArgument, ZyppFlags::TriBoolType( set._forceResolution, ZyppFlags::StoreTrue ), _("Force the solver to find a solution (even an aggressive one) rather than asking.") },
         { "no-force-resolution", 'R', ZyppFlags::NoArgument, ZyppFlags::TriBoolType( set._forceResolution, ZyppFlags::StoreFalse ), _("Do not force the solver to find a solution, let it ask.") },
         { "solver-focus", '\0', ZyppFlags::RequiredArgument, ResolverFocusArgType( set._focus ), _("Set the solvers general attitude when resolving a job.") },
+        { "reuse-solution", '\0', ZyppFlags::NoArgument, ZyppFlags::BoolType( &set._reuseSolution, ZyppFlags::StoreTrue, set._reuseSolution ),
+          // translators: --reuse-solution
+          _("Together with --dry-run save the computed solution. Otherwise reuse a solution saved by a previous identical dry run instead of solving again.") },
       },
       {
         //conflicting flags
@@ -8,13 +8,17 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <csignal>
 #include <cerrno>
 #include <cstring>
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <algorithm>
+#include <map>
 #include <set>
 #include <zypp/base/LogTools.h>
 #include <zypp/ExternalProgram.h>
@@ -23,6 +27,7 @@
 #include "Table.h"
 #include "subcommand.h"
 #include "utils/messages.h"
+#include "utils/misc.h"
 #include "commands/commandhelpformatter.h"
 
 #include <boost/utility/string_ref.hpp>
@@ -37,6 +42,7 @@ namespace env
       ret = env;
     return ret;
   }
+
 } // namespace env
 ///////////////////////////////////////////////////////////////////
 
@@ -147,17 +153,186 @@ namespace	// subcommand detetction
     return false;
   }
 
-  /** Return whether \a dir_r/name_r forms a valid subcommand. */
-  inline SubcommandOptions::Detected detectSubcommand( const Pathname & dir_r, std::string name_r )
+  /** The 'zypper-*' entries of a directory, remembered across zypper calls.
+   *
+   * Scanning the execdir and all $PATH directories for 'zypper-*' files on
+   * each help or command lookup is slow, esp. on network filesystems. The
+   * names found are remembered per directory together with the directories
+   * mtime, in a per user cache file. As long as the mtime is unchanged (no
+   * entry was added, removed or renamed) a single stat is enough to reuse them.
+   *
+   * Only the names are cached, not whether they are executable: changing the
+   * permissions of a file does not change the directories mtime. So the
+   * callers check each candidate (\ref canExecute).
+   *
+   * Directories modified within the last seconds are not written to the cache
+   * file, as a change within the mtime granularity would not be noticed.
+   */
+  class SubcommandCache
   {
-    SubcommandOptions::Detected ret;
-    if ( str::startsWith( name_r, "zypper-" ) && canExecute( dir_r/name_r ) ) {
-      ret._cmd  = name_r.substr( 7 /*"zypper-"*/ );
-      ret._name = std::move(name_r);
-      ret._path = dir_r;
+  public:
+    typedef std::set<std::string> Names;
+
+    static SubcommandCache & instance()
+    { static SubcommandCache _instance; return _instance; }
+
+    /** The names of all 'zypper-*' entries in \a dir_r, executable or not (rescan if outdated). */
+    const Names & namesIn( const Pathname & dir_r )
+    {
+      static const Names noNames;
+      Stamp stamp;
+      if ( ! stampOf( dir_r, stamp ) )
+        return noNames;
+
+      Entry & entry { _entries[dir_r.asString()] };
+      if ( !( entry._valid && entry._stamp == stamp ) )
+      {
+        DBG << "Scan for subcommands: " << dir_r << endl;
+        entry._names.clear();
+        filesystem::dirForEach( dir_r,
+                                [&entry]( const Pathname & dir_r, std::string name_r )->bool
+                                {
+                                  if ( str::startsWith( name_r, "zypper-" ) )
+                                    entry._names.insert( std::move(name_r) );
+                                  return true;
+                                } );
+        entry._stamp = stamp;
+        entry._valid = true;
+        entry._racy = ( stamp.first + 2 >= ::time( nullptr ) );
+        _dirty = true;
+      }
+      return entry._names;
     }
-    return ret;
-  }
+
+    /** Whether \a dir_r may contain an entry \a name_r.
+     * False only if an up to date entry for \a dir_r does not know it. Unlike
+     * \ref namesIn, an outdated directory is not scanned.
+     */
+    bool mayContain( const Pathname & dir_r, const std::string & name_r )
+    {
+      auto it { _entries.find( dir_r.asString() ) };
+      if ( it == _entries.end() || ! it->second._valid )
+        return true;
+      Stamp stamp;
+      if ( ! stampOf( dir_r, stamp ) || stamp != it->second._stamp )
+        return true;
+      return it->second._names.count( name_r );
+    }
+
+    /** Write the cache file if entries changed. Errors are logged only. */
+    void save()
+    {
+      if ( ! _dirty || _file.empty() )
+        return;
+      _dirty = false;
+
+      if ( filesystem::assert_dir( _file.dirname() ) != 0 )
+      {
+        WAR << "Can not create " << _file.dirname() << endl;
+        return;
+      }
+      Pathname tmpfile { _file.extend( ".new" ) };
+      {
+        std::ofstream out( tmpfile.c_str() );
+        out << _header << endl;
+        for ( const auto & p : _entries )
+        {
+          if ( ! p.second._valid || p.second._racy )
+            continue;
+          out << "D " << p.second._stamp.first << " " << p.second._stamp.second << " " << p.first << endl;
+          for ( const std::string & name : p.second._names )
+            out << "C " << name << endl;
+        }
+        if ( ! out )
+        {
+          WAR << "Can not write " << tmpfile << endl;
+          filesystem::unlink( tmpfile );
+          return;
+        }
+      }
+      if ( filesystem::rename( tmpfile, _file ) != 0 )
+      {
+        WAR << "Can not rename " << tmpfile << endl;
+        filesystem::unlink( tmpfile );
+        return;
+      }
+      MIL << "Saved subcommand cache " << _file << endl;
+    }
+
+  private:
+    typedef std::pair<time_t,long> Stamp;	///< mtime in seconds, nanoseconds
+
+    struct Entry
+    {
+      Stamp _stamp;
+      Names _names;
+      bool _valid = false;
+      bool _racy = false;	///< too recently modified to be saved
+    };
+
+    SubcommandCache()
+    {
+      Pathname cachedir { zypperUserCacheDir() };
+      if ( ! cachedir.empty() )
+        _file = cachedir / "subcommands.cache";
+      load();
+    }
+
+    static bool stampOf( const Pathname & dir_r, Stamp & stamp_r )
+    {
+      struct stat st;
+      if ( ::stat( dir_r.c_str(), &st ) != 0 || ! S_ISDIR( st.st_mode ) )
+        return false;
+      stamp_r = Stamp( st.st_mtim.tv_sec, st.st_mtim.tv_nsec );
+      return true;
+    }
+
+    void load()
+    {
+      if ( _file.empty() )
+        return;
+      std::ifstream in( _file.c_str() );
+      if ( ! in )
+        return;
+
+      std::string line;
+      if ( ! std::getline( in, line ) || line != _header )
+      {
+        MIL << "Ignore subcommand cache " << _file << " (unknown format)" << endl;
+        return;
+      }
+
+      Entry * entry = nullptr;
+      while ( std::getline( in, line ) )
+      {
+        if ( str::startsWith( line, "D " ) )
+        {
+          std::istringstream fields( line.substr( 2 ) );
+          time_t sec = 0;
+          long nsec = 0;
+          std::string dir;
+          if ( !( fields >> sec >> nsec ) || fields.get() != ' ' || ! std::getline( fields, dir ) || dir.empty() )
+          {
+            entry = nullptr;
+            continue;
+          }
+          entry = &_entries[dir];
+          entry->_stamp = Stamp( sec, nsec );
+          entry->_names.clear();
+          entry->_valid = true;
+        }
+        else if ( entry && str::startsWith( line, "C " ) )
+          entry->_names.insert( line.substr( 2 ) );
+      }
+      DBG << "Loaded subcommand cache " << _file << ": " << _entries.size() << " dirs" << endl;
+    }
+
+  private:
+    static constexpr const char * _header = "# zypper subcommands cache v2";	// v1 listed executables only
+    Pathname _file;
+    std::map<std::string,Entry> _entries;
+    bool _dirty = false;
+  };
 
   /** Collect subcommands found in \a dir_r. */
   inline void detectSubcommandsIn( const Pathname & dir_r, std::function<void(SubcommandOptions::Detected)> fnc_r )
@@ -165,14 +340,16 @@ namespace	// subcommand detetction
     if ( !fnc_r )
       return;
 
-    filesystem::dirForEach( dir_r,
-                            [&fnc_r]( const Pathname & dir_r, std::string name_r )->bool
-                            {
-                              SubcommandOptions::Detected cmd { detectSubcommand( dir_r, std::move(name_r) ) };
-                              if ( ! cmd._cmd.empty() )
-                                fnc_r( std::move(cmd) );
-                              return true;
-                            } );
+    for ( const std::string & name : SubcommandCache::instance().namesIn( dir_r ) )
+    {
+      if ( ! canExecute( dir_r/name ) )
+        continue;
+      SubcommandOptions::Detected cmd;
+      cmd._cmd  = name.substr( 7 /*"zypper-"*/ );
+      cmd._name = name;
+      cmd._path = dir_r;
+      fnc_r( std::move(cmd) );
+    }
   }
 
   /* Just the command names for the short help. */
@@ -190,6 +367,8 @@ namespace	// subcommand detetction
 
     for ( const auto & dir : pathDirs_r )
       collectSubcommandsIn( dir );
+
+    SubcommandCache::instance().save();
   }
 
   /* The command details for the long help. */
@@ -210,6 +389,8 @@ namespace	// subcommand detetction
 
     for ( const auto & dir : pathDirs_r )
       collectSubcommandsIn( dir, pathCommands_r, &execdirCommands_r );
+
+    SubcommandCache::instance().save();
   }
 
 } // namespace
@@ -523,7 +704,7 @@ SubCmd::SubCmd(std::vector<std::string> &&commandAliases_r , boost::shared_ptr<S
     : _("Lists available subcommands. Using zypper subcommands found on your $PATH is disabled in zypper.conf.")
     ,
     "", //no help text, its created on demand
-    DisableAll
+    NoZYpp
     ),
   _options ( options_r )
 {
@@ -550,14 +731,18 @@ bool SubCmd::isSubcommand(const std::string &strval_r )
   if ( execname.empty() )
     return false;	// illegal name (e.g. pathsep in name)
 
+  // Directories known not to contain execname need not be probed.
+  SubcommandCache & cache { SubcommandCache::instance() };
+
   // Execdir first..
-  if ( testAndRememberSubcommand( SubcommandOptions::_execdir, execname, strval_r ) )
+  if ( cache.mayContain( SubcommandOptions::_execdir, execname )
+    && testAndRememberSubcommand( SubcommandOptions::_execdir, execname, strval_r ) )
     return true;
 
   if ( Zypper::instance().config().seach_subcommand_in_path ) {
     // Search in $PATH...
     for ( const auto & dir : pathDirsIf( true ) ) {
-      if ( testAndRememberSubcommand( dir, execname, strval_r ) )
+      if ( cache.mayContain( dir, execname ) && testAndRememberSubcommand( dir, execname, strval_r ) )
         return true;
     }
   }
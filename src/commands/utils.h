@@ -7,5 +7,6 @@
 #include "utils/download.h"
 #include "utils/source-download.h"
 #include "utils/purge-kernels.h"
+#include "utils/log.h"
 
 #endif
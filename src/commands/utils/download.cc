@@ -6,7 +6,9 @@
 \*---------------------------------------------------------------------------*/
 
 #include <iostream>
+#include <optional>
 
+#include <zypp/base/DtorReset.h>
 #include <zypp/base/LogTools.h>
 #include <zypp/Package.h>
 #include <zypp/ResPool.h>
@@ -18,8 +20,10 @@
 
 #include "utils/flags/flagtypes.h"
 #include "utils/messages.h"
+#include "output/OutJSON.h"
 #include "Zypper.h"
 #include "PackageArgs.h"
+#include "PackageStore.h"
 #include "Table.h"
 #include "download.h"
 #include "global-settings.h"
@@ -83,6 +87,19 @@ namespace
     }
   }
 
+  inline void logJsonResult( const PoolItem & pi_r, const Pathname & localfile_r )
+  {
+    // {"event":"download-result","kind":"package","name":"glibc",...,"localfile":"/tmp/..."}
+    // "localfile" is empty on error
+    OutJSON::Line( "download-result" )
+      .add( "kind", pi_r.kind().asString() )
+      .add( "name", pi_r.name() )
+      .add( "edition", pi_r.edition().asString() )
+      .add( "arch", pi_r.arch().asString() )
+      .add( "repository", pi_r.repoInfo().alias() )
+      .add( "localfile", localfile_r.asString() );
+  }
+
   /** Whether user may create \a dir_r or has rw-access to it. */
   inline bool userMayUseDir( const Pathname & dir_r )
   {
@@ -103,6 +120,40 @@ namespace
     return mayuse;
   }
 
+  /** The names the package arguments may refer to, for loading only the repos containing them.
+   * Each prefix ending at a '-' or '.' is a candidate, as we don't know yet whether the
+   * argument contains an edition or arch. No filter for repo or kind qualified arguments.
+   */
+  std::optional<RepoNameFilter> downloadRepoNameFilter( const std::vector<std::string> & args_r )
+  {
+    RepoNameFilter ret;
+    ret._fullLoadIfUnmatched = true;	// may be a provides
+    for ( std::string arg : args_r )
+    {
+      if ( arg.find_first_of( ":/" ) != std::string::npos )
+        return std::nullopt;
+      if ( ! arg.empty() && arg[0] == '+' )
+        arg.erase( 0, 1 );
+      else if ( ! arg.empty() && ( arg[0] == '-' || arg[0] == '~' || arg[0] == '!' ) )
+        continue;	// don'ts are not looked up
+
+      arg = str::trim( arg.substr( 0, arg.find_first_of( "<>=! " ) ) );
+      if ( arg.empty() )
+        return std::nullopt;
+
+      std::vector<std::string> names { arg };
+      for ( std::string::size_type pos = arg.find_first_of( "-." ); pos != std::string::npos; pos = arg.find_first_of( "-.", pos+1 ) )
+      {
+        if ( pos )
+          names.push_back( arg.substr( 0, pos ) );
+      }
+      ret._names.push_back( std::move(names) );
+    }
+    if ( ret._names.empty() )
+      return std::nullopt;
+    return ret;
+  }
+
   class EnsureWriteableCacheCondition : public BaseCommandCondition
   {
     // BaseCommandCondition interface
@@ -193,6 +244,14 @@ int DownloadCmd::earlyPositionalArgsCheck( Zypper &zypper, const std::vector<std
   return ZYPPER_EXIT_OK;
 };
 
+int DownloadCmd::systemSetup( Zypper &zypper )
+{
+  // Load only the repos which may contain the wanted packages.
+  DtorReset guard( zypper.runtimeData().repoNameFilter );
+  zypper.runtimeData().repoNameFilter = downloadRepoNameFilter( positionalArguments() );
+  return ZypperBaseCommand::systemSetup( zypper );
+}
+
 int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &positionalArgs_r )
 {
     typedef ui::SelectableTraits::AvailableItemSet AvailableItemSet;
@@ -284,7 +343,8 @@ int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &posit
       {
         ++current;
 
-        if ( ! isCached( pi ) )
+        if ( ! isCached( pi )
+             && ( DryRunSettings::instance().isEnabled() || ! PackageStore::instance().provide( pi.satSolvable() ) ) )
         {
           if ( !DryRunSettings::instance().isEnabled() )
           {
@@ -317,8 +377,12 @@ int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &posit
 
             //DBG << localfile << endl;
             localfile.resetDispose();
+            if ( ! localfile->empty() )
+              PackageStore::instance().remember( pi.satSolvable() );
             if ( zypper.out().typeXML() )
               logXmlResult( pi, localfile );
+            else if ( zypper.out().type() == OutJSON::TYPE_JSON )
+              logJsonResult( pi, localfile );
 
             if ( zypper.exitRequested() )
               return ZYPPER_EXIT_ON_SIGNAL;
@@ -336,6 +400,8 @@ int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &posit
           Out::ProgressBar report( zypper.out(), localfile.asString(), current, total );
           if ( zypper.out().typeXML() )
             logXmlResult( pi, localfile );
+          else if ( zypper.out().type() == OutJSON::TYPE_JSON )
+            logJsonResult( pi, localfile );
         }
 
         if ( !_allMatches )
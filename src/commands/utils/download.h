@@ -52,6 +52,7 @@ protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
   int earlyPositionalArgsCheck( Zypper &zypper, const std::vector<std::string> &positionalArgs_r ) override;
+  int systemSetup( Zypper &zypper ) override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
   std::vector<BaseCommandConditionPtr> conditions() const override;
 };
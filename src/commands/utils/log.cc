@@ -0,0 +1,217 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include "log.h"
+#include "utils/flags/flagtypes.h"
+#include "utils/messages.h"
+#include "utils/misc.h"
+#include "LogIndex.h"
+#include "output/OutJSON.h"
+#include "Table.h"
+#include "Zypper.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <zypp/base/Exception.h>
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** YYYY[-MM[-DD]] */
+  bool validDate( const std::string & date_r )
+  {
+    if ( date_r.size() != 4 && date_r.size() != 7 && date_r.size() != 10 )
+      return false;
+    for ( unsigned idx = 0; idx < date_r.size(); ++idx )
+    {
+      if ( idx == 4 || idx == 7 ? date_r[idx] != '-' : ! ::isdigit( date_r[idx] ) )
+        return false;
+    }
+    return true;
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+LogCmd::LogCmd( std::vector<std::string> &&commandAliases_r )
+: ZypperBaseCommand (
+    std::move( commandAliases_r ),
+    // translators: command synopsis; do not translate lowercase words
+    _("log [OPTIONS] [PID] ..."),
+    // translators: command summary: log
+    _("List the zypper runs in the log or show the log of a run."),
+    // translators: command description
+    { _("Without arguments list the zypper and YaST runs found in the zypper log file. Given the PID of a run, show the lines logged by this run."),
+      _("The runs found in a log file are remembered in an index, so the log file is not read again unless it changed. Rotated log files are read as they are, compressed or not.") },
+    NoZYpp )
+{}
+
+ZyppFlags::CommandGroup LogCmd::cmdOptions() const
+{
+  auto that = const_cast<LogCmd *>( this );
+  return {{
+    { "log-file", 'l', ZyppFlags::RequiredArgument, ZyppFlags::PathNameType( that->_logFile, boost::optional<std::string>(), ARG_FILE ),
+      // translators: -l, --log-file <FILE>
+      str::Format(_("Read this log file instead of '%1%'.")) % ZYPPER_LOG
+    },
+    { "rotated", 'r', ZyppFlags::RequiredArgument, ZyppFlags::IntType( &that->_rotated ),
+      // translators: -r, --rotated <NUMBER>
+      _("Also read the given number of most recent rotated log files.")
+    },
+    { "date", 'd', ZyppFlags::RequiredArgument, ZyppFlags::StringType( &that->_date, boost::optional<const char *>(), "YYYY[-MM[-DD]]" ),
+      // translators: -d, --date <YYYY[-MM[-DD]]>
+      _("Only the runs started at this date.")
+    },
+    { "downloads", '\0', ZyppFlags::NoArgument, ZyppFlags::BoolType( &that->_downloads, ZyppFlags::StoreTrue, _downloads ),
+      // translators: --downloads
+      _("Show only the download URLs and the mirror statistics of the runs.")
+    },
+    { "no-index", '\0', ZyppFlags::NoArgument, ZyppFlags::BoolType( &that->_noIndex, ZyppFlags::StoreTrue, _noIndex ),
+      // translators: --no-index
+      _("Neither use nor update the index of the log files.")
+    }
+  }};
+}
+
+void LogCmd::doReset()
+{
+  _logFile = Pathname();
+  _rotated = 0;
+  _date.clear();
+  _downloads = false;
+  _noIndex = false;
+}
+
+int LogCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
+{
+  if ( zypper.out().type() == Out::TYPE_XML )
+  {
+    zypper.out().error(_("XML output not implemented for this command.") );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+  if ( zypper.out().type() == OutJSON::TYPE_JSON )
+  {
+    zypper.out().error(_("JSON output not implemented for this command.") );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  if ( _rotated < 0 )
+  {
+    zypper.out().error( str::Format(_("Invalid number of rotated log files '%1%'.")) % _rotated );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+  if ( ! _date.empty() && ! validDate( _date ) )
+  {
+    zypper.out().error( str::Format(_("Date '%1%' does not match the format 'YYYY[-MM[-DD]]'.")) % _date );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+  std::vector<unsigned> pids;
+  for ( const std::string & arg : positionalArgs_r )
+  {
+    if ( arg.empty() || arg.find_first_not_of( "0123456789" ) != std::string::npos )
+    {
+      zypper.out().error( str::Format(_("Invalid PID '%1%'.")) % arg );
+      return ZYPPER_EXIT_ERR_INVALID_ARGS;
+    }
+    pids.push_back( str::strtonum<unsigned>( arg ) );
+  }
+
+  Pathname stem { _logFile.empty() ? Pathname::assertprefix( zypper.config().root_dir, ZYPPER_LOG ) : _logFile };
+  std::vector<Pathname> logs { LogIndex::logFiles( stem, _rotated ) };
+  if ( logs.empty() )
+  {
+    zypper.out().error( str::Format(_("Can not read '%1%'.")) % stem );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  Pathname indexDir;
+  if ( ! _noIndex && ! zypperUserCacheDir().empty() )
+    indexDir = zypperUserCacheDir() / "log-index";
+
+  auto wanted = [&]( const LogIndex::Run & run_r ) {
+    return str::hasPrefix( run_r._time, _date )
+      && ( pids.empty() || std::find( pids.begin(), pids.end(), run_r._pid ) != pids.end() );
+  };
+
+  int ret = ZYPPER_EXIT_OK;
+  Table t;
+  t << ( TableHeader() << _("Time") << _("PID") << _("Version") << _("Command") );
+  unsigned found = 0;
+  for ( const Pathname & log : logs )
+  {
+    try
+    {
+      LogIndex index { log, indexDir };
+      std::vector<const LogIndex::Run *> runs;
+      for ( const LogIndex::Run & run : index.runs() )
+      {
+        if ( ! wanted( run ) )
+          continue;
+        ++found;
+        if ( _downloads || ! pids.empty() )
+          runs.push_back( &run );
+        else
+          t << ( TableRow() << run._time << run._pid << run._version << run._command );
+      }
+      if ( runs.empty() )
+        continue;
+
+      // The log is read once for all runs (a compressed one is decompressed
+      // once). Runs may overlap, so their lines are collected per run and
+      // printed run by run.
+      std::unordered_map<const LogIndex::Run *, std::vector<std::string>> lines;
+      index.forEachLine( runs, [&]( const LogIndex::Run & run_r, const std::string & line_r ) {
+        if ( _downloads )
+        {
+          std::string info { LogIndex::downloadInfo( line_r ) };
+          if ( ! info.empty() )
+            lines[&run_r].push_back( std::move(info) );
+        }
+        else
+          lines[&run_r].push_back( line_r );
+        return true;
+      });
+
+      for ( const LogIndex::Run * run : runs )
+      {
+        const std::vector<std::string> & runlines { lines[run] };
+        if ( _downloads )
+        {
+          cout << str::Format(_("Run %1% started %2%: %3%")) % run->_pid % run->_time % run->_command << endl;
+          for ( const std::string & info : runlines )
+          {
+            cout << "  " << info << endl;
+            if ( info.find( "done:" ) != std::string::npos )
+              cout << endl;
+          }
+        }
+        else
+        {
+          for ( const std::string & line : runlines )
+            cout << line << endl;
+        }
+      }
+    }
+    catch ( const Exception & e )
+    {
+      ZYPP_CAUGHT( e );
+      zypper.out().error( e.asUserString() );
+      ret = ZYPPER_EXIT_ERR_ZYPP;
+    }
+  }
+
+  if ( ! indexDir.empty() )
+    LogIndex::prune( indexDir );
+
+  if ( ! found )
+    zypper.out().info(_("No matching runs found.") );
+  else if ( pids.empty() && ! _downloads )
+    cout << t;
+
+  return ret;
+}
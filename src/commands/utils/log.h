@@ -0,0 +1,35 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_COMMANDS_UTILS_LOG_INCLUDED
+#define ZYPPER_COMMANDS_UTILS_LOG_INCLUDED
+
+#include "commands/basecommand.h"
+#include "utils/flags/zyppflags.h"
+
+#include <zypp/Pathname.h>
+
+/** List the zypper runs in the log or show the log of a run (see \ref LogIndex). */
+class LogCmd : public ZypperBaseCommand
+{
+public:
+  LogCmd( std::vector<std::string> &&commandAliases_r );
+
+  // ZypperBaseCommand interface
+protected:
+  zypp::ZyppFlags::CommandGroup cmdOptions() const override;
+  void doReset() override;
+  int execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r ) override;
+
+private:
+  zypp::Pathname _logFile;
+  int _rotated = 0;
+  std::string _date;
+  bool _downloads = false;
+  bool _noIndex = false;
+};
+
+#endif
@@ -25,7 +25,7 @@ TargetOSCmd::TargetOSCmd(std::vector<std::string> &&commandAliases_r) :
       _("If the baseproduct does not provide this entry, or if no baseproduct is installed at all, the value is empty if the --terse global option is used."),
       _("In not-terse mode the distribution label is shown instead of an empty value, if a baseproduct is installed."),
     },
-    DisableAll
+    NoZYpp
   )
 { }
 
@@ -21,7 +21,7 @@ VersionCompareCmd::VersionCompareCmd(std::vector<std::string> &&commandAliases_r
     _("Compare two version strings."),
     // translators: command description
     _("Compare the versions supplied as arguments."),
-    DisableAll
+    NoZYpp
   )
 { }
 
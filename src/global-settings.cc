@@ -14,6 +14,7 @@ void GlobalSettings::reset()
   LicenseAgreementPolicy::reset();
   DupSettings::reset();
   FileConflictPolicy::reset();
+  TransactionBundleSettings::reset();
 }
 
 bool LicenseAgreementPolicyData::_defaultAutoAgreeWithLicenses = false;
@@ -74,6 +74,7 @@ struct SolverSettingsData
   zypp::TriBool _allowArchChange = zypp::indeterminate;
   zypp::TriBool _cleanDeps = zypp::indeterminate;
   zypp::TriBool _removeOrphaned = zypp::indeterminate;  // by now libsolv supports it in distupgrade only
+  bool _reuseSolution = false;  // save a --dry-run solution, replay it in the real run
 };
 using SolverSettings = GlobalSettingSingleton<SolverSettingsData>;
 
@@ -98,6 +99,15 @@ struct FileConflictPolicyData
 };
 using FileConflictPolicy = GlobalSettingSingleton<FileConflictPolicyData>;
 
+/**
+ * Export the solved transaction and its rpms instead of installing it (\c --export-bundle)
+ */
+struct TransactionBundleSettingsData
+{
+  std::string _exportDir;
+};
+using TransactionBundleSettings = GlobalSettingSingleton<TransactionBundleSettingsData>;
+
 
 
 #endif
@@ -260,6 +260,54 @@ namespace {
 } // namespace
 ///////////////////////////////////////////////////////////////////
 
+std::optional<RepoNameFilter> printInfoRepoNameFilter( const std::vector<std::string> &names_r, const PrintInfoOptions &options_r )
+{
+  if ( options_r._matchSubstrings || names_r.empty() )
+    return std::nullopt;
+
+  // Pattern contents and product requirements are looked up in the whole pool.
+  auto needsFullPool = []( const ResKind & kind_r ) {
+    return kind_r == ResKind::pattern || kind_r == ResKind::product;
+  };
+  for ( const ResKind & kind : options_r._kinds )
+  {
+    if ( needsFullPool( kind ) )
+      return std::nullopt;
+  }
+
+  // The names checkVersioned may look up.
+  static const zypp::str::regex rxVers { "^(.+)-([^-]+)$" };
+  RepoNameFilter ret;
+  ret._fullLoadIfUnmatched = true;	// report 'not found' based on the whole pool, as without filter
+  unsigned kindless = 0;
+  for ( const std::string & rawarg : names_r )
+  {
+    KNSplit kn( rawarg );
+    if ( needsFullPool( kn._kind ) )
+      return std::nullopt;
+    if ( ! kn._kind )
+      ++kindless;
+    std::vector<std::string> names { kn._name };
+    str::smatch what;
+    if ( zypp::str::regex_match( kn._name, what, rxVers ) )
+    {
+      std::string name = what[1];	// name-version
+      names.push_back( name );
+      if ( zypp::str::regex_match( name, what, rxVers ) )
+        names.push_back( what[1] );	// name-version-release
+    }
+    ret._names.push_back( std::move(names) );
+  }
+
+  // Without a kind info prefers packages but falls back to any kind (e.g. a pattern).
+  // Matching just packages leaves such names unmatched, so all repos are loaded.
+  if ( ! options_r._kinds.empty() || ! kindless )
+    ret._anyKind = true;
+  else if ( kindless != names_r.size() )
+    return std::nullopt;	// a kind:name would match a pattern for a plain name too
+  return ret;
+}
+
 void printInfo( Zypper & zypper, const std::vector<std::string> &names_r, const PrintInfoOptions &options_r )
 {
   zypper.out().gap();
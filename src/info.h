@@ -8,6 +8,8 @@
 #ifndef ZYPPERINFO_H_
 #define ZYPPERINFO_H_
 
+#include <optional>
+
 #include <zypp/PoolItem.h>
 #include <zypp/ResKind.h>
 #include <zypp/ui/Selectable.h>
@@ -37,4 +39,7 @@ struct PrintInfoOptions {
 
 void printInfo(Zypper & zypper, const std::vector<std::string> &names_r, const PrintInfoOptions &options_r );
 
+/** The names \ref printInfo may look up; only repos containing them need to be loaded. */
+std::optional<RepoNameFilter> printInfoRepoNameFilter( const std::vector<std::string> &names_r, const PrintInfoOptions &options_r );
+
 #endif /*ZYPPERINFO_H_*/
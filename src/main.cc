@@ -11,14 +11,9 @@
 #include "main.h"
 #include "Zypper.h"
 
-#include "callbacks/rpm.h"
-#include "callbacks/keyring.h"
-#include "callbacks/repo.h"
-#include "callbacks/media.h"
-#include "callbacks/locks.h"
-#include "callbacks/job.h"
 #include "output/OutNormal.h"
 #include "utils/messages.h"
+#include "utils/MemStats.h"
 
 namespace env
 {
@@ -164,35 +159,14 @@ try {
 
   readline_setup(); // bsc#1226493# let readline abort on Ctrl-C
 
-  try
-  {
-    static RpmCallbacks rpm_callbacks;
-    static SourceCallbacks source_callbacks;
-    static MediaCallbacks media_callbacks;
-    static KeyRingCallbacks keyring_callbacks;
-    static DigestCallbacks digest_callbacks;
-    static LocksCallbacks locks_callbacks;
-    static JobCallbacks job_callbacks;
-  }
-  catch ( const Exception & e )
-  {
-    ZYPP_CAUGHT( e );
-    zypper.out().error( e, "Failed to initialize zypper callbacks." );
-    report_a_bug( zypper.out() );
-    return ZYPPER_EXIT_ERR_BUG;
-  }
-  catch (...)
-  {
-    zypper.out().error( "Failed to initialize zypper callbacks." );
-    ERR << "Failed to initialize zypper callbacks." << endl;
-    report_a_bug( zypper.out() );
-    return ZYPPER_EXIT_ERR_BUG;
-  }
+  // NOTE: The callback receivers are set up by Zypper::assertZYppPtrGod,
+  // as only commands using the ZYpp instance need them.
 
   int & exitcode { say_goodbye.exitcode };
   exitcode = zypper.main( argc, argv );
   if ( !exitcode )
     exitcode = zypper.exitInfoCode();	// propagate refresh errors even if main action succeeded
+  MemStats::instance().report();	// --memstats
   return exitcode;
 }
 catch (...) {
@@ -0,0 +1,254 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <zypp/base/String.h>
+
+#include "OutJSON.h"
+#include "utils/misc.h"
+#include "Table.h"
+
+using std::cout;
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+// OutJSON::Line
+///////////////////////////////////////////////////////////////////
+
+OutJSON::Line::Line( const std::string & event_r )
+: Line( cout, event_r )
+{}
+
+OutJSON::Line::Line( std::ostream & str_r, const std::string & event_r )
+: _str { str_r }
+{
+  _buffer = "{\"event\":\"" + escape( event_r ) + "\"";
+}
+
+OutJSON::Line::~Line()
+{
+  _buffer += "}\n";
+  _str << _buffer << std::flush;
+}
+
+OutJSON::Line & OutJSON::Line::add( const std::string & key_r, const std::string & val_r )
+{ return addRaw( key_r, "\"" + escape( val_r ) + "\"" ); }
+
+OutJSON::Line & OutJSON::Line::addRaw( const std::string & key_r, const std::string & json_r )
+{
+  _buffer += ",\"";
+  _buffer += escape( key_r );
+  _buffer += "\":";
+  _buffer += json_r;
+  return *this;
+}
+
+///////////////////////////////////////////////////////////////////
+// OutJSON
+///////////////////////////////////////////////////////////////////
+
+OutJSON::OutJSON( Verbosity verbosity_r )
+: Out( TYPE_JSON, verbosity_r )
+{}
+
+OutJSON::~OutJSON()
+{}
+
+std::string OutJSON::escape( const std::string & val_r )
+{
+  std::string ret;
+  ret.reserve( val_r.size() );
+  for ( unsigned char ch : val_r )
+  {
+    switch ( ch )
+    {
+      case '"':  ret += "\\\""; break;
+      case '\\': ret += "\\\\"; break;
+      case '\n': ret += "\\n";  break;
+      case '\r': ret += "\\r";  break;
+      case '\t': ret += "\\t";  break;
+      case '\b': ret += "\\b";  break;
+      case '\f': ret += "\\f";  break;
+      default:
+        if ( ch < 0x20 || ch == 0x7f )
+          ret += str::form( "\\u%04x", ch );
+        else
+          ret += ch;
+        break;
+    }
+  }
+  return ret;
+}
+
+bool OutJSON::mine( Type type )
+{
+  if ( type & TYPE_JSON )
+    return true;
+  return false;
+}
+
+bool OutJSON::infoWarningFilter( Verbosity verbosity_r, Type mask )
+{
+  if ( !mine(mask) )
+    return true;
+  if ( verbosity() < verbosity_r )
+    return true;
+  return false;
+}
+
+void OutJSON::writeMessage( const char * type_r, const std::string & text_r, const std::string & hint_r )
+{
+  Line( "message" ).add( "type", type_r ).add( "text", text_r ).addOptional( "hint", hint_r );
+}
+
+void OutJSON::info( const std::string & msg, Verbosity verbosity_r, Type mask )
+{
+  if ( infoWarningFilter( verbosity_r, mask ) || msg.empty() )	// no visual separators
+    return;
+  writeMessage( "info", msg );
+}
+
+void OutJSON::warning( const std::string & msg, Verbosity verbosity_r, Type mask )
+{
+  if ( infoWarningFilter( verbosity_r, mask ) )
+    return;
+  writeMessage( "warning", msg );
+}
+
+void OutJSON::error( const std::string & problem_desc, const std::string & hint )
+{
+  writeMessage( "error", problem_desc, hint );
+}
+
+void OutJSON::error( const zypp::Exception & e, const std::string & problem_desc, const std::string & hint )
+{
+  Line( "message" )
+    .add( "type", "error" )
+    .add( "text", problem_desc )
+    .add( "cause", zyppExceptionReport( e ) )
+    .addOptional( "hint", hint );
+}
+
+void OutJSON::progressStart( const std::string & id, const std::string & label, bool has_range )
+{
+  if ( progressFilter() )
+    return;
+
+  Line line( "progress" );
+  line.add( "id", id ).add( "name", label );
+  if ( has_range )
+    line.add( "value", 0 );
+}
+
+void OutJSON::progress( const std::string & id, const std::string & label, int value )
+{
+  if ( progressFilter() )
+    return;
+
+  Line line( "progress" );
+  line.add( "id", id ).add( "name", label );
+  // missing value means 'is-alive' notification
+  if ( value >= 0 )
+    line.add( "value", value );
+}
+
+void OutJSON::progressEnd( const std::string & id, const std::string & label, const std::string & /*donetag*/, bool error )
+{
+  if ( progressFilter() )
+    return;
+
+  Line( "progress" ).add( "id", id ).add( "name", label ).add( "done", !error );
+}
+
+void OutJSON::dwnldProgressStart( const Url & uri )
+{
+  Line( "download" ).add( "url", uri.asString() ).add( "percent", -1 ).add( "rate", -1 );
+}
+
+void OutJSON::dwnldProgress( const Url & uri, int value, long rate )
+{
+  Line( "download" ).add( "url", uri.asString() ).add( "percent", value ).add( "rate", rate );
+}
+
+void OutJSON::dwnldProgressEnd( const Url & uri, long rate, TriBool error )
+{
+  Line( "download" ).add( "url", uri.asString() ).add( "rate", rate ).add( "done", bool(!error) );
+}
+
+void OutJSON::searchResult( const Table & table_r )
+{
+  // *** CAUTION: Must match the header list defined in FillSearchTableSolvable
+  //              ctor (search.cc), like OutXML::searchResult does.
+  std::vector<std::string> header;
+  {
+    const TableHeader & theader( table_r.header() );
+    for ( const std::string & col : theader.columnsNoTr() )
+    {
+      if ( col == "S" )
+        header.push_back( "status" );
+      else if ( col == "Type" )
+        header.push_back( "kind" );
+      else if ( col == "Version" )
+        header.push_back( "edition" );
+      else
+        header.push_back( str::toLower( col ) );
+    }
+  }
+
+  for ( const TableRow & row : table_r.rows() )
+  {
+    Line line( "solvable" );
+    unsigned cidx = 0;
+    for ( const std::string & col : row.columns() )
+    {
+      const std::string & key { cidx < header.size() ? header[cidx] : std::string("?") };
+      if ( cidx == 0 )
+      {
+        if ( col[0] == 'i' || col[0] == 'I' )	// test 1st char as locked is "iL"/"IL"
+          line.add( key, "installed" );
+        else if ( col[0] == 'v' )		// test 1st char as locked is "vL"
+          line.add( key, "other-version" );
+        else
+          line.add( key, "not-installed" );
+      }
+      else
+        line.add( key, col );
+      ++cidx;
+    }
+  }
+}
+
+void OutJSON::prompt( PromptId id, const std::string & prompt, const PromptOptions & poptions, const std::string & startdesc )
+{
+  std::string options { "[" };
+  unsigned i = 0;
+  for ( PromptOptions::StrVector::const_iterator it = poptions.options().begin(); it != poptions.options().end(); ++it, ++i )
+  {
+    if ( poptions.isDisabled( i ) )
+      continue;
+    if ( options.size() > 1 )
+      options += ",";
+    options += "{\"value\":\"" + escape( *it ) + "\",\"desc\":\"" + escape( poptions.optionHelp( i ) ) + "\"";
+    if ( poptions.defaultOpt() == i )
+      options += ",\"default\":true";
+    options += "}";
+  }
+  options += "]";
+
+  Line( "prompt" )
+    .add( "id", int(id) )
+    .addOptional( "description", startdesc )
+    .add( "text", prompt )
+    .addRaw( "options", options );
+}
+
+void OutJSON::promptHelp( const PromptOptions & poptions )
+{
+  // nothing to do here
+}
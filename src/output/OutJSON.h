@@ -0,0 +1,115 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_OUTPUT_OUTJSON_H_
+#define ZYPPER_OUTPUT_OUTJSON_H_
+
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+
+#include "output/Out.h"
+
+class Table;
+
+/**
+ * JSON Lines output (\c --jsonout).
+ *
+ * Every message, progress tick, download report and result row is written
+ * as a self-contained JSON object on a line of it's own. The \c "event"
+ * member tells what kind of object it is:
+ * \code
+ * {"event":"message","type":"info","text":"Loading repository data..."}
+ * {"event":"progress","id":"raw-refresh","name":"Retrieving repository 'OSS' metadata","value":42}
+ * {"event":"summary-item","list":"to-upgrade","kind":"package","name":"glibc",...}
+ * \endcode
+ * Unlike \ref OutXML there is no enclosing document, so consumers may
+ * process the stream line by line with constant memory.
+ *
+ * Commands which do not (yet) support JSON print their plain text results;
+ * such lines do not start with a \c '{'.
+ */
+class OutJSON : public Out
+{
+public:
+  /** The output type of \ref OutJSON (beyond the ones known to \ref Out). */
+  static constexpr TypeBit TYPE_JSON = TypeBit( 0x1<<2 );
+
+  OutJSON( Verbosity verbosity );
+  ~OutJSON() override;
+
+  /** Escape \a val_r for use inside a JSON string (UTF-8 is passed through). */
+  static std::string escape( const std::string & val_r );
+
+  /**
+   * One JSON object, written as a single line when going out of scope.
+   * \code
+   * OutJSON::Line( "update" ).add( "name", pi.name() ).add( "edition", pi.edition().asString() );
+   * \endcode
+   */
+  class Line
+  {
+  public:
+    /** Start the object for \a event_r (to be written to \c cout). */
+    Line( const std::string & event_r );
+    Line( std::ostream & str_r, const std::string & event_r );
+    ~Line();
+
+    Line( const Line & ) = delete;
+    Line & operator=( const Line & ) = delete;
+
+    Line & add( const std::string & key_r, const std::string & val_r );
+    Line & add( const std::string & key_r, const char * val_r )
+    { return add( key_r, std::string( val_r ) ); }
+    Line & add( const std::string & key_r, bool val_r )
+    { return addRaw( key_r, val_r ? "true" : "false" ); }
+    template <class Tp, std::enable_if_t<std::is_integral_v<Tp> && ! std::is_same_v<Tp,bool>, int> = 0>
+    Line & add( const std::string & key_r, Tp val_r )
+    { return addRaw( key_r, std::to_string( val_r ) ); }
+
+    /** Add \a val_r if it is not empty. */
+    Line & addOptional( const std::string & key_r, const std::string & val_r )
+    { return val_r.empty() ? *this : add( key_r, val_r ); }
+
+    /** Add \a json_r which must already be valid JSON (e.g. an array). */
+    Line & addRaw( const std::string & key_r, const std::string & json_r );
+
+  private:
+    std::ostream & _str;
+    std::string _buffer;	///< written at once, so lines are never torn
+  };
+
+public:
+  void info( const std::string & msg, Verbosity verbosity, Type mask ) override;
+  void warning( const std::string & msg, Verbosity verbosity, Type mask ) override;
+  void error( const std::string & problem_desc, const std::string & hint ) override;
+  void error( const zypp::Exception & e, const std::string & problem_desc, const std::string & hint ) override;
+
+  // progress
+  void progressStart( const std::string & id, const std::string & label, bool is_tick ) override;
+  void progress( const std::string & id, const std::string & label, int value ) override;
+  void progressEnd( const std::string & id, const std::string & label, const std::string & donetag, bool error ) override;
+
+  // progress with download rate
+  void dwnldProgressStart( const zypp::Url & uri ) override;
+  void dwnldProgress( const zypp::Url & uri, int value, long rate ) override;
+  void dwnldProgressEnd( const zypp::Url & uri, long rate, zypp::TriBool error ) override;
+
+  void searchResult( const Table & table_r ) override;
+
+  void prompt( PromptId id, const std::string & prompt, const PromptOptions & poptions, const std::string & startdesc ) override;
+
+  void promptHelp( const PromptOptions & poptions ) override;
+
+protected:
+  bool mine( Type type ) override;
+
+private:
+  bool infoWarningFilter( Verbosity verbosity, Type mask );
+  void writeMessage( const char * type_r, const std::string & text_r, const std::string & hint_r = std::string() );
+};
+
+#endif // ZYPPER_OUTPUT_OUTJSON_H_
@@ -0,0 +1,43 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include <unistd.h>
+
+#include "output/ProgressThrottle.h"
+
+ProgressThrottle & ProgressThrottle::instance()
+{
+  static ProgressThrottle _instance { ::isatty( STDOUT_FILENO ) != 0 };
+  return _instance;
+}
+
+ProgressThrottle::ProgressThrottle( bool isatty_r )
+: _isatty { isatty_r }
+{}
+
+bool ProgressThrottle::due( const Out & out_r, const std::string & id_r, int value_r, Clock::time_point now_r )
+{
+  auto it = _bars.find( id_r );
+  bool first = ( it == _bars.end() );
+  Bar & bar { first ? _bars[id_r] : it->second };
+
+  bool draw = false;
+  const Clock::time_point & now { now_r };
+  if ( out_r.type() != Out::TYPE_NORMAL )	// XML or JSON
+    draw = first || value_r != bar._value || ( value_r < 0 && now - bar._last >= interval );
+  else if ( _isatty )
+    draw = first || now - bar._last >= interval || ( value_r != bar._value && value_r >= 100 );
+
+  if ( draw )
+  {
+    bar._last = now;
+    bar._value = value_r;
+  }
+  return draw;
+}
+
+void ProgressThrottle::done( const std::string & id_r )
+{ _bars.erase( id_r ); }
@@ -0,0 +1,71 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_OUTPUT_PROGRESSTHROTTLE_H_
+#define ZYPPER_OUTPUT_PROGRESSTHROTTLE_H_
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+#include "output/Out.h"
+
+/**
+ * Coalesce progress updates to a fixed refresh rate.
+ *
+ * Download and rpm callbacks may report progress thousands of times per
+ * second. Callbacks ask \ref due before passing an update to \ref Out, so
+ * each progress bar (identified by it's id) is redrawn at most every
+ * \ref interval. Several bars may be active at the same time, each is
+ * throttled on it's own.
+ *
+ * \li On a terminal an update is drawn if the interval has elapsed, or if
+ *     it completes the bar (100%) so the final state is always shown.
+ * \li If stdout is not a terminal, there is no line to redraw. Intermediate
+ *     updates are dropped, only start and end of a progress are printed.
+ * \li XML and JSON output keep their \c progress semantics, but an update is
+ *     written only if the value actually changed ('is alive' notifications
+ *     at most every interval).
+ *
+ * Start and end of a progress are not affected and should still be passed
+ * to \ref Out unconditionally.
+ */
+class ProgressThrottle
+{
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  /** The minimum time between two redraws of a bar on a terminal (10Hz). */
+  static constexpr std::chrono::milliseconds interval { 100 };
+
+  static ProgressThrottle & instance();
+
+  /** Ctor for testing: as if stdout is a terminal or not (\ref instance checks stdout). */
+  explicit ProgressThrottle( bool isatty_r );
+
+  /** Whether to draw the update of bar \a id_r to \a value_r now.
+   * A negative \a value_r is an 'is alive' notification without value.
+   */
+  bool due( const Out & out_r, const std::string & id_r, int value_r )
+  { return due( out_r, id_r, value_r, Clock::now() ); }
+
+  /** \overload at time \a now_r */
+  bool due( const Out & out_r, const std::string & id_r, int value_r, Clock::time_point now_r );
+
+  /** Forget about bar \a id_r, e.g. at the end of a progress. */
+  void done( const std::string & id_r );
+
+private:
+  struct Bar
+  {
+    Clock::time_point _last;	//< when it was drawn
+    int _value = -1;		//< the value drawn
+  };
+  std::unordered_map<std::string,Bar> _bars;
+  bool _isatty;
+};
+
+#endif // ZYPPER_OUTPUT_PROGRESSTHROTTLE_H_
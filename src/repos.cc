@@ -8,7 +8,9 @@
 #include <iostream>
 #include <fstream>
 #include <iterator>
+#include <algorithm>
 #include <list>
+#include <set>
 
 #include <zypp/ZYpp.h>
 #include <zypp/base/Logger.h>
@@ -28,8 +30,12 @@
 #include "Table.h"
 #include "utils/messages.h"
 #include "utils/misc.h"
+#include "utils/MemStats.h"
 #include "utils/prompt.h"
 #include "repos.h"
+#include "PackageCacheTrim.h"
+#include "PackageStore.h"
+#include "MultiRoot.h"
 #include "global-settings.h"
 
 #include "commands/services/common.h"
@@ -201,6 +207,7 @@ void repoPrioSummary( Zypper & zypper )
 
 bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_download )
 {
+  MultiRoot::CacheLock cacheLock;	// --roots children share the host caches
   RuntimeData & gData( zypper.runtimeData() );
   gData.current_repo = repo;
   bool do_refresh = false;
@@ -412,6 +419,7 @@ bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_do
 
 bool build_cache( Zypper & zypper, const RepoInfo & repo, bool force_build )
 {
+  MultiRoot::CacheLock cacheLock;	// --roots children share the host caches
   if ( force_build )
     zypper.out().info(_("Forcing building of repository cache") );
 
@@ -1021,7 +1029,7 @@ void clean_repos(Zypper & zypper , std::vector<std::string> specificRepos, Clean
   bool clean_all =		flags.testFlag( CleanRepoBits::CleanAll );
   bool clean_metadata =		( clean_all || flags.testFlag( CleanRepoBits::CleanMetaData ) );
   bool clean_raw_metadata =	( clean_all || flags.testFlag( CleanRepoBits::CleanRawMetaData ) );
-  bool clean_packages =		( clean_all || !( clean_metadata || clean_raw_metadata ) );
+  bool clean_packages =		( clean_all || !( clean_metadata || clean_raw_metadata ) ) && ! flags.testFlag( CleanRepoBits::KeepPackages );
 
   DBG << "Metadata will be cleaned: " << clean_metadata << endl;
   DBG << "Raw metadata will be cleaned: " << clean_raw_metadata << endl;
@@ -1124,6 +1132,8 @@ void clean_repos(Zypper & zypper , std::vector<std::string> specificRepos, Clean
     // this could also be done with a special option
     filesystem::recursive_rmdir( Pathname::assertprefix( zypper.config().root_dir, ZYPPER_RPM_CACHE_DIR ) );
   }
+  if ( clean_packages )
+    PackageStore::instance().prune();	// files of the cleaned caches
 
   if ( enabled_repo_count > 0 && error_count >= enabled_repo_count )
   {
@@ -1143,6 +1153,61 @@ void clean_repos(Zypper & zypper , std::vector<std::string> specificRepos, Clean
     zypper.out().info(_("All repositories have been cleaned up.") );
 }
 
+void trim_package_caches( Zypper & zypper, const std::vector<std::string> & specificRepos, ByteCount maxSize_r, unsigned maxAgeDays_r,
+                          const std::vector<sat::Solvable> & keep_r )
+{
+  std::list<RepoInfo> repos;
+  try
+  {
+    RepoManager & manager( zypper.repoManager() );
+    if ( specificRepos.empty() )
+      repos.insert( repos.end(), manager.repoBegin(), manager.repoEnd() );
+    else
+    {
+      std::list<std::string> not_found;
+      get_repos( zypper, specificRepos.begin(), specificRepos.end(), repos, not_found );
+      report_unknown_repos( zypper.out(), not_found );
+    }
+  }
+  catch ( const Exception & e )
+  {
+    ZYPP_CAUGHT( e );
+    zypper.out().error( e, _("Error reading repositories:") );
+    zypper.setExitCode( ZYPPER_EXIT_ERR_ZYPP );
+    return;
+  }
+
+  PackageCacheTrim trim( maxSize_r, maxAgeDays_r );
+  for ( const RepoInfo & repo : repos )
+    trim.addCacheDir( repo.packagesPath() );
+
+  // keep the rpms of the installed packages
+  if ( sat::Pool::instance().findSystemRepo() == Repository::noRepository )
+  {
+    init_target( zypper );
+    load_target_resolvables( zypper );
+  }
+  Repository system { sat::Pool::instance().findSystemRepo() };
+  if ( system == Repository::noRepository )
+  {
+    // Better keep everything than removing the rpms of installed packages.
+    zypper.out().error(_("Cannot trim the package caches without reading the installed packages.") );
+    zypper.setExitCode( ZYPPER_EXIT_ERR_ZYPP );
+    return;
+  }
+  for_( it, system.solvablesBegin(), system.solvablesEnd() )
+    trim.keep( *it );
+  for ( const sat::Solvable & solv : keep_r )
+    trim.keep( solv );
+
+  PackageCacheTrim::Result result { trim.run() };
+  if ( result._removed )
+    PackageStore::instance().prune();
+  // translators: %1% and %2% are numbers of rpm files, %3% their size (e.g. '1.2 GiB')
+  zypper.out().info( str::Format(_("Removed %1% of %2% cached packages (%3%).")) % result._removed % result._files % result._freed,
+                     result._removed ? Out::NORMAL : Out::HIGH );
+}
+
 // ----------------------------------------------------------------------------
 
 bool add_repo( Zypper & zypper, RepoInfo & repo, bool noCheck )
@@ -1754,6 +1819,7 @@ void load_resolvables( Zypper & zypper )
 
 void load_repo_resolvables( Zypper & zypper )
 {
+  MemStats::Phase memPhase( "load repos" );
   RepoManager & manager = zypper.repoManager();
   RuntimeData & gData = zypper.runtimeData();
 
@@ -1761,6 +1827,33 @@ void load_repo_resolvables( Zypper & zypper )
   if ( gData.repos.empty() )
     zypper.out().warning(_("No repositories defined. Operating only with the installed resolvables. Nothing can be installed.") );
 
+  // Commands looking up just a few names may skip repos which do not contain them.
+  auto solvDir = [&zypper]( const RepoInfo & repo_r ) {
+    return zypper.config().rm_options.repoSolvCachePath / repo_r.escaped_alias();
+  };
+  std::set<std::string> skipRepos;
+  if ( gData.repoNameFilter && ! gData.repoNameFilter->_names.empty() && ! zypper.runningShell() )
+  {
+    const RepoNameFilter & filter { *gData.repoNameFilter };
+    std::vector<bool> found( filter._names.size(), false );
+    for ( const RepoInfo & repo : gData.repos )
+    {
+      if ( ! repo.enabled() )
+        continue;
+      RepoNameIndex index { solvDir( repo ) };
+      std::vector<bool> matches { filter.matches( index ) };
+      if ( std::find( matches.begin(), matches.end(), true ) == matches.end() )
+        skipRepos.insert( repo.alias() );
+      for ( unsigned i = 0; i < matches.size(); ++i )
+        if ( matches[i] ) found[i] = true;
+    }
+    if ( filter._fullLoadIfUnmatched && std::find( found.begin(), found.end(), false ) != found.end() )
+    {
+      MIL << "Some names are in no repo name index. Loading all repos." << endl;
+      skipRepos.clear();
+    }
+  }
+
   bool hintExpired = false;
   for_( it, gData.repos.begin(), gData.repos.end() )
   {
@@ -1774,6 +1867,12 @@ void load_repo_resolvables( Zypper & zypper )
       continue;     // #217297
     }
 
+    if ( skipRepos.count( repo.alias() ) )
+    {
+      DBG << "Skipping repo '" << repo.alias() << "' (contains none of the names)" << endl;
+      continue;
+    }
+
     try
     {
       bool error = false;
@@ -1809,15 +1908,20 @@ void load_repo_resolvables( Zypper & zypper )
         }
       }
 
-      manager.loadFromCache( repo );
-
       // check that the metadata is not outdated
       // feature #301904
       // ma@: Using God->pool() here would always rebuild the pools index tables,
       // because loading a new repo invalidates them. Rebuilding the whatprovides
       // index is sometimes slow, so we avoid this overhead by directly accessing
       // the sat::Pool.
-      Repository robj = sat::Pool::instance().reposFind( repo.alias() );
+      Repository robj;
+      {
+        MultiRoot::CacheLock cacheLock( true );	// no --roots sibling rebuilds it meanwhile
+        manager.loadFromCache( repo );
+        robj = sat::Pool::instance().reposFind( repo.alias() );
+        if ( robj != Repository::noRepository )
+          RepoNameIndex( solvDir( repo ) ).update( robj );
+      }
       if ( robj != Repository::noRepository && robj.maybeOutdated() )
       {
         zypper.out().warning( str::Format(_("Repository '%1%' metadata expired since %2%."))
@@ -1849,6 +1953,7 @@ void load_repo_resolvables( Zypper & zypper )
 
 void load_target_resolvables(Zypper & zypper)
 {
+  MemStats::Phase memPhase( "load target" );
   MIL << "Going to read RPM database" << endl;
   zypper.out().info( _("Reading installed packages...") );
 
@@ -1871,6 +1976,7 @@ std::vector<std::string> createTempRepoFromArgs( Zypper &zypper, std::vector<std
   std::vector<std::string> rpms_files_caps;
   filesystem::Pathname cliRPMCache;	// temporary plaindir repo (if needed)
 
+  std::vector<std::string> rpmArgs;
   for ( std::vector<std::string>::iterator it = positionalArgs.begin(); it != positionalArgs.end(); )
   {
     if ( looks_like_rpm_file( *it ) )
@@ -1878,44 +1984,51 @@ std::vector<std::string> createTempRepoFromArgs( Zypper &zypper, std::vector<std
       DBG << *it << " looks like rpm file" << endl;
       zypper.out().info( str::Format(_("'%s' looks like an RPM file. Will try to download it.")) % *it,
         Out::HIGH );
+      rpmArgs.push_back( std::move(*it) );
+
+      // remove this rpm argument
+      it = positionalArgs.erase( it );
+    }
+    else
+      ++it;
+  }
 
-      // download the rpm into the temp cache
-      if ( cliRPMCache.empty() )
-        cliRPMCache = zypper.runtimeData().tmpdir / TMP_RPM_REPO_ALIAS / "%CLI%";
-      filesystem::Pathname rpmpath = cache_rpm( *it, cliRPMCache );
+  if ( ! rpmArgs.empty() )
+  {
+    // download the rpms into the temp cache (local ones are just linked)
+    cliRPMCache = zypper.runtimeData().tmpdir / TMP_RPM_REPO_ALIAS / "%CLI%";
+    std::vector<Pathname> rpmpaths { cache_rpms( rpmArgs, cliRPMCache ) };
+
+    for ( unsigned i = 0; i < rpmArgs.size(); ++i )
+    {
+      const Pathname & rpmpath { rpmpaths[i] };
       if ( rpmpath.empty() )
       {
-        zypper.out().error( str::Format(_("Problem with the RPM file specified as '%s', skipping.")) % *it );
+        zypper.out().error( str::Format(_("Problem with the RPM file specified as '%s', skipping.")) % rpmArgs[i] );
+        continue;
+      }
+
+      using target::rpm::RpmHeader;
+      // rpm header (need name-version-release)
+      RpmHeader::constPtr header = RpmHeader::readPackage( rpmpath, RpmHeader::NOSIGNATURE );
+      if ( header )
+      {
+        std::string nvrcap =
+          TMP_RPM_REPO_ALIAS ":" +
+          header->tag_name() + "=" +
+          str::numstring(header->tag_epoch()) + ":" +
+          header->tag_version() + "-" +
+          header->tag_release();
+        DBG << "rpm package capability: " << nvrcap << endl;
+
+        // store the rpm file capability string (name=version-release)
+        rpms_files_caps.push_back( nvrcap );
       }
       else
       {
-        using target::rpm::RpmHeader;
-        // rpm header (need name-version-release)
-        RpmHeader::constPtr header = RpmHeader::readPackage( rpmpath, RpmHeader::NOSIGNATURE );
-        if ( header )
-        {
-          std::string nvrcap =
-            TMP_RPM_REPO_ALIAS ":" +
-            header->tag_name() + "=" +
-            str::numstring(header->tag_epoch()) + ":" +
-            header->tag_version() + "-" +
-            header->tag_release();
-          DBG << "rpm package capability: " << nvrcap << endl;
-
-          // store the rpm file capability string (name=version-release)
-          rpms_files_caps.push_back( nvrcap );
-        }
-        else
-        {
-          zypper.out().error( str::Format(_("Problem reading the RPM header of %s. Is it an RPM file?")) % *it );
-        }
+        zypper.out().error( str::Format(_("Problem reading the RPM header of %s. Is it an RPM file?")) % rpmArgs[i] );
       }
-
-      // remove this rpm argument
-      it = positionalArgs.erase( it );
     }
-    else
-      ++it;
   }
 
   // If there were some rpm files, add the rpm cache as a temporary plaindir repo.
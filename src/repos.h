@@ -12,10 +12,12 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <zypp/ByteCount.h>
 #include <zypp/TriBool.h>
 #include <zypp/Url.h>
 #include <zypp/RepoInfo.h>
 #include <zypp/ServiceInfo.h>
+#include <zypp/sat/Solvable.h>
 
 #include "Zypper.h"
 #include "commands/reposerviceoptionsets.h"
@@ -101,11 +103,21 @@ enum class CleanRepoBits {
   Default = 0,
   CleanMetaData = 1,
   CleanRawMetaData = 2,
-  CleanAll = CleanMetaData | CleanRawMetaData
+  CleanAll = CleanMetaData | CleanRawMetaData,
+  KeepPackages = 4	///< don't clean the package caches (e.g. they are trimmed instead)
 };
 ZYPP_DECLARE_FLAGS_AND_OPERATORS(CleanRepoFlags, CleanRepoBits)
 void clean_repos(Zypper & zypper, std::vector<std::string> specificRepos, CleanRepoFlags flags );
 
+/**
+ * Trim the package caches of all (specified) repositories: remove rpm files
+ * not used for \a maxAgeDays_r days and the least recently used ones until the
+ * caches fit into \a maxSize_r (\c 0 is no limit). The rpm files of installed
+ * packages and of \a keep_r are kept.
+ */
+void trim_package_caches( Zypper & zypper, const std::vector<std::string> & specificRepos, zypp::ByteCount maxSize_r, unsigned maxAgeDays_r,
+                          const std::vector<zypp::sat::Solvable> & keep_r = std::vector<zypp::sat::Solvable>() );
+
 /**
  * Try match given string with any known repository.
  *
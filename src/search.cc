@@ -22,19 +22,53 @@
 
 extern ZYpp::Ptr God;
 
+///////////////////////////////////////////////////////////////////
+// class RowLabels
+///////////////////////////////////////////////////////////////////
+
+const std::string & RowLabels::kind( const ResKind & kind_r ) const
+{
+  for ( const auto & entry : _kinds )
+  {
+    if ( entry.first == kind_r )
+      return entry.second;
+  }
+  _kinds.push_back( { kind_r, kind_to_string_localized( kind_r, 1 ) } );
+  return _kinds.back().second;
+}
+
+const RowLabels::RepoEntry & RowLabels::repoEntry( const Repository & repo_r ) const
+{
+  // consecutive rows are likely from the same repo
+  if ( _lastRepo < _repos.size() && _repos[_lastRepo]._repo == repo_r )
+    return _repos[_lastRepo];
+
+  for ( _lastRepo = 0; _lastRepo < _repos.size(); ++_lastRepo )
+  {
+    if ( _repos[_lastRepo]._repo == repo_r )
+      return _repos[_lastRepo];
+  }
+  _repos.push_back( { repo_r, repo_r.asUserString(), _aliases.empty() || _aliases.count( repo_r.alias() ) } );
+  return _repos.back();	// _lastRepo == _repos.size()-1
+}
+
 ///////////////////////////////////////////////////////////////////
 // class FillSearchTableSolvable
 ///////////////////////////////////////////////////////////////////
 
 FillSearchTableSolvable::FillSearchTableSolvable( Table & table_r, TriBool instNotinst_r )
 : _table( &table_r )
+, _systemLabel( std::string("(") + _("System Packages") + ")" )
 , _instNotinst( instNotinst_r )
 {
   Zypper & zypper( Zypper::instance() );
   if ( InitRepoSettings::instance()._repoFilter.size() )
   {
+    std::set<std::string> aliases;
     for ( const auto & ri : zypper.runtimeData().repos )
-      _repos.insert( ri.alias() );
+      aliases.insert( ri.alias() );
+    _repoFilter = true;
+    _labels = RowLabels( std::move(aliases) );
   }
 
   //
@@ -59,7 +93,7 @@ FillSearchTableSolvable::FillSearchTableSolvable( Table & table_r, TriBool instN
 bool FillSearchTableSolvable::operator()( const PoolItem & pi_r ) const
 {
   // --repo => we only want the repo resolvables, not @System (bnc #467106)
-  if ( !_repos.empty() && !_repos.count( pi_r.repoInfo().alias() ) )
+  if ( _repoFilter && !_labels.wanted( pi_r.repository() ) )
     return false;
 
   // hide patterns with user visible flag not set (bnc #538152)
@@ -88,16 +122,14 @@ bool FillSearchTableSolvable::operator()( const PoolItem & pi_r ) const
       return false;
   }
 
-  TableRow row;
+  TableRow row( 6 );
   row
     << statusIndicator
     << pi_r->name()
-    << kind_to_string_localized( pi_r->kind(), 1 )
+    << _labels.kind( pi_r->kind() )
     << pi_r->edition().asString()
     << pi_r->arch().asString()
-    << ( pi_r->isSystem()
-       ? (std::string("(") + _("System Packages") + ")")
-       : pi_r->repository().asUserString() );
+    << ( pi_r->isSystem() ? _systemLabel : _labels.repository( pi_r->repository() ) );
 
   row.userData( SolvableCSI(pi_r.satSolvable(), picklistPos) );
 
@@ -398,6 +430,7 @@ void list_packages(Zypper & zypper , ListPackagesFlags flags_r )
 
   // if both --system and --orphaned are given, tag orphaned system packages
   bool tagOrphaned = system && orphaned;
+  RowLabels labels;
 
   for( const auto & sel : God->pool().proxy().byKind<Package>() )
   {
@@ -437,12 +470,17 @@ void list_packages(Zypper & zypper , ListPackagesFlags flags_r )
       if ( repofilter && pi.repository().isSystemRepo() )
         continue;
 
-      tbl << ( TableRow()
-          << (computeStatusIndicator( pi, sel )+std::string(tagOrphaned && pi.status().isOrphaned()?" (o)":""))
-          << pi.repository().asUserString()
-          << pi.name()
-          << pi.edition().asString()
-          << pi.arch().asString() );
+      TableRow row( 5 );
+      if ( tagOrphaned && pi.status().isOrphaned() )
+        row << ( computeStatusIndicator( pi, sel ) + std::string(" (o)") );
+      else
+        row << computeStatusIndicator( pi, sel );
+      row
+        << labels.repository( pi.repository() )
+        << pi.name()
+        << pi.edition().asString()
+        << pi.arch().asString();
+      tbl << std::move(row);
     }
   }
 
@@ -8,6 +8,11 @@
 #ifndef ZYPPERSEARCH_H_
 #define ZYPPERSEARCH_H_
 
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <zypp/TriBool.h>
 #include <zypp/PoolQuery.h>
 #include <zypp/base/Flags.h>
@@ -16,6 +21,55 @@
 #include "Table.h"
 #include "utils/misc.h"
 
+///////////////////////////////////////////////////////////////////
+/// \class RowLabels
+/// \brief Per kind and per repository table cells, computed once instead of per row.
+///
+/// Listing many solvables, the localized kind name, the repository name and
+/// the \c --repo filter result would otherwise be looked up and built for
+/// every row. The few distinct values are remembered in small vectors (a
+/// pool rarely has more than a few dozen repos), searched linearly starting
+/// at the last hit.
+///////////////////////////////////////////////////////////////////
+class RowLabels
+{
+public:
+  /** All repos are \ref wanted. */
+  RowLabels()
+  {}
+
+  /** Only repos whose alias is in \a aliases_r are \ref wanted (all if empty). */
+  RowLabels( std::set<std::string> aliases_r )
+  : _aliases { std::move(aliases_r) }
+  {}
+
+  /** Localized kind name (singular). */
+  const std::string & kind( const ResKind & kind_r ) const;
+
+  /** Repository name as shown to the user. */
+  const std::string & repository( const Repository & repo_r ) const
+  { return repoEntry( repo_r )._label; }
+
+  /** Whether \a repo_r passes the \c --repo filter. */
+  bool wanted( const Repository & repo_r ) const
+  { return repoEntry( repo_r )._wanted; }
+
+private:
+  struct RepoEntry
+  {
+    Repository _repo;
+    std::string _label;
+    bool _wanted;
+  };
+  const RepoEntry & repoEntry( const Repository & repo_r ) const;
+
+private:
+  std::set<std::string> _aliases;
+  mutable std::vector<std::pair<ResKind,std::string>> _kinds;
+  mutable std::vector<RepoEntry> _repos;
+  mutable unsigned _lastRepo = 0;
+};
+
 ///////////////////////////////////////////////////////////////////
 /// \class FillSearchTableSolvable
 /// \brief Functor for filling a detailed search output table.
@@ -38,7 +92,9 @@ private:
 
 private:
   Table * _table;		//!< The table used for output
-  std::set<std::string> _repos;	//!< Filter --repo
+  bool _repoFilter = false;	//!< Filter --repo
+  RowLabels _labels;		//!< Kind and repo cells, --repo filter
+  std::string _systemLabel;	//!< Repo cell of installed items
   TriBool _instNotinst;		//!< Filter --[not-]installed
 
 };
@@ -21,12 +21,20 @@
 
 #include "misc.h"		// confirm_licenses
 #include "repos.h"		// get_repo - used in dist_upgrade
+#include "PackageStore.h"
+#include "TransactionBundle.h"
 #include "utils/misc.h"
+#include "utils/CommitEvents.h"
+#include "utils/DownloadStats.h"
+#include "utils/MemStats.h"
 #include "utils/prompt.h"	// Continue? and solver problem prompt
 #include "utils/pager.h"	// to view the summary
 #include "utils/messages.h"
+#include "output/OutJSON.h"
 #include "global-settings.h"
 #include "CommitSummary.h"
+#include "CommitTimings.h"
+#include "SolutionCache.h"
 
 #include "solve-commit.h"
 #include "commands/needs-rebooting.h"
@@ -570,6 +578,18 @@ bool SolveAndCommitPolicy::forceCommit() const
 SolveAndCommitPolicy &SolveAndCommitPolicy::forceCommit(bool enable)
 { _forceCommit = enable; return *this; }
 
+bool SolveAndCommitPolicy::presolved() const
+{ return _presolved; }
+
+SolveAndCommitPolicy & SolveAndCommitPolicy::presolved( bool enable )
+{ _presolved = enable; return *this; }
+
+const std::optional<sat::StringQueue> & SolveAndCommitPolicy::autoInstalled() const
+{ return _autoInstalled; }
+
+SolveAndCommitPolicy & SolveAndCommitPolicy::autoInstalled( sat::StringQueue autoInstalled_r )
+{ _autoInstalled = std::move(autoInstalled_r); return *this; }
+
 bool SolveAndCommitPolicy::skipNotApplicablePatches() const
 { return _skipNotApplicablePatches; }
 
@@ -699,31 +719,65 @@ static void show_update_messages( Zypper & zypper, const UpdateNotifications & m
 void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
 {
   bool need_another_solver_run = true;
+
+  // --export-bundle: download only, the bundle is installed elsewhere
+  const std::string & exportBundle { TransactionBundleSettings::instance()._exportDir };
+  if ( ! exportBundle.empty() && ! policy.zyppCommitPolicy().dryRun() )
+    policy.downloadMode( DownloadOnly );
+
   bool dryRunEtc = policy.zyppCommitPolicy().dryRun() || ( policy.zyppCommitPolicy().downloadMode() == DownloadOnly );
   policy.summaryHints.clear();  // just in case ther's garbage from a previous use
+
+  // --reuse-solution: A dry run saves the solution, the real run tries to replay it.
+  std::optional<SolutionCache> solutionCache;
+  bool solutionReplayed = policy.presolved();
+  if ( SolverSettings::instance()._reuseSolution && ! SolverSettings::instance()._debugSolver && ! solutionReplayed )
+  {
+    set_solver_flags( zypper );   // they are part of the fingerprint
+    solutionCache.emplace( zypper );
+    if ( ! policy.zyppCommitPolicy().dryRun() )
+    {
+      solutionReplayed = solutionCache->replay();
+      if ( solutionReplayed )
+      {
+        zypper.out().info(_("Reusing the solution saved by a previous dry run.") );
+        policy.autoInstalled( solutionCache->autoInstalled() );
+      }
+      else
+        zypper.out().info(_("No matching solution saved by a previous dry run. Solving again..."), Out::HIGH );
+    }
+  }
+
   do
   {
     // CALL SOLVER
 
+    if ( solutionReplayed )
+    {
+      MIL << "using the " << ( policy.presolved() ? "given" : "replayed" ) << " solution" << endl;
+    }
     // doUpdate sets this flag, if no other jobs are to be included
-    if ( not zypper.runtimeData().solve_update_only )
+    else if ( not zypper.runtimeData().solve_update_only )
     {
       MIL << "solving..." << endl;
 
       while ( true )
       {
         bool success;
-        if ( zypper.command() == ZypperCommand::VERIFY )
-          success = verify(zypper);
-        else if ( zypper.command() == ZypperCommand::DIST_UPGRADE )
         {
-          zypper.out().info(_("Computing distribution upgrade...") );
-          success = dist_upgrade(zypper);
-        }
-        else
-        {
-          zypper.out().info(_("Resolving package dependencies...") );
-          success = resolve( zypper );
+          MemStats::Phase memPhase( "solve" );
+          if ( zypper.command() == ZypperCommand::VERIFY )
+            success = verify(zypper);
+          else if ( zypper.command() == ZypperCommand::DIST_UPGRADE )
+          {
+            zypper.out().info(_("Computing distribution upgrade...") );
+            success = dist_upgrade(zypper);
+          }
+          else
+          {
+            zypper.out().info(_("Resolving package dependencies...") );
+            success = resolve( zypper );
+          }
         }
 
         // go on, we've got solution or we don't want a solution (we want testcase)
@@ -740,6 +794,7 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
     } else {
       MIL << "Computing package update..." << endl;
       set_solver_flags( zypper );   // bsc#1201972: make sure 'up' also respects solver options
+      MemStats::Phase memPhase( "solve" );
       zypp::getZYpp()->resolver()->doUpdate();
     }
 
@@ -749,11 +804,23 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
       return;	// ZYPPER_EXIT_OK
     }
 
+    if ( solutionCache && policy.zyppCommitPolicy().dryRun() )
+    {
+      if ( solutionCache->save() )
+        zypper.out().info( str::Format(_("Solution saved to '%1%'. Run the same command with '%2%' but without '%3%' to reuse it.") )
+                           % solutionCache->file() % "--reuse-solution" % "--dry-run", Out::HIGH );
+      else
+        zypper.out().warning( str::Format(_("Failed to save the solution to '%1%'.") ) % solutionCache->file() );
+    }
+
     MIL << "got solution, showing summary" << endl;
 
     // SHOW SUMMARY
 
-    Summary summary( God->pool(), std::move(policy.summaryHints), policy.summaryOptions() );
+    Summary summary { [&]() {
+      MemStats::Phase memPhase( "summary" );
+      return Summary( God->pool(), std::move(policy.summaryHints), policy.summaryOptions() );
+    }() };
 
     if ( zypper.out().verbosity() == Out::HIGH )
       summary.setViewOption( Summary::SHOW_VERSION );
@@ -775,6 +842,8 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
     // show the summary
     if ( zypper.out().type() == Out::TYPE_XML )
       summary.dumpAsXmlTo( cout );
+    else if ( zypper.out().type() == OutJSON::TYPE_JSON )
+      summary.dumpAsJsonTo( cout );
     else
       summary.dumpTo( cout );
 
@@ -874,6 +943,7 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
           zypper.runtimeData().force_resolution = false;
           // undo solver changes before retrying
           God->resolver()->undo();
+          solutionReplayed = false;
           continue;
         }
         case 3: // v - show version
@@ -964,11 +1034,49 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
           // bsc#1183268: Patch reboot-needed flag overrules included packages.
           PatchRebootRulesWatchdog guard { summary.hasViewOption( Summary::PATCH_REBOOT_RULES ) && not summary.needMachineReboot() };
 
+          // remember the transaction to export (the commit may reset the pool)
+          std::optional<TransactionBundle> bundle;
+          if ( ! exportBundle.empty() && ! policy.zyppCommitPolicy().dryRun() )
+            bundle = TransactionBundle::fromPool( policy.autoInstalled() ? *policy.autoInstalled() : SolutionCache::solvedAutoInstalled() );
+
+          // packages downloaded via other repos are taken from the shared store
+          std::vector<sat::Solvable> toInstall;
+          if ( PackageStore::instance().enabled() && ! policy.zyppCommitPolicy().dryRun() )
+          {
+            for ( const PoolItem & pi : God->pool().byKind<Package>() )
+            {
+              if ( pi.status().isToBeInstalled() )
+              {
+                toInstall.push_back( pi.satSolvable() );
+                PackageStore::instance().provide( pi.satSolvable() );
+              }
+            }
+          }
+
+          // where the time goes (--timings)
+          if ( zypper.config().commit_timings > 0 || ! zypper.config().commit_timings_file.empty() )
+            CommitEvents::instance().recordTimings();
+
           MIL << "Using commit policy: " << policy.zyppCommitPolicy() << endl;
-          result = God->commit( policy.zyppCommitPolicy() );
+          DownloadStats::instance().start();
+          {
+            MemStats::Phase memPhase( "commit" );
+            result = God->commit( policy.zyppCommitPolicy() );
+          }
+          DownloadStats::instance().stop();
+
+          for ( const sat::Solvable & solv : toInstall )
+            PackageStore::instance().remember( solv );	// if kept in the package cache
 
           gData.entered_commit = false;
 
+          // the solver did not run: tell the target which packages came as dependencies
+          if ( policy.autoInstalled() && ! dryRunEtc && result->attemptToModify() )
+            SolutionCache::restoreAutoInstalled( *policy.autoInstalled() );
+
+          if ( solutionCache && ! dryRunEtc )
+            solutionCache->drop();	// consumed or outdated now
+
           if ( !result->allDone() && !( dryRunEtc && result->noError() ) )
           { zypper.setExitCode( result->attemptToModify() ? ZYPPER_EXIT_ERR_COMMIT : ZYPPER_EXIT_ERR_ZYPP ); }	// error message comes later....
 
@@ -981,6 +1089,21 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
           }
 
           show_update_messages( zypper, result->updateMessages() );
+
+          if ( bundle && result->noError() )
+          {
+            try
+            {
+              bundle->write( exportBundle );
+              zypper.out().info( str::Format(_("Transaction bundle with %1% packages saved to '%2%'.") ) % bundle->size() % exportBundle );
+            }
+            catch ( const Exception & e )
+            {
+              ZYPP_CAUGHT( e );
+              zypper.out().error( e, str::Format(_("Failed to save the transaction bundle to '%1%'.") ) % exportBundle );
+              zypper.setExitCode( ZYPPER_EXIT_ERR_ZYPP );
+            }
+          }
         }
         catch ( const media::MediaException & e )
         {
@@ -1059,6 +1182,8 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
             // show the summary
             if ( zypper.out().type() == Out::TYPE_XML )
               cSummary.dumpAsXmlTo( cout );
+            else if ( zypper.out().type() == OutJSON::TYPE_JSON )
+              cSummary.dumpAsJsonTo( cout );
             else
               cSummary.dumpTo( cout );
 
@@ -1096,6 +1221,61 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
             " manager itself. Run this command once more to install any other"
             " needed patches." ), Out::QUIET, Out::TYPE_NORMAL ); // don't show this to machines
           }
+
+          // bound the package caches (zypper.conf: commit/packageCacheMax*)
+          const Config & config { zypper.config() };
+          if ( !dryRunEtc && result && ( config.packageCacheMaxSize || config.packageCacheMaxAge ) )
+          {
+            std::vector<sat::Solvable> installed;	// not yet in the system repo
+            for ( const auto & step : result->transactionStepList() )
+            {
+              if ( step.stepType() == sat::Transaction::TRANSACTION_INSTALL && step.stepStage() == sat::Transaction::STEP_DONE )
+                installed.push_back( step.satSolvable() );
+            }
+            trim_package_caches( zypper, {}, config.packageCacheMaxSize, config.packageCacheMaxAge, installed );
+          }
+        }
+
+        // where the time went (--timings)
+        if ( zypper.config().commit_timings > 0 || ! zypper.config().commit_timings_file.empty() )
+        {
+          const Config & config { zypper.config() };
+          CommitTimings timings( CommitEvents::instance().timings(), config.commit_timings > 0 ? config.commit_timings : 10 );
+          if ( config.commit_timings > 0 )
+          {
+            if ( zypper.out().type() == Out::TYPE_XML )
+              timings.dumpAsXmlTo( cout );
+            else if ( zypper.out().type() == OutJSON::TYPE_JSON )
+              timings.dumpAsJsonTo( cout );
+            else
+              timings.dumpTo( cout );
+          }
+          if ( ! config.commit_timings_file.empty() && ! timings.empty() )
+          {
+            try
+            { timings.appendTo( config.commit_timings_file ); }
+            catch ( const Exception & e )
+            {
+              ZYPP_CAUGHT( e );
+              zypper.out().error( e, _("Failed to save the commit timings.") );
+            }
+          }
+        }
+
+        // what the package downloads cost
+        const DownloadStats & downloadStats { DownloadStats::instance() };
+        if ( ! downloadStats.empty() )
+        {
+          if ( zypper.out().type() == Out::TYPE_XML )
+            downloadStats.writeXml( cout );
+          else if ( zypper.out().type() == OutJSON::TYPE_JSON )
+            downloadStats.writeJson( cout );
+          else
+          {
+            zypper.out().info( downloadStats.summary() );
+            if ( zypper.out().verbosity() >= Out::HIGH )
+              downloadStats.writeTable( cout );
+          }
         }
 
         // check for running services (fate #300763)
@@ -15,6 +15,10 @@
 #ifndef SOLVE_COMMIT_H_
 #define SOLVE_COMMIT_H_
 
+#include <optional>
+
+#include <zypp/sat/Queue.h>
+
 #include "Zypper.h"
 #include "Summary.h"
 
@@ -37,6 +41,20 @@ struct SolveAndCommitPolicy {
   bool forceCommit () const;
   SolveAndCommitPolicy &forceCommit ( bool enable );
 
+  /*!
+   * The caller already set the pool status of the transaction (e.g. from a
+   * transaction bundle). The solver is not called.
+   */
+  bool presolved() const;
+  SolveAndCommitPolicy & presolved( bool enable );
+
+  /*!
+   * For a transaction not computed by the solver (\ref presolved, replayed):
+   * the idents of the packages auto-installed after the commit.
+   */
+  const std::optional<sat::StringQueue> & autoInstalled() const;
+  SolveAndCommitPolicy & autoInstalled( sat::StringQueue autoInstalled_r );
+
   /**
    * Auto skip not applicable patches.
    */
@@ -61,6 +79,8 @@ struct SolveAndCommitPolicy {
 
 private:
   bool _forceCommit = false;
+  bool _presolved = false;
+  std::optional<sat::StringQueue> _autoInstalled;
   bool _skipNotApplicablePatches = false;
   Summary::ViewOptions _summaryOptions = Summary::DEFAULT;
   ZYppCommitPolicy _zyppCommitPolicy;
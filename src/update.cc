@@ -15,6 +15,7 @@
 #include "main.h"
 #include "global-settings.h"
 #include "utils/misc.h"
+#include "output/OutJSON.h"
 
 using namespace zypp;
 typedef std::set<PoolItem> Candidates;
@@ -160,6 +161,59 @@ namespace
     return str;
   }
 
+
+  /** JSON Lines: Print an update line for a non-patch */
+  inline void jsonPrintOtherUpdate( const PoolItem & pi_r )
+  {
+    OutJSON::Line line( "update" );
+    line.add( "kind", pi_r.kind().asString() )
+        .add( "name", pi_r.name() )
+        .add( "edition", pi_r.edition().asString() )
+        .add( "arch", pi_r.arch().asString() );
+    // for packages show also the current installed version (bnc #466599)
+    {
+      const PoolItem & ipi( ui::Selectable::get(pi_r)->installedObj() );
+      if ( ipi )
+      {
+        if ( pi_r.edition() != ipi.edition() )
+          line.add( "edition-old", ipi.edition().asString() );
+        if ( pi_r.arch() != ipi.arch() )
+          line.add( "arch-old", ipi.arch().asString() );
+      }
+    }
+    line.addOptional( "summary", pi_r.summary() )
+        .addOptional( "description", pi_r.description() )
+        .addOptional( "repository", pi_r.repoInfo().alias() );
+  }
+
+  /** JSON Lines: Print an update line for a patch; \a blocked_r by a pending update stack patch. */
+  inline void jsonPrintPatchUpdate( const PoolItem & pi_r, bool blocked_r )
+  {
+    Patch::constPtr patch = pi_r->asKind<Patch>();
+
+    Patch::InteractiveFlags ignoreFlags = Patch::NoFlags;
+    if ( Zypper::instance().config().reboot_req_non_interactive )
+      ignoreFlags |= Patch::Reboot;
+    if ( LicenseAgreementPolicy::instance()._autoAgreeWithLicenses )
+      ignoreFlags |= Patch::License;
+
+    OutJSON::Line( "update" )
+      .add( "kind", "patch" )
+      .add( "name", patch->name() )
+      .add( "edition", patch->edition().asString() )
+      .add( "arch", patch->arch().asString() )
+      .add( "status", textPatchStatus( pi_r ) )
+      .add( "category", patch->category() )
+      .add( "severity", patch->severity() )
+      .add( "pkgmanager", patch->restartSuggested() )
+      .add( "restart", patch->rebootSuggested() )
+      .add( "interactive", patch->interactiveWhenIgnoring( ignoreFlags ) )
+      .add( "blocked", blocked_r )
+      .addOptional( "summary", patch->summary() )
+      .addOptional( "description", patch->description() )
+      .addOptional( "repository", patch->repoInfo().alias() );
+  }
+
 } //namespace
 ///////////////////////////////////////////////////////////////////
 
@@ -546,6 +600,46 @@ static void xml_list_updates(const ResKindSet & kinds, bool all_r )
 
 // ----------------------------------------------------------------------------
 
+// returns true if NEEDED! restartSuggested() patches are available
+static bool json_list_patches( bool all_r )
+{
+  const ResPool& pool = God->pool();
+
+  // check whether there are packages affecting the update stack
+  bool pkg_mgr_available = false;
+  for_( it, pool.byKindBegin(ResKind::patch), pool.byKindEnd(ResKind::patch) )
+  {
+    if ( patchIsNeededRestartSuggested( *it ) )
+    {
+      pkg_mgr_available = true;
+      break;
+    }
+  }
+
+  // if updates stack patches are available, the others are blocked
+  for_( it, pool.byKindBegin(ResKind::patch), pool.byKindEnd(ResKind::patch) )
+  {
+    const PoolItem & pi( *it );
+    if ( all_r || patchIsApplicable( pi ) )
+      jsonPrintPatchUpdate( pi, !all_r && pkg_mgr_available && !patchIsNeededRestartSuggested( pi ) );
+  }
+  return pkg_mgr_available;
+}
+
+static void json_list_updates( const ResKindSet & kinds, bool all_r )
+{
+  ResKindSet localkinds = kinds;
+
+  // patch updates first; other kinds only if no patches affect the package manager
+  if ( localkinds.erase( ResKind::patch ) && json_list_patches( all_r ) )
+    return;
+
+  Candidates candidates;
+  find_updates( localkinds, candidates, all_r );
+  for( const PoolItem & pi : candidates )
+    jsonPrintOtherUpdate( pi );
+}
+
 // returns true if NEEDED! restartSuggested() patches are available
 static bool list_patch_updates( Zypper & zypper, bool all_r, const PatchSelector &sel, const PatchHistoryData & historyData_r )
 {
@@ -714,6 +808,12 @@ std::string i18n_kind_updates(const ResKind & kind)
 
 void list_updates(Zypper & zypper, const ResKindSet & kinds, bool best_effort, bool all_r, const PatchSelector &patchSel_r )
 {
+  if ( zypper.out().type() == OutJSON::TYPE_JSON )
+  {
+    json_list_updates( kinds, all_r );
+    return;
+  }
+
   PatchHistoryData patchHistoryData;	// commonly used by all tables
 
   if (zypper.out().type() == Out::TYPE_XML)
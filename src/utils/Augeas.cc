@@ -525,6 +525,7 @@ public:
   AugRef _aug;	///< The reference to ::augeas
 
   std::vector<Pathname> _cfgFiles;	///< list of config files to load (higher prio first)
+  mutable bool _ambiguous = false;	///< getOption found multiple definitions
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -539,14 +540,7 @@ Augeas::Augeas( Pathname customcfg_r, bool readmode_r  )
   // determine the config files to load
   if ( customcfg_r.empty() )
   {
-    // add $HOME/.zypper.conf
-    if ( const char * HOME = env::HOME() )
-      _pimpl->_cfgFiles.push_back( Pathname(HOME) / ".zypper.conf" );
-    else
-      WAR << "Cannot figure out user's home directory. Skipping user's config." << endl;
-
-    // add /etc/zypp/zypper.conf
-    _pimpl->_cfgFiles.push_back( "/etc/zypp/zypper.conf" );
+    _pimpl->_cfgFiles = defaultConfigFiles();
   }
   else
   {
@@ -610,6 +604,23 @@ Augeas::Augeas( Pathname customcfg_r, bool readmode_r  )
 Augeas::~Augeas()
 {}
 
+std::vector<Pathname> Augeas::defaultConfigFiles()
+{
+  std::vector<Pathname> ret;
+  // add $HOME/.zypper.conf
+  if ( const char * HOME = env::HOME() )
+    ret.push_back( Pathname(HOME) / ".zypper.conf" );
+  else
+    WAR << "Cannot figure out user's home directory. Skipping user's config." << endl;
+
+  // add /etc/zypp/zypper.conf
+  ret.push_back( "/etc/zypp/zypper.conf" );
+  return ret;
+}
+
+bool Augeas::isAmbiguous() const
+{ return _pimpl->_ambiguous; }
+
 Pathname Augeas::getSaveFile() const
 { return( _pimpl->_cfgFiles.empty() ? Pathname() : _pimpl->_cfgFiles[0] ); }
 
@@ -633,6 +644,7 @@ std::string Augeas::getOption( const std::string & option_r ) const
       {
         // translator: %1% is the path to a config file, %2% is the name of an options inside the file
         Zypper::instance().out().error( str::Format(_("%1%: Option '%2%' is defined multiple times. Using the last one.") ) % cfg % option_r );
+        _pimpl->_ambiguous = true;
 
         fP = *AugMatches(fP).last();
         WAR << fP << endl;
@@ -10,6 +10,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 #include <zypp/base/PtrTypes.h>
 #include <zypp/Pathname.h>
@@ -44,6 +45,13 @@ public:
   /** Actually the */
   zypp::Pathname getSaveFile() const;
 
+  /** Whether \ref getOption found an option defined multiple times in a file. */
+  bool isAmbiguous() const;
+
+public:
+  /** The config files read if no custom config file is given (higher prio first). */
+  static std::vector<zypp::Pathname> defaultConfigFiles();
+
 public:
   class Impl;
 private:
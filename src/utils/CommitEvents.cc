@@ -0,0 +1,181 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <sstream>
+
+#include <zypp/base/Exception.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/RepoInfo.h>
+
+#include "main.h"
+#include "output/OutJSON.h"
+#include "utils/CommitEvents.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Wall clock time as seconds since the epoch. */
+  inline std::string timestamp()
+  {
+    std::chrono::duration<double> now { std::chrono::system_clock::now().time_since_epoch() };
+    return str::form( "%.3f", now.count() );
+  }
+
+  /** Start the line for an event of \a solv_r. */
+  inline OutJSON::Line & startLine( OutJSON::Line & line_r, const std::string & state_r, const std::string & phase_r,
+                                    sat::Solvable solv_r, const std::string & detail_r )
+  {
+    line_r.add( "phase", phase_r ).add( "state", state_r ).addRaw( "time", timestamp() );
+    if ( solv_r )
+    {
+      line_r.add( "name", solv_r.name() )
+            .add( "edition", solv_r.edition().asString() )
+            .add( "arch", solv_r.arch().asString() )
+            .add( "repository", solv_r.repoInfo().alias() );
+    }
+    line_r.addOptional( "detail", detail_r );
+    return line_r;
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+CommitEvents & CommitEvents::instance()
+{
+  static CommitEvents _instance;
+  return _instance;
+}
+
+void CommitEvents::enable( int fd_r )
+{
+  if ( fd_r < 0 || ::fcntl( fd_r, F_GETFD ) < 0 )
+    ZYPP_THROW( Exception( str::Format(_("File descriptor %1% is not open.")) % fd_r ) );
+  _fd = fd_r;
+  MIL << "Writing commit events to fd " << _fd << endl;
+}
+
+std::string CommitEvents::key( const std::string & phase_r, sat::Solvable solv_r, const std::string & detail_r ) const
+{ return str::Str() << phase_r << '|' << solv_r.id() << '|' << detail_r; }
+
+bool CommitEvents::active( const std::string & phase_r, sat::Solvable solv_r, const std::string & detail_r ) const
+{ return enabled() && _begun.count( key( phase_r, solv_r, detail_r ) ); }
+
+void CommitEvents::begin( const std::string & phase_r, sat::Solvable solv_r, ByteCount bytes_r, const std::string & detail_r )
+{
+  if ( ! enabled() )
+    return;
+  _begun[key( phase_r, solv_r, detail_r )] = std::chrono::steady_clock::now();
+  if ( _fd < 0 )
+    return;	// timings only
+
+  std::ostringstream str;
+  {
+    OutJSON::Line line( str, "commit" );
+    startLine( line, "begin", phase_r, solv_r, detail_r );
+    if ( bytes_r )
+      line.add( "bytes", (ByteCount::SizeType)bytes_r );
+  }
+  write( str.str() );
+}
+
+void CommitEvents::end( const std::string & phase_r, sat::Solvable solv_r, bool ok_r, ByteCount bytes_r, const std::string & detail_r )
+{
+  if ( ! enabled() )
+    return;
+  auto it = _begun.find( key( phase_r, solv_r, detail_r ) );
+  if ( it == _begun.end() )
+    return;
+  std::chrono::duration<double> duration { std::chrono::steady_clock::now() - it->second };
+  _begun.erase( it );
+  if ( _record )
+    _timings.push_back( { phase_r, solv_r, detail_r, duration.count() } );
+  if ( _fd < 0 )
+    return;	// timings only
+
+  std::ostringstream str;
+  {
+    OutJSON::Line line( str, "commit" );
+    startLine( line, "end", phase_r, solv_r, detail_r );
+    line.add( "ok", ok_r ).addRaw( "duration", str::form( "%.3f", duration.count() ) );
+    if ( bytes_r )
+      line.add( "bytes", (ByteCount::SizeType)bytes_r );
+  }
+  write( str.str() );
+}
+
+void CommitEvents::cached( sat::Solvable solv_r, const Pathname & localfile_r )
+{
+  if ( _fd < 0 )
+    return;
+
+  std::ostringstream str;
+  {
+    OutJSON::Line line( str, "commit" );
+    startLine( line, "cached", "download", solv_r, std::string() );
+    line.add( "bytes", (ByteCount::SizeType)PathInfo( localfile_r ).size() );
+  }
+  write( str.str() );
+}
+
+void CommitEvents::downloadStart( sat::Solvable solv_r )
+{
+  if ( ! enabled() )
+    return;
+  _downloading = solv_r;
+  begin( "download", solv_r, solv_r.downloadSize() );
+}
+
+void CommitEvents::fileDownloaded( const Pathname & localfile_r )
+{
+  if ( localfile_r.extension() != ".rpm" || ! active( "download", _downloading ) )
+    return;	// not the package itself
+  end( "download", _downloading, true, PathInfo( localfile_r ).size() );
+  begin( "verify", _downloading );
+}
+
+void CommitEvents::verified( bool ok_r )
+{
+  if ( ! _downloading )
+    return;
+  end( "download", _downloading, true );	// unless the media backend told
+  end( "verify", _downloading, ok_r );
+}
+
+void CommitEvents::downloadFinish( bool ok_r )
+{
+  if ( ! _downloading )
+    return;
+  end( "download", _downloading, ok_r );
+  end( "verify", _downloading, ok_r );
+  _downloading = sat::Solvable();
+}
+
+void CommitEvents::write( const std::string & line_r )
+{
+  const char * data = line_r.data();
+  std::string::size_type left = line_r.size();
+  while ( left )
+  {
+    ssize_t written = ::write( _fd, data, left );
+    if ( written < 0 )
+    {
+      if ( errno == EINTR )
+        continue;
+      WAR << "Can not write commit events to fd " << _fd << ": " << str::strerror( errno ) << " - disabled" << endl;
+      _fd = -1;
+      return;
+    }
+    data += written;
+    left -= written;
+  }
+}
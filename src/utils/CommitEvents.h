@@ -0,0 +1,121 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#ifndef ZYPPER_UTILS_COMMITEVENTS_H_
+#define ZYPPER_UTILS_COMMITEVENTS_H_
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <zypp/ByteCount.h>
+#include <zypp/Pathname.h>
+#include <zypp/sat/Solvable.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class CommitEvents
+/// \brief Per package commit events for external tools (\c --events-fd).
+///
+/// The download, rpm and script callbacks tell when a phase of a package
+/// begins and ends. Each of them is written as a JSON line to the file
+/// descriptor passed to \ref enable:
+/// \code
+/// {"event":"commit","phase":"download","state":"begin","time":1718000000.123,"name":"glibc",...,"bytes":1846272}
+/// {"event":"commit","phase":"download","state":"end","time":1718000001.457,"name":"glibc",...,"ok":true,"duration":1.334,"bytes":1846272}
+/// \endcode
+/// The phases are \c download, \c verify (the signature check following the
+/// download), \c install, \c remove, \c script and \c transaction (rpm
+/// preparing or verifying the whole transaction). A package found in the
+/// cache is reported once with state \c cached.
+///
+/// If \ref recordTimings was called, the duration of each phase is also
+/// kept in memory for the report following the commit (\c --timings).
+///
+/// As long as neither \ref enable nor \ref recordTimings was called,
+/// nothing is done. If writing fails (e.g. the reader went away) the events
+/// are no longer written.
+///////////////////////////////////////////////////////////////////
+class CommitEvents
+{
+public:
+  static CommitEvents & instance();
+
+  /** Write the events to \a fd_r.
+   * \throws zypp::Exception if \a fd_r is not an open file descriptor.
+   */
+  void enable( int fd_r );
+
+  /** Keep the \ref timings of the commit, dropping those of a previous one. */
+  void recordTimings()
+  {
+    _record = true;
+    _timings.clear();
+    _begun.clear();
+  }
+
+  bool enabled() const
+  { return _fd >= 0 || _record; }
+
+  /** The duration of a phase. */
+  struct Timing
+  {
+    std::string _phase;
+    zypp::sat::Solvable _solv;
+    std::string _detail;
+    double _seconds = 0.0;
+  };
+
+  /** The phases ended so far, in order (if \ref recordTimings). */
+  const std::vector<Timing> & timings() const
+  { return _timings; }
+
+  /** Phase \a phase_r of \a solv_r (\a detail_r, e.g. the script type) begins.
+   * \a bytes_r is the expected size, if known.
+   */
+  void begin( const std::string & phase_r, zypp::sat::Solvable solv_r, zypp::ByteCount bytes_r = zypp::ByteCount(), const std::string & detail_r = std::string() );
+
+  /** Phase \a phase_r of \a solv_r (\a detail_r) ends. Ignored unless it was begun.
+   * \a bytes_r is the actual size, if known.
+   */
+  void end( const std::string & phase_r, zypp::sat::Solvable solv_r, bool ok_r, zypp::ByteCount bytes_r = zypp::ByteCount(), const std::string & detail_r = std::string() );
+
+  /** Whether phase \a phase_r of \a solv_r was begun and not yet ended. */
+  bool active( const std::string & phase_r, zypp::sat::Solvable solv_r, const std::string & detail_r = std::string() ) const;
+
+  /** \a solv_r was not downloaded but found in the cache. */
+  void cached( zypp::sat::Solvable solv_r, const zypp::Pathname & localfile_r );
+
+  /** \name The package download.
+   * The media backend knows when the file is downloaded, but not for which package.
+   * The download callback tells which package is being downloaded.
+   */
+  //@{
+  void downloadStart( zypp::sat::Solvable solv_r );
+  /** A file of the current package download arrived; the \c verify phase begins. */
+  void fileDownloaded( const zypp::Pathname & localfile_r );
+  /** The signature check is done. */
+  void verified( bool ok_r );
+  /** End the phases of the current package download which are still open. */
+  void downloadFinish( bool ok_r );
+  //@}
+
+private:
+  CommitEvents() {}
+
+  std::string key( const std::string & phase_r, zypp::sat::Solvable solv_r, const std::string & detail_r ) const;
+  void write( const std::string & line_r );
+
+private:
+  int _fd = -1;
+  bool _record = false;
+  std::vector<Timing> _timings;
+  std::unordered_map<std::string,std::chrono::steady_clock::time_point> _begun;
+  zypp::sat::Solvable _downloading;	///< the current package download
+};
+
+#endif // ZYPPER_UTILS_COMMITEVENTS_H_
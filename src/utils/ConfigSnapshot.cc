@@ -0,0 +1,213 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <sys/stat.h>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+
+#include <zypp/base/Logger.h>
+#include <zypp/PathInfo.h>
+
+#include "utils/ConfigSnapshot.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Changing the format or the lens requires a new magic. */
+  const std::string magic { "zypper config snapshot v1 " VERSION };
+
+  /** Max. length of a string we are willing to read. */
+  constexpr std::uint32_t maxStringSize = 64*1024;
+
+  inline void writeNum( std::ostream & out_r, std::uint64_t num_r )
+  { out_r.write( reinterpret_cast<const char *>(&num_r), sizeof(num_r) ); }
+
+  inline void writeString( std::ostream & out_r, const std::string & str_r )
+  {
+    std::uint32_t size = str_r.size();
+    out_r.write( reinterpret_cast<const char *>(&size), sizeof(size) );
+    out_r.write( str_r.data(), size );
+  }
+
+  inline bool readNum( std::istream & in_r, std::uint64_t & num_r )
+  { return bool( in_r.read( reinterpret_cast<char *>(&num_r), sizeof(num_r) ) ); }
+
+  inline bool readString( std::istream & in_r, std::string & str_r )
+  {
+    std::uint32_t size = 0;
+    if ( ! in_r.read( reinterpret_cast<char *>(&size), sizeof(size) ) || size > maxStringSize )
+      return false;
+    str_r.resize( size );
+    return bool( in_r.read( &str_r[0], size ) );
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+bool ConfigSnapshot::FileStamp::operator==( const FileStamp & rhs ) const
+{
+  return _path == rhs._path && _exists == rhs._exists
+      && _dev == rhs._dev && _ino == rhs._ino && _size == rhs._size
+      && _mtime == rhs._mtime && _mtimeNsec == rhs._mtimeNsec;
+}
+
+ConfigSnapshot::FileStamp ConfigSnapshot::stampOf( const Pathname & file_r )
+{
+  FileStamp ret;
+  ret._path = file_r.asString();
+  struct stat st;
+  if ( ::stat( file_r.c_str(), &st ) == 0 )
+  {
+    ret._exists = true;
+    ret._dev = st.st_dev;
+    ret._ino = st.st_ino;
+    ret._size = st.st_size;
+    ret._mtime = st.st_mtim.tv_sec;
+    ret._mtimeNsec = st.st_mtim.tv_nsec;
+  }
+  return ret;
+}
+
+ConfigSnapshot::ConfigSnapshot( Pathname file_r, std::vector<Pathname> cfgFiles_r )
+: _file { std::move(file_r) }
+{
+  if ( _file.empty() )
+    return;
+
+  for ( const Pathname & cfg : cfgFiles_r )
+    _stamps.push_back( stampOf( cfg ) );
+
+  if ( load() )
+    DBG << "Using config snapshot " << _file << " (" << _options.size() << " options)" << endl;
+  else
+    _options.clear();
+}
+
+bool ConfigSnapshot::load()
+{
+  std::ifstream in( _file.c_str(), std::ios::binary );
+  if ( ! in )
+    return false;
+
+  std::string str;
+  if ( ! readString( in, str ) || str != magic )
+  {
+    MIL << "Ignore config snapshot " << _file << " (other version)" << endl;
+    return false;
+  }
+
+  std::uint64_t num = 0;
+  if ( ! readNum( in, num ) || num != _stamps.size() )
+    return false;
+  for ( const FileStamp & current : _stamps )
+  {
+    FileStamp stamp;
+    std::uint64_t exists = 0, mtime = 0, mtimeNsec = 0;
+    if ( ! ( readString( in, stamp._path )
+          && readNum( in, exists ) && readNum( in, stamp._dev ) && readNum( in, stamp._ino )
+          && readNum( in, stamp._size ) && readNum( in, mtime ) && readNum( in, mtimeNsec ) ) )
+      return false;
+    stamp._exists = exists;
+    stamp._mtime = mtime;
+    stamp._mtimeNsec = mtimeNsec;
+    if ( !( stamp == current ) )
+    {
+      MIL << "Config file changed: " << current._path << endl;
+      return false;
+    }
+  }
+
+  if ( ! readNum( in, num ) )
+    return false;
+  for ( ; num; --num )
+  {
+    std::string option;
+    if ( ! ( readString( in, option ) && readString( in, str ) ) )
+      return false;
+    _options[std::move(option)] = std::move(str);
+  }
+  return true;
+}
+
+bool ConfigSnapshot::getOption( const std::string & option_r, std::string & value_r ) const
+{
+  auto it { _options.find( option_r ) };
+  if ( it == _options.end() )
+    return false;
+  value_r = it->second;
+  return true;
+}
+
+void ConfigSnapshot::setOption( const std::string & option_r, std::string value_r )
+{
+  if ( _file.empty() )
+    return;
+  _options[option_r] = std::move(value_r);
+  _dirty = true;
+}
+
+void ConfigSnapshot::save() const
+{
+  if ( ! _dirty )
+    return;
+
+  // A file modified within the mtime granularity could change again
+  // without us noticing. Don't remember it yet.
+  const long long now = ::time( nullptr );
+  for ( const FileStamp & stamp : _stamps )
+  {
+    if ( stamp._exists && stamp._mtime + 2 >= now )
+    {
+      DBG << "Not saving config snapshot: " << stamp._path << " was just modified" << endl;
+      return;
+    }
+  }
+
+  if ( filesystem::assert_dir( _file.dirname() ) != 0 )
+  {
+    WAR << "Can not create " << _file.dirname() << endl;
+    return;
+  }
+
+  Pathname tmpfile { _file.extend( ".new" ) };
+  {
+    std::ofstream out( tmpfile.c_str(), std::ios::binary );
+    writeString( out, magic );
+    writeNum( out, _stamps.size() );
+    for ( const FileStamp & stamp : _stamps )
+    {
+      writeString( out, stamp._path );
+      writeNum( out, stamp._exists );
+      writeNum( out, stamp._dev );
+      writeNum( out, stamp._ino );
+      writeNum( out, stamp._size );
+      writeNum( out, stamp._mtime );
+      writeNum( out, stamp._mtimeNsec );
+    }
+    writeNum( out, _options.size() );
+    for ( const auto & option : _options )
+    {
+      writeString( out, option.first );
+      writeString( out, option.second );
+    }
+    if ( ! out )
+    {
+      WAR << "Can not write " << tmpfile << endl;
+      filesystem::unlink( tmpfile );
+      return;
+    }
+  }
+  if ( filesystem::rename( tmpfile, _file ) != 0 )
+  {
+    WAR << "Can not rename " << tmpfile << endl;
+    filesystem::unlink( tmpfile );
+    return;
+  }
+  MIL << "Saved config snapshot " << _file << endl;
+}
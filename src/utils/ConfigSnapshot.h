@@ -0,0 +1,79 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#ifndef ZYPPER_UTILS_CONFIGSNAPSHOT_H_
+#define ZYPPER_UTILS_CONFIGSNAPSHOT_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <zypp/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class ConfigSnapshot
+/// \brief The option values read from the zypper config files, remembered across zypper calls.
+///
+/// Starting Augeas (loading the lens, parsing the config files) is a noticeable
+/// part of the startup time of trivial commands. The option values \ref Augeas
+/// returned are saved in a small binary file, together with inode, size and
+/// mtime of the config files they were read from. As long as none of the files
+/// changed, the values are taken from the snapshot.
+///
+/// An option unknown to the snapshot (e.g. after a zypper update) must be read
+/// via \ref Augeas and added by \ref setOption. The snapshot is written by
+/// \ref save if anything was added.
+///
+/// \note The snapshot is written in host byte order; it's a per user cache, not
+/// meant to be shared.
+///////////////////////////////////////////////////////////////////
+class ConfigSnapshot
+{
+public:
+  /** Load the snapshot from \a file_r for the \a cfgFiles_r (higher prio first).
+   * An empty \a file_r disables the snapshot.
+   */
+  ConfigSnapshot( zypp::Pathname file_r, std::vector<zypp::Pathname> cfgFiles_r );
+
+  /** Get the remembered value of \a option_r ("SECTION/VARIABLE").
+   * \return \c false if the value is not known and must be read via \ref Augeas.
+   */
+  bool getOption( const std::string & option_r, std::string & value_r ) const;
+
+  /** Remember the \a value_r read for \a option_r. */
+  void setOption( const std::string & option_r, std::string value_r );
+
+  /** Write the snapshot if options were added. Errors are logged only. */
+  void save() const;
+
+private:
+  /** What identifies the content of a config file. */
+  struct FileStamp
+  {
+    std::string _path;
+    bool _exists = false;
+    std::uint64_t _dev = 0;
+    std::uint64_t _ino = 0;
+    std::uint64_t _size = 0;
+    long long _mtime = 0;	///< seconds
+    long long _mtimeNsec = 0;
+
+    bool operator==( const FileStamp & rhs ) const;
+  };
+
+  static FileStamp stampOf( const zypp::Pathname & file_r );
+  bool load();
+
+private:
+  zypp::Pathname _file;
+  std::vector<FileStamp> _stamps;	///< of the current config files
+  std::map<std::string,std::string> _options;
+  bool _dirty = false;
+};
+
+#endif // ZYPPER_UTILS_CONFIGSNAPSHOT_H_
@@ -0,0 +1,316 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <iostream>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/RepoInfo.h>
+
+#include "main.h"
+#include "Table.h"
+#include "output/OutJSON.h"
+#include "utils/DownloadStats.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  inline double secondsSince( std::chrono::steady_clock::time_point start_r )
+  { return std::chrono::duration<double>( std::chrono::steady_clock::now() - start_r ).count(); }
+
+  inline std::string asSeconds( double seconds_r )
+  { return str::form( "%.3f", seconds_r ); }
+
+  inline std::string asRate( const ByteCount & rate_r )
+  { return rate_r ? rate_r.asString() + "/s" : std::string(); }
+
+  inline bool isRpm( const Pathname & file_r )
+  { return file_r.extension() == ".rpm"; }	// also *.delta.rpm
+
+  inline std::string repoOf( sat::Solvable solv_r )
+  { return solv_r.repository().alias(); }
+
+  /** The attributes shared by the XML elements. */
+  void xmlCounts( std::ostream & str, const DownloadStats::Counts & counts_r )
+  {
+    str << " downloaded=\"" << counts_r._downloaded << "\""
+        << " cached=\"" << counts_r._cached << "\""
+        << " failed=\"" << counts_r._failed << "\""
+        << " retries=\"" << counts_r._retries << "\""
+        << " bytes=\"" << counts_r._bytes.blocks( ByteCount::B ) << "\""
+        << " cached-bytes=\"" << counts_r._cachedBytes.blocks( ByteCount::B ) << "\""
+        << " deltas=\"" << counts_r._deltas << "\""
+        << " delta-saved=\"" << counts_r._deltaSaved.blocks( ByteCount::B ) << "\""
+        << " seconds=\"" << asSeconds( counts_r._seconds ) << "\""
+        << " rate=\"" << counts_r.rate().blocks( ByteCount::B ) << "\"";
+  }
+
+  /** The attributes shared by the JSON lines. */
+  void jsonCounts( OutJSON::Line & line_r, const DownloadStats::Counts & counts_r )
+  {
+    line_r.add( "downloaded", counts_r._downloaded )
+          .add( "cached", counts_r._cached )
+          .add( "failed", counts_r._failed )
+          .add( "retries", counts_r._retries )
+          .add( "bytes", counts_r._bytes.blocks( ByteCount::B ) )
+          .add( "cached_bytes", counts_r._cachedBytes.blocks( ByteCount::B ) )
+          .add( "deltas", counts_r._deltas )
+          .add( "delta_saved", counts_r._deltaSaved.blocks( ByteCount::B ) )
+          .addRaw( "seconds", asSeconds( counts_r._seconds ) )
+          .add( "rate", counts_r.rate().blocks( ByteCount::B ) );
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+ByteCount DownloadStats::Counts::rate() const
+{ return _seconds > 0.0 ? ByteCount( ByteCount::SizeType( _bytes / _seconds ) ) : ByteCount(); }
+
+double DownloadStats::Counts::cacheHitRatio() const
+{ return ( _cached + _downloaded ) ? double(_cached) / ( _cached + _downloaded ) : 0.0; }
+
+DownloadStats::Counts & DownloadStats::Counts::operator+=( const Counts & rhs )
+{
+  _downloaded += rhs._downloaded;
+  _cached += rhs._cached;
+  _failed += rhs._failed;
+  _retries += rhs._retries;
+  _deltas += rhs._deltas;
+  _bytes += rhs._bytes;
+  _cachedBytes += rhs._cachedBytes;
+  _deltaSaved += rhs._deltaSaved;
+  _seconds += rhs._seconds;
+  return *this;
+}
+
+DownloadStats & DownloadStats::instance()
+{
+  static DownloadStats _instance;
+  return _instance;
+}
+
+void DownloadStats::start()
+{
+  _repos.clear();
+  _servers.clear();
+  _package = sat::Solvable();
+  _deltaSize = ByteCount();
+  _fileStart.clear();
+  _active = true;
+}
+
+void DownloadStats::cached( sat::Solvable solv_r, const Pathname & localfile_r )
+{
+  if ( ! _active || ! solv_r )
+    return;
+  Counts & counts { _repos[repoOf( solv_r )] };
+  ++counts._cached;
+  counts._cachedBytes += PathInfo( localfile_r ).size();
+}
+
+void DownloadStats::packageStart( sat::Solvable solv_r )
+{
+  if ( ! _active || solv_r == _package )
+    return;	// a retry is part of the download
+  _package = solv_r;
+  _packageStart = std::chrono::steady_clock::now();
+}
+
+void DownloadStats::packageRetry()
+{
+  if ( ! _active || ! _package )
+    return;
+  ++_repos[repoOf( _package )]._retries;
+}
+
+void DownloadStats::packageFinish( bool ok_r )
+{
+  if ( ! _active || ! _package )
+    return;
+  Counts & counts { _repos[repoOf( _package )] };
+  if ( ok_r )
+    ++counts._downloaded;
+  else
+    ++counts._failed;
+  counts._seconds += secondsSince( _packageStart );
+  _package = sat::Solvable();
+  _deltaSize = ByteCount();
+}
+
+void DownloadStats::deltaDownload( const ByteCount & size_r )
+{
+  if ( _active )
+    _deltaSize = size_r;
+}
+
+void DownloadStats::deltaApplied()
+{
+  if ( ! _active )
+    return;
+  if ( ! _package )
+  {
+    DBG << "Delta rpm applied for an unknown package" << endl;
+    return;
+  }
+  Counts & counts { _repos[repoOf( _package )] };
+  ++counts._deltas;
+  if ( _package.downloadSize() > _deltaSize )
+    counts._deltaSaved += _package.downloadSize() - _deltaSize;
+}
+
+void DownloadStats::fileStart( const Url & url_r )
+{
+  if ( _active )
+    _fileStart[url_r.asString()] = std::chrono::steady_clock::now();
+}
+
+void DownloadStats::fileRetry( const Url & url_r )
+{
+  if ( _active )
+    ++_servers[serverOf( url_r )]._retries;
+}
+
+void DownloadStats::fileFinish( const Url & url_r, const Pathname & localfile_r, bool ok_r )
+{
+  if ( ! _active )
+    return;
+  auto it = _fileStart.find( url_r.asString() );
+  if ( it == _fileStart.end() )
+    return;	// not started while collecting
+
+  Counts & counts { _servers[serverOf( url_r )] };
+  counts._seconds += secondsSince( it->second );
+  _fileStart.erase( it );
+  if ( ! ok_r )
+  {
+    ++counts._failed;
+    return;
+  }
+  ByteCount size { PathInfo( localfile_r ).size() };
+  ++counts._downloaded;
+  counts._bytes += size;
+  if ( _package && isRpm( localfile_r ) )
+    _repos[repoOf( _package )]._bytes += size;
+}
+
+DownloadStats::Counts DownloadStats::total() const
+{
+  Counts ret;
+  for ( const auto & el : _repos )
+    ret += el.second;
+  return ret;
+}
+
+std::string DownloadStats::serverOf( const Url & url_r )
+{
+  std::string ret { url_r.getScheme() + "://" + url_r.getHost() };
+  if ( ! url_r.getPort().empty() )
+    ret += ":" + url_r.getPort();
+  return ret;
+}
+
+std::string DownloadStats::summary() const
+{
+  Counts counts { total() };
+  str::Str ret;
+  // translators: %1% is a number of packages, %2% a size like "5.6 MiB", %3% a duration in seconds
+  ret << str::Format(PL_("Downloaded %1% package (%2% in %3%s", "Downloaded %1% packages (%2% in %3%s", counts._downloaded))
+         % counts._downloaded % counts._bytes % str::form( "%.1f", counts._seconds );
+  if ( counts.rate() )
+    ret << ", " << asRate( counts.rate() );
+  ret << ")";
+  if ( counts._cached )
+    // translators: %1% is a number of packages, %2% a percentage
+    ret << ", " << str::Format(PL_("%1% package in cache (%2%%% hit ratio)", "%1% packages in cache (%2%%% hit ratio)", counts._cached))
+                   % counts._cached % unsigned( counts.cacheHitRatio() * 100 + 0.5 );
+  if ( counts._retries )
+    // translators: %1% is a number of retries
+    ret << ", " << str::Format(PL_("%1% retry", "%1% retries", counts._retries)) % counts._retries;
+  if ( counts._failed )
+    // translators: %1% is a number of downloads
+    ret << ", " << str::Format(PL_("%1% failed", "%1% failed", counts._failed)) % counts._failed;
+  if ( counts._deltaSaved )
+    // translators: %1% is a size like "5.6 MiB"
+    ret << ", " << str::Format(_("%1% saved by delta rpms")) % counts._deltaSaved;
+  ret << ".";
+  return ret;
+}
+
+void DownloadStats::writeTable( std::ostream & str ) const
+{
+  if ( ! _repos.empty() )
+  {
+    Table t;
+    t << ( TableHeader() << _("Repository") << _("Downloaded") << _("In Cache") << _("Failed") << _("Retries") << _("Size") << _("Seconds") << _("Rate") << _("Delta Saved") );
+    for ( const auto & el : _repos )
+    {
+      const Counts & counts { el.second };
+      t << ( TableRow() << el.first << counts._downloaded << counts._cached << counts._failed << counts._retries
+                        << counts._bytes.asString() << asSeconds( counts._seconds ) << asRate( counts.rate() )
+                        << ( counts._deltaSaved ? counts._deltaSaved.asString() : std::string() ) );
+    }
+    str << std::endl << t;
+  }
+
+  if ( ! _servers.empty() )
+  {
+    Table t;
+    t << ( TableHeader() << _("Server") << _("Files") << _("Failed") << _("Retries") << _("Size") << _("Seconds") << _("Rate") );
+    for ( const auto & el : _servers )
+    {
+      const Counts & counts { el.second };
+      t << ( TableRow() << el.first << counts._downloaded << counts._failed << counts._retries
+                        << counts._bytes.asString() << asSeconds( counts._seconds ) << asRate( counts.rate() ) );
+    }
+    str << std::endl << t;
+  }
+}
+
+void DownloadStats::writeXml( std::ostream & str ) const
+{
+  Counts counts { total() };
+  str << "<download-stats";
+  xmlCounts( str, counts );
+  str << " cache-hit-ratio=\"" << str::form( "%.3f", counts.cacheHitRatio() ) << "\">" << std::endl;
+  for ( const auto & el : _repos )
+  {
+    str << "<repo alias=\"" << xml::escape( el.first ) << "\"";
+    xmlCounts( str, el.second );
+    str << "/>" << std::endl;
+  }
+  for ( const auto & el : _servers )
+  {
+    str << "<server url=\"" << xml::escape( el.first ) << "\"";
+    xmlCounts( str, el.second );
+    str << "/>" << std::endl;
+  }
+  str << "</download-stats>" << std::endl;
+}
+
+void DownloadStats::writeJson( std::ostream & str ) const
+{
+  Counts counts { total() };
+  {
+    OutJSON::Line line( str, "download-stats" );
+    jsonCounts( line, counts );
+    line.addRaw( "cache_hit_ratio", str::form( "%.3f", counts.cacheHitRatio() ) );
+  }
+  for ( const auto & el : _repos )
+  {
+    OutJSON::Line line( str, "download-repo" );
+    line.add( "alias", el.first );
+    jsonCounts( line, el.second );
+  }
+  for ( const auto & el : _servers )
+  {
+    OutJSON::Line line( str, "download-server" );
+    line.add( "url", el.first );
+    jsonCounts( line, el.second );
+  }
+}
@@ -0,0 +1,133 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#ifndef ZYPPER_UTILS_DOWNLOADSTATS_H_
+#define ZYPPER_UTILS_DOWNLOADSTATS_H_
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+#include <zypp/ByteCount.h>
+#include <zypp/Pathname.h>
+#include <zypp/Url.h>
+#include <zypp/sat/Solvable.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class DownloadStats
+/// \brief What the package downloads of a commit really cost.
+///
+/// Fed by the download callbacks while \ref start was called and \ref stop
+/// was not: the packages taken from the cache, the bytes actually received
+/// and the time it took per repository and per server, the retries and the
+/// bytes saved by applying delta rpms.
+///
+/// The servers are those of the URLs reported by the media backend. For a
+/// metalink download that is the repository URL, not the mirrors the
+/// chunks were actually fetched from.
+///////////////////////////////////////////////////////////////////
+class DownloadStats
+{
+public:
+  /** Counts per repository or server. */
+  struct Counts
+  {
+    unsigned _downloaded = 0;	///< packages (repo) or files (server) received
+    unsigned _cached = 0;	///< packages taken from the cache
+    unsigned _failed = 0;	///< downloads which failed
+    unsigned _retries = 0;	///< downloads retried on user request
+    unsigned _deltas = 0;	///< delta rpms applied
+    zypp::ByteCount _bytes;	///< bytes received
+    zypp::ByteCount _cachedBytes;	///< size of the packages taken from the cache
+    zypp::ByteCount _deltaSaved;	///< bytes saved by downloading delta rpms
+    double _seconds = 0.0;	///< spent downloading
+
+    /** Bytes received per second (0 if unknown). */
+    zypp::ByteCount rate() const;
+
+    /** Share of the packages taken from the cache (0..1). */
+    double cacheHitRatio() const;
+
+    Counts & operator+=( const Counts & rhs );
+  };
+
+public:
+  static DownloadStats & instance();
+
+  /** Reset and start collecting. */
+  void start();
+
+  /** Stop collecting. */
+  void stop()
+  { _active = false; }
+
+  bool active() const
+  { return _active; }
+
+  /** Whether anything was collected. */
+  bool empty() const
+  { return _repos.empty() && _servers.empty(); }
+
+  /** \name Package downloads (repo::DownloadResolvableReport). */
+  //@{
+  void cached( zypp::sat::Solvable solv_r, const zypp::Pathname & localfile_r );
+  void packageStart( zypp::sat::Solvable solv_r );
+  void packageRetry();
+  void packageFinish( bool ok_r );
+  void deltaDownload( const zypp::ByteCount & size_r );
+  void deltaApplied();
+  //@}
+
+  /** \name File downloads (media::DownloadProgressReport). */
+  //@{
+  void fileStart( const zypp::Url & url_r );
+  void fileRetry( const zypp::Url & url_r );
+  void fileFinish( const zypp::Url & url_r, const zypp::Pathname & localfile_r, bool ok_r );
+  //@}
+
+  /** Counts per repository alias. */
+  const std::map<std::string,Counts> & repos() const
+  { return _repos; }
+
+  /** Counts per server (scheme://host). */
+  const std::map<std::string,Counts> & servers() const
+  { return _servers; }
+
+  /** The sum of the \ref repos. */
+  Counts total() const;
+
+  /** One line telling the \ref total. */
+  std::string summary() const;
+
+  /** Print the counts per repo and server as tables. */
+  void writeTable( std::ostream & str ) const;
+
+  /** Write a \c download-stats element. */
+  void writeXml( std::ostream & str ) const;
+
+  /** Write a \c download-stats line followed by \c download-repo and \c download-server lines. */
+  void writeJson( std::ostream & str ) const;
+
+  /** The server an URL is downloaded from. */
+  static std::string serverOf( const zypp::Url & url_r );
+
+private:
+  DownloadStats() {}
+
+private:
+  bool _active = false;
+  std::map<std::string,Counts> _repos;
+  std::map<std::string,Counts> _servers;
+
+  zypp::sat::Solvable _package;	///< the package being downloaded
+  std::chrono::steady_clock::time_point _packageStart;
+  zypp::ByteCount _deltaSize;	///< of the delta rpm of \ref _package
+  std::map<std::string,std::chrono::steady_clock::time_point> _fileStart;	///< by URL
+};
+
+#endif // ZYPPER_UTILS_DOWNLOADSTATS_H_
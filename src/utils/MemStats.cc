@@ -0,0 +1,189 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <malloc.h>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+
+#include "utils/MemStats.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Read the "Key:   N kB" lines we are interested in from a /proc file. */
+  void readProcKb( const char * file_r, std::initializer_list<std::pair<const char *, std::uint64_t *>> keys_r )
+  {
+    std::ifstream in( file_r );
+    for ( std::string line; std::getline( in, line ); )
+    {
+      for ( const auto & key : keys_r )
+      {
+        std::string::size_type len = ::strlen( key.first );
+        if ( line.compare( 0, len, key.first ) == 0 && line.size() > len && line[len] == ':' )
+          *key.second = str::strtonum<std::uint64_t>( str::trim( line.substr( len+1 ) ) );
+      }
+    }
+  }
+
+  /** Reset the peak RSS (VmHWM) of the process (Linux >= 4.0). */
+  bool resetPeakRss()
+  {
+    std::ofstream out( "/proc/self/clear_refs" );
+    out << "5" << std::flush;
+    return bool(out);
+  }
+
+  inline double secondsSince( std::chrono::steady_clock::time_point start_r )
+  { return std::chrono::duration<double>( std::chrono::steady_clock::now() - start_r ).count(); }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+MemStats::Phase::Phase( std::string name_r )
+: _name { std::move(name_r) }
+, _start { std::chrono::steady_clock::now() }
+, _active { MemStats::instance().enabled() && ! MemStats::instance()._inPhase }	// nested phases count for the outer one
+{
+  if ( _active )
+    MemStats::instance().phaseStart();
+}
+
+MemStats::Phase::~Phase()
+{
+  if ( _active )
+    MemStats::instance().phaseDone( std::move(_name), secondsSince( _start ) );
+}
+
+MemStats & MemStats::instance()
+{
+  static MemStats _instance;
+  return _instance;
+}
+
+void MemStats::enable( Pathname reportFile_r )
+{
+  _enabled = true;
+  _reportFile = std::move(reportFile_r);
+  _start = std::chrono::steady_clock::now();
+  MIL << "Memory statistics enabled, report to " << ( _reportFile.empty() ? "stderr" : _reportFile.asString() ) << endl;
+}
+
+MemStats::Sample MemStats::current( std::string phase_r )
+{
+  Sample ret;
+  ret._phase = std::move(phase_r);
+  readProcKb( "/proc/self/status", { { "VmRSS", &ret._rss }, { "VmHWM", &ret._peakRss } } );
+  readProcKb( "/proc/self/smaps_rollup", { { "Pss", &ret._pss } } );
+#if defined(__GLIBC__) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+  struct mallinfo2 mi = ::mallinfo2();
+#else
+  struct mallinfo mi = ::mallinfo();	// int counters, may wrap above 2GB
+#endif
+  ret._heapInUse   = std::uint64_t(mi.uordblks) / 1024;
+  ret._heapFree    = std::uint64_t(mi.fordblks) / 1024;
+  ret._heapMmapped = std::uint64_t(mi.hblkhd) / 1024;
+  return ret;
+}
+
+void MemStats::phaseStart()
+{
+  _inPhase = true;
+  // Remember the peak since the last reset before starting a new one.
+  _peakRss = std::max( _peakRss, current( std::string() )._peakRss );
+  _phasePeak = resetPeakRss();
+}
+
+void MemStats::phaseDone( std::string phase_r, double seconds_r )
+{
+  _inPhase = false;
+  Sample sample { current( std::move(phase_r) ) };
+  sample._seconds = seconds_r;
+  _peakRss = std::max( _peakRss, sample._peakRss );
+  DBG << "memstats " << sample._phase << ": rss " << sample._rss << "kB, peak " << sample._peakRss << "kB, heap " << sample._heapInUse << "kB" << endl;
+  _samples.push_back( std::move(sample) );
+}
+
+void MemStats::report()
+{
+  if ( ! _enabled )
+    return;
+
+  Sample total { current( "total" ) };
+  total._seconds = secondsSince( _start );
+  total._peakRss = _peakRss = std::max( _peakRss, total._peakRss );
+  _samples.push_back( std::move(total) );
+
+  if ( _reportFile.empty() )
+  {
+    writeTable( std::cerr );
+    return;
+  }
+
+  std::ofstream out( _reportFile.c_str() );
+  writeJson( out );
+  if ( ! out )
+    ERR << "Can not write memory statistics to " << _reportFile << endl;
+  else
+    MIL << "Memory statistics written to " << _reportFile << endl;
+}
+
+void MemStats::writeJson( std::ostream & str ) const
+{
+  // The phase names are ours, plain ASCII without quotes.
+  str << "{\n"
+      << "  \"unit\": \"kB\",\n"
+      << "  \"phase_peak\": " << ( _phasePeak ? "true" : "false" ) << ",\n"
+      << "  \"peak_rss\": " << _peakRss << ",\n"
+      << "  \"phases\": [";
+  const char * sep = "\n";
+  for ( const Sample & sample : _samples )
+  {
+    str << sep
+        << "    { \"phase\": \"" << sample._phase << "\""
+        << ", \"seconds\": " << std::fixed << std::setprecision(3) << sample._seconds
+        << ", \"rss\": " << sample._rss
+        << ", \"peak_rss\": " << sample._peakRss
+        << ", \"pss\": " << sample._pss
+        << ", \"heap_in_use\": " << sample._heapInUse
+        << ", \"heap_free\": " << sample._heapFree
+        << ", \"heap_mmapped\": " << sample._heapMmapped
+        << " }";
+    sep = ",\n";
+  }
+  str << "\n  ]\n}" << std::endl;
+}
+
+void MemStats::writeTable( std::ostream & str ) const
+{
+  str << "Memory usage per phase (kB)" << ( _phasePeak ? "" : ", peak since start" ) << ":" << std::endl;
+  str << std::left << std::setw(16) << "phase" << std::right
+      << std::setw(10) << "seconds"
+      << std::setw(10) << "rss"
+      << std::setw(10) << "peak"
+      << std::setw(10) << "pss"
+      << std::setw(12) << "heap used"
+      << std::setw(12) << "heap free"
+      << std::setw(12) << "heap mmap" << std::endl;
+  for ( const Sample & sample : _samples )
+  {
+    str << std::left << std::setw(16) << sample._phase << std::right
+        << std::setw(10) << std::fixed << std::setprecision(3) << sample._seconds
+        << std::setw(10) << sample._rss
+        << std::setw(10) << sample._peakRss
+        << std::setw(10) << sample._pss
+        << std::setw(12) << sample._heapInUse
+        << std::setw(12) << sample._heapFree
+        << std::setw(12) << sample._heapMmapped << std::endl;
+  }
+}
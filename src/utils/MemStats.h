@@ -0,0 +1,112 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#ifndef ZYPPER_UTILS_MEMSTATS_H_
+#define ZYPPER_UTILS_MEMSTATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <zypp/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class MemStats
+/// \brief Memory usage per setup or command phase (\c --memstats).
+///
+/// A \ref Phase guard placed around a phase (loading the repos or the
+/// rpm database, solving, computing the summary, commit) resets the
+/// kernels peak RSS counter when entered and samples the memory usage
+/// when left. So the peak of each phase can be told apart from the
+/// peak of the whole run.
+///
+/// As long as \ref enable was not called the guards do nothing.
+///////////////////////////////////////////////////////////////////
+class MemStats
+{
+public:
+  /** Memory usage at the end of a phase. Sizes in kB. */
+  struct Sample
+  {
+    std::string _phase;
+    double _seconds = 0.0;		///< duration of the phase
+    std::uint64_t _rss = 0;		///< VmRSS
+    std::uint64_t _peakRss = 0;		///< VmHWM, peak RSS within the phase if \ref phasePeak
+    std::uint64_t _pss = 0;		///< Pss from smaps_rollup, 0 if not available
+    std::uint64_t _heapInUse = 0;	///< malloc: allocated
+    std::uint64_t _heapFree = 0;	///< malloc: free but not returned to the system
+    std::uint64_t _heapMmapped = 0;	///< malloc: in mmapped chunks
+  };
+
+  /** Scope guard sampling the memory usage of a phase. */
+  class Phase
+  {
+  public:
+    Phase( std::string name_r );
+    ~Phase();
+
+    Phase( const Phase & ) = delete;
+    Phase & operator=( const Phase & ) = delete;
+
+  private:
+    std::string _name;
+    std::chrono::steady_clock::time_point _start;
+    bool _active;
+  };
+
+public:
+  static MemStats & instance();
+
+  /** Start collecting. The report is written as JSON to \a reportFile_r or,
+   * if empty, printed to stderr.
+   */
+  void enable( zypp::Pathname reportFile_r = zypp::Pathname() );
+
+  bool enabled() const
+  { return _enabled; }
+
+  /** Whether the peak RSS of a \ref Sample is the peak within its phase
+   * (the kernel allows to reset it), or the peak since the process started.
+   */
+  bool phasePeak() const
+  { return _phasePeak; }
+
+  /** The collected samples, in order. */
+  const std::vector<Sample> & samples() const
+  { return _samples; }
+
+  /** Take a final sample and write or print the report if enabled. */
+  void report();
+
+  /** Write the report as JSON. */
+  void writeJson( std::ostream & str ) const;
+
+  /** Print the report as table. */
+  void writeTable( std::ostream & str ) const;
+
+  /** The current memory usage. */
+  static Sample current( std::string phase_r );
+
+private:
+  MemStats() {}
+
+  void phaseStart();
+  void phaseDone( std::string phase_r, double seconds_r );
+
+private:
+  bool _enabled = false;
+  bool _phasePeak = false;
+  bool _inPhase = false;
+  std::uint64_t _peakRss = 0;	///< peak of the whole run, collected across resets
+  zypp::Pathname _reportFile;
+  std::chrono::steady_clock::time_point _start;
+  std::vector<Sample> _samples;
+};
+
+#endif // ZYPPER_UTILS_MEMSTATS_H_
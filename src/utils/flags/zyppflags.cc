@@ -13,6 +13,7 @@
 
 #include <getopt.h>
 #include <unordered_map>
+#include <map>
 #include <exception>
 #include <utility>
 #include <string.h>
@@ -83,23 +84,15 @@ Value::Value( DefValueFun &&defValue, SetterFun &&setter, std::string argHint )
 
 }
 
-void Value::set( const CommandOption &opt, const boost::optional<std::string> in )
+bool Value::set( const CommandOption &opt, const boost::optional<std::string> in ) const
 {
-  if ( _wasSet && !(opt.flags & Repeatable) ) {
-    // bsc#1123865: don't throw, just warn
-    Zypper::instance().out().warning( FlagRepeatedException(opt.nameStr()).asString() );
-    return;
-  }
-
   if ( _preWriteHook.size() ) {
     for ( auto &hook : _preWriteHook ) {
       if ( !hook ( opt, in ) )
-        return;
+        return false;
     }
   }
 
-  _wasSet = true;
-
   bool runPostSetHook = false;
   if ( !in && opt.flags & OptionalArgument ) {
       auto optVal = _defaultVal();
@@ -118,14 +111,14 @@ void Value::set( const CommandOption &opt, const boost::optional<std::string> in
         hook ( opt, in );
       }
     }
-    return;
+    return true;
   }
 
   // this line should never be reached, because the case of required argument is handled directly in parseCLI
   ZYPP_THROW( ZyppFlagsException(str::Format("BUG: Flag %1% requires a value, but non was provided.") % opt.nameStr() ) );
 }
 
-void Value::neverUsed()
+void Value::neverUsed() const
 {
   if ( _notFoundHook )
     _notFoundHook();
@@ -141,11 +134,6 @@ std::string Value::argHint() const
   return _argHint;
 }
 
-bool Value::wasSet() const
-{
-  return _wasSet;
-}
-
 Value &Value::after( std::function<void ()> &&postWriteHook )
 {
   return after ( [ postWriteHook ] ( const CommandOption &, const boost::optional<std::string> & ) {
@@ -182,33 +170,25 @@ bool &onlyWarnOnAbbrevSwitches()
   return enable;
 }
 
-int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup> &options )
-{
-  // the short options string as used int getopt
+OptionTable::OptionTable( const std::vector<CommandGroup> &options )
   // + - do not permute, stop at the 1st nonoption, which is the command
   // : - return : to indicate missing arg, not ?
-  std::string shortopts( "+:" );
-
-  // the set of long options
-  std::vector<struct option> longopts;
+  : _shortopts( "+:" )
+{
+  _shortoptsIndex.fill( -1 );
 
   // the set of all conflicting options
   ConflictingFlagsList conflictingFlags;
 
   //build a complete list and a long and short option index so we can
   //easily get to the CommandOption
-  std::vector<CommandOption> allOpts;
-  std::unordered_map<std::string, int> longOptIndex;  //we do not actually need that index other than checking for dups
-  std::unordered_map<char, int>        shortOptIndex;
+  std::unordered_map<std::string, int> longOptIndex;
 
-  //we intentionally copy all the CommandOptions here instead of using pointers, each state change in the
-  //Options or Value implementations are only valid for one run of parseCLI, state should not be remembered
-  //to not influence a possible next run
   for ( const CommandGroup &grp : options ) {
     for ( const CommandOption &currOpt : grp.options ) {
-      allOpts.push_back( currOpt );
+      _opts.push_back( &currOpt );
 
-      int allOptIndex = allOpts.size() - 1;
+      int allOptIndex = _opts.size() - 1;
       int flags = currOpt.flags;
 
       if ( flags & RequiredArgument && flags &  OptionalArgument ) {
@@ -219,23 +199,46 @@ int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup
         if ( !longOptIndex.insert( { currOpt.name, allOptIndex } ).second ) {
           throw ZyppFlagsException( str::Format("Duplicate long option %1%") % currOpt.nameStr() );
         }
-        appendToLongOptions( currOpt, longopts );
+        appendToLongOptions( currOpt, _longopts );
+        _longoptsIndex.push_back( allOptIndex );
       }
 
       if ( currOpt.shortName ) {
-        if ( !shortOptIndex.insert( { currOpt.shortName, allOptIndex } ).second ) {
+        int &idx = _shortoptsIndex[ static_cast<unsigned char>(currOpt.shortName) ];
+        if ( idx != -1 ) {
           throw ZyppFlagsException( str::Format("Duplicate short option %1%") % currOpt.shortNameStr() );
         }
-        appendToOptString( currOpt, shortopts );
+        idx = allOptIndex;
+        appendToOptString( currOpt, _shortopts );
       }
     }
     conflictingFlags.insert( conflictingFlags.end(), grp.conflictingOptions.begin(), grp.conflictingOptions.end() );
   }
 
   //the long options always need to end with a set of zeros
-  longopts.push_back( {0, 0, 0, 0} );
+  _longopts.push_back( {0, 0, 0, 0} );
+
+  //resolve the conflicting flags per option
+  _conflicts.resize( _opts.size() );
+  for ( int i = 0; unsigned(i) < _opts.size(); ++i ) {
+    const CommandOption &opt = *_opts[i];
+    for ( const auto &flagSet : conflictingFlags ) {
+      if ( std::find( flagSet.begin(), flagSet.end(), opt.name ) == flagSet.end() )
+        continue;
 
+      for ( const std::string &conflicting : flagSet ) {
+        if ( conflicting == opt.name )
+          continue;
 
+        auto it = longOptIndex.find( conflicting );
+        if ( it == longOptIndex.end() ) {
+          WAR << "Ignoring unknown option " << conflicting << " specified as conflicting flag for " << opt.name << endl;
+        } else {
+          _conflicts[i].push_back( it->second );
+        }
+      }
+    }
+  }
 
   /*
    * Because of complex rules for flags in zypper, its required to process
@@ -273,27 +276,28 @@ int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup
    * Third pass through
    *    D
    *
+   * The passes only depend on the options, so they are done once here and the
+   * resulting order is remembered in _writeOrder.
+   *
    * We keep track of the number of values to be written, if the number
    * does not change during a pass through something in the dependency chain is broken
    * we need to give up, since its most likely to be a circular dependency problem we can
-   * try to detect that and give a hint by throwing a exception
+   * try to detect that and give a hint by throwing a exception. The exception is
+   * remembered and thrown by \ref parse, after the writeable flags were written.
    */
 
 
   //build the dependency tree
-  //the dependency tree, pointing to indices in the allOpts
+  //the dependency tree, pointing to indices in _opts
   std::map< int, std::set<int> > dependencyTree;
-  for ( int i = 0; unsigned(i) < allOpts.size(); ++i ) {
-    const CommandOption &opt = allOpts[i];
+  for ( int i = 0; unsigned(i) < _opts.size(); ++i ) {
+    const CommandOption &opt = *_opts[i];
 
     std::set<int> myDeps;
     for ( const std::string &str : opt.dependencies ) {
       int idx = -1;
       if ( str.size() == 1 ) {
-        auto it = shortOptIndex.find( str.at(0) );
-        if ( it != shortOptIndex.end() ) {
-          idx = it->second;
-        }
+        idx = _shortoptsIndex[ static_cast<unsigned char>(str.at(0)) ];
       } else {
         auto it = longOptIndex.find( str );
         if ( it != longOptIndex.end() ) {
@@ -309,25 +313,103 @@ int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup
     dependencyTree.insert( std::make_pair( i, myDeps) );
   }
 
+  std::set<int> flagsSolved;
+
+  auto allSolved = [ &flagsSolved ]( const int &flagIdx ) {
+    return ( flagsSolved.find( flagIdx ) != flagsSolved.end() );
+  };
+
+  //we need to run util all flags were solved
+  while ( flagsSolved.size() < _opts.size() ) {
+
+    std::vector<int> writeableFlags;
+
+    for ( const auto &node : dependencyTree ) {
+
+      //all values for that flag where written
+      if ( flagsSolved.find( node.first ) != flagsSolved.end() )
+        continue;
+
+      const std::set<int> &nodeDependencies = node.second;
+
+      if ( nodeDependencies.empty() || std::all_of( nodeDependencies.begin(), nodeDependencies.end(), allSolved ) ) {
+        writeableFlags.push_back ( node.first );
+      }
+    }
+
+    if ( writeableFlags.size() == 0 ) {
+
+      //we were unable to resolve one argument in one pass, give up and check for circular deps (recursive search with copied set)
+      const auto &allOpts = _opts;
+      std::function<void ( std::set<int>, int )> findAllDeps = [ &allOpts, &dependencyTree, &findAllDeps] ( std::set < int > foundSoFar, int nextDep ) -> void {
+        for ( int i : dependencyTree.at( nextDep ) ) {
+
+          //explicitely do a copy, so we only have one path in the set always
+          std::set<int> mySet = foundSoFar;
+
+          if ( ! mySet.insert( i ).second ) {
+            //found a circular dependency
+
+            std::string circDep;
+            auto appendDepToString = [ &circDep, &allOpts ] ( int depIndex ) {
+              auto &opt = *allOpts.at( depIndex );
+              if ( circDep.size() )
+                circDep += "->";
+              circDep += opt.nameStr() + "(" + opt.shortNameStr() + ")";
+            };
+
+            for ( int dep : foundSoFar )
+              appendDepToString(dep);
+            appendDepToString(i);
+
+            ZYPP_THROW( ZyppFlagsException ( str::Format("Found a circular dependency: %1%") % circDep ) );
+          } else {
+            findAllDeps( mySet, i );
+          }
+        }
+      };
+
+      try {
+        for ( const auto &currDep : dependencyTree )
+          findAllDeps ( { currDep.first }, currDep.first );
+      } catch ( const ZyppFlagsException & ) {
+        _dependencyError = std::current_exception();
+      }
+
+      break;
+    }
+
+    //we now have all writeables for this pass through,
+    //lets sort them by priority and remember the order
+    std::stable_sort( writeableFlags.begin(), writeableFlags.end(), [ this ]( int flagA, int flagB  ) {
+      return _opts[flagA]->priority > _opts[flagB]->priority;
+    });
+
+    _writeOrder.insert( _writeOrder.end(), writeableFlags.begin(), writeableFlags.end() );
+    flagsSolved.insert( writeableFlags.begin(), writeableFlags.end() );
+  }
+}
+
+int OptionTable::parse( const int argc, char * const *argv ) const
+{
   //setup getopt
   opterr = 0; 			// we report errors on our own
 
   //work around the getopt quirks
   optind = 0;       // setting optind to zero will reset the argument parser
 
-  //remember all values we want to write
-  //the key of the map is the index of options in allOpts
-  std::map<int, std::vector< boost::optional<std::string> > > parsedValues;
+  //remember all values we want to write, per index in _opts
+  std::vector< std::vector< boost::optional<std::string> > > parsedValues( _opts.size() );
 
   //regular expression used to match against flags later in the code
-  //kept here to avoid constant recompilation of the regex during the loop
-  const zypp::str::regex rxexpr("^--([^=]+)(=.*)?$");
+  //kept here to avoid constant recompilation of the regex
+  static const zypp::str::regex rxexpr("^--([^=]+)(=.*)?$");
 
   while ( true ) {
 
     const int currOptInd = optind == 0 ?  1 : optind; //optind 0 always points to the command name
-    int option_index = -1;      //index of the last found long option, same as in allOpts
-    const int optc = getopt_long( argc, argv, shortopts.c_str(), longopts.data(), &option_index );
+    int option_index = -1;      //index of the last found long option in _longopts
+    const int optc = getopt_long( argc, argv, _shortopts.c_str(), _longopts.data(), &option_index );
 
     if ( optc == -1 )
       break;
@@ -353,14 +435,12 @@ int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup
         bool longOpt = false;
         if ( option_index == -1 ) {
           //we have a short option
-          auto it = shortOptIndex.find( (char) optc );
-          if ( it != shortOptIndex.end() ) {
-            index = it->second;
-          }
+          if ( optc > 0 && optc < 256 )
+            index = _shortoptsIndex[ optc ];
         } else {
           //we have a long option
           longOpt = true;
-          index = option_index;
+          index = _longoptsIndex[ option_index ];
         }
 
         if ( index >= 0 ) {
@@ -373,7 +453,7 @@ int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup
               arg = std::string();
           }
 
-          CommandOption &opt = allOpts[index];
+          const CommandOption &opt = *_opts[index];
 
           // getopt_long supports unqiue abbreviation of flags, e.g. --reposd-dir can be abbreviated
           // with --repos. We need to check here if the flag that was parsed is matching exactly
@@ -400,29 +480,13 @@ int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup
           }
 
           // check if a conflicting option was used before
-          std::vector<std::string> conflictingList;
-          for ( const auto &flagSet : conflictingFlags ) {
-            if ( std::find( flagSet.begin(), flagSet.end(), opt.name ) != flagSet.end() ) {
-              std::copy_if( flagSet.begin(), flagSet.end(), std::back_inserter(conflictingList),  [ &opt ]( const std::string &val ) {
-                return val != opt.name;
-              });
-            }
-          }
-
-          if ( !conflictingList.empty() ) {
-            for ( const std::string &conflicting : conflictingList ){
-              auto it = longOptIndex.find( conflicting );
-              if ( it == longOptIndex.end() ) {
-                WAR << "Ignoring unknown option " << conflicting << " specified as conflicting flag for " << opt.name << endl;
-              } else {
-                if ( parsedValues.find( it->second ) != parsedValues.end() ) {
-                  throw ConflictingFlagsException( opt.nameStr(), CommandOption::nameStr(conflicting) );
-                }
-              }
+          for ( int conflicting : _conflicts[index] ) {
+            if ( !parsedValues[conflicting].empty() ) {
+              throw ConflictingFlagsException( opt.nameStr(), _opts[conflicting]->nameStr() );
             }
           }
 
-          //we remember the given value for now, and write it out in the next step when iterating over the dependency tree
+          //we remember the given value for now, and write it out in the next step in _writeOrder
           parsedValues[ index ].push_back( arg );
         }
         break;
@@ -430,96 +494,44 @@ int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup
     }
   }
 
-  std::set<int> flagsSolved;
-
-  auto allSolved = [ &flagsSolved ]( const int &flagIdx ) {
-    return ( flagsSolved.find( flagIdx ) != flagsSolved.end() );
-  };
-
-  //we need to run util all flags were solved
-  while ( flagsSolved.size() < allOpts.size() ) {
+  //finally we can write the values
+  for ( int flag : _writeOrder ) {
+    const CommandOption &opt = *_opts[flag];
+    std::vector< boost::optional<std::string> > &values = parsedValues[flag];
 
-    std::vector<int> writeableFlags;
-
-    for ( const auto &node : dependencyTree ) {
-
-      //all values for that flag where written
-      if ( flagsSolved.find( node.first ) != flagsSolved.end() )
-        continue;
-
-      std::vector<CommandOption *> opts;
-      const std::set<int> &nodeDependencies = node.second;
-
-      if ( nodeDependencies.empty() || std::all_of( nodeDependencies.begin(), nodeDependencies.end(), allSolved ) ) {
-        writeableFlags.push_back ( node.first );
-      }
+    if ( values.empty() ) {
+      //trigger the "neverUsed" callback if registered
+      opt.value.neverUsed();
+      continue;
     }
 
-    if ( writeableFlags.size() == 0 ) {
-
-      //we were unable to resolve one argument in one pass, give up and check for circular deps (recursive search with copied set)
-      std::set< std::string > dep;
-      std::function<void ( std::set<int>, int )> findAllDeps = [ &allOpts, &dependencyTree, &findAllDeps] ( std::set < int > foundSoFar, int nextDep ) -> void {
-        for ( int i : dependencyTree.at( nextDep ) ) {
-
-          //explicitely do a copy, so we only have one path in the set always
-          std::set<int> mySet = foundSoFar;
-
-          if ( ! mySet.insert( i ).second ) {
-            //found a circular dependency
-
-            std::string circDep;
-            auto appendDepToString = [ &circDep, &allOpts ] ( int depIndex ) {
-              auto &opt = allOpts.at( depIndex );
-              if ( circDep.size() )
-                circDep += "->";
-              circDep += opt.nameStr() + "(" + opt.shortNameStr() + ")";
-            };
-
-            for ( int dep : foundSoFar )
-              appendDepToString(dep);
-            appendDepToString(i);
-
-            ZYPP_THROW( ZyppFlagsException ( str::Format("Found a circular dependency: %1%") % circDep ) );
-          } else {
-            findAllDeps( mySet, i );
-          }
-        }
-      };
-
-      for ( const auto &currDep : dependencyTree )
-        findAllDeps ( { currDep.first }, currDep.first );
-
-      break;
-    }
-
-    //we now have all writeables for this pass through,
-    //lets sort them by priority and finally write them
-    std::sort( writeableFlags.begin(), writeableFlags.end(), [ &allOpts ]( int flagA, int flagB  ) {
-      return allOpts.at(flagA).priority > allOpts.at(flagB).priority;
-    });
-
-    //finally we can write the values
-    for ( int flag : writeableFlags ) {
-      if ( parsedValues.find( flag ) == parsedValues.end() ) {
-        //trigger the "neverUsed" callback if registered
-        allOpts[flag].value.neverUsed();
-      } else {
-        for ( const auto & val : parsedValues.at( flag ) ) {
-          allOpts[flag].value.set( allOpts[flag], val );
-        }
+    bool wasSet = false;
+    for ( const auto & val : values ) {
+      if ( wasSet && !(opt.flags & Repeatable) ) {
+        // bsc#1123865: don't throw, just warn
+        Zypper::instance().out().warning( FlagRepeatedException(opt.nameStr()).asString() );
+        continue;
       }
-      flagsSolved.insert( flag );
-      parsedValues.erase( flag );
+      if ( opt.value.set( opt, val ) )
+        wasSet = true;
     }
+    values.clear();
   }
 
-  if ( parsedValues.size() )
+  if ( _dependencyError )
+    std::rethrow_exception( _dependencyError );
+
+  if ( std::any_of( parsedValues.begin(), parsedValues.end(), []( const auto &values ) { return !values.empty(); } ) )
     ZYPP_THROW( ZyppFlagsException ("Not all parsed values were handled") );
 
   return optind;
 }
 
+int parseCLI( const int argc, char * const *argv, const std::vector<CommandGroup> &options )
+{
+  return OptionTable( options ).parse( argc, argv );
+}
+
 void renderHelp( const std::vector<CommandGroup> &options )
 {
   for ( const CommandGroup &grp : options ) {
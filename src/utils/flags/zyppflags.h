@@ -14,6 +14,8 @@
 #include <exception>
 #include <initializer_list>
 #include <set>
+#include <array>
+#include <getopt.h>
 
 #include <boost/optional.hpp>
 
@@ -90,15 +92,17 @@ namespace ZyppFlags {
 
     /**
      * Calls the setter functor, with either the given argument or the optional argument
-     * if the \a in parameter is null. Additionally it checks if the argument was already seen
-     * before and fails if that \a Repeatable flag is not set
+     * if the \a in parameter is null.
+     * \returns \c false if a \sa before hook rejected the value
+     * \note Whether a not \a Repeatable option was already set is checked by the parser,
+     * a \ref Value does not remember anything about a parse run.
      */
-    void set( const CommandOption &opt, const boost::optional<std::string> in );
+    bool set( const CommandOption &opt, const boost::optional<std::string> in ) const;
 
     /**
      * Calls the \sa never hook, the option was never given on CLI
      */
-    void neverUsed ();
+    void neverUsed () const;
 
     /**
      * Returns the default value represented as string, or a empty
@@ -112,9 +116,6 @@ namespace ZyppFlags {
      */
     std::string argHint () const;
 
-
-    bool wasSet () const;
-
     /**
      * Callback to call before writing the value
      */
@@ -136,7 +137,6 @@ namespace ZyppFlags {
     Value &notSeen ( std::function<void ()> &&notFoundHook );
 
   private:
-    bool _wasSet = false;
     DefValueFun _defaultVal;
     SetterFun _setter;
     std::string _argHint;
@@ -225,8 +225,44 @@ namespace ZyppFlags {
    */
   bool &onlyWarnOnAbbrevSwitches();
 
+  /**
+   * The getopt tables, option indexes and the order in which values are written,
+   * computed once for a list of \ref CommandGroup.
+   *
+   * All of this only depends on the options, so a table can be kept and used for
+   * any number of \ref parse calls. The state of a single run (the values found on
+   * the command line) is local to \ref parse. The options are referenced, not copied,
+   * and must outlive the table.
+   *
+   * \throws ZyppFlagsException if the options are inconsistent (e.g. duplicate names
+   * or dependencies on unknown flags)
+   */
+  class OptionTable
+  {
+  public:
+    OptionTable ( const std::vector<CommandGroup> &options );
+
+    /**
+     * Parses the command line arguments.
+     * \returns The first index in argv that was not parsed
+     * \throws ZyppFlagsException or any subtypes of it
+     */
+    int parse ( const int argc, char * const *argv ) const;
+
+  private:
+    std::vector<const CommandOption *> _opts;       //< all options, indices below refer to this
+    std::string _shortopts;                         //< the short options string as used in getopt
+    std::vector<struct option> _longopts;           //< the long options as used in getopt_long
+    std::vector<int> _longoptsIndex;                //< _longopts index to option index
+    std::array<int, 256> _shortoptsIndex;           //< short option char to option index, -1 if unknown
+    std::vector< std::vector<int> > _conflicts;     //< per option the options it conflicts with
+    std::vector<int> _writeOrder;                   //< the order in which the values must be written
+    std::exception_ptr _dependencyError;            //< circular dependency found when computing _writeOrder
+  };
+
   /**
    * Parses the command line arguments based on \a options.
+   * Same as parsing with a temporary \ref OptionTable.
    * \returns The first index in argv that was not parsed
    * \throws ZyppFlagsException or any subtypes of it
    */
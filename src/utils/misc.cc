@@ -5,6 +5,7 @@
                              |__/|_|  |_|
 \*---------------------------------------------------------------------------*/
 
+#include <map>
 #include <sstream>
 #include <iostream>
 #include <unistd.h>          // for getcwd()
@@ -617,43 +618,113 @@ bool looks_like_rpm_file( const std::string & s )
 
 // ----------------------------------------------------------------------------
 
-Pathname cache_rpm( const std::string & rpm_uri_str, const Pathname & cache_dir )
+namespace
 {
-  Url rpmurl = make_url(rpm_uri_str);
-  Pathname rpmpath(rpmurl.getPathName());
-  rpmurl.setPathName(rpmpath.dirname().asString()); // directory
-  rpmpath = rpmpath.basename(); // rpm file name
-
-  try
+  /** Put the local file \a file_r into the cache as \a target_r, without copying it if possible.
+   * Across filesystems (or with protected_hardlinks) it is copied: a symlink would be
+   * skipped when the cache is turned into a plaindir repo.
+   */
+  bool linkIntoCache( const Pathname & file_r, const Pathname & target_r )
   {
-    media::MediaManager mm;
-    AutoDispose<media::MediaAccessId> mid { mm.open(rpmurl) };
-    mid.setDispose( [&mm]( media::MediaAccessId mid ){ mm.release(mid); mm.close(mid); } );
-    mm.attach(mid);
-
-    mm.provideFile(mid, rpmpath.basename());
-    Pathname localrpmpath = mm.localPath(mid, rpmpath.basename());
-    filesystem::assert_dir(cache_dir);
-    bool error =
-      filesystem::hardlinkCopy(localrpmpath, cache_dir / localrpmpath.basename());
-
-    if ( error )
-    {
-      Zypper::instance().out().error(
-        _("Problem copying the specified RPM file to the cache directory."),
-        _("Perhaps you are running out of disk space."));
-      return Pathname();
-    }
-    return cache_dir / localrpmpath.basename();
+    filesystem::unlink( target_r );
+    return filesystem::hardlinkCopy( file_r, target_r ) == 0;
   }
-  catch (const Exception & e)
+
+  void reportCacheRpmError( const Exception & e )
   {
     Zypper::instance().out().error(e,
         _("Problem retrieving the specified RPM file") + std::string(":"),
         _("Please check whether the file is accessible."));
   }
 
-  return Pathname();
+  void reportCacheRpmCopyError()
+  {
+    Zypper::instance().out().error(
+      _("Problem copying the specified RPM file to the cache directory."),
+      _("Perhaps you are running out of disk space."));
+  }
+} // namespace
+
+Pathname cache_rpm( const std::string & rpm_uri_str, const Pathname & cache_dir )
+{
+  return cache_rpms( { rpm_uri_str }, cache_dir ).front();
+}
+
+std::vector<Pathname> cache_rpms( const std::vector<std::string> & rpm_uri_strs_r, const Pathname & cache_dir )
+{
+  std::vector<Pathname> ret( rpm_uri_strs_r.size() );
+  if ( rpm_uri_strs_r.empty() )
+    return ret;
+  filesystem::assert_dir( cache_dir );
+
+  // Local files are linked, remote ones grouped by directory.
+  std::map<std::string,std::pair<Url,std::vector<std::pair<unsigned,Pathname>>>> remoteDirs;
+  for ( unsigned i = 0; i < rpm_uri_strs_r.size(); ++i )
+  {
+    Url rpmurl = make_url( rpm_uri_strs_r[i] );
+    if ( ! rpmurl.isValid() )
+      continue;	// make_url reported the error
+
+    Pathname rpmpath( rpmurl.getPathName() );
+    if ( rpmurl.getScheme() == "dir" || rpmurl.getScheme() == "file" )
+    {
+      if ( ! PathInfo( rpmpath ).isFile() )
+      {
+        Zypper::instance().out().error(_("Specified local path does not exist or is not accessible."));
+        ERR << "not a file: " << rpmpath << endl;
+        continue;
+      }
+      if ( ! linkIntoCache( rpmpath, cache_dir / rpmpath.basename() ) )
+      {
+        reportCacheRpmCopyError();
+        continue;
+      }
+      ret[i] = cache_dir / rpmpath.basename();
+      continue;
+    }
+
+    rpmurl.setPathName( rpmpath.dirname().asString() ); // directory
+    auto & dir { remoteDirs[rpmurl.asCompleteString()] };
+    dir.first = rpmurl;
+    dir.second.push_back( { i, rpmpath.basename() } );
+  }
+
+  for ( const auto & dir : remoteDirs )
+  {
+    try
+    {
+      media::MediaManager mm;
+      AutoDispose<media::MediaAccessId> mid { mm.open( dir.second.first ) };
+      mid.setDispose( [&mm]( media::MediaAccessId mid ){ mm.release(mid); mm.close(mid); } );
+      mm.attach(mid);
+
+      for ( const auto & file : dir.second.second )
+      {
+        unsigned i = file.first;
+        const Pathname & rpmpath { file.second };
+        try
+        {
+          mm.provideFile( mid, rpmpath );
+          Pathname localrpmpath = mm.localPath( mid, rpmpath );
+          if ( filesystem::hardlinkCopy( localrpmpath, cache_dir / localrpmpath.basename() ) != 0 )
+          {
+            reportCacheRpmCopyError();
+            continue;
+          }
+          ret[i] = cache_dir / localrpmpath.basename();
+        }
+        catch ( const Exception & e )
+        {
+          reportCacheRpmError( e );
+        }
+      }
+    }
+    catch ( const Exception & e )
+    {
+      reportCacheRpmError( e );
+    }
+  }
+  return ret;
 }
 
 std::string indent( std::string text, int columns )
@@ -893,3 +964,18 @@ const char * computeStatusIndicator( const ui::Selectable & sel_r, bool tagForei
     return stem[1];
   return stem[0];
 }
+
+Pathname zypperUserCacheDir()
+{
+  if ( ::geteuid() == 0 )
+    return "/var/cache/zypper";
+
+  // http://standards.freedesktop.org/basedir-spec/basedir-spec-latest.html
+  const char * envp = ::getenv( "XDG_CACHE_HOME" );
+  if ( envp && *envp )
+    return Pathname( envp ) / "zypper";
+  envp = ::getenv( "HOME" );
+  if ( envp && *envp )
+    return Pathname( envp ) / ".cache/zypper";
+  return Pathname();
+}
@@ -217,6 +217,26 @@ bool looks_like_rpm_file( const std::string & s );
  */
 Pathname cache_rpm( const std::string & rpm_uri_str, const Pathname & cache_dir );
 
+/**
+ * Like \ref cache_rpm, for many RPM files at once.
+ *
+ * Files in the same remote directory are retrieved within one media session.
+ * Local files are not copied but linked into \a cache_dir (a symlink if a
+ * hardlink is not possible).
+ *
+ * \return Per argument the local Pathname of the file in the cache, empty
+ *      if a problem occurred.
+ */
+std::vector<Pathname> cache_rpms( const std::vector<std::string> & rpm_uri_strs_r, const Pathname & cache_dir );
+
+/**
+ * Directory for zypper's own (non-essential) cache files of the current user:
+ * \c /var/cache/zypper for root, \c $XDG_CACHE_HOME/zypper otherwise.
+ *
+ * \return An empty Pathname if no such directory can be determined.
+ */
+Pathname zypperUserCacheDir();
+
 /// Indent each line in \a text to \a columns
 std::string indent( std::string text, int columns );
 
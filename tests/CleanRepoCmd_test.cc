@@ -0,0 +1,47 @@
+#include "TestSetup.h"
+#include "commands/repos/clean.h"
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup();
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+namespace
+{
+  /** The \ref clean_repos flags of 'zypper clean \a args_r'. */
+  std::optional<CleanRepoFlags> cleanFlagsOf( std::vector<std::string> args_r )
+  {
+    args_r.insert( args_r.begin(), "clean" );
+    std::vector<char *> argv;
+    for ( std::string & arg : args_r )
+      argv.push_back( &arg[0] );
+    argv.push_back( nullptr );
+
+    CleanRepoCmd cmd { { "clean" } };
+    cmd.reset();
+    cmd.parseArguments( test.zypper(), argv.size() - 1, argv.data() );
+    return cmd.cleanFlags();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(clean_flags)
+{
+  BOOST_CHECK( cleanFlagsOf( {} ) == CleanRepoFlags( CleanRepoBits::Default ) );
+  BOOST_CHECK( cleanFlagsOf( { "-m" } ) == CleanRepoFlags( CleanRepoBits::CleanMetaData ) );
+  BOOST_CHECK( cleanFlagsOf( { "--all" } ) == CleanRepoFlags( CleanRepoBits::CleanAll ) );
+}
+
+BOOST_AUTO_TEST_CASE(clean_flags_with_trimming)
+{
+  // just trimming the package caches
+  BOOST_CHECK( ! cleanFlagsOf( { "--max-size", "2G" } ) );
+  BOOST_CHECK( ! cleanFlagsOf( { "--max-age", "30" } ) );
+  // the metadata is still cleaned, the package caches are trimmed instead
+  BOOST_CHECK( cleanFlagsOf( { "-m", "--max-size", "2G" } ) == CleanRepoFlags( CleanRepoBits::CleanMetaData | CleanRepoBits::KeepPackages ) );
+  BOOST_CHECK( cleanFlagsOf( { "-M", "--max-age", "30" } ) == CleanRepoFlags( CleanRepoBits::CleanRawMetaData | CleanRepoBits::KeepPackages ) );
+  BOOST_CHECK( cleanFlagsOf( { "-m", "-M", "--max-size", "2G" } ) == CleanRepoFlags( CleanRepoBits::CleanAll | CleanRepoBits::KeepPackages ) );
+}
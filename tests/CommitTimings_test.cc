@@ -0,0 +1,95 @@
+#include "TestSetup.h"
+#include "CommitTimings.h"
+
+#include <fstream>
+
+#include <zypp/TmpPath.h>
+
+namespace
+{
+  std::vector<CommitEvents::Timing> timings()
+  {
+    return {
+      { "download", sat::Solvable(), "a", 1.5 },
+      { "install", sat::Solvable(), "a", 0.25 },
+      { "download", sat::Solvable(), "b", 3.0 },
+      { "script", sat::Solvable(), "%post", 2.0 },
+      { "install", sat::Solvable(), "b", 0.5 },
+    };
+  }
+}
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+  CommitTimings t( {}, 10 );
+  BOOST_CHECK( t.empty() );
+  BOOST_CHECK( t.slowest().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(phases)
+{
+  CommitTimings t( timings(), 10 );
+  BOOST_REQUIRE_EQUAL( t.phases().size(), 3U );
+  BOOST_CHECK_EQUAL( t.phases()[0]._phase, "download" );
+  BOOST_CHECK_EQUAL( t.phases()[0]._count, 2U );
+  BOOST_CHECK_EQUAL( t.phases()[0]._seconds, 4.5 );
+  BOOST_CHECK_EQUAL( t.phases()[1]._phase, "install" );
+  BOOST_CHECK_EQUAL( t.phases()[1]._seconds, 0.75 );
+  BOOST_CHECK_EQUAL( t.phases()[2]._phase, "script" );
+  BOOST_CHECK_EQUAL( t.phases()[2]._count, 1U );
+}
+
+BOOST_AUTO_TEST_CASE(slowest)
+{
+  CommitTimings t( timings(), 3 );
+  BOOST_REQUIRE_EQUAL( t.slowest().size(), 3U );
+  BOOST_CHECK_EQUAL( t.slowest()[0]._seconds, 3.0 );
+  BOOST_CHECK_EQUAL( t.slowest()[1]._seconds, 2.0 );
+  BOOST_CHECK_EQUAL( t.slowest()[2]._seconds, 1.5 );
+  BOOST_CHECK_EQUAL( CommitTimings::label( t.slowest()[1] ), "%post" );
+
+  CommitTimings all( timings(), 100 );
+  BOOST_CHECK_EQUAL( all.slowest().size(), 5U );
+}
+
+BOOST_AUTO_TEST_CASE(append)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "timings.jsonl" };
+  CommitTimings t( timings(), 2 );
+  t.appendTo( file );
+  t.appendTo( file );
+
+  std::ifstream in( file.c_str() );
+  std::string line;
+  unsigned lines = 0;
+  while ( std::getline( in, line ) )
+  {
+    ++lines;
+    BOOST_CHECK( str::startsWith( line, "{\"event\":\"commit-timings\",\"time\":" ) );
+    BOOST_CHECK( line.find( "\"phases\":[{\"phase\":\"download\",\"count\":2,\"seconds\":4.500}," ) != std::string::npos );
+    BOOST_CHECK( line.find( "\"slowest\":[{\"phase\":\"download\",\"item\":\"b\",\"seconds\":3.000},{\"phase\":\"script\",\"item\":\"%post\",\"seconds\":2.000}]" ) != std::string::npos );
+  }
+  BOOST_CHECK_EQUAL( lines, 2U );
+
+  BOOST_CHECK_THROW( t.appendTo( tmp.path() / "no" / "such" / "file" ), Exception );
+}
+
+BOOST_AUTO_TEST_CASE(record_per_commit)
+{
+  // each commit (e.g. of the shell or of --roots) starts with no timings
+  CommitEvents & events { CommitEvents::instance() };
+  events.recordTimings();
+  events.begin( "install", sat::Solvable(), ByteCount(), "a" );
+  events.end( "install", sat::Solvable(), true, ByteCount(), "a" );
+  events.begin( "script", sat::Solvable(), ByteCount(), "%post" );	// left open
+  BOOST_CHECK_EQUAL( events.timings().size(), 1U );
+
+  events.recordTimings();
+  BOOST_CHECK( events.timings().empty() );
+  BOOST_CHECK( ! events.active( "script", sat::Solvable(), "%post" ) );
+  events.begin( "install", sat::Solvable(), ByteCount(), "b" );
+  events.end( "install", sat::Solvable(), true, ByteCount(), "b" );
+  BOOST_REQUIRE_EQUAL( events.timings().size(), 1U );
+  BOOST_CHECK_EQUAL( events.timings()[0]._detail, "b" );
+}
@@ -0,0 +1,168 @@
+#include "TestSetup.h"
+#include "commands/locks/common.h"
+#include "commands/locks/matcher.h"
+
+#include <fstream>
+#include <set>
+#include <sstream>
+
+BOOST_AUTO_TEST_CASE(export_import_roundtrip)
+{
+  std::ostringstream out;
+  locks::writeArg( out, "foo", "" );
+  locks::writeArg( out, "bar >= 1.0", "keep\nthe old one" );
+  locks::writeArg( out, "pattern:baz", "why not" );
+  BOOST_CHECK_EQUAL( out.str(),
+                     "foo\n"
+                     "# comment: keep the old one\n"
+                     "bar >= 1.0\n"
+                     "# comment: why not\n"
+                     "pattern:baz\n" );
+
+  filesystem::TmpFile file;
+  std::ofstream( file.path().c_str() ) << out.str()
+                                       << "# a plain comment is ignored\n"
+                                       << "\n"
+                                       << "# comment: dangling, as the file ends\n";
+
+  // args already present (command line) get no comment from file
+  std::vector<std::string> args { "cmdline" };
+  std::vector<std::string> comments;
+  locks::readArgsFromFile( file.path(), args, &comments );
+  BOOST_CHECK( args == ( std::vector<std::string>{ "cmdline", "foo", "bar >= 1.0", "pattern:baz" } ) );
+  BOOST_CHECK( comments == ( std::vector<std::string>{ "", "", "keep the old one", "why not" } ) );
+
+  // without comments vector just the args
+  std::vector<std::string> plain;
+  locks::readArgsFromFile( file.path(), plain );
+  BOOST_CHECK( plain == ( std::vector<std::string>{ "foo", "bar >= 1.0", "pattern:baz" } ) );
+}
+
+BOOST_AUTO_TEST_CASE(comment_applies_to_next_spec_only)
+{
+  filesystem::TmpFile file;
+  std::ofstream( file.path().c_str() ) << "# comment: first\n"
+                                       << "# comment: second\n"
+                                       << "# plain\n"
+                                       << "a\n"
+                                       << "b\n";
+  std::vector<std::string> args;
+  std::vector<std::string> comments;
+  locks::readArgsFromFile( file.path(), args, &comments );
+  BOOST_CHECK( args == ( std::vector<std::string>{ "a", "b" } ) );
+  BOOST_CHECK( comments == ( std::vector<std::string>{ "second", "" } ) );
+}
+
+BOOST_AUTO_TEST_CASE(repo_restricted_roundtrip)
+{
+  std::ostringstream out;
+  locks::writeArg( out, "foo", "pinned", { "oss", "update" } );
+  locks::writeArg( out, "bar", "" );
+  BOOST_CHECK_EQUAL( out.str(),
+                     "# comment: pinned\n"
+                     "# repo: oss\n"
+                     "# repo: update\n"
+                     "foo\n"
+                     "bar\n" );
+
+  filesystem::TmpFile file;
+  std::ofstream( file.path().c_str() ) << out.str();
+
+  std::vector<std::string> args { "cmdline" };
+  std::vector<std::string> comments;
+  std::vector<std::vector<std::string>> repos;
+  locks::readArgsFromFile( file.path(), args, &comments, &repos );
+  BOOST_CHECK( args == ( std::vector<std::string>{ "cmdline", "foo", "bar" } ) );
+  BOOST_CHECK( comments == ( std::vector<std::string>{ "", "pinned", "" } ) );
+  BOOST_CHECK( repos == ( std::vector<std::vector<std::string>>{ {}, { "oss", "update" }, {} } ) );
+}
+
+BOOST_AUTO_TEST_CASE(query2arg_repo_restricted)
+{
+  PoolQuery q;
+  q.setMatchGlob();
+  q.setCaseSensitive();
+  q.addAttribute( sat::SolvAttr::name, "kernel-default" );
+  q.addKind( ResKind::package );
+  q.addRepo( "oss" );
+  // the repo is written as '# repo:' line by writeArg
+  BOOST_CHECK_EQUAL( locks::query2arg( q ), "kernel-default" );
+
+  q.addAttribute( sat::SolvAttr::name, "kernel-rt" );
+  BOOST_CHECK_EQUAL( locks::query2arg( q ), "" );
+}
+
+BOOST_AUTO_TEST_CASE(matcher_vs_poolquery)
+{
+  TestSetup test( Arch_x86_64 );
+  test.loadTargetRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_subset" );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_subset", "subset" );
+
+  auto lock = []( const std::string & name_r, const ResKind & kind_r = ResKind::package ) {
+    PoolQuery q;
+    q.setMatchGlob();
+    q.setCaseSensitive();
+    q.addAttribute( sat::SolvAttr::name, name_r );
+    q.addKind( kind_r );
+    return q;
+  };
+  std::vector<PoolQuery> queries;
+  queries.push_back( lock( "zypper" ) );			// exact
+  queries.push_back( lock( "yast2-*" ) );			// glob
+  {
+    PoolQuery q { lock( "glibc" ) };			// versioned
+    q.setEdition( Edition( "2.8.90-2.3" ), Rel::GT );
+    queries.push_back( q );
+  }
+  {
+    PoolQuery q { lock( "glibc*" ) };			// no release: any release
+    q.setEdition( Edition( "2.8.90" ), Rel::EQ );
+    queries.push_back( q );
+  }
+  queries.push_back( lock( "*", ResKind::pattern ) );	// kind-prefixed
+  {
+    PoolQuery q { lock( "YAST2-QT" ) };			// case-insensitive
+    q.setCaseSensitive( false );
+    queries.push_back( q );
+  }
+  {
+    PoolQuery q { lock( "Yast2-Q*" ) };
+    q.setCaseSensitive( false );
+    queries.push_back( q );
+  }
+  {
+    PoolQuery q { lock( "zypper" ) };			// repo-restricted
+    q.addRepo( "main" );
+    queries.push_back( q );
+  }
+  {
+    PoolQuery q { lock( "lib*" ) };
+    q.addRepo( "subset" );
+    queries.push_back( q );
+  }
+
+  Locks & locks { Locks::instance() };
+  BOOST_REQUIRE( locks.empty() );
+  for ( const PoolQuery & q : queries )
+    locks.addLock( q );
+  BOOST_REQUIRE_EQUAL( locks.size(), queries.size() );
+
+  locks::LockMatcher matcher { locks };
+  unsigned idx = 0;
+  for ( const PoolQuery & q : locks )
+  {
+    std::set<sat::Solvable> expected { q.begin(), q.end() };
+    const locks::LockMatcher::Matches & matches { matcher.matches( idx ) };
+    std::set<sat::Solvable> got { matches.begin(), matches.end() };
+    BOOST_TEST_CONTEXT( "lock " << idx << ": " << q )
+    {
+      BOOST_CHECK( ! expected.empty() );	// the test pool has some
+      BOOST_CHECK_EQUAL( got.size(), matches.size() );	// no duplicates
+      BOOST_CHECK( got == expected );
+    }
+    ++idx;
+  }
+  for ( const PoolQuery & q : queries )
+    locks.removeLock( q );
+}
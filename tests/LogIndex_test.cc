@@ -0,0 +1,132 @@
+#include "TestSetup.h"
+#include "LogIndex.h"
+
+#include <fstream>
+#include <list>
+#include <map>
+
+#include <zypp/TmpPath.h>
+
+namespace
+{
+  const char * run1 =
+    "2024-06-10 11:01:02 <1> host(2195) [zypper] main.cc(main):97 ===== Hi, me zypper 1.14.30\n"
+    "2024-06-10 11:01:02 <1> host(2195) [zypper] main.cc(main):98 ===== 'zypper' 'in' 'aspell' =====\n"
+    "2024-06-10 11:01:03 <1> host(2195) [zypp-curl] MediaCurl.cc(doGetFileCopyFile):1254 URL: http://dl/aspell.rpm\n"
+    "2024-06-10 11:01:03 <1> host(3000) [zypper] Zypper.cc(foo):1 other\n"
+    "2024-06-10 11:01:04 <1> host(2195) [zypper] Zypper.cc(bar):2 {T:7f00} last\n"
+    "continued\n";
+  const char * run2 =
+    "2024-06-11 09:00:00 <1> host(2703) [zypper] main.cc(main):97 ===== Hi, me zypper 1.14.31\n"
+    "2024-06-11 09:00:00 <1> host(2703) [zypper] main.cc(main):98 ===== 'zypper' 'lr' =====\n";
+
+  std::vector<std::string> linesOf( const LogIndex & index_r, const LogIndex::Run & run_r )
+  {
+    std::vector<std::string> ret;
+    index_r.forEachLine( run_r, [&ret]( const std::string & line_r ) { ret.push_back( line_r ); return true; } );
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lines)
+{
+  std::string line { "2024-06-10 11:01:04 <1> host(2195) [zypper] Zypper.cc(bar):2 {T:7f00} last" };
+  BOOST_CHECK_EQUAL( LogIndex::pidOf( line ), 2195U );
+  BOOST_CHECK_EQUAL( LogIndex::messageOf( line ), "last" );
+  BOOST_CHECK_EQUAL( LogIndex::pidOf( "continued" ), 0U );
+  BOOST_CHECK_EQUAL( LogIndex::downloadInfo( line ), "" );
+  BOOST_CHECK_EQUAL( LogIndex::downloadInfo( "2024-06-10 11:01:03 <1> host(2195) [zypp-curl] MediaCurl.cc(doGetFileCopyFile):1254 URL: http://dl/aspell.rpm" ),
+                     "URL: http://dl/aspell.rpm" );
+}
+
+BOOST_AUTO_TEST_CASE(runs)
+{
+  filesystem::TmpDir tmp;
+  Pathname log { tmp.path() / "zypper.log" };
+  Pathname indexDir { tmp.path() / "index" };
+  std::ofstream( log.c_str() ) << run1;
+
+  {
+    LogIndex index { log, indexDir };
+    BOOST_REQUIRE_EQUAL( index.runs().size(), 1U );
+    const LogIndex::Run & run { index.runs()[0] };
+    BOOST_CHECK_EQUAL( run._pid, 2195U );
+    BOOST_CHECK_EQUAL( run._time, "2024-06-10 11:01:02" );
+    BOOST_CHECK_EQUAL( run._version, "1.14.30" );
+    BOOST_CHECK_EQUAL( run._command, "zypper in aspell" );
+
+    std::vector<std::string> lines { linesOf( index, run ) };
+    BOOST_REQUIRE_EQUAL( lines.size(), 5U );	// not the line of PID 3000
+    BOOST_CHECK_EQUAL( lines[4], "continued" );
+  }
+
+  std::ofstream( log.c_str(), std::ios_base::app ) << run2;
+  {
+    LogIndex index { log, indexDir };	// continues the index
+    BOOST_REQUIRE_EQUAL( index.runs().size(), 2U );
+    BOOST_CHECK_EQUAL( index.runs()[0]._command, "zypper in aspell" );
+    BOOST_CHECK_EQUAL( index.runs()[1]._pid, 2703U );
+    BOOST_CHECK_EQUAL( index.runs()[1]._command, "zypper lr" );
+    BOOST_CHECK_EQUAL( linesOf( index, index.runs()[1] ).size(), 2U );
+  }
+
+  std::ofstream( log.c_str() ) << run2;	// replaced
+  {
+    LogIndex index { log, indexDir };
+    BOOST_REQUIRE_EQUAL( index.runs().size(), 1U );
+    BOOST_CHECK_EQUAL( index.runs()[0]._pid, 2703U );
+  }
+
+  filesystem::unlink( log );
+  LogIndex::prune( indexDir );
+  std::list<std::string> entries;
+  filesystem::readdir( entries, indexDir, /*dots*/false );
+  BOOST_CHECK( entries.empty() );
+
+  BOOST_CHECK_THROW( LogIndex { log }, Exception );
+}
+
+BOOST_AUTO_TEST_CASE(logFiles)
+{
+  filesystem::TmpDir tmp;
+  Pathname stem { tmp.path() / "zypper.log" };
+  for ( const char * name : { "zypper.log", "zypper.log-20240101.xz", "zypper.log-20240301.xz", "zypper.log-20240201.gz", "zypper.log-old" } )
+    std::ofstream( ( tmp.path() / name ).c_str() ) << "";
+
+  std::vector<Pathname> files { LogIndex::logFiles( stem, 2 ) };
+  BOOST_REQUIRE_EQUAL( files.size(), 3U );
+  BOOST_CHECK_EQUAL( files[0].basename(), "zypper.log-20240201.gz" );
+  BOOST_CHECK_EQUAL( files[1].basename(), "zypper.log-20240301.xz" );
+  BOOST_CHECK_EQUAL( files[2], stem );
+
+  BOOST_CHECK_EQUAL( LogIndex::logFiles( stem, 0 ).size(), 1U );
+}
+
+BOOST_AUTO_TEST_CASE(several_runs_one_pass)
+{
+  filesystem::TmpDir tmp;
+  Pathname log { tmp.path() / "zypper.log" };
+  std::ofstream( log.c_str() ) << run1 << run2;
+
+  LogIndex index { log };
+  BOOST_REQUIRE_EQUAL( index.runs().size(), 2U );
+  const LogIndex::Run & first { index.runs()[0] };
+  const LogIndex::Run & second { index.runs()[1] };
+
+  std::map<const LogIndex::Run *, std::vector<std::string>> lines;
+  index.forEachLine( { &first, &second }, [&]( const LogIndex::Run & run_r, const std::string & line_r ) {
+    lines[&run_r].push_back( line_r );
+    return true;
+  });
+  BOOST_CHECK( lines[&first] == linesOf( index, first ) );
+  BOOST_CHECK( lines[&second] == linesOf( index, second ) );
+
+  // stopping one run does not stop the others
+  lines.clear();
+  index.forEachLine( { &first, &second }, [&]( const LogIndex::Run & run_r, const std::string & line_r ) {
+    lines[&run_r].push_back( line_r );
+    return &run_r != &first;
+  });
+  BOOST_CHECK_EQUAL( lines[&first].size(), 1U );
+  BOOST_CHECK_EQUAL( lines[&second].size(), 2U );
+}
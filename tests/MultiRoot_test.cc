@@ -0,0 +1,101 @@
+#include "TestSetup.h"
+#include "MultiRoot.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+
+#include <zypp/TmpPath.h>
+
+BOOST_AUTO_TEST_CASE(readRoots)
+{
+  filesystem::TmpDir dir;
+  Pathname file { dir.path() / "roots" };
+  std::ofstream( file.c_str() ) << "# containers\n/srv/c1\n\n  /srv/c2  \n#/srv/c3\n";
+
+  std::vector<Pathname> roots { MultiRoot::readRoots( file ) };
+  BOOST_REQUIRE_EQUAL( roots.size(), 2U );
+  BOOST_CHECK_EQUAL( roots[0], Pathname("/srv/c1") );
+  BOOST_CHECK_EQUAL( roots[1], Pathname("/srv/c2") );
+
+  std::ofstream( file.c_str() ) << "/srv/c1\nsrv/c2\n";
+  BOOST_CHECK_THROW( MultiRoot::readRoots( file ), zypp::Exception );
+  BOOST_CHECK_THROW( MultiRoot::readRoots( dir.path() / "nonexistent" ), zypp::Exception );
+}
+
+BOOST_AUTO_TEST_CASE(run)
+{
+  filesystem::TmpDir dir;
+  std::vector<Pathname> roots { "/srv/c1", "/srv/c2", "/srv/c3" };
+  MultiRoot multiRoot { roots, 2, dir.path() };
+
+  unsigned done = 0;
+  std::vector<MultiRoot::Result> results { multiRoot.run(
+    []( const Pathname & root_r ) {
+      std::cout << "root " << root_r << std::endl;
+      return root_r == Pathname("/srv/c2") ? 104 : 0;
+    },
+    [&]( const MultiRoot::Result & result_r ) {
+      ++done;
+      std::ifstream captured( result_r._output.c_str() );
+      std::string line;
+      std::getline( captured, line );
+      BOOST_CHECK_EQUAL( line, "root " + result_r._root.asString() );
+    } ) };
+
+  BOOST_CHECK_EQUAL( done, 3U );
+  BOOST_REQUIRE_EQUAL( results.size(), 3U );
+  BOOST_CHECK_EQUAL( results[0]._root, roots[0] );
+  BOOST_CHECK_EQUAL( results[0]._exitCode, 0 );
+  BOOST_CHECK_EQUAL( results[1]._exitCode, 104 );
+  BOOST_CHECK_EQUAL( results[2]._exitCode, 0 );
+}
+
+BOOST_AUTO_TEST_CASE(cacheLock)
+{
+  filesystem::TmpDir dir;
+  Pathname busy { dir.path() / "busy" };
+  MultiRoot multiRoot { { "/srv/c1", "/srv/c2", "/srv/c3", "/srv/c4" }, 3 };
+  multiRoot.cacheLockFile( dir.path() / "lock" );
+
+  std::vector<MultiRoot::Result> results { multiRoot.run(
+    [&]( const Pathname & ) {
+      MultiRoot::CacheLock cacheLock;
+      int fd = ::open( busy.c_str(), O_WRONLY|O_CREAT|O_EXCL, 0600 );
+      if ( fd < 0 )
+        return 1;	// another child is inside the lock
+      ::close( fd );
+      ::usleep( 50000 );
+      filesystem::unlink( busy );
+      return 0;
+    } ) };
+
+  for ( const auto & result : results )
+    BOOST_CHECK_EQUAL( result._exitCode, 0 );
+
+  MultiRoot::CacheLock parentLock;	// no-op outside the children
+  BOOST_CHECK( ! PathInfo( dir.path() / "busy" ).isExist() );
+}
+
+BOOST_AUTO_TEST_CASE(claimRepoUrls)
+{
+  filesystem::TmpDir dir;
+  Pathname file { dir.path() / ".zypper-roots.repos" };
+
+  auto repo = []( const std::string & alias_r, const std::string & url_r ) {
+    RepoInfo ret;
+    ret.setAlias( alias_r );
+    ret.setBaseUrl( Url( url_r ) );
+    return ret;
+  };
+
+  BOOST_CHECK( MultiRoot::claimRepoUrls( file, { repo( "oss", "http://host/oss" ), repo( "upd", "http://host/upd" ) }, true ) );
+  BOOST_CHECK( MultiRoot::claimRepoUrls( file, { repo( "oss", "http://host/oss" ), repo( "extra", "http://root1/extra" ) } ) );
+  // same alias, other URL: must not share the caches, and records nothing
+  BOOST_CHECK( ! MultiRoot::claimRepoUrls( file, { repo( "new", "http://root2/new" ), repo( "oss", "http://root2/oss" ) } ) );
+  BOOST_CHECK( ! MultiRoot::claimRepoUrls( file, { repo( "extra", "http://root3/extra" ) } ) );
+  BOOST_CHECK( MultiRoot::claimRepoUrls( file, { repo( "new", "http://root4/new" ) } ) );
+  // the host's repos override whatever a root recorded
+  BOOST_CHECK( MultiRoot::claimRepoUrls( file, { repo( "extra", "http://host/extra" ) }, true ) );
+  BOOST_CHECK( ! MultiRoot::claimRepoUrls( file, { repo( "extra", "http://root1/extra" ) } ) );
+}
@@ -0,0 +1,467 @@
+#include "TestSetup.h"
+#include "output/OutJSON.h"
+
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <zypp/ResPoolProxy.h>
+#include <zypp/ZYppCommitResult.h>
+#include <zypp/ui/Selectable.h>
+
+#include "Summary.h"
+#include "CommitSummary.h"
+#include "update.h"
+#include "commands/locks/common.h"
+
+using namespace zypp;
+
+extern ZYpp::Ptr God;
+
+namespace
+{
+  /** Just enough of a JSON parser to check the lines we write. */
+  struct Json
+  {
+    enum Type { Null, Bool, Number, String, Array, Object };
+    Type _type = Null;
+    std::string _val;	///< Bool, Number and String
+    std::vector<Json> _array;
+    std::map<std::string,Json> _object;
+
+    bool has( const std::string & key_r ) const
+    { return _object.count( key_r ); }
+
+    const Json & operator[]( const std::string & key_r ) const
+    {
+      auto it { _object.find( key_r ) };
+      if ( it == _object.end() )
+        throw std::runtime_error( "JSON: no key " + key_r );
+      return it->second;
+    }
+
+    const std::string & str() const
+    { return _val; }
+  };
+
+  class JsonParser
+  {
+  public:
+    JsonParser( const std::string & text_r )
+    : _text { text_r }
+    {}
+
+    Json parse()
+    {
+      Json ret { value() };
+      skipWs();
+      if ( _pos != _text.size() )
+        fail( "trailing characters" );
+      return ret;
+    }
+
+  private:
+    [[noreturn]] void fail( const std::string & msg_r ) const
+    { throw std::runtime_error( "JSON: " + msg_r + " at " + std::to_string( _pos ) + " in " + _text ); }
+
+    void skipWs()
+    { while ( _pos < _text.size() && ::strchr( " \t\r\n", _text[_pos] ) ) ++_pos; }
+
+    char peek()
+    { skipWs(); if ( _pos == _text.size() ) fail( "unexpected end" ); return _text[_pos]; }
+
+    void expect( char ch_r )
+    { if ( peek() != ch_r ) fail( std::string( "expected " ) + ch_r ); ++_pos; }
+
+    bool literal( const char * lit_r )
+    {
+      if ( _text.compare( _pos, ::strlen( lit_r ), lit_r ) != 0 )
+        return false;
+      _pos += ::strlen( lit_r );
+      return true;
+    }
+
+    Json value()
+    {
+      Json ret;
+      char ch { peek() };
+      if ( ch == '{' )
+      {
+        ret._type = Json::Object;
+        ++_pos;
+        if ( peek() == '}' )
+        { ++_pos; return ret; }
+        while ( true )
+        {
+          std::string key { string() };
+          expect( ':' );
+          ret._object[key] = value();
+          if ( peek() != ',' )
+            break;
+          ++_pos;
+        }
+        expect( '}' );
+      }
+      else if ( ch == '[' )
+      {
+        ret._type = Json::Array;
+        ++_pos;
+        if ( peek() == ']' )
+        { ++_pos; return ret; }
+        while ( true )
+        {
+          ret._array.push_back( value() );
+          if ( peek() != ',' )
+            break;
+          ++_pos;
+        }
+        expect( ']' );
+      }
+      else if ( ch == '"' )
+      {
+        ret._type = Json::String;
+        ret._val = string();
+      }
+      else if ( literal( "true" ) )
+      {
+        ret._type = Json::Bool;
+        ret._val = "true";
+      }
+      else if ( literal( "false" ) )
+      {
+        ret._type = Json::Bool;
+        ret._val = "false";
+      }
+      else if ( literal( "null" ) )
+      {}
+      else
+      {
+        std::string::size_type end { _text.find_first_not_of( "-+.eE0123456789", _pos ) };
+        if ( end == _pos )
+          fail( "unexpected character" );
+        ret._type = Json::Number;
+        ret._val = _text.substr( _pos, end - _pos );
+        _pos = end;
+      }
+      return ret;
+    }
+
+    std::string string()
+    {
+      expect( '"' );
+      std::string ret;
+      while ( true )
+      {
+        if ( _pos == _text.size() )
+          fail( "unterminated string" );
+        char ch { _text[_pos++] };
+        if ( ch == '"' )
+          break;
+        if ( (unsigned char)ch < 0x20 )
+          fail( "control character in string" );
+        if ( ch != '\\' )
+        { ret += ch; continue; }
+        if ( _pos == _text.size() )
+          fail( "unterminated escape" );
+        switch ( char esc = _text[_pos++] )
+        {
+          case '"': case '\\': case '/': ret += esc; break;
+          case 'b': ret += '\b'; break;
+          case 'f': ret += '\f'; break;
+          case 'n': ret += '\n'; break;
+          case 'r': ret += '\r'; break;
+          case 't': ret += '\t'; break;
+          case 'u':
+            if ( _pos + 4 > _text.size() )
+              fail( "short \\u escape" );
+            ret += char( std::stoi( _text.substr( _pos, 4 ), nullptr, 16 ) );	// we only escape control characters
+            _pos += 4;
+            break;
+          default:
+            fail( "bad escape" );
+        }
+      }
+      return ret;
+    }
+
+  private:
+    const std::string & _text;
+    std::string::size_type _pos = 0;
+  };
+
+  /** Parse the JSON Lines in \a text_r; every line must be a JSON object. */
+  std::vector<Json> parseLines( const std::string & text_r )
+  {
+    std::vector<Json> ret;
+    std::istringstream str { text_r };
+    for ( std::string line; std::getline( str, line ); )
+    {
+      ret.push_back( JsonParser( line ).parse() );
+      if ( ret.back()._type != Json::Object )
+        throw std::runtime_error( "JSON: not an object: " + line );
+    }
+    return ret;
+  }
+
+  /** The lines of \a lines_r for \a event_r. */
+  std::vector<Json> byEvent( const std::vector<Json> & lines_r, const std::string & event_r )
+  {
+    std::vector<Json> ret;
+    for ( const Json & line : lines_r )
+      if ( line["event"].str() == event_r )
+        ret.push_back( line );
+    return ret;
+  }
+
+  /** Lines written to \c cout while in scope. */
+  struct CaptureCout
+  {
+    CaptureCout()
+    : _buf { std::cout.rdbuf( _str.rdbuf() ) }
+    {}
+    ~CaptureCout()
+    { std::cout.rdbuf( _buf ); }
+
+    std::string str() const
+    { return _str.str(); }
+
+  private:
+    std::ostringstream _str;
+    std::streambuf * _buf;
+  };
+
+  /** An rpm-md repo in \a dir_r providing \a pkgs_r (name, version, summary). */
+  void mkRepo( const Pathname & dir_r, const std::vector<std::vector<std::string>> & pkgs_r )
+  {
+    filesystem::assert_dir( dir_r / "repodata" );
+    std::ofstream( ( dir_r / "repodata/repomd.xml" ).c_str() )
+      << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<repomd xmlns=\"http://linux.duke.edu/metadata/repo\">\n"
+      << "  <data type=\"primary\"><location href=\"repodata/primary.xml\"/></data>\n"
+      << "</repomd>\n";
+    std::ofstream primary( ( dir_r / "repodata/primary.xml" ).c_str() );
+    primary << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<metadata xmlns=\"http://linux.duke.edu/metadata/common\" xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\" packages=\"" << pkgs_r.size() << "\">\n";
+    for ( const auto & pkg : pkgs_r )
+    {
+      primary << "<package type=\"rpm\">\n"
+              << "  <name>" << pkg[0] << "</name><arch>noarch</arch><version epoch=\"0\" ver=\"" << pkg[1] << "\" rel=\"1\"/>\n"
+              << "  <summary>" << xml::escape( pkg[2] ) << "</summary>\n"
+              << "  <location href=\"noarch/" << pkg[0] << "-" << pkg[1] << "-1.noarch.rpm\"/>\n"
+              << "</package>\n";
+    }
+    primary << "</metadata>\n";
+  }
+
+  /** Install foo (an update) and bar while in scope. */
+  struct InstallFooBar
+  {
+    InstallFooBar()
+    {
+      ResPool pool { ResPool::instance() };
+      pool.proxy().saveState();
+      BOOST_REQUIRE( ui::Selectable::get( "foo" )->setToInstall( ResStatus::USER ) );
+      BOOST_REQUIRE( ui::Selectable::get( "bar" )->setToInstall( ResStatus::USER ) );
+      BOOST_REQUIRE( God->resolver()->resolvePool() );
+    }
+    ~InstallFooBar()
+    {
+      ResPool::instance().proxy().restoreState();
+      God->resolver()->resolvePool();
+    }
+  };
+}
+
+struct TestInit {
+  TestInit()
+    : testSetup( std::make_unique<TestSetup>( Arch_x86_64 ) )
+  {
+    mkRepo( repoDir.path() / "system", { { "foo", "0.9", "foo" } } );
+    mkRepo( repoDir.path() / "json", { { "foo", "1.0", "foo" }, { "bar", "1.0", "bar \"quoted\"\ttabbed" } } );
+    testSetup->loadTargetRepo( repoDir.path() / "system" );
+    testSetup->loadRepo( repoDir.path() / "json", "json" );
+    testSetup->zypper().setOutputWriter( new OutJSON( Out::NORMAL ) );
+    God = getZYpp();
+  }
+
+  filesystem::TmpDir repoDir;
+  std::unique_ptr<TestSetup> testSetup;
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+BOOST_AUTO_TEST_CASE(escape)
+{
+  BOOST_CHECK_EQUAL( OutJSON::escape( "plain" ), "plain" );
+  BOOST_CHECK_EQUAL( OutJSON::escape( "a \"b\" \\c" ), "a \\\"b\\\" \\\\c" );
+  BOOST_CHECK_EQUAL( OutJSON::escape( "line\nnext\ttab" ), "line\\nnext\\ttab" );
+  BOOST_CHECK_EQUAL( OutJSON::escape( std::string( "\x01" ) ), "\\u0001" );
+  BOOST_CHECK_EQUAL( OutJSON::escape( "Grüße" ), "Grüße" );	// UTF-8 passed through
+}
+
+BOOST_AUTO_TEST_CASE(line)
+{
+  std::ostringstream str;
+  {
+    OutJSON::Line line( str, "update" );
+    line.add( "name", "glibc" ).add( "size", 42 ).add( "blocked", false ).addOptional( "summary", "" );
+    BOOST_CHECK( str.str().empty() );	// written when complete
+  }
+  OutJSON::Line( str, "message" ).add( "text", "two\nlines" ).addRaw( "options", "[]" );
+
+  BOOST_CHECK_EQUAL( str.str(),
+                     "{\"event\":\"update\",\"name\":\"glibc\",\"size\":42,\"blocked\":false}\n"
+                     "{\"event\":\"message\",\"text\":\"two\\nlines\",\"options\":[]}\n" );
+}
+
+BOOST_AUTO_TEST_CASE(json_summary)
+{
+  InstallFooBar trans;
+  Summary summary( ResPool::instance(), SummaryHints(), Summary::DEFAULT );
+  std::ostringstream str;
+  summary.dumpAsJsonTo( str );
+
+  std::vector<Json> lines;
+  BOOST_REQUIRE_NO_THROW( lines = parseLines( str.str() ) );
+  BOOST_REQUIRE( ! lines.empty() );
+
+  const Json & head { lines.front() };
+  BOOST_CHECK_EQUAL( head["event"].str(), "install-summary" );
+  for ( const char * key : { "download-size", "space-usage-diff", "space-usage-installed", "space-usage-removed", "packages-to-change" } )
+    BOOST_CHECK_EQUAL( head[key]._type, Json::Number );
+  for ( const char * key : { "need-restart", "need-reboot" } )
+    BOOST_CHECK_EQUAL( head[key]._type, Json::Bool );
+
+  std::map<std::string,Json> items;
+  for ( const Json & item : byEvent( lines, "summary-item" ) )
+    items[item["name"].str()] = item;
+  BOOST_REQUIRE_EQUAL( items.size(), 2U );
+
+  const Json & foo { items["foo"] };
+  BOOST_CHECK_EQUAL( foo["list"].str(), "to-upgrade" );
+  BOOST_CHECK_EQUAL( foo["kind"].str(), "package" );
+  BOOST_CHECK_EQUAL( foo["edition"].str(), "1.0-1" );
+  BOOST_CHECK_EQUAL( foo["arch"].str(), "noarch" );
+  BOOST_CHECK_EQUAL( foo["repository"].str(), "json" );
+  BOOST_CHECK_EQUAL( foo["edition-old"].str(), "0.9-1" );
+  BOOST_CHECK_EQUAL( foo["arch-old"].str(), "noarch" );
+
+  const Json & bar { items["bar"] };
+  BOOST_CHECK_EQUAL( bar["list"].str(), "to-install" );
+  BOOST_CHECK( ! bar.has( "edition-old" ) );
+  BOOST_CHECK_EQUAL( bar["summary"].str(), "bar \"quoted\"\ttabbed" );
+}
+
+BOOST_AUTO_TEST_CASE(json_commit_summary)
+{
+  InstallFooBar trans;
+  ZYppCommitResult result( "/" );
+  result.rTransaction() = sat::Transaction( sat::Transaction::loadFromPool );
+  for ( const sat::Transaction::Step & step : result.transaction() )
+  {
+    if ( step.stepType() == sat::Transaction::TRANSACTION_IGNORE )
+      continue;
+    result.rTransactionStepList().push_back( step );
+    if ( step.stepType() != sat::Transaction::TRANSACTION_ERASE && step.satSolvable().name() == "foo" )
+      result.rTransactionStepList().back().stepStage( sat::Transaction::STEP_ERROR );
+  }
+
+  CommitSummary summary( result );
+  std::ostringstream str;
+  summary.dumpAsJsonTo( str );
+
+  std::vector<Json> lines;
+  BOOST_REQUIRE_NO_THROW( lines = parseLines( str.str() ) );
+  BOOST_REQUIRE( ! lines.empty() );
+
+  const Json & head { lines.front() };
+  BOOST_CHECK_EQUAL( head["event"].str(), "commit-summary" );
+  for ( const char * key : { "failed-installs", "skipped-installs", "failed-removals", "skipped-removals" } )
+    BOOST_CHECK_EQUAL( head[key]._type, Json::Number );
+  BOOST_CHECK_EQUAL( head["failed-installs"].str(), "1" );
+  BOOST_CHECK_EQUAL( head["skipped-installs"].str(), "1" );
+
+  std::map<std::string,Json> items;
+  for ( const Json & item : byEvent( lines, "commit-item" ) )
+  {
+    for ( const char * key : { "list", "kind", "name", "edition", "arch", "repository" } )
+      BOOST_CHECK_EQUAL( item[key]._type, Json::String );
+    if ( item["list"].str() != "skipped-removals" )
+      items[item["name"].str()] = item;
+  }
+  BOOST_REQUIRE_EQUAL( items.size(), 2U );
+  BOOST_CHECK_EQUAL( items["foo"]["list"].str(), "failed-installs" );
+  BOOST_CHECK_EQUAL( items["foo"]["repository"].str(), "json" );
+  BOOST_CHECK_EQUAL( items["bar"]["list"].str(), "skipped-installs" );
+  BOOST_CHECK_EQUAL( items["bar"]["summary"].str(), "bar \"quoted\"\ttabbed" );
+}
+
+BOOST_AUTO_TEST_CASE(json_list_updates)
+{
+  CaptureCout capture;
+  ::list_updates( Zypper::instance(), { ResKind::package }, false, false );
+
+  std::vector<Json> lines;
+  BOOST_REQUIRE_NO_THROW( lines = parseLines( capture.str() ) );
+  std::vector<Json> updates { byEvent( lines, "update" ) };
+  BOOST_REQUIRE_EQUAL( updates.size(), 1U );
+
+  const Json & foo { updates.front() };
+  BOOST_CHECK_EQUAL( foo["kind"].str(), "package" );
+  BOOST_CHECK_EQUAL( foo["name"].str(), "foo" );
+  BOOST_CHECK_EQUAL( foo["edition"].str(), "1.0-1" );
+  BOOST_CHECK_EQUAL( foo["arch"].str(), "noarch" );
+  BOOST_CHECK_EQUAL( foo["edition-old"].str(), "0.9-1" );
+  BOOST_CHECK( ! foo.has( "arch-old" ) );
+  BOOST_CHECK_EQUAL( foo["summary"].str(), "foo" );
+  BOOST_CHECK_EQUAL( foo["repository"].str(), "json" );
+}
+
+BOOST_AUTO_TEST_CASE(json_locks_changed)
+{
+  PoolQuery q;
+  q.addAttribute( sat::SolvAttr::name, "foo" );
+  q.setMatchExact();
+  q.addKind( ResKind::package );
+  q.addRepo( "json" );
+  q.setEdition( Edition( "1.0" ), Rel::GE );
+  const locks::LockSnapshot none;
+  const locks::LockSnapshot some { { locks::lockKey( q ), q } };
+
+  auto report = []( const locks::LockSnapshot & before_r, const locks::LockSnapshot & after_r ) {
+    CaptureCout capture;
+    locks::reportChanges( Zypper::instance(), before_r, after_r );
+    std::vector<Json> lines;
+    BOOST_REQUIRE_NO_THROW( lines = parseLines( capture.str() ) );
+    BOOST_REQUIRE_EQUAL( lines.size(), 1U );
+    BOOST_CHECK_EQUAL( lines.front()["event"].str(), "locks-changed" );
+    return lines.front();
+  };
+
+  {
+    Json changed { report( none, some ) };
+    BOOST_CHECK_EQUAL( changed["added"].str(), "1" );
+    BOOST_CHECK_EQUAL( changed["removed"].str(), "0" );
+    BOOST_REQUIRE_EQUAL( changed["locks"]._array.size(), 1U );
+
+    const Json & lock { changed["locks"]._array.front() };
+    BOOST_CHECK_EQUAL( lock["action"].str(), "added" );
+    BOOST_REQUIRE_EQUAL( lock["names"]._array.size(), 1U );
+    BOOST_CHECK_EQUAL( lock["names"]._array.front().str(), "foo" );
+    BOOST_REQUIRE_EQUAL( lock["types"]._array.size(), 1U );
+    BOOST_CHECK_EQUAL( lock["types"]._array.front().str(), "package" );
+    BOOST_REQUIRE_EQUAL( lock["repos"]._array.size(), 1U );
+    BOOST_CHECK_EQUAL( lock["repos"]._array.front().str(), "json" );
+    BOOST_CHECK_EQUAL( lock["range"]["flag"].str(), ">=" );
+    BOOST_CHECK_EQUAL( lock["range"]["edition"].str(), "1.0" );
+  }
+  {
+    Json changed { report( some, none ) };
+    BOOST_CHECK_EQUAL( changed["added"].str(), "0" );
+    BOOST_CHECK_EQUAL( changed["removed"].str(), "1" );
+    BOOST_REQUIRE_EQUAL( changed["locks"]._array.size(), 1U );
+    BOOST_CHECK_EQUAL( changed["locks"]._array.front()["action"].str(), "removed" );
+  }
+}
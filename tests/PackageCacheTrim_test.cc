@@ -0,0 +1,120 @@
+#include "TestSetup.h"
+#include "PackageCacheTrim.h"
+
+#include <sys/time.h>
+#include <fstream>
+
+#include <zypp/TmpPath.h>
+
+namespace
+{
+  constexpr time_t now = 1700000000;
+  constexpr time_t day = 24 * 60 * 60;
+
+  /** Create \a file_r with \a size_r bytes, last used \a daysAgo_r days ago. */
+  void mkFile( const Pathname & file_r, unsigned size_r, unsigned daysAgo_r )
+  {
+    filesystem::assert_dir( file_r.dirname() );
+    std::ofstream( file_r.c_str() ) << std::string( size_r, 'x' );
+    struct timeval times[2];
+    times[0].tv_sec = times[1].tv_sec = now - daysAgo_r * day;
+    times[0].tv_usec = times[1].tv_usec = 0;
+    ::utimes( file_r.c_str(), times );
+  }
+
+  /** A cache with 4 rpms (1K each, 40..10 days old) and a non rpm file. */
+  struct Cache
+  {
+    Cache()
+    {
+      mkFile( _dir.path() / "repoA/x86_64/a-1-1.x86_64.rpm", 1024, 40 );
+      mkFile( _dir.path() / "repoA/x86_64/b-1-1.x86_64.rpm", 1024, 30 );
+      mkFile( _dir.path() / "repoB/noarch/c-1-1.noarch.rpm", 1024, 20 );
+      mkFile( _dir.path() / "repoB/noarch/d-1-1.noarch.rpm", 1024, 10 );
+      mkFile( _dir.path() / "repoB/repodata/repomd.xml", 4096, 50 );
+    }
+
+    PackageCacheTrim trim( ByteCount maxSize_r, unsigned maxAgeDays_r ) const
+    {
+      PackageCacheTrim ret( maxSize_r, maxAgeDays_r );
+      ret.setNow( now );
+      ret.addCacheDir( _dir.path() / "repoA" );
+      ret.addCacheDir( _dir.path() / "repoB" );
+      return ret;
+    }
+
+    bool exists( const std::string & file_r ) const
+    { return PathInfo( _dir.path() / file_r ).isExist(); }
+
+    filesystem::TmpDir _dir;
+  };
+} // namespace
+
+BOOST_AUTO_TEST_CASE(parse_size)
+{
+  ByteCount size;
+  BOOST_CHECK( PackageCacheTrim::parseSize( "1024", size ) );
+  BOOST_CHECK_EQUAL( (long long)size, 1024 );
+  BOOST_CHECK( PackageCacheTrim::parseSize( " 2G", size ) );
+  BOOST_CHECK_EQUAL( (long long)size, 2LL * 1024 * 1024 * 1024 );
+  BOOST_CHECK( PackageCacheTrim::parseSize( "500m", size ) );
+  BOOST_CHECK_EQUAL( (long long)size, 500LL * 1024 * 1024 );
+
+  BOOST_CHECK( ! PackageCacheTrim::parseSize( "", size ) );
+  BOOST_CHECK( ! PackageCacheTrim::parseSize( "G", size ) );
+  BOOST_CHECK( ! PackageCacheTrim::parseSize( "-1", size ) );
+  BOOST_CHECK( ! PackageCacheTrim::parseSize( "1.5G", size ) );
+  BOOST_CHECK( ! PackageCacheTrim::parseSize( "2X", size ) );
+}
+
+BOOST_AUTO_TEST_CASE(no_limits)
+{
+  Cache cache;
+  PackageCacheTrim::Result result { cache.trim( 0, 0 ).run() };
+  BOOST_CHECK_EQUAL( result._files, 4U );
+  BOOST_CHECK_EQUAL( (long long)result._size, 4096 );
+  BOOST_CHECK_EQUAL( result._removed, 0U );
+}
+
+BOOST_AUTO_TEST_CASE(max_size_lru)
+{
+  Cache cache;
+  PackageCacheTrim::Result result { cache.trim( 2048, 0 ).run() };
+  BOOST_CHECK_EQUAL( result._removed, 2U );
+  BOOST_CHECK_EQUAL( (long long)result._freed, 2048 );
+  BOOST_CHECK( ! cache.exists( "repoA/x86_64/a-1-1.x86_64.rpm" ) );
+  BOOST_CHECK( ! cache.exists( "repoA/x86_64/b-1-1.x86_64.rpm" ) );
+  BOOST_CHECK( cache.exists( "repoB/noarch/c-1-1.noarch.rpm" ) );
+  BOOST_CHECK( cache.exists( "repoB/noarch/d-1-1.noarch.rpm" ) );
+  BOOST_CHECK( cache.exists( "repoB/repodata/repomd.xml" ) );
+}
+
+BOOST_AUTO_TEST_CASE(max_size_keeps_installed)
+{
+  Cache cache;
+  PackageCacheTrim trim { cache.trim( 2048, 0 ) };
+  trim.keep( "a-1-1.x86_64.rpm" );
+  PackageCacheTrim::Result result { trim.run() };
+  BOOST_CHECK_EQUAL( result._removed, 2U );
+  BOOST_CHECK( cache.exists( "repoA/x86_64/a-1-1.x86_64.rpm" ) );	// kept, but counts
+  BOOST_CHECK( ! cache.exists( "repoA/x86_64/b-1-1.x86_64.rpm" ) );
+  BOOST_CHECK( ! cache.exists( "repoB/noarch/c-1-1.noarch.rpm" ) );
+  BOOST_CHECK( cache.exists( "repoB/noarch/d-1-1.noarch.rpm" ) );
+}
+
+BOOST_AUTO_TEST_CASE(max_age)
+{
+  Cache cache;
+  PackageCacheTrim::Result result { cache.trim( 0, 25 ).run() };
+  BOOST_CHECK_EQUAL( result._removed, 2U );
+  BOOST_CHECK( cache.exists( "repoB/noarch/c-1-1.noarch.rpm" ) );
+  BOOST_CHECK( ! cache.exists( "repoA/x86_64/b-1-1.x86_64.rpm" ) );
+}
+
+BOOST_AUTO_TEST_CASE(dry_run)
+{
+  Cache cache;
+  PackageCacheTrim::Result result { cache.trim( 1, 0 ).run( /*dryRun*/true ) };
+  BOOST_CHECK_EQUAL( result._removed, 4U );
+  BOOST_CHECK( cache.exists( "repoA/x86_64/a-1-1.x86_64.rpm" ) );
+}
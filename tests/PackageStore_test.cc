@@ -0,0 +1,138 @@
+#include "TestSetup.h"
+#include "PackageStore.h"
+
+#include <fstream>
+
+#include <zypp/TmpPath.h>
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+  PackageStore store { Pathname() };
+  BOOST_CHECK( ! store.enabled() );
+  BOOST_CHECK_EQUAL( store.prune(), 0U );
+}
+
+BOOST_AUTO_TEST_CASE(prune)
+{
+  filesystem::TmpDir root;
+  Pathname storeDir { root.path() / "store" };
+  Pathname cacheDir { root.path() / "cache" };
+  filesystem::assert_dir( storeDir / "sha256/ab" );
+  filesystem::assert_dir( cacheDir );
+
+  Pathname used { storeDir / "sha256/ab/ab01" };
+  Pathname unused { storeDir / "sha256/ab/ab02" };
+  std::ofstream( used.c_str() ) << "used";
+  std::ofstream( unused.c_str() ) << "unused";
+  BOOST_REQUIRE_EQUAL( filesystem::hardlink( used, cacheDir / "foo-1-1.noarch.rpm" ), 0 );
+
+  PackageStore store { storeDir };
+  BOOST_CHECK( store.enabled() );
+  BOOST_CHECK_EQUAL( store.prune(), 1U );
+  BOOST_CHECK( PathInfo( used ).isFile() );
+  BOOST_CHECK( ! PathInfo( unused ).isExist() );
+  BOOST_CHECK( PathInfo( cacheDir / "foo-1-1.noarch.rpm" ).isFile() );
+}
+
+namespace
+{
+  const std::string rpmContent { "not really foo-1.0-1.noarch.rpm" };
+
+  /** An rpm-md repo in \a dir_r providing foo-1.0-1.noarch with the checksum of \ref rpmContent. */
+  void mkRepo( const Pathname & dir_r, const std::string & sha256_r )
+  {
+    filesystem::assert_dir( dir_r / "repodata" );
+    std::ofstream( ( dir_r / "repodata/repomd.xml" ).c_str() )
+      << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<repomd xmlns=\"http://linux.duke.edu/metadata/repo\">\n"
+      << "  <data type=\"primary\"><location href=\"repodata/primary.xml\"/></data>\n"
+      << "</repomd>\n";
+    std::ofstream( ( dir_r / "repodata/primary.xml" ).c_str() )
+      << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<metadata xmlns=\"http://linux.duke.edu/metadata/common\" xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\" packages=\"1\">\n"
+      << "<package type=\"rpm\">\n"
+      << "  <name>foo</name><arch>noarch</arch><version epoch=\"0\" ver=\"1.0\" rel=\"1\"/>\n"
+      << "  <checksum type=\"sha256\" pkgid=\"YES\">" << sha256_r << "</checksum>\n"
+      << "  <summary>foo</summary>\n"
+      << "  <location href=\"noarch/foo-1.0-1.noarch.rpm\"/>\n"
+      << "</package>\n"
+      << "</metadata>\n";
+  }
+
+  /** Load the repo in \a dir_r as \a alias_r, caching its packages below \a packages_r. */
+  sat::Solvable loadFoo( TestSetup & test_r, const Pathname & dir_r, const std::string & alias_r, const Pathname & packages_r, bool keepPackages_r = true )
+  {
+    RepoInfo repo;
+    repo.setAlias( alias_r );
+    repo.addBaseUrl( dir_r.asUrl() );
+    repo.setGpgCheck( false );
+    repo.setKeepPackages( keepPackages_r );
+    repo.setPackagesPath( packages_r / alias_r );
+    test_r.loadRepo( repo );
+    for ( const sat::Solvable & solv : sat::Pool::instance().reposFind( alias_r ).solvables() )
+      return solv;
+    return sat::Solvable();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(remember_provide)
+{
+  filesystem::TmpDir root;
+  Pathname rpm { root.path() / "foo.rpm" };
+  std::ofstream( rpm.c_str() ) << rpmContent;
+  std::string sha256 { filesystem::checksum( rpm, "sha256" ) };
+  for ( const char * repo : { "a", "b", "nokeep" } )
+    mkRepo( root.path() / repo, sha256 );
+
+  TestSetup test( Arch_x86_64 );
+  Pathname packages { root.path() / "packages" };
+  sat::Solvable fooA { loadFoo( test, root.path() / "a", "a", packages ) };
+  sat::Solvable fooB { loadFoo( test, root.path() / "b", "b", packages ) };
+  sat::Solvable fooNokeep { loadFoo( test, root.path() / "nokeep", "nokeep", packages, false ) };
+  BOOST_REQUIRE( fooA && fooB && fooNokeep );
+
+  PackageStore store { root.path() / "store" };
+  BOOST_CHECK( ! store.provide( fooA ) );	// nothing stored yet
+
+  // downloaded via repo a
+  Pathname cachedA { PackageStore::cacheLocation( fooA ) };
+  BOOST_CHECK_EQUAL( cachedA, packages / "a/noarch/foo-1.0-1.noarch.rpm" );
+  filesystem::assert_dir( cachedA.dirname() );
+  BOOST_REQUIRE_EQUAL( filesystem::hardlink( rpm, cachedA ), 0 );
+  store.remember( fooA );
+
+  // installed via repo b: taken from the store
+  BOOST_CHECK( store.provide( fooB ) );
+  Pathname cachedB { PackageStore::cacheLocation( fooB ) };
+  BOOST_CHECK_EQUAL( PathInfo( cachedB ).ino(), PathInfo( cachedA ).ino() );
+
+  // not for repos which don't keep their packages
+  BOOST_CHECK( ! store.provide( fooNokeep ) );
+  BOOST_CHECK( ! PathInfo( PackageStore::cacheLocation( fooNokeep ) ).isExist() );
+}
+
+BOOST_AUTO_TEST_CASE(provide_checksum_mismatch)
+{
+  filesystem::TmpDir root;
+  Pathname rpm { root.path() / "foo.rpm" };
+  std::ofstream( rpm.c_str() ) << rpmContent;
+  std::string sha256 { filesystem::checksum( rpm, "sha256" ) };
+  for ( const char * repo : { "a", "b" } )
+    mkRepo( root.path() / repo, sha256 );
+
+  TestSetup test( Arch_x86_64 );
+  Pathname packages { root.path() / "packages" };
+  sat::Solvable fooA { loadFoo( test, root.path() / "a", "a", packages ) };
+  sat::Solvable fooB { loadFoo( test, root.path() / "b", "b", packages ) };
+  BOOST_REQUIRE( fooA && fooB );
+
+  // a corrupt download in the cache of repo a
+  Pathname cachedA { PackageStore::cacheLocation( fooA ) };
+  filesystem::assert_dir( cachedA.dirname() );
+  std::ofstream( cachedA.c_str() ) << "corrupt";
+  PackageStore store { root.path() / "store" };
+  store.remember( fooA );
+
+  BOOST_CHECK( ! store.provide( fooB ) );
+  BOOST_CHECK( ! PathInfo( PackageStore::cacheLocation( fooB ) ).isExist() );
+}
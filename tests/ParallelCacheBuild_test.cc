@@ -0,0 +1,117 @@
+#include "TestSetup.h"
+#include "ParallelCacheBuild.h"
+
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sstream>
+
+namespace
+{
+  RepoInfo repo( const std::string & alias_r )
+  {
+    RepoInfo ret;
+    ret.setAlias( alias_r );
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(output_order)
+{
+  ParallelCacheBuild build { 3, []( const RepoInfo & repo_r ) {
+    if ( repo_r.alias() == "a" )
+      ::usleep( 200000 );	// finishes last, but is reported first
+    std::cout << "building " << repo_r.alias() << std::endl;
+    std::cerr << "error in " << repo_r.alias() << std::endl;
+    std::cout << "built " << repo_r.alias() << std::endl;
+    return false;
+  } };
+  for ( const char * alias : { "a", "b", "c" } )
+    build.add( repo( alias ) );
+
+  std::ostringstream out;
+  std::ostringstream err;
+  std::vector<std::string> done;
+  build.run( [&]( const RepoInfo & repo_r, bool error_r ) {
+    BOOST_CHECK( ! error_r );
+    done.push_back( repo_r.alias() );
+    // the output of a repo is replayed before it's reported done
+    BOOST_CHECK( out.str().find( "built " + repo_r.alias() ) != std::string::npos );
+    BOOST_CHECK( err.str().find( "error in " + repo_r.alias() ) != std::string::npos );
+  }, out, err );
+
+  BOOST_CHECK( done == ( std::vector<std::string>{ "a", "b", "c" } ) );
+  // stdout and stderr are replayed on their own stream
+  BOOST_CHECK_EQUAL( out.str(),
+                     "building a\nbuilt a\n"
+                     "building b\nbuilt b\n"
+                     "building c\nbuilt c\n" );
+  BOOST_CHECK_EQUAL( err.str(),
+                     "error in a\n"
+                     "error in b\n"
+                     "error in c\n" );
+}
+
+BOOST_AUTO_TEST_CASE(errors)
+{
+  for ( unsigned jobs : { 1U, 4U } )
+  {
+    ParallelCacheBuild build { jobs, []( const RepoInfo & repo_r ) {
+      if ( repo_r.alias() == "failed" )
+        return true;
+      if ( repo_r.alias() == "throws" )
+        ZYPP_THROW( Exception( "oops" ) );
+      if ( repo_r.alias() == "killed" )
+        ::raise( SIGKILL );
+      return false;
+    } };
+    for ( const char * alias : { "ok1", "failed", "throws", "killed", "ok2" } )
+      build.add( repo( alias ) );
+
+    // refresh counts the errors to compute the exit code
+    std::ostringstream out;
+    std::ostringstream err;
+    std::vector<std::pair<std::string,bool>> done;
+    unsigned errors = 0;
+    build.run( [&]( const RepoInfo & repo_r, bool error_r ) {
+      done.push_back( { repo_r.alias(), error_r } );
+      if ( error_r )
+        ++errors;
+    }, out, err );
+
+    BOOST_CHECK_EQUAL( errors, 3U );
+    BOOST_CHECK( done == ( std::vector<std::pair<std::string,bool>>{
+      { "ok1", false }, { "failed", true }, { "throws", true }, { "killed", true }, { "ok2", false } } ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(foreign_children)
+{
+  // a child not started by ParallelCacheBuild, exited before the build
+  pid_t child = ::fork();
+  BOOST_REQUIRE( child >= 0 );
+  if ( child == 0 )
+    ::_exit( 7 );
+  ::usleep( 100000 );
+
+  ParallelCacheBuild build { 2, []( const RepoInfo & ) {
+    ::usleep( 50000 );
+    return false;
+  } };
+  for ( const char * alias : { "a", "b", "c" } )
+    build.add( repo( alias ) );
+
+  std::ostringstream out;
+  std::ostringstream err;
+  unsigned errors = 0;
+  build.run( [&]( const RepoInfo & repo_r, bool error_r ) {
+    if ( error_r )
+      ++errors;
+  }, out, err );
+  BOOST_CHECK_EQUAL( errors, 0U );
+
+  // its exit status is left to us
+  int status = 0;
+  BOOST_CHECK_EQUAL( ::waitpid( child, &status, 0 ), child );
+  BOOST_CHECK( WIFEXITED( status ) && WEXITSTATUS( status ) == 7 );
+}
@@ -0,0 +1,64 @@
+#include "TestSetup.h"
+#include "output/ProgressThrottle.h"
+#include "output/OutXML.h"
+
+namespace
+{
+  typedef ProgressThrottle::Clock Clock;
+  const Clock::duration half { ProgressThrottle::interval / 2 };
+  const Clock::duration full { ProgressThrottle::interval };
+}
+
+BOOST_AUTO_TEST_CASE(tty)
+{
+  OutNormal out( Out::QUIET );
+  ProgressThrottle throttle( true );
+  Clock::time_point t0 { Clock::now() };
+
+  BOOST_CHECK( throttle.due( out, "bar", 0, t0 ) );		// first update
+  BOOST_CHECK( ! throttle.due( out, "bar", 10, t0 + half ) );	// too early
+  BOOST_CHECK( throttle.due( out, "bar", 20, t0 + full ) );	// interval elapsed
+  BOOST_CHECK( throttle.due( out, "bar", 100, t0 + full + half ) );	// completes the bar
+  BOOST_CHECK( ! throttle.due( out, "bar", 100, t0 + full + half ) );	// but only once
+
+  // each bar on its own
+  BOOST_CHECK( throttle.due( out, "other", 50, t0 + full + half ) );
+
+  // done: the next update starts a new bar
+  throttle.done( "bar" );
+  BOOST_CHECK( throttle.due( out, "bar", 0, t0 + full + half ) );
+}
+
+BOOST_AUTO_TEST_CASE(no_tty)
+{
+  OutNormal out( Out::QUIET );
+  ProgressThrottle throttle( false );
+  Clock::time_point t0 { Clock::now() };
+
+  // intermediate updates are dropped, start and end are drawn unconditionally by Out
+  BOOST_CHECK( ! throttle.due( out, "bar", 0, t0 ) );
+  BOOST_CHECK( ! throttle.due( out, "bar", 50, t0 + 10 * full ) );
+  BOOST_CHECK( ! throttle.due( out, "bar", 100, t0 + 20 * full ) );
+}
+
+BOOST_AUTO_TEST_CASE(xml)
+{
+  OutXML out( Out::QUIET );
+  ProgressThrottle throttle( true );
+  Clock::time_point t0 { Clock::now() };
+
+  BOOST_CHECK( throttle.due( out, "bar", 0, t0 ) );
+  BOOST_CHECK( throttle.due( out, "bar", 1, t0 ) );		// value changed: no time limit
+  BOOST_CHECK( ! throttle.due( out, "bar", 1, t0 + 10 * full ) );	// value unchanged
+
+  // 'is alive' notifications at most every interval
+  BOOST_CHECK( throttle.due( out, "alive", -1, t0 ) );
+  BOOST_CHECK( ! throttle.due( out, "alive", -1, t0 + half ) );
+  BOOST_CHECK( throttle.due( out, "alive", -1, t0 + full ) );
+
+  // the same for a non-tty stdout
+  ProgressThrottle notty( false );
+  BOOST_CHECK( notty.due( out, "bar", 0, t0 ) );
+  BOOST_CHECK( notty.due( out, "bar", 1, t0 ) );
+  BOOST_CHECK( ! notty.due( out, "bar", 1, t0 ) );
+}
@@ -0,0 +1,221 @@
+#include "TestSetup.h"
+#include "commands/ps-scan.h"
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <set>
+
+#include <zypp/TmpPath.h>
+
+using ps::DeletedFilesScanner;
+
+namespace
+{
+  /** A fake \c /proc to scan. */
+  struct FakeProc
+  {
+    FakeProc()
+    {
+      filesystem::assert_dir( proc() / "sys/kernel/random" );
+      bootId( "boot-1" );
+    }
+
+    Pathname proc() const
+    { return _dir.path() / "proc"; }
+
+    Pathname cacheFile() const
+    { return _dir.path() / "ps.cache"; }
+
+    /** A real file to be mapped. */
+    Pathname file( const std::string & name_r, const std::string & content_r = "content" ) const
+    {
+      Pathname ret { _dir.path() / name_r };
+      std::ofstream( ret.c_str() ) << content_r;
+      return ret;
+    }
+
+    void bootId( const std::string & id_r ) const
+    { std::ofstream( ( proc() / "sys/kernel/random/boot_id" ).c_str() ) << id_r << "\n"; }
+
+    void process( const std::string & pid_r, const std::string & starttime_r, const std::string & vsize_r, const std::string & maps_r ) const
+    {
+      Pathname dir { proc() / pid_r };
+      filesystem::assert_dir( dir );
+      // fields after COMM: state ppid ... [19] starttime [20] vsize
+      std::ofstream stat( ( dir / "stat" ).c_str() );
+      stat << pid_r << " (my (cmd)) S 1";
+      for ( unsigned i = 2; i < 19; ++i )
+        stat << " 0";
+      stat << " " << starttime_r << " " << vsize_r << " 0 0\n";
+      std::ofstream( ( dir / "status" ).c_str() ) << "Name:\tcmd\nUid:\t1000\t1000\t1000\t1000\n";
+      std::ofstream( ( dir / "maps" ).c_str() ) << maps_r;
+      filesystem::unlink( dir / "root" );
+      filesystem::symlink( "/", dir / "root" );
+    }
+
+    /** Scan (with cache) and return the files of \a pid_r. */
+    std::set<std::string> scan( const std::string & pid_r ) const
+    {
+      DeletedFilesScanner scanner { cacheFile(), proc() };
+      std::set<std::string> ret;
+      for ( const ps::ProcInfo & info : scanner.scan() )
+      {
+        if ( info.pid == pid_r )
+        {
+          BOOST_CHECK_EQUAL( info.command, "my (cmd)" );
+          BOOST_CHECK_EQUAL( info.ppid, "1" );
+          BOOST_CHECK_EQUAL( info.puid, "1000" );
+          ret.insert( info.files.begin(), info.files.end() );
+        }
+      }
+      scanner.saveCache();
+      return ret;
+    }
+
+    filesystem::TmpDir _dir;
+  };
+
+  std::string mapsLine( const std::string & path_r, const std::string & inode_r = "1234" )
+  { return "7f0000000000-7f0000001000 r-xp 00000000 08:01 " + inode_r + "                   " + path_r + "\n"; }
+}
+
+BOOST_AUTO_TEST_CASE(parse_maps_line)
+{
+  std::string path;
+  bool deleted = true;
+  BOOST_CHECK( DeletedFilesScanner::parseMapsLine( "7f3a1c000000-7f3a1c021000 r-xp 00000000 08:01 393228                     /usr/lib64/libz.so.1.2.13", path, deleted ) );
+  BOOST_CHECK_EQUAL( path, "/usr/lib64/libz.so.1.2.13" );
+  BOOST_CHECK( ! deleted );
+
+  BOOST_CHECK( DeletedFilesScanner::parseMapsLine( "7f3a1c000000-7f3a1c021000 r-xp 00000000 08:01 393228                     /usr/lib64/lib with blank.so (deleted)", path, deleted ) );
+  BOOST_CHECK_EQUAL( path, "/usr/lib64/lib with blank.so" );
+  BOOST_CHECK( deleted );
+
+  // anonymous mappings
+  BOOST_CHECK( ! DeletedFilesScanner::parseMapsLine( "55d4a7c8e000-55d4a7caf000 rw-p 00000000 00:00 0                          [heap]", path, deleted ) );
+  BOOST_CHECK( ! DeletedFilesScanner::parseMapsLine( "7ffd5c9e1000-7ffd5c9e3000 r-xp 00000000 00:00 0", path, deleted ) );
+  BOOST_CHECK( ! DeletedFilesScanner::parseMapsLine( "", path, deleted ) );
+}
+
+BOOST_AUTO_TEST_CASE(ignore_files)
+{
+  BOOST_CHECK( DeletedFilesScanner::ignoreFile( "/dev/shm/pulse-shm-1" ) );
+  BOOST_CHECK( DeletedFilesScanner::ignoreFile( "/run/user/1000/x" ) );
+  BOOST_CHECK( DeletedFilesScanner::ignoreFile( "/var/run/nscd/db" ) );
+  BOOST_CHECK( DeletedFilesScanner::ignoreFile( "/SYSV00000000" ) );
+  BOOST_CHECK( DeletedFilesScanner::ignoreFile( "/memfd:wayland-cursor" ) );
+  BOOST_CHECK( DeletedFilesScanner::ignoreFile( "[vdso]" ) );
+  BOOST_CHECK( DeletedFilesScanner::ignoreFile( "" ) );
+  BOOST_CHECK( ! DeletedFilesScanner::ignoreFile( "/usr/lib64/libz.so.1" ) );
+  BOOST_CHECK( ! DeletedFilesScanner::ignoreFile( "/devel/lib.so" ) );
+
+  // only deleted and not ignored mappings are reported
+  FakeProc fake;
+  Pathname lib { fake.file( "libfoo.so" ) };
+  fake.process( "100", "500", "4096",
+                mapsLine( lib.asString() )
+                + mapsLine( "/usr/lib64/libgone.so (deleted)" )
+                + mapsLine( "/dev/shm/x (deleted)" )
+                + mapsLine( "/run/x (deleted)" )
+                + mapsLine( "/SYSV00000000 (deleted)" )
+                + mapsLine( "/memfd:foo (deleted)" )
+                + "55d4a7c8e000-55d4a7caf000 rw-p 00000000 00:00 0                          [heap]\n" );
+  BOOST_CHECK( fake.scan( "100" ) == std::set<std::string>{ "/usr/lib64/libgone.so" } );
+}
+
+BOOST_AUTO_TEST_CASE(cache_invalidation)
+{
+  FakeProc fake;
+  const std::string gone { mapsLine( "/usr/lib64/libgone.so (deleted)" ) };
+  const std::set<std::string> expectGone { "/usr/lib64/libgone.so" };
+
+  fake.process( "100", "500", "4096", gone );
+  BOOST_CHECK( fake.scan( "100" ) == expectGone );
+
+  // unchanged start time and vsize: the cached mappings are used, the maps not read
+  fake.process( "100", "500", "4096", "" );
+  BOOST_CHECK( fake.scan( "100" ) == expectGone );
+
+  // vsize changed: maps are read again
+  fake.process( "100", "500", "8192", "" );
+  BOOST_CHECK( fake.scan( "100" ).empty() );
+
+  // start time changed (PID reused): maps are read again
+  fake.process( "100", "500", "8192", gone );
+  BOOST_CHECK( fake.scan( "100" ).empty() );	// still the cached (empty) mappings
+  fake.process( "100", "501", "8192", gone );
+  BOOST_CHECK( fake.scan( "100" ) == expectGone );
+
+  // boot id changed: the whole cache is dropped
+  fake.process( "100", "501", "8192", "" );
+  fake.bootId( "boot-2" );
+  BOOST_CHECK( fake.scan( "100" ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE(cache_replaced_files)
+{
+  FakeProc fake;
+  Pathname replaced { fake.file( "libreplaced.so" ) };
+  Pathname removed { fake.file( "libremoved.so" ) };
+  Pathname kept { fake.file( "libkept.so" ) };
+  fake.process( "100", "500", "4096", mapsLine( replaced.asString() ) + mapsLine( removed.asString() ) + mapsLine( kept.asString() ) );
+  BOOST_CHECK( fake.scan( "100" ).empty() );
+
+  // the cached mappings are stat'ed: a new inode or a missing file means deleted
+  Pathname newfile { fake.file( "libreplaced.so.new", "new content" ) };
+  BOOST_REQUIRE_EQUAL( filesystem::rename( newfile, replaced ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::unlink( removed ), 0 );
+  BOOST_CHECK( fake.scan( "100" ) == ( std::set<std::string>{ replaced.asString(), removed.asString() } ) );
+}
+
+BOOST_AUTO_TEST_CASE(compare_with_CheckAccessDeleted)
+{
+  // map a file and delete it
+  filesystem::TmpDir dir;
+  Pathname file { dir.path() / "mapped-and-deleted" };
+  std::ofstream( file.c_str() ) << std::string( 4096, 'x' );
+  int fd = ::open( file.c_str(), O_RDONLY );
+  BOOST_REQUIRE( fd >= 0 );
+  void * addr = ::mmap( nullptr, 4096, PROT_READ, MAP_PRIVATE, fd, 0 );
+  ::close( fd );
+  BOOST_REQUIRE( addr != MAP_FAILED );
+  filesystem::unlink( file );
+
+  const std::string mypid { str::numstring( ::getpid() ) };
+  auto filesOf = [&mypid]( const std::vector<ps::ProcInfo> & procs_r ) {
+    std::set<std::string> ret;
+    for ( const ps::ProcInfo & info : procs_r )
+    {
+      if ( info.pid == mypid )
+      {
+        for ( const std::string & f : info.files )
+          if ( ! DeletedFilesScanner::ignoreFile( f ) )
+            ret.insert( f );
+      }
+    }
+    return ret;
+  };
+
+  std::set<std::string> scanned { filesOf( DeletedFilesScanner().scan() ) };
+  BOOST_CHECK( scanned.count( file.asString() ) );
+
+  std::vector<ps::ProcInfo> lsofProcs;
+  try
+  {
+    CheckAccessDeleted checker( false );
+    checker.check( /*verbose*/true );
+    lsofProcs.assign( checker.begin(), checker.end() );
+  }
+  catch ( const Exception & excpt )
+  {
+    BOOST_TEST_MESSAGE( "CheckAccessDeleted not available (lsof?): " << excpt.asUserString() );
+    ::munmap( addr, 4096 );
+    return;
+  }
+  BOOST_CHECK( scanned == filesOf( lsofProcs ) );
+
+  ::munmap( addr, 4096 );
+}
@@ -0,0 +1,145 @@
+#include "TestSetup.h"
+#include "RepoNameIndex.h"
+#include "info.h"
+
+#include <utime.h>
+#include <algorithm>
+
+namespace
+{
+  /** The test repo, loaded once. */
+  TestSetup & testSetup()
+  {
+    static std::unique_ptr<TestSetup> test;
+    if ( ! test )
+    {
+      test = std::make_unique<TestSetup>( Arch_x86_64 );
+      test->loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_subset", "main" );
+    }
+    return *test;
+  }
+
+  Pathname solvDir()
+  { return RepoManagerOptions::makeTestSetup( testSetup().root() ).repoSolvCachePath / "main"; }
+
+  Repository repo()
+  { return sat::Pool::instance().reposFind( "main" ); }
+
+  std::vector<bool> matches( const RepoNameFilter & filter_r )
+  { return filter_r.matches( RepoNameIndex( solvDir() ) ); }
+}
+
+BOOST_AUTO_TEST_CASE(write_index)
+{
+  BOOST_REQUIRE( PathInfo( solvDir() / "solv" ).isFile() );
+  BOOST_REQUIRE( repo() != Repository::noRepository );
+
+  RepoNameIndex index { solvDir() };
+  filesystem::unlink( solvDir() / "zypper-names" );
+  BOOST_CHECK( ! index.valid() );
+
+  // no index: any repo may contain the names
+  RepoNameFilter filter;
+  filter._names = { { "bash" }, { "no-such-package" } };
+  BOOST_CHECK( matches( filter ) == ( std::vector<bool>{ true, true } ) );
+
+  index.update( repo() );
+  BOOST_CHECK( index.valid() );
+
+  std::vector<std::string> idents;
+  BOOST_CHECK( index.forEachIdent( [&idents]( const std::string & ident_r ) {
+    idents.push_back( ident_r );
+    return true;
+  } ) );
+  BOOST_CHECK( std::is_sorted( idents.begin(), idents.end() ) );
+  BOOST_CHECK( std::adjacent_find( idents.begin(), idents.end() ) == idents.end() );
+  BOOST_CHECK( std::binary_search( idents.begin(), idents.end(), "bash" ) );
+  BOOST_CHECK( std::binary_search( idents.begin(), idents.end(), "glibc" ) );
+}
+
+BOOST_AUTO_TEST_CASE(filter)
+{
+  RepoNameIndex( solvDir() ).update( repo() );
+
+  RepoNameFilter filter;
+  filter._names = {
+    { "bash" },			// exact
+    { "GLIBC" },		// case insensitive
+    { "cracklib-dict-*" },	// glob
+    { "no-such-package" },
+    { "bzip2-1.0", "bzip2" },	// any of the candidates
+  };
+  BOOST_CHECK( matches( filter ) == ( std::vector<bool>{ true, true, true, false, true } ) );
+
+  // the forEachIdent callback stops early, the result must not depend on it
+  filter._names = { { "zlib" }, { "aaa_base" } };
+  BOOST_CHECK( matches( filter ) == ( std::vector<bool>{ true, true } ) );
+}
+
+BOOST_AUTO_TEST_CASE(kinds)
+{
+  RepoNameIndex( solvDir() ).update( repo() );
+
+  // idents of other kinds (e.g. 'product:openSUSE') match only if asked for
+  std::string other;
+  RepoNameIndex( solvDir() ).forEachIdent( [&other]( const std::string & ident_r ) {
+    if ( ResKind::explicitBuiltin( ident_r ) )
+    {
+      other = ident_r.substr( ident_r.find( ':' ) + 1 );
+      return false;
+    }
+    return true;
+  } );
+  if ( other.empty() )
+  {
+    BOOST_TEST_MESSAGE( "no non-package solvables in the test repo" );
+    return;
+  }
+
+  RepoNameFilter filter;
+  filter._names = { { other } };
+  BOOST_CHECK( matches( filter ) == ( std::vector<bool>{ false } ) );
+  filter._anyKind = true;
+  BOOST_CHECK( matches( filter ) == ( std::vector<bool>{ true } ) );
+}
+
+BOOST_AUTO_TEST_CASE(outdated_index)
+{
+  RepoNameIndex index { solvDir() };
+  index.update( repo() );
+  BOOST_REQUIRE( index.valid() );
+
+  // a rebuilt solv file invalidates the index
+  struct utimbuf times { 1, 1 };
+  BOOST_REQUIRE_EQUAL( ::utime( ( solvDir() / "solv" ).c_str(), &times ), 0 );
+  BOOST_CHECK( ! index.valid() );
+
+  RepoNameFilter filter;
+  filter._names = { { "no-such-package" } };
+  BOOST_CHECK( matches( filter ) == ( std::vector<bool>{ true } ) );
+
+  index.update( repo() );
+  BOOST_CHECK( index.valid() );
+  BOOST_CHECK( matches( filter ) == ( std::vector<bool>{ false } ) );
+}
+
+BOOST_AUTO_TEST_CASE(info_filter)
+{
+  PrintInfoOptions options;
+  std::optional<RepoNameFilter> filter { printInfoRepoNameFilter( { "zypper", "zypper-1.0" }, options ) };
+  BOOST_REQUIRE( filter );
+  BOOST_CHECK( ! filter->_anyKind );	// other kinds are found by loading all repos
+  BOOST_CHECK_EQUAL( filter->_names.size(), 2U );
+
+  BOOST_CHECK( printInfoRepoNameFilter( { "patch:foo" }, options ) );
+  BOOST_CHECK( printInfoRepoNameFilter( { "patch:foo" }, options )->_anyKind );
+  BOOST_CHECK( ! printInfoRepoNameFilter( { "patch:foo", "zypper" }, options ) );
+
+  // pattern contents and product requirements need the whole pool
+  BOOST_CHECK( ! printInfoRepoNameFilter( { "pattern:base" }, options ) );
+  BOOST_CHECK( ! printInfoRepoNameFilter( { "product:openSUSE" }, options ) );
+  options._kinds = { ResKind::pattern };
+  BOOST_CHECK( ! printInfoRepoNameFilter( { "base" }, options ) );
+  options._kinds = { ResKind::patch };
+  BOOST_CHECK( printInfoRepoNameFilter( { "foo" }, options ) );
+}
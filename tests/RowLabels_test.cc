@@ -0,0 +1,196 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+/** \file tests/RowLabels_test.cc
+ *
+ * Check the cells of search table rows (status, kind and repository) for
+ * installed, updatable, retracted and locked packages.
+ *
+ * The RowLabels computed once per kind and repo are benchmarked against
+ * looking them up per row, as FillSearchTableSolvable formerly did.
+ */
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <set>
+
+#include "TestSetup.h"
+#include "zypp/TmpPath.h"
+
+#include "search.h"
+
+using namespace zypp;
+
+extern ZYpp::Ptr God;
+
+namespace
+{
+  struct Pkg
+  {
+    std::string _name;
+    std::string _ver;
+    bool _retracted = false;
+  };
+
+  /** An rpm-md repo in \a dir_r providing \a pkgs_r. */
+  void mkRepo( const Pathname & dir_r, const std::vector<Pkg> & pkgs_r )
+  {
+    filesystem::assert_dir( dir_r / "repodata" );
+    std::ofstream( ( dir_r / "repodata/repomd.xml" ).c_str() )
+      << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<repomd xmlns=\"http://linux.duke.edu/metadata/repo\">\n"
+      << "  <data type=\"primary\"><location href=\"repodata/primary.xml\"/></data>\n"
+      << "</repomd>\n";
+    std::ofstream primary( ( dir_r / "repodata/primary.xml" ).c_str() );
+    primary << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<metadata xmlns=\"http://linux.duke.edu/metadata/common\" xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\" packages=\"" << pkgs_r.size() << "\">\n";
+    for ( const Pkg & pkg : pkgs_r )
+    {
+      primary << "<package type=\"rpm\">\n"
+              << "  <name>" << pkg._name << "</name><arch>noarch</arch><version epoch=\"0\" ver=\"" << pkg._ver << "\" rel=\"1\"/>\n"
+              << "  <summary>" << pkg._name << "</summary>\n"
+              << "  <location href=\"noarch/" << pkg._name << "-" << pkg._ver << "-1.noarch.rpm\"/>\n";
+      if ( pkg._retracted )
+        primary << "  <format><rpm:provides><rpm:entry name=\"retracted-patch-package()\"/></rpm:provides></format>\n";
+      primary << "</package>\n";
+    }
+    primary << "</metadata>\n";
+  }
+}
+
+struct TestInit {
+  TestInit()
+    : testSetup( std::make_unique<TestSetup>( Arch_x86_64 ) )
+  {
+    mkRepo( repoDir.path() / "system", { { "foo", "0.9" }, { "qux", "1.0" } } );
+    mkRepo( repoDir.path() / "labels", { { "foo", "1.0" }, { "qux", "1.0" }, { "bar", "1.0", true }, { "baz", "1.0" } } );
+    testSetup->loadTargetRepo( repoDir.path() / "system" );
+    testSetup->loadRepo( repoDir.path() / "labels", "labels" );
+    testSetup->loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+    God = getZYpp();
+  }
+
+  filesystem::TmpDir repoDir;
+  std::unique_ptr<TestSetup> testSetup;
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+BOOST_AUTO_TEST_CASE(search_rows)
+{
+  Repository labelsRepo { sat::Pool::instance().reposFind( "labels" ) };
+  BOOST_REQUIRE( labelsRepo );
+  for ( const sat::Solvable & solv : labelsRepo.solvables() )
+  {
+    if ( solv.name() == "baz" )
+      PoolItem( solv ).status().setLock( true, ResStatus::USER );
+  }
+
+  Table tbl;
+  FillSearchTableSolvable fill( tbl );
+  for ( const sat::Solvable & solv : sat::Pool::instance().solvables() )
+  {
+    if ( solv.repository() == labelsRepo || solv.isSystem() )
+      fill( solv );
+  }
+
+  std::map<std::string,std::vector<std::string>> rows;	// name-version -> cells
+  for ( const TableRow & row : tbl.rows() )
+    rows[row.columns()[1] + "-" + row.columns()[3]] = row.columns();
+  // the installed qux is identical to the available one, so it is not listed
+  BOOST_REQUIRE_EQUAL( rows.size(), 5U );
+
+  const std::string system { std::string("(") + _("System Packages") + ")" };
+  auto check = [&]( const std::string & nv_r, const std::string & status_r, const std::string & repo_r ) {
+    BOOST_TEST_CONTEXT( nv_r )
+    {
+      BOOST_REQUIRE( rows.count( nv_r ) );
+      const std::vector<std::string> & cells { rows[nv_r] };
+      BOOST_CHECK_EQUAL( cells[0], status_r );
+      BOOST_CHECK_EQUAL( cells[2], kind_to_string_localized( ResKind::package, 1 ) );
+      BOOST_CHECK_EQUAL( cells[5], repo_r );
+    }
+  };
+  check( "foo-0.9-1", "i+", system );				// installed
+  check( "foo-1.0-1", "v ", labelsRepo.asUserString() );	// update
+  check( "qux-1.0-1", "i+", labelsRepo.asUserString() );	// installed, from the repo
+  check( "bar-1.0-1", " R", labelsRepo.asUserString() );	// retracted
+  check( "baz-1.0-1", " l", labelsRepo.asUserString() );	// locked
+
+  for ( const sat::Solvable & solv : labelsRepo.solvables() )
+    PoolItem( solv ).status().setLock( false, ResStatus::USER );
+}
+
+BOOST_AUTO_TEST_CASE(repo_filter)
+{
+  Repository labelsRepo { sat::Pool::instance().reposFind( "labels" ) };
+  Repository mainRepo { sat::Pool::instance().reposFind( "main" ) };
+
+  RowLabels all;
+  BOOST_CHECK( all.wanted( labelsRepo ) );
+  BOOST_CHECK( all.wanted( mainRepo ) );
+  BOOST_CHECK( all.wanted( sat::Pool::instance().systemRepo() ) );
+
+  RowLabels some { std::set<std::string>{ "labels" } };
+  BOOST_CHECK( some.wanted( labelsRepo ) );
+  BOOST_CHECK( ! some.wanted( mainRepo ) );
+  BOOST_CHECK( ! some.wanted( sat::Pool::instance().systemRepo() ) );
+  BOOST_CHECK_EQUAL( some.repository( mainRepo ), mainRepo.asUserString() );
+
+  // computed once
+  BOOST_CHECK_EQUAL( &some.kind( ResKind::package ), &some.kind( ResKind::package ) );
+  BOOST_CHECK_EQUAL( &some.repository( mainRepo ), &some.repository( mainRepo ) );
+}
+
+BOOST_AUTO_TEST_CASE(rowlabels_benchmark)
+{
+  std::vector<sat::Solvable> solvables;
+  for ( const sat::Solvable & solv : sat::Pool::instance().solvables() )
+    solvables.push_back( solv );
+  BOOST_REQUIRE( solvables.size() > 1000 );
+
+  using Clock = std::chrono::steady_clock;
+  static const unsigned rounds = 20;
+  const std::set<std::string> aliases { "main", "labels" };
+
+  // former per row lookups: gettext, repo name and --repo filter per row
+  std::vector<std::string> oldCells;
+  auto start = Clock::now();
+  for ( unsigned round = 0; round < rounds; ++round )
+  {
+    oldCells.clear();
+    for ( const sat::Solvable & solv : solvables )
+    {
+      if ( ! aliases.count( solv.repository().alias() ) )
+        continue;
+      oldCells.push_back( kind_to_string_localized( solv.kind(), 1 ) );
+      oldCells.push_back( solv.repository().asUserString() );
+    }
+  }
+  auto oldDone = Clock::now();
+
+  // RowLabels: computed once per kind and repo
+  std::vector<std::string> newCells;
+  for ( unsigned round = 0; round < rounds; ++round )
+  {
+    RowLabels labels { aliases };
+    newCells.clear();
+    for ( const sat::Solvable & solv : solvables )
+    {
+      if ( ! labels.wanted( solv.repository() ) )
+        continue;
+      newCells.push_back( labels.kind( solv.kind() ) );
+      newCells.push_back( labels.repository( solv.repository() ) );
+    }
+  }
+  auto newDone = Clock::now();
+
+  BOOST_TEST_MESSAGE( solvables.size() << " solvables, " << rounds << " rounds" );
+  BOOST_TEST_MESSAGE( "per row lookups: " << std::chrono::duration_cast<std::chrono::microseconds>( oldDone - start ).count() / rounds << "us per round" );
+  BOOST_TEST_MESSAGE( "RowLabels:       " << std::chrono::duration_cast<std::chrono::microseconds>( newDone - oldDone ).count() / rounds << "us per round" );
+
+  BOOST_CHECK( oldCells == newCells );
+}
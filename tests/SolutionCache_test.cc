@@ -0,0 +1,173 @@
+#include "TestSetup.h"
+#include "SolutionCache.h"
+
+#include <set>
+
+#include <zypp/ui/Selectable.h>
+
+using namespace zypp;
+
+extern ZYpp::Ptr God;
+
+namespace
+{
+  struct TestInit {
+    TestInit()
+      : testSetup( std::make_unique<TestSetup>( Arch_x86_64 ) )
+    {
+      // fake target from a subset of the online 11.1 repo
+      testSetup->loadTargetRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_subset" );
+      testSetup->loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+      God = getZYpp();
+    }
+
+    std::unique_ptr<TestSetup> testSetup;
+  };
+
+  std::set<sat::Solvable> transacting()
+  {
+    std::set<sat::Solvable> ret;
+    for ( const PoolItem & pi : God->pool() )
+    {
+      if ( pi.status().transacts() )
+        ret.insert( pi.satSolvable() );
+    }
+    return ret;
+  }
+
+  /** Request to install some not installed packages. */
+  void requestInstall( const std::string & prefix_r )
+  {
+    unsigned requested = 0;
+    for ( const ui::Selectable::Ptr & sel : God->pool().proxy().byKind<Package>() )
+    {
+      if ( requested < 3 && str::hasPrefix( sel->name(), prefix_r ) && ! sel->hasInstalledObj()
+           && sel->hasCandidateObj() && sel->setToInstall( ResStatus::USER ) )
+        ++requested;
+    }
+    BOOST_REQUIRE( requested );
+  }
+
+  /** Drop all transactions. */
+  void reset()
+  {
+    God->resolver()->undo();
+    for ( const PoolItem & pi : God->pool() )
+      pi.status().resetTransact( ResStatus::USER );
+    God->resolver()->setUpgradeMode( false );
+  }
+}
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+BOOST_AUTO_TEST_CASE(save_and_replay)
+{
+  reset();
+  requestInstall( "lib" );
+  SolutionCache cache { Zypper::instance() };	// after the flags, before solving
+  BOOST_REQUIRE( God->resolver()->resolvePool() );
+  const std::set<sat::Solvable> solution { transacting() };
+  BOOST_REQUIRE( cache.save() );
+
+  // the real run: same request, the solver is not called
+  God->resolver()->undo();
+  SolutionCache again { Zypper::instance() };
+  BOOST_CHECK_EQUAL( again.fingerprint(), cache.fingerprint() );
+  BOOST_CHECK( again.replay() );
+  BOOST_CHECK( transacting() == solution );
+
+  again.drop();
+  God->resolver()->undo();
+  BOOST_CHECK( ! again.replay() );
+  reset();
+}
+
+BOOST_AUTO_TEST_CASE(fingerprint_mismatch)
+{
+  reset();
+  requestInstall( "lib" );
+  SolutionCache cache { Zypper::instance() };
+  BOOST_REQUIRE( God->resolver()->resolvePool() );
+  BOOST_REQUIRE( cache.save() );
+  God->resolver()->undo();
+  const std::set<sat::Solvable> request { transacting() };
+
+  // different solver flags
+  Resolver_Ptr resolver { God->resolver() };
+  resolver->setOnlyRequires( ! resolver->onlyRequires() );
+  {
+    SolutionCache changed { Zypper::instance() };
+    BOOST_CHECK_NE( changed.fingerprint(), cache.fingerprint() );
+    BOOST_CHECK( ! changed.replay() );
+    BOOST_CHECK( transacting() == request );	// nothing applied
+  }
+  resolver->setOnlyRequires( ! resolver->onlyRequires() );
+
+  // a different request
+  requestInstall( "x" );
+  {
+    SolutionCache changed { Zypper::instance() };
+    BOOST_CHECK_NE( changed.fingerprint(), cache.fingerprint() );
+    BOOST_CHECK( ! changed.replay() );
+  }
+  reset();
+}
+
+BOOST_AUTO_TEST_CASE(upgrade_mode)
+{
+  reset();
+  SolutionCache cache { Zypper::instance() };
+  God->resolver()->doUpgrade();
+  BOOST_REQUIRE( God->resolver()->upgradeMode() );
+  const std::set<sat::Solvable> solution { transacting() };
+  BOOST_REQUIRE( cache.save() );
+
+  reset();
+  BOOST_REQUIRE( ! God->resolver()->upgradeMode() );
+  SolutionCache again { Zypper::instance() };
+  BOOST_REQUIRE( again.replay() );
+  BOOST_CHECK( transacting() == solution );
+  BOOST_CHECK( God->resolver()->upgradeMode() );	// as if doUpgrade was called
+  again.drop();
+  reset();
+}
+
+BOOST_AUTO_TEST_CASE(auto_installed)
+{
+  reset();
+  requestInstall( "yast2-" );	// they need much more than the test system has
+  SolutionCache cache { Zypper::instance() };
+  BOOST_REQUIRE( God->resolver()->resolvePool() );
+  BOOST_REQUIRE( cache.save() );
+
+  // the dependencies pulled in by the solver, not the requested packages
+  std::set<IdString> requested;
+  std::set<IdString> dependencies;
+  for ( const PoolItem & pi : God->pool() )
+  {
+    if ( pi.status().isToBeInstalled() && pi.isKind<Package>() )
+      ( pi.status().isByUser() ? requested : dependencies ).insert( pi.ident() );
+  }
+  BOOST_REQUIRE( ! dependencies.empty() );
+
+  God->resolver()->undo();
+  SolutionCache again { Zypper::instance() };
+  BOOST_REQUIRE( again.replay() );
+  std::set<IdString> autoInstalled;
+  for ( sat::StringQueue::value_type id : again.autoInstalled() )
+    autoInstalled.insert( IdString( id ) );
+  for ( const IdString & ident : dependencies )
+    BOOST_CHECK_MESSAGE( autoInstalled.count( ident ) || requested.count( ident ), ident << " is auto-installed" );
+  for ( const IdString & ident : requested )
+    BOOST_CHECK_MESSAGE( ! autoInstalled.count( ident ), ident << " is requested by the user" );
+
+  // restored in the pool, as the commit would have done
+  SolutionCache::restoreAutoInstalled( again.autoInstalled() );
+  for ( const IdString & ident : dependencies )
+  {
+    if ( ! requested.count( ident ) )
+      BOOST_CHECK( sat::Pool::instance().isOnSystemByAuto( ident ) );
+  }
+  sat::Pool::instance().setAutoInstalled( sat::StringQueue() );
+  again.drop();
+  reset();
+}
@@ -0,0 +1,149 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+/** \file tests/Summary_test.cc
+ *
+ * Build the install summary of a large transaction (installing all 'lib*'
+ * packages of the 11.1 repo). Checks the package counts and reports the
+ * time needed to compute and write the summary, incl. the recommended and
+ * required closure.
+ *
+ * The id based Summary::ResPairSet is benchmarked against the former
+ * std::set<ResPair,ResPairNameCompare> of ResObjects it replaces.
+ */
+#include <chrono>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include "TestSetup.h"
+#include "zypp/ui/Selectable.h"
+
+#include "Summary.h"
+
+using namespace zypp;
+
+extern ZYpp::Ptr God;
+
+struct TestInit {
+  TestInit()
+    : testSetup( std::make_unique<TestSetup>( Arch_x86_64 ) )
+  {
+    // fake target from a subset of the online 11.1 repo
+    testSetup->loadTargetRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_subset" );
+    testSetup->loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+    God = getZYpp();
+  }
+
+  std::unique_ptr<TestSetup> testSetup;
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+BOOST_AUTO_TEST_CASE(large_transaction)
+{
+  ResPool pool( ResPool::instance() );
+
+  unsigned requested = 0;
+  for ( const ui::Selectable::Ptr & sel : pool.proxy().byKind<Package>() )
+  {
+    if ( str::hasPrefix( sel->name(), "lib" ) && sel->hasCandidateObj() && sel->setToInstall( ResStatus::USER ) )
+      ++requested;
+  }
+  BOOST_TEST_MESSAGE( "requested packages: " << requested );
+  BOOST_REQUIRE( requested > 100 );
+
+  God->resolver()->setForceResolve( true );	// we want a transaction, not problems
+  God->resolver()->resolvePool();
+
+  unsigned toinstall = 0;
+  unsigned toremove = 0;
+  for ( const PoolItem & pi : pool.byKind<Package>() )
+  {
+    if ( pi.status().isToBeInstalled() )
+      ++toinstall;
+    else if ( pi.status().isToBeUninstalled() )
+      ++toremove;
+  }
+  BOOST_TEST_MESSAGE( "transaction: " << toinstall << " to install, " << toremove << " to remove" );
+
+  auto start = std::chrono::steady_clock::now();
+  Summary summary( pool, SummaryHints(), Summary::DEFAULT );
+  auto built = std::chrono::steady_clock::now();
+  std::ostringstream str;
+  summary.dumpTo( str );
+  auto written = std::chrono::steady_clock::now();
+
+  BOOST_TEST_MESSAGE( "Summary ctor: " << std::chrono::duration_cast<std::chrono::milliseconds>( built - start ).count() << "ms" );
+  BOOST_TEST_MESSAGE( "Summary dumpTo: " << std::chrono::duration_cast<std::chrono::milliseconds>( written - built ).count() << "ms" );
+
+  // upgrades, downgrades and reinstalls pair an installed and a removed package
+  unsigned paired = summary.packagesToUpgrade() + summary.packagesToDowngrade() + summary.packagesToReInstall();
+  BOOST_CHECK_EQUAL( summary.packagesToGetAndInstall(), toinstall );
+  BOOST_CHECK( summary.packagesToInstall() + paired <= toinstall );
+  BOOST_CHECK( summary.packagesToRemove() + paired <= toremove );
+  BOOST_CHECK( ! str.str().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(respairset_vs_set_benchmark)
+{
+  // runs after large_transaction: the pool still holds the transaction
+  std::vector<PoolItem> items;
+  for ( const PoolItem & pi : ResPool::instance() )
+  {
+    if ( pi.status().transacts() )
+      items.push_back( pi );
+  }
+  BOOST_REQUIRE( items.size() > 100 );
+
+  using Clock = std::chrono::steady_clock;
+  static const unsigned rounds = 20;
+
+  // former model: ResObjects in name sorted sets, filled while collecting
+  std::vector<std::string> oldOrder;
+  auto start = Clock::now();
+  for ( unsigned round = 0; round < rounds; ++round )
+  {
+    std::map<ResKind, std::set<Summary::ResPair, Summary::ResPairNameCompare>> lists;
+    for ( const PoolItem & pi : items )
+      lists[pi.kind()].insert( Summary::ResPair( nullptr, pi.resolvable() ) );
+    oldOrder.clear();
+    for ( const auto & kindset : lists )
+      for ( const Summary::ResPair & respair : kindset.second )
+        oldOrder.push_back( respair.second->name() );
+  }
+  auto oldDone = Clock::now();
+
+  // id model: ids collected, sorted by name and rendered once
+  std::vector<std::string> newOrder;
+  for ( unsigned round = 0; round < rounds; ++round )
+  {
+    Summary::KindToResPairSet lists;
+    for ( const PoolItem & pi : items )
+      lists[pi.kind()].insert( pi.satSolvable() );
+    newOrder.clear();
+    for ( const auto & kindset : lists )
+      for ( const Summary::ResPair & respair : kindset.second )
+        newOrder.push_back( respair.second->name() );
+  }
+  auto newDone = Clock::now();
+
+  BOOST_TEST_MESSAGE( items.size() << " items, " << rounds << " rounds" );
+  BOOST_TEST_MESSAGE( "std::set<ResPair>: " << std::chrono::duration_cast<std::chrono::microseconds>( oldDone - start ).count() / rounds << "us per round" );
+  BOOST_TEST_MESSAGE( "ResPairSet:        " << std::chrono::duration_cast<std::chrono::microseconds>( newDone - oldDone ).count() / rounds << "us per round" );
+
+  // same items, same order, same name/edition dedup
+  BOOST_CHECK( oldOrder == newOrder );
+
+  Summary::ResPairSet set;
+  BOOST_CHECK( set.insert( items[0].satSolvable() ) );
+  BOOST_CHECK( ! set.insert( items[0].satSolvable() ) );
+  BOOST_CHECK( set.contains( items[0].satSolvable() ) );
+  BOOST_CHECK_EQUAL( set.size(), 1U );
+  set.clear();
+  BOOST_CHECK( set.empty() );
+  BOOST_CHECK( set.begin() == set.end() );
+}
@@ -0,0 +1,135 @@
+#include "TestSetup.h"
+#include "TransactionBundle.h"
+#include "SolutionCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+#include <zypp/CheckSum.h>
+#include <zypp/TmpPath.h>
+#include <zypp/ui/Selectable.h>
+
+extern ZYpp::Ptr God;
+
+namespace
+{
+  void writeManifest( const Pathname & dir_r, const std::string & entries_r )
+  {
+    std::ofstream( ( dir_r / "transaction" ).c_str() )
+      << "# zypper transaction bundle v2\n"
+      << "system 0123456789abcdef\n"
+      << "auto libfoo\n"
+      << entries_r;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(read_and_verify)
+{
+  filesystem::TmpDir root;
+  filesystem::assert_dir( root.path() / "rpms" );
+  Pathname rpm { root.path() / "rpms/foo-2-1.noarch.rpm" };
+  std::ofstream( rpm.c_str() ) << "not really an rpm";
+  std::string sha256 { filesystem::checksum( rpm, CheckSum::sha256Type() ) };
+
+  writeManifest( root.path(),
+                 "i\tfoo\t2-1\tnoarch\t" + sha256 + "\trpms/foo-2-1.noarch.rpm\n"
+                 "U\tfoo\t1-1\tnoarch\n" );
+
+  TransactionBundle bundle { root.path() };
+  BOOST_CHECK_EQUAL( bundle.system(), "0123456789abcdef" );
+  BOOST_REQUIRE_EQUAL( bundle.autoInstalled().size(), 1U );
+  BOOST_CHECK_EQUAL( IdString( bundle.autoInstalled()[0] ), IdString( "libfoo" ) );
+  BOOST_REQUIRE_EQUAL( bundle.size(), 2U );
+  BOOST_CHECK_EQUAL( bundle.entries()[0]._action, 'i' );
+  BOOST_CHECK_EQUAL( bundle.entries()[0]._edition, Edition("2-1") );
+  BOOST_CHECK_EQUAL( bundle.entries()[1]._action, 'U' );
+  BOOST_CHECK_EQUAL( bundle.entries()[1]._checksum, "" );
+  BOOST_CHECK( bundle.verify().empty() );
+
+  std::ofstream( rpm.c_str() ) << "tampered";
+  std::vector<std::string> corrupt { bundle.verify() };
+  BOOST_REQUIRE_EQUAL( corrupt.size(), 1U );
+  BOOST_CHECK_EQUAL( corrupt[0], "rpms/foo-2-1.noarch.rpm" );
+}
+
+BOOST_AUTO_TEST_CASE(malformed)
+{
+  filesystem::TmpDir root;
+  BOOST_CHECK_THROW( TransactionBundle( root.path() ), Exception );	// no manifest
+
+  writeManifest( root.path(), "x\tfoo\t1-1\tnoarch\n" );
+  BOOST_CHECK_THROW( TransactionBundle( root.path() ), Exception );
+
+  writeManifest( root.path(), "i\tfoo\t1-1\tnoarch\n" );	// checksum and file missing
+  BOOST_CHECK_THROW( TransactionBundle( root.path() ), Exception );
+
+  writeManifest( root.path(), "i\tfoo\t1-1\tnoarch\tab\t../etc/passwd\n" );
+  BOOST_CHECK_THROW( TransactionBundle( root.path() ), Exception );
+}
+
+BOOST_AUTO_TEST_CASE(export_apply_roundtrip)
+{
+  // a file:// repo providing the rpms (fake ones, the bundle checks its own checksums)
+  filesystem::TmpDir repoDir;
+  BOOST_REQUIRE_EQUAL( filesystem::copy_dir_content( TESTS_SRC_DIR "/data/openSUSE-11.1", repoDir.path() ), 0 );
+  TestSetup test( Arch_x86_64 );
+  test.loadTargetRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_subset" );
+  test.loadRepo( Url( "file://" + repoDir.path().asString() ), "main" );
+  God = getZYpp();
+
+  unsigned requested = 0;
+  for ( const ui::Selectable::Ptr & sel : God->pool().proxy().byKind<Package>() )
+  {
+    if ( requested < 3 && str::hasPrefix( sel->name(), "yast2-" ) && ! sel->hasInstalledObj()
+         && sel->hasCandidateObj() && sel->setToInstall( ResStatus::USER ) )
+      ++requested;
+  }
+  BOOST_REQUIRE( requested );
+  BOOST_REQUIRE( God->resolver()->resolvePool() );
+
+  std::set<sat::Solvable> solution;
+  for ( const PoolItem & pi : God->pool() )
+  {
+    if ( pi.status().transacts() && pi.isKind<Package>() )
+    {
+      solution.insert( pi.satSolvable() );
+      if ( pi.status().isToBeInstalled() )
+      {
+        // 'download' the rpm
+        Pathname rpm { repoDir.path() / pi.lookupLocation().filename() };
+        filesystem::assert_dir( rpm.dirname() );
+        std::ofstream( rpm.c_str() ) << "rpm of " << pi.satSolvable().asString();
+      }
+    }
+  }
+  const sat::StringQueue autoInstalled { SolutionCache::solvedAutoInstalled() };
+  BOOST_REQUIRE( ! autoInstalled.empty() );
+
+  // export
+  filesystem::TmpDir bundleDir;
+  TransactionBundle exported { TransactionBundle::fromPool( autoInstalled ) };
+  BOOST_CHECK_NO_THROW( exported.write( bundleDir.path() ) );
+
+  // apply, to the same system
+  God->resolver()->undo();
+  for ( const PoolItem & pi : God->pool() )
+    pi.status().resetTransact( ResStatus::USER );
+
+  TransactionBundle bundle { bundleDir.path() };
+  BOOST_CHECK_EQUAL( bundle.system(), TransactionBundle::systemFingerprint() );
+  BOOST_CHECK( bundle.verify().empty() );
+  BOOST_CHECK( bundle.autoInstalled().size() == autoInstalled.size()
+               && std::equal( autoInstalled.begin(), autoInstalled.end(), bundle.autoInstalled().begin() ) );
+  BOOST_CHECK( bundle.apply( "main" ).empty() );
+
+  std::set<sat::Solvable> applied;
+  for ( const PoolItem & pi : God->pool() )
+  {
+    if ( pi.status().transacts() && pi.isKind<Package>() )
+      applied.insert( pi.satSolvable() );
+  }
+  BOOST_CHECK( applied == solution );
+
+  God->resolver()->undo();
+}
@@ -460,6 +460,107 @@ BOOST_AUTO_TEST_CASE( circular_dependencies )
   BOOST_REQUIRE_THROW( parseCLI( sizeof(testArgs) / sizeof(char *),  ( char *const* )testArgs, { grp } ), ZyppFlagsException ) ;
 }
 
+BOOST_AUTO_TEST_CASE( option_table )
+{
+  //a OptionTable is built once and reused, each parse must behave like a fresh parseCLI
+  int  requiredArgOption = 0;
+  std::vector<int> containerArg;
+  std::vector <int> values;
+
+  std::vector<CommandGroup> options {
+    CommandGroup {
+      {
+        { "reqArg", 'b', RequiredArgument, IntType( &requiredArgOption ) },
+        { "repeatableArg", 'd', RequiredArgument | Repeatable, GenericContainerType( containerArg ) },
+        std::move( CommandOption (
+           "arg1", 'a', NoArgument, CallbackVal(  [&] ( const CommandOption &, const boost::optional<std::string> & ) {
+              values.push_back( 1 );
+            })
+        ).setDependencies( { "arg2" } ) ),
+        std::move( CommandOption (
+           "arg2", 0, NoArgument, CallbackVal(  [&] ( const CommandOption &, const boost::optional<std::string> & ) {
+              values.push_back( 2 );
+            })
+        ).setPriority( 1 ) ),
+        std::move( CommandOption (
+           "arg3", 'c', NoArgument, CallbackVal(  [&] ( const CommandOption &, const boost::optional<std::string> & ) {
+              values.push_back( 3 );
+            })
+        ).setPriority( 2 ) ),
+        CommandOption (
+           "arg4", 0, NoArgument, CallbackVal(  [&] ( const CommandOption &, const boost::optional<std::string> & ) {
+              values.push_back( 4 );
+            })
+        )
+      },
+      {
+        { "arg4", "reqArg" }
+      }
+    }
+  };
+
+  OptionTable table( options );
+
+  const char *testArgs[] {
+    "command",
+    "--arg1", "-c", "--arg2",
+    "--reqArg", "10",
+    "--reqArg", "11", // not repeatable, only the first value is taken
+    "-d1", "--repeatableArg", "2",
+    "positional"
+  };
+  const int argc = sizeof(testArgs) / sizeof(char *);
+
+  std::vector<int> expectedValues { 3, 2, 1 };
+  std::vector<int> expectedSet{ 1, 2 };
+
+  for ( int run = 0; run < 3; ++run ) {
+    values.clear();
+    containerArg.clear();
+    requiredArgOption = 0;
+
+    int nextArg = -1;
+    BOOST_CHECK_NO_THROW( nextArg = table.parse( argc, ( char *const* )testArgs ) );
+    BOOST_CHECK_EQUAL ( nextArg, argc - 1 );
+    BOOST_CHECK_EQUAL ( values, expectedValues );
+    BOOST_CHECK_EQUAL ( requiredArgOption, 10 );
+    BOOST_CHECK_EQUAL ( containerArg, expectedSet );
+  }
+
+  {
+    //same result as parseCLI
+    values.clear();
+    containerArg.clear();
+    requiredArgOption = 0;
+
+    BOOST_CHECK_EQUAL ( parseCLI( argc, ( char *const* )testArgs, options ), argc - 1 );
+    BOOST_CHECK_EQUAL ( values, expectedValues );
+    BOOST_CHECK_EQUAL ( requiredArgOption, 10 );
+    BOOST_CHECK_EQUAL ( containerArg, expectedSet );
+  }
+
+  {
+    //errors do not leave state behind for the next parse
+    const char *badArgs[] {
+      "command",
+      "--reqArg", "10",
+      "--arg4"
+    };
+
+    BOOST_REQUIRE_THROW( table.parse( sizeof(badArgs) / sizeof(char *), ( char *const* )badArgs ), ConflictingFlagsException );
+
+    const char *goodArgs[] {
+      "command",
+      "--reqArg", "12"
+    };
+
+    values.clear();
+    BOOST_CHECK_NO_THROW( table.parse( sizeof(goodArgs) / sizeof(char *), ( char *const* )goodArgs ) );
+    BOOST_CHECK_EQUAL ( requiredArgOption, 12 );
+    BOOST_CHECK ( values.empty() );
+  }
+}
+
 BOOST_AUTO_TEST_CASE( types )
 {
   int integer = 0;
@@ -0,0 +1,71 @@
+#include "TestSetup.h"
+#include "utils/CommitEvents.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+
+namespace
+{
+  std::string readAll( int fd_r )
+  {
+    std::string ret;
+    char buf[4096];
+    for ( ssize_t got; ( got = ::read( fd_r, buf, sizeof(buf) ) ) > 0; )
+      ret.append( buf, got );
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+  CommitEvents & events( CommitEvents::instance() );
+  BOOST_CHECK( ! events.enabled() );
+  events.begin( "install", sat::Solvable() );
+  BOOST_CHECK( ! events.active( "install", sat::Solvable() ) );
+  BOOST_CHECK_THROW( events.enable( -1 ), zypp::Exception );
+}
+
+BOOST_AUTO_TEST_CASE(events)
+{
+  int fds[2];
+  BOOST_REQUIRE_EQUAL( ::pipe( fds ), 0 );
+  ::fcntl( fds[0], F_SETFL, O_NONBLOCK );
+
+  CommitEvents & events( CommitEvents::instance() );
+  events.enable( fds[1] );
+  BOOST_CHECK( events.enabled() );
+
+  events.end( "install", sat::Solvable(), true );	// not begun: ignored
+  events.begin( "script", sat::Solvable(), ByteCount(), "%post" );
+  BOOST_CHECK( events.active( "script", sat::Solvable(), "%post" ) );
+  events.end( "script", sat::Solvable(), false, ByteCount(), "%post" );
+  BOOST_CHECK( ! events.active( "script", sat::Solvable(), "%post" ) );
+
+  std::string out { readAll( fds[0] ) };
+  std::vector<std::string> lines;
+  str::split( out, std::back_inserter(lines), "\n" );
+  BOOST_REQUIRE_EQUAL( lines.size(), 2U );
+  BOOST_CHECK( str::startsWith( lines[0], "{\"event\":\"commit\",\"phase\":\"script\",\"state\":\"begin\",\"time\":" ) );
+  BOOST_CHECK( str::endsWith( lines[0], ",\"detail\":\"%post\"}" ) );
+  BOOST_CHECK( str::startsWith( lines[1], "{\"event\":\"commit\",\"phase\":\"script\",\"state\":\"end\"" ) );
+  BOOST_CHECK( lines[1].find( "\"ok\":false,\"duration\":" ) != std::string::npos );
+
+  ::close( fds[0] );
+  ::close( fds[1] );
+}
+
+BOOST_AUTO_TEST_CASE(timings)
+{
+  CommitEvents & events( CommitEvents::instance() );
+  events.recordTimings();
+  BOOST_CHECK( events.enabled() );
+
+  events.begin( "transaction", sat::Solvable(), ByteCount(), "Preparing" );
+  events.end( "transaction", sat::Solvable(), true, ByteCount(), "Preparing" );
+  events.end( "install", sat::Solvable(), true );	// not begun: ignored
+
+  BOOST_REQUIRE_EQUAL( events.timings().size(), 1U );
+  BOOST_CHECK_EQUAL( events.timings()[0]._phase, "transaction" );
+  BOOST_CHECK_EQUAL( events.timings()[0]._detail, "Preparing" );
+  BOOST_CHECK( events.timings()[0]._seconds >= 0.0 );
+}
@@ -0,0 +1,69 @@
+#include "TestSetup.h"
+#include "utils/DownloadStats.h"
+
+#include <fstream>
+
+#include <zypp/TmpPath.h>
+
+BOOST_AUTO_TEST_CASE(counts)
+{
+  DownloadStats::Counts counts;
+  BOOST_CHECK_EQUAL( counts.rate(), ByteCount() );
+  BOOST_CHECK_EQUAL( counts.cacheHitRatio(), 0.0 );
+
+  counts._downloaded = 3;
+  counts._cached = 1;
+  counts._bytes = ByteCount( 1000 );
+  counts._seconds = 0.5;
+  BOOST_CHECK_EQUAL( counts.rate(), ByteCount( 2000 ) );
+  BOOST_CHECK_EQUAL( counts.cacheHitRatio(), 0.25 );
+
+  DownloadStats::Counts sum;
+  sum += counts;
+  sum += counts;
+  BOOST_CHECK_EQUAL( sum._downloaded, 6U );
+  BOOST_CHECK_EQUAL( sum._bytes, ByteCount( 2000 ) );
+  BOOST_CHECK_EQUAL( sum._seconds, 1.0 );
+}
+
+BOOST_AUTO_TEST_CASE(serverOf)
+{
+  BOOST_CHECK_EQUAL( DownloadStats::serverOf( Url("https://download.opensuse.org/tumbleweed/repo/oss/") ), "https://download.opensuse.org" );
+  BOOST_CHECK_EQUAL( DownloadStats::serverOf( Url("http://mirror:8080/repo") ), "http://mirror:8080" );
+  BOOST_CHECK_EQUAL( DownloadStats::serverOf( Url("dir:///srv/repo") ), "dir://" );
+}
+
+BOOST_AUTO_TEST_CASE(files)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "a.rpm" };
+  std::ofstream( file.c_str() ) << std::string( 100, 'x' );
+  Url url { "https://mirror.example.org/repo/x86_64/a.rpm" };
+
+  DownloadStats & stats( DownloadStats::instance() );
+  stats.fileStart( url );	// not active: ignored
+  stats.fileFinish( url, file, true );
+  BOOST_CHECK( stats.empty() );
+
+  stats.start();
+  stats.fileStart( url );
+  stats.fileRetry( url );
+  stats.fileFinish( url, file, true );
+  stats.fileStart( url );
+  stats.fileFinish( url, file, false );
+  stats.fileFinish( url, file, true );	// not started: ignored
+  stats.stop();
+
+  BOOST_REQUIRE_EQUAL( stats.servers().size(), 1U );
+  const DownloadStats::Counts & counts { stats.servers().begin()->second };
+  BOOST_CHECK_EQUAL( stats.servers().begin()->first, "https://mirror.example.org" );
+  BOOST_CHECK_EQUAL( counts._downloaded, 1U );
+  BOOST_CHECK_EQUAL( counts._failed, 1U );
+  BOOST_CHECK_EQUAL( counts._retries, 1U );
+  BOOST_CHECK_EQUAL( counts._bytes, ByteCount( 100 ) );
+  BOOST_CHECK( stats.repos().empty() );	// no package download
+
+  stats.start();
+  BOOST_CHECK( stats.empty() );
+  stats.stop();
+}
@@ -0,0 +1,44 @@
+#include "TestSetup.h"
+#include "utils/MemStats.h"
+
+#include <sstream>
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+  {
+    MemStats::Phase phase( "ignored" );
+  }
+  BOOST_CHECK( MemStats::instance().samples().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(phases)
+{
+  MemStats & memstats( MemStats::instance() );
+  memstats.enable();
+
+  constexpr std::size_t allocSize = 64 * 1024 * 1024;
+  {
+    MemStats::Phase phase( "big" );
+    std::vector<char> mem( allocSize, 'x' );	// touched, so it counts in RSS
+    BOOST_CHECK_EQUAL( mem.back(), 'x' );
+  }
+  {
+    MemStats::Phase phase( "small" );
+    MemStats::Phase nested( "nested" );	// counts for "small"
+  }
+
+  const std::vector<MemStats::Sample> & samples( memstats.samples() );
+  BOOST_REQUIRE_EQUAL( samples.size(), 2U );
+  BOOST_CHECK_EQUAL( samples[0]._phase, "big" );
+  BOOST_CHECK_EQUAL( samples[1]._phase, "small" );
+
+  BOOST_CHECK( samples[0]._rss > 0 );
+  BOOST_CHECK( samples[0]._peakRss >= allocSize / 1024 );
+  if ( memstats.phasePeak() )	// kernel allows to reset the peak
+    BOOST_CHECK( samples[1]._peakRss < samples[0]._peakRss );
+
+  std::ostringstream json;
+  memstats.writeJson( json );
+  BOOST_CHECK( json.str().find( "\"phase\": \"big\"" ) != std::string::npos );
+  BOOST_CHECK( json.str().find( "\"phase\": \"nested\"" ) == std::string::npos );
+}
@@ -0,0 +1,52 @@
+#include "TestSetup.h"
+#include "utils/misc.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <zypp/TmpPath.h>
+
+namespace
+{
+  std::string contentOf( const Pathname & file_r )
+  {
+    std::ifstream in( file_r.c_str() );
+    std::ostringstream str;
+    str << in.rdbuf();
+    return str.str();
+  }
+
+  /** The local rpm is in the cache as a regular file, not a symlink. */
+  void checkCached( const Pathname & rpm_r, const Pathname & cacheDir_r )
+  {
+    std::vector<Pathname> cached { cache_rpms( { "file://" + rpm_r.asString() }, cacheDir_r ) };
+    BOOST_REQUIRE_EQUAL( cached.size(), 1U );
+    BOOST_CHECK_EQUAL( cached[0], cacheDir_r / rpm_r.basename() );
+    BOOST_CHECK( PathInfo( cached[0], PathInfo::LSTAT ).isFile() );
+    BOOST_CHECK_EQUAL( contentOf( cached[0] ), contentOf( rpm_r ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cache_rpms_local)
+{
+  filesystem::TmpDir tmp;
+  Pathname rpm { tmp.path() / "foo-1.0-1.noarch.rpm" };
+  std::ofstream( rpm.c_str() ) << "not really an rpm";
+
+  checkCached( rpm, tmp.path() / "cache" );
+  // again, replacing the cached one
+  checkCached( rpm, tmp.path() / "cache" );
+}
+
+BOOST_AUTO_TEST_CASE(cache_rpms_other_filesystem)
+{
+  filesystem::TmpDir tmp;
+  Pathname rpm { tmp.path() / "foo-1.0-1.noarch.rpm" };
+  std::ofstream( rpm.c_str() ) << "not really an rpm";
+
+  // a hardlink fails there, so the rpm must be copied
+  if ( ! PathInfo( "/dev/shm" ).isDir() || PathInfo( "/dev/shm" ).dev() == PathInfo( tmp.path() ).dev() )
+    return;
+  filesystem::TmpDir other( "/dev/shm" );
+  checkCached( rpm, other.path() / "cache" );
+}